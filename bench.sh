@@ -15,11 +15,15 @@ Options:
       --min-time SECONDS    Minimum benchmark time (default: 0.01)
       --format FORMAT       json|console (default: json)
       --no-build            Skip build step
+      --baseline PATH|auto  Compare against a stored run and fail on regressions
+                             (auto: newest benchmarks/results/<preset>__*__<os>-<arch>__*.json)
+      --threshold PCT       Allowed slowdown or memory growth in percent (default: 15)
   -h, --help                Show this help
 
 Examples:
   ./bench.sh --preset bench-release
   ./bench.sh --preset bench-release --filter Inference --min-time 0.05
+  ./bench.sh --preset bench-release --baseline auto --threshold 10
 EOF
 }
 
@@ -46,6 +50,8 @@ BENCH_FILTER=""
 MIN_TIME="0.01"
 OUT_FORMAT="json"
 DO_BUILD="1"
+BASELINE=""
+THRESHOLD="15"
 
 # ------------------------------------------------------------
 # Argument parsing
@@ -70,6 +76,12 @@ while [[ $# -gt 0 ]]; do
       OUT_FORMAT="$2"; shift 2 ;;
     --no-build)
       DO_BUILD="0"; shift ;;
+    --baseline)
+      [[ $# -ge 2 ]] || die "missing value for $1"
+      BASELINE="$2"; shift 2 ;;
+    --threshold)
+      [[ $# -ge 2 ]] || die "missing value for $1"
+      THRESHOLD="$2"; shift 2 ;;
     -h|--help)
       usage; exit 0 ;;
     *)
@@ -81,6 +93,12 @@ done
 
 command -v cmake >/dev/null 2>&1 || die "cmake not found"
 
+if [[ -n "$BASELINE" ]]; then
+  [[ "$OUT_FORMAT" == "json" ]] || die "--baseline needs --format json"
+  [[ "$THRESHOLD" =~ ^[0-9]+([.][0-9]+)?$ ]] || die "invalid --threshold: $THRESHOLD"
+  command -v python3 >/dev/null 2>&1 || die "python3 not found (needed for --baseline)"
+fi
+
 # ------------------------------------------------------------
 # Normalize min time
 # ------------------------------------------------------------
@@ -122,6 +140,7 @@ echo "out:      $OUT_PATH"
 echo "format:   $OUT_FORMAT"
 echo "min-time: $MIN_TIME"
 [[ -n "$BENCH_FILTER" ]] && echo "filter:   $BENCH_FILTER"
+[[ -n "$BASELINE" ]] && echo "baseline: $BASELINE (threshold ${THRESHOLD}%)"
 
 cmake --preset "$PRESET"
 
@@ -177,3 +196,35 @@ esac
 
 echo "wrote benchmark json: $OUT_PATH"
 echo "wrote system info:    $SYSINFO_PATH"
+
+# ------------------------------------------------------------
+# Regression gate
+# ------------------------------------------------------------
+
+[[ -n "$BASELINE" ]] || exit 0
+
+if [[ "$BASELINE" == "auto" ]]; then
+  BASELINE=""
+  # Stamps sort lexically, so the last match is the newest run on this platform
+  for candidate in "$ROOT_DIR"/benchmarks/results/"${PRESET}"__*__"${OS}-${ARCH}"__*.json; do
+    [[ -f "$candidate" && "$candidate" != "$OUT_PATH" ]] && BASELINE="$candidate"
+  done
+  if [[ -z "$BASELINE" ]]; then
+    echo "no stored ${PRESET} baseline for ${OS}-${ARCH}; skipping comparison"
+    exit 0
+  fi
+fi
+
+[[ -f "$BASELINE" ]] || die "baseline not found: $BASELINE"
+
+COMPARE_PATH="${OUT_PATH%.json}.compare.txt"
+COMPARE_ARGS=( "--threshold" "$THRESHOLD" )
+[[ -n "$BENCH_FILTER" ]] && COMPARE_ARGS+=( "--filter" "$BENCH_FILTER" )
+
+set +e
+python3 "$ROOT_DIR/benchmarks/compare.py" "${COMPARE_ARGS[@]}" "$BASELINE" "$OUT_PATH" | tee "$COMPARE_PATH"
+STATUS="${PIPESTATUS[0]}"
+set -e
+
+echo "wrote comparison:     $COMPARE_PATH"
+exit "$STATUS"
@@ -6,16 +6,121 @@
  * - Expression evaluation
  * - Full deduction cycles with varying knowledge base sizes
  * - Lexer tokenization
+ * - Parsing assumptions and facts files
+ * - Warm start from a snapshot
+ * - Streaming facts ingestion
+ * - Reads concurrent with deduction
+ * - Memory per proposition
+ * - Large and adversarial workloads (fan-out, deep chains, dense disjunctions,
+ *   quantifier expressions, file load plus deduction), with heap high-water marks
  */
 
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
 #include "Ratiocinator.h"
 #include "InferenceEngine.h"
 #include "Expression.h"
+#include "ExpressionDag.h"
+#include "TripartiteBatch.h"
 #include "Lexer.h"
+#include "Parser.h"
+#include "OutputFile.h"
+#include "RuleBase.h"
+
+// ============================================================
+// ALLOCATION COUNTING
+// ============================================================
+
+// Live heap bytes, tracked by replacing the global allocator for this binary.
+// Each block carries its size in a header so delete can subtract it. The
+// high-water mark is the most live bytes seen since the last markHeapPeak().
+namespace {
+std::atomic<long long> liveHeapBytes{0};
+std::atomic<long long> peakHeapBytes{0};
+constexpr size_t kHeapHeader = alignof(std::max_align_t);
+}  // namespace
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + kHeapHeader));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    long long live = liveHeapBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed) +
+                     static_cast<long long>(size);
+    long long peak = peakHeapBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakHeapBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    return block + kHeapHeader;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+    char* block = static_cast<char*>(pointer) - kHeapHeader;
+    liveHeapBytes.fetch_sub(static_cast<long long>(*reinterpret_cast<size_t*>(block)),
+                            std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+/**
+ * Restart the heap high-water mark from the bytes live now, and return them.
+ */
+static long long markHeapPeak() {
+    long long live = liveHeapBytes.load();
+    peakHeapBytes.store(live);
+    return live;
+}
+
+/**
+ * Most heap bytes live above a mark since it was taken.
+ */
+static long long heapPeakSince(long long mark) {
+    return peakHeapBytes.load() - mark;
+}
+
+/**
+ * Resident set high-water mark of the whole process, in bytes (0 if unknown).
+ */
+static double maxResidentBytes() {
+#if defined(__APPLE__)
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<double>(usage.ru_maxrss) : 0.0;
+#elif defined(__unix__)
+    struct rusage usage;  // ru_maxrss is in kilobytes here
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<double>(usage.ru_maxrss) * 1024.0 : 0.0;
+#else
+    return 0.0;
+#endif
+}
+
+/**
+ * Report memory counters: the heap high-water mark above the run's starting
+ * point (peak_heap_mb) and the process's resident high-water mark (max_rss_mb).
+ */
+static void reportMemory(benchmark::State& state, long long peakBytes) {
+    state.counters["peak_heap_mb"] = static_cast<double>(peakBytes) / (1024.0 * 1024.0);
+    state.counters["max_rss_mb"] = maxResidentBytes() / (1024.0 * 1024.0);
+}
 
 // ============================================================
 // HELPER FUNCTIONS
@@ -96,9 +201,13 @@ BENCHMARK(BM_ModusPonens_Single);
  * Setup: A=TRUE, A->B, B->C, ..., Y->Z
  * Measure: Time to derive all consequents
  */
-static void BM_ModusPonens_Chain(benchmark::State& state) {
+static void runModusPonensChain(benchmark::State& state, DeductionStrategy strategy) {
     const int chainLength = state.range(0);
     
+    InferenceEngine::Options options;
+    options.strategy = strategy;
+    size_t passes = 0;
+    
     for (auto _ : state) {
         std::unordered_map<std::string, Proposition> props;
         std::vector<Expression> exprs;
@@ -113,16 +222,39 @@ static void BM_ModusPonens_Chain(benchmark::State& state) {
             props[curr] = makeImplication("imp_" + prev + "_" + curr, prev, curr);
         }
         
-        InferenceEngine engine;
+        InferenceEngine engine(options);
         engine.deduceAll(props, exprs);
+        passes = engine.getConvergence().passes;
         
         std::string last = "P" + std::to_string(chainLength);
         benchmark::DoNotOptimize(props[last].getTruthValue());
     }
     
+    state.counters["passes"] = static_cast<double>(passes);
     state.SetComplexityN(chainLength);
 }
-BENCHMARK(BM_ModusPonens_Chain)->Range(2, 64)->Complexity();
+
+static void BM_ModusPonens_Chain(benchmark::State& state) {
+    runModusPonensChain(state, DeductionStrategy::WORKLIST);
+}
+BENCHMARK(BM_ModusPonens_Chain)->Range(2, 4096)->Complexity();
+
+/**
+ * Benchmark: Modus Ponens chain under the FULL_SWEEP reference strategy
+ */
+static void BM_ModusPonens_Chain_FullSweep(benchmark::State& state) {
+    runModusPonensChain(state, DeductionStrategy::FULL_SWEEP);
+}
+BENCHMARK(BM_ModusPonens_Chain_FullSweep)->Range(2, 64)->Complexity();
+
+/**
+ * Benchmark: Modus Ponens chain under the TOPOLOGICAL strategy (one pass in
+ * dependency order, whatever order the map visits the links in)
+ */
+static void BM_ModusPonens_Chain_Topological(benchmark::State& state) {
+    runModusPonensChain(state, DeductionStrategy::TOPOLOGICAL);
+}
+BENCHMARK(BM_ModusPonens_Chain_Topological)->Range(2, 4096)->Complexity();
 
 // ============================================================
 // MODUS TOLLENS BENCHMARKS
@@ -234,6 +366,98 @@ static void BM_DisjunctiveSyllogism(benchmark::State& state) {
 }
 BENCHMARK(BM_DisjunctiveSyllogism);
 
+// ============================================================
+// RESOLUTION BENCHMARKS
+// ============================================================
+
+/**
+ * Benchmark: Resolution over N independent clause pairs
+ * Setup: Pi OR Qi, ~Pi OR Ri, Qi=FALSE for each i
+ * Measure: Rule pairing cost; only clauses sharing a pivot are examined
+ */
+static void runResolutionPairs(benchmark::State& state, DeductionStrategy strategy) {
+    const int numPairs = state.range(0);
+    
+    InferenceEngine::Options options;
+    options.strategy = strategy;
+    
+    for (auto _ : state) {
+        std::unordered_map<std::string, Proposition> props;
+        std::vector<Expression> exprs;
+        
+        for (int i = 0; i < numPairs; ++i) {
+            std::string id = std::to_string(i);
+            props["disjPQ" + id] = makeDisjunction("disjPQ" + id, "P" + id, "Q" + id);
+            props["disjnPR" + id] = makeDisjunction("disjnPR" + id, "~P" + id, "R" + id);
+            props["Q" + id] = makeProp("Q" + id, Tripartite::FALSE);
+        }
+        
+        InferenceEngine engine(options);
+        engine.deduceAll(props, exprs);
+        
+        benchmark::DoNotOptimize(props.size());
+    }
+    
+    state.SetComplexityN(numPairs);
+}
+
+static void BM_Resolution_Pairs(benchmark::State& state) {
+    runResolutionPairs(state, DeductionStrategy::WORKLIST);
+}
+BENCHMARK(BM_Resolution_Pairs)->Range(2, 4096)->Complexity();
+
+/**
+ * Benchmark: Resolution pairing under the FULL_SWEEP reference strategy
+ */
+static void BM_Resolution_Pairs_FullSweep(benchmark::State& state) {
+    runResolutionPairs(state, DeductionStrategy::FULL_SWEEP);
+}
+BENCHMARK(BM_Resolution_Pairs_FullSweep)->Range(2, 4096)->Complexity();
+
+// ============================================================
+// N-ARY CLAUSE BENCHMARKS
+// ============================================================
+
+/**
+ * Benchmark: 64 clauses of width N, all but the last literal FALSE
+ * Setup: clause_k = or(Lk_0, ..., Lk_N-1), Lk_i=FALSE for i < N-1
+ * Measure: Watched-literal propagation; each literal is stored once, not as
+ * a chain of binary disjunctions
+ */
+static void BM_Clauses_Wide(benchmark::State& state) {
+    const int width = state.range(0);
+    constexpr int kClauses = 64;
+    
+    for (auto _ : state) {
+        std::unordered_map<std::string, Proposition> props;
+        std::vector<Expression> exprs;
+        
+        for (int k = 0; k < kClauses; ++k) {
+            std::string id = "L" + std::to_string(k) + "_";
+            std::vector<std::string> literals;
+            for (int i = 0; i < width; ++i) {
+                literals.push_back(id + std::to_string(i));
+                if (i + 1 < width) {
+                    props[literals.back()] = makeProp(literals.back(), Tripartite::FALSE);
+                }
+            }
+            Proposition clause;
+            clause.setPrefix("clause" + std::to_string(k));
+            clause.setRelation(LogicalOperator::OR);
+            clause.setOperands(std::move(literals));
+            props[clause.getPrefix()] = clause;
+        }
+        
+        InferenceEngine engine;
+        engine.deduceAll(props, exprs);
+        
+        benchmark::DoNotOptimize(props.size());
+    }
+    
+    state.SetComplexityN(width);
+}
+BENCHMARK(BM_Clauses_Wide)->Range(2, 1024)->Complexity();
+
 // ============================================================
 // EXPRESSION EVALUATION BENCHMARKS
 // ============================================================
@@ -315,6 +539,146 @@ static void BM_Expression_NOperands(benchmark::State& state) {
 }
 BENCHMARK(BM_Expression_NOperands)->Range(2, 128)->Complexity();
 
+/**
+ * Benchmark: Re-evaluating a compiled, bound expression against live storage
+ * Measure: A && B && C && ... (N operands), one operand flipped per iteration
+ */
+static void BM_Expression_Bound_NOperands(benchmark::State& state) {
+    const int numOperands = state.range(0);
+    
+    SymbolTable symbols;
+    std::vector<Proposition> props;
+    for (int i = 0; i < numOperands; ++i) {
+        props.push_back(makeProp("P" + std::to_string(i), Tripartite::TRUE));
+    }
+    
+    Expression expr;
+    for (int i = 0; i < numOperands; ++i) {
+        if (i > 0) {
+            expr.addToken(LogicalOperator::AND);
+        }
+        expr.addToken(props[i]);
+    }
+    expr.bind(symbols);
+    
+    std::vector<Proposition*> byId(symbols.idCount(), nullptr);
+    for (int i = 0; i < numOperands; ++i) {
+        PropId id;
+        symbols.find(props[i].getPrefix(), id);
+        byId[id] = &props[i];
+    }
+    
+    int flip = 0;
+    for (auto _ : state) {
+        Proposition& target = props[flip];
+        target.setTruthValue(target.getTruthValue() == Tripartite::TRUE ? Tripartite::FALSE
+                                                                         : Tripartite::TRUE);
+        flip = (flip + 1) % numOperands;
+        benchmark::DoNotOptimize(expr.evaluate(byId));
+    }
+    
+    state.SetComplexityN(numOperands);
+}
+BENCHMARK(BM_Expression_Bound_NOperands)->Range(2, 128)->Complexity();
+
+/**
+ * Build ((W0 AND NOT W1) OR W2) IMPLIES W3, bound to symbols
+ */
+static Expression makeWorldFormula(SymbolTable& symbols) {
+    Expression expr;
+    expr.openParen();
+    expr.addToken("W0", Tripartite::UNKNOWN);
+    expr.addToken(LogicalOperator::AND);
+    expr.addToken(LogicalOperator::NOT);
+    expr.addToken("W1", Tripartite::UNKNOWN);
+    expr.closeParen();
+    expr.addToken(LogicalOperator::OR);
+    expr.addToken("W2", Tripartite::UNKNOWN);
+    expr.addToken(LogicalOperator::IMPLIES);
+    expr.addToken("W3", Tripartite::UNKNOWN);
+    expr.bind(symbols);
+    return expr;
+}
+
+/**
+ * Deterministic value of variable v in world w
+ */
+static Tripartite worldValue(size_t world, size_t variable) {
+    static const Tripartite kValues[] = {Tripartite::TRUE, Tripartite::FALSE, Tripartite::UNKNOWN};
+    return kValues[(world * 7 + variable * 13 + (world >> 3)) % 3];
+}
+
+/**
+ * Benchmark: One formula over N worlds on bit planes (worlds/s)
+ */
+static void BM_Expression_Batch(benchmark::State& state) {
+    const size_t worlds = static_cast<size_t>(state.range(0));
+    
+    SymbolTable symbols;
+    Expression expr = makeWorldFormula(symbols);
+    std::vector<TripartiteBatch> columns(4, TripartiteBatch(worlds));
+    std::vector<const TripartiteBatch*> byId(symbols.idCount(), nullptr);
+    for (size_t v = 0; v < columns.size(); ++v) {
+        for (size_t w = 0; w < worlds; ++w) {
+            columns[v].set(w, worldValue(w, v));
+        }
+        PropId id;
+        symbols.find("W" + std::to_string(v), id);
+        byId[id] = &columns[v];
+    }
+    
+    TripartiteBatch result(worlds);
+    for (auto _ : state) {
+        expr.evaluateBatch(byId, result);
+        benchmark::DoNotOptimize(result.value());
+        benchmark::ClobberMemory();
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(worlds));
+    state.SetLabel(TripartiteBatch::kernelName());
+}
+BENCHMARK(BM_Expression_Batch)->Arg(64)->Arg(256)->Arg(512)->Arg(4096)->Arg(65536);
+
+/**
+ * Benchmark: The same formula evaluated world by world (baseline for BM_Expression_Batch)
+ */
+static void BM_Expression_Scalar_Worlds(benchmark::State& state) {
+    const size_t worlds = static_cast<size_t>(state.range(0));
+    
+    SymbolTable symbols;
+    Expression expr = makeWorldFormula(symbols);
+    std::vector<Proposition> props;
+    for (size_t v = 0; v < 4; ++v) {
+        props.push_back(makeProp("W" + std::to_string(v), Tripartite::UNKNOWN));
+    }
+    std::vector<Proposition*> byId(symbols.idCount(), nullptr);
+    for (Proposition& prop : props) {
+        PropId id;
+        symbols.find(prop.getPrefix(), id);
+        byId[id] = &prop;
+    }
+    std::vector<Tripartite> values(worlds * props.size());
+    for (size_t w = 0; w < worlds; ++w) {
+        for (size_t v = 0; v < props.size(); ++v) {
+            values[w * props.size() + v] = worldValue(w, v);
+        }
+    }
+    
+    std::vector<Tripartite> result(worlds);
+    for (auto _ : state) {
+        for (size_t w = 0; w < worlds; ++w) {
+            for (size_t v = 0; v < props.size(); ++v) {
+                props[v].setTruthValue(values[w * props.size() + v]);
+            }
+            result[w] = expr.evaluate(byId);
+        }
+        benchmark::DoNotOptimize(result.data());
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(worlds));
+}
+BENCHMARK(BM_Expression_Scalar_Worlds)->Arg(64)->Arg(4096)->Arg(65536);
+
 // ============================================================
 // LEXER BENCHMARKS
 // ============================================================
@@ -371,6 +735,195 @@ static void BM_Lexer_Size(benchmark::State& state) {
 }
 BENCHMARK(BM_Lexer_Size)->Range(2, 256)->Complexity();
 
+/**
+ * Benchmark: Lexer over long names, tokenizing into one reused vector
+ * Setup: "long-proposition-name-i && ..." with N terms, padded with spaces
+ * Measure: Block-wise skipping of identifier and whitespace runs, without
+ * per-call token allocation
+ */
+static void BM_Lexer_LongNames_Reused(benchmark::State& state) {
+    Lexer lexer;
+    const int numTerms = state.range(0);
+    
+    std::ostringstream oss;
+    for (int i = 0; i < numTerms; ++i) {
+        if (i > 0) oss << "        &&        ";
+        oss << "long-proposition-name-" << i;
+    }
+    std::string input = oss.str();
+    std::vector<LexerToken> tokens;
+    
+    for (auto _ : state) {
+        lexer.tokenize(input, tokens);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+    state.SetComplexityN(numTerms);
+}
+BENCHMARK(BM_Lexer_LongNames_Reused)->Range(2, 256)->Complexity();
+
+// ============================================================
+// FILE LOADING BENCHMARKS
+// ============================================================
+
+/**
+ * Write a rule dump of the given number of lines: assumptions are implies()
+ * rules over hyphenated names, facts mix assertions and assignments.
+ */
+static std::string writeParseFile(bool facts, int lines) {
+    std::string path = std::string("bench_parse_") + (facts ? "facts_" : "assumptions_") +
+                       std::to_string(lines) + ".txt";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    for (int i = 0; i < lines; ++i) {
+        std::string id = std::to_string(i);
+        if (!facts) {
+            out << "r" << id << ", implies(cosmic-event-" << id << ", observed, background-signal-"
+                << id << ", present)\n";
+        } else if (i % 4 == 3) {
+            out << "derived-" << id << " = cosmic-event-" << id << " && !background-signal-" << id << "\n";
+        } else {
+            out << (i % 2 ? "!" : "") << "cosmic-event-" << id << "\n";
+        }
+    }
+    return path;
+}
+
+/**
+ * Benchmark: Parse an assumptions or facts file from disk
+ * Args: 0 = assumptions, 1 = facts; number of lines; parser threads (chunks of 64 KB
+ * when more than one). Reports MB/s (bytes_per_second).
+ */
+static void BM_Parse_File(benchmark::State& state) {
+    const bool facts = state.range(0) == 1;
+    const int lines = static_cast<int>(state.range(1));
+    const std::string assumptionsPath = writeParseFile(false, lines);
+    const std::string factsPath = facts ? writeParseFile(true, lines) : std::string();
+    const std::string& path = facts ? factsPath : assumptionsPath;
+
+    Parser::Options options;
+    options.threads = static_cast<size_t>(state.range(2));
+    options.chunkBytes = size_t(1) << 16;
+    Parser parser(options);
+    std::unordered_map<std::string, Proposition> base = parser.parseAssumptionsFile(assumptionsPath);
+
+    for (auto _ : state) {
+        if (facts) {
+            state.PauseTiming();
+            std::unordered_map<std::string, Proposition> props = base;
+            std::vector<Expression> exprs;
+            state.ResumeTiming();
+            parser.parseFactsFile(path, props, exprs);
+            benchmark::DoNotOptimize(exprs.size());
+            state.PauseTiming();
+            props.clear();
+            state.ResumeTiming();
+        } else {
+            std::unordered_map<std::string, Proposition> props = parser.parseAssumptionsFile(path);
+            benchmark::DoNotOptimize(props.size());
+        }
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(file.tellg()));
+    state.SetLabel(std::string(facts ? "facts" : "assumptions") + "/threads:" +
+                   std::to_string(options.threads));
+    file.close();
+    std::remove(assumptionsPath.c_str());
+    if (facts) {
+        std::remove(factsPath.c_str());
+    }
+}
+BENCHMARK(BM_Parse_File)
+    ->ArgsProduct({{0, 1}, {1 << 12, 1 << 16}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark: Warm start of a deduced knowledge base
+ * Args: 0 = load the text files and deduce, 1 = load a snapshot; number of lines
+ * in each file. Reports propositions restored per second (items_per_second).
+ */
+static void BM_WarmStart(benchmark::State& state) {
+    const bool snapshot = state.range(0) == 1;
+    const int lines = static_cast<int>(state.range(1));
+    const std::string assumptionsPath = writeParseFile(false, lines);
+    const std::string factsPath = writeParseFile(true, lines);
+    const std::string snapshotPath = "bench_warm_start_" + std::to_string(lines) + ".snap";
+
+    size_t propositions = 0;
+    {
+        Ratiocinator source;
+        source.loadAssumptions(assumptionsPath);
+        source.loadFacts(factsPath);
+        source.deduce();
+        source.saveSnapshot(snapshotPath);
+        propositions = source.getPropositionCount();
+    }
+
+    for (auto _ : state) {
+        Ratiocinator rationator;
+        if (snapshot) {
+            rationator.loadSnapshot(snapshotPath);
+        } else {
+            rationator.loadAssumptions(assumptionsPath);
+            rationator.loadFacts(factsPath);
+            rationator.deduce();
+        }
+        benchmark::DoNotOptimize(rationator.getPropositionCount());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(propositions));
+    state.SetLabel(snapshot ? "snapshot" : "text+deduce");
+    std::remove(assumptionsPath.c_str());
+    std::remove(factsPath.c_str());
+    std::remove(snapshotPath.c_str());
+}
+BENCHMARK(BM_WarmStart)
+    ->ArgsProduct({{0, 1}, {1 << 12, 1 << 16}})
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark: Stream facts into a deduced knowledge base
+ * Args: batch size. Each line toggles one antecedent of 4096 independent rules,
+ * so every batch runs one incremental deduction. Reports lines per second.
+ */
+static void BM_Ingest_Batch(benchmark::State& state) {
+    constexpr int kRules = 4096;
+    const std::string assumptionsPath = writeParseFile(false, kRules);
+    std::vector<std::string> lines;
+    for (int i = 0; i < kRules; ++i) {
+        lines.push_back((i % 3 ? "" : "!") + std::string("cosmic-event-") + std::to_string(i));
+    }
+
+    Ratiocinator rationator;
+    rationator.loadAssumptions(assumptionsPath);
+    rationator.deduce();
+    IngestOptions options;
+    options.batchSize = static_cast<size_t>(state.range(0));
+    rationator.setIngestOptions(options);
+    size_t changes = 0;
+    rationator.setChangeCallback([&](const std::vector<PropositionChange>& batch) {
+        changes += batch.size();
+    });
+
+    bool negate = false;
+    for (auto _ : state) {
+        for (const std::string& line : lines) {
+            rationator.ingest(negate ? "!" + line : line);
+        }
+        rationator.flush();
+        negate = !negate;
+    }
+    benchmark::DoNotOptimize(changes);
+
+    state.SetItemsProcessed(state.iterations() * kRules);
+    std::remove(assumptionsPath.c_str());
+}
+BENCHMARK(BM_Ingest_Batch)
+    ->Arg(1)->Arg(64)->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
 // ============================================================
 // FULL DEDUCTION CYCLE BENCHMARKS
 // ============================================================
@@ -379,9 +932,12 @@ BENCHMARK(BM_Lexer_Size)->Range(2, 256)->Complexity();
  * Benchmark: Full deduction with N propositions
  * Measure: Time for complete deduction cycle
  */
-static void BM_DeduceAll_Size(benchmark::State& state) {
+static void runDeduceAllSize(benchmark::State& state, DeductionStrategy strategy) {
     const int numProps = state.range(0);
     
+    InferenceEngine::Options options;
+    options.strategy = strategy;
+    
     for (auto _ : state) {
         std::unordered_map<std::string, Proposition> props;
         std::vector<Expression> exprs;
@@ -401,7 +957,7 @@ static void BM_DeduceAll_Size(benchmark::State& state) {
             props[currQ] = makeImplication("imp_" + currQ, prevQ, currQ);
         }
         
-        InferenceEngine engine;
+        InferenceEngine engine(options);
         engine.deduceAll(props, exprs);
         
         benchmark::DoNotOptimize(props.size());
@@ -409,53 +965,614 @@ static void BM_DeduceAll_Size(benchmark::State& state) {
     
     state.SetComplexityN(numProps);
 }
-BENCHMARK(BM_DeduceAll_Size)->Range(4, 256)->Complexity();
+
+static void BM_DeduceAll_Size(benchmark::State& state) {
+    runDeduceAllSize(state, DeductionStrategy::WORKLIST);
+}
+BENCHMARK(BM_DeduceAll_Size)->Range(4, 16384)->Complexity();
 
 /**
- * Benchmark: Ratiocinator full workflow
- * Measure: Load + deduce + format results
+ * Decide one goal of the BM_DeduceAll_Size knowledge base, either by backward
+ * chaining or with a full deduction. The index is maintained across iterations,
+ * as a Ratiocinator maintains it; only the answers are reset.
+ * Args: knowledge base size, goal (0 = end of the P chain, 1 = its first link)
  */
-static void BM_Ratiocinator_Workflow(benchmark::State& state) {
+static void runGoalSize(benchmark::State& state, bool query) {
     const int numProps = state.range(0);
+    const bool shallow = state.range(1) == 1;
+    const std::string goal = shallow ? "P1" : "P" + std::to_string(numProps / 2 - 1);
     
-    for (auto _ : state) {
-        Ratiocinator engine;
+    std::unordered_map<std::string, Proposition> base;
+    base["P0"] = makeProp("P0", Tripartite::TRUE);
+    base["Q0"] = makeProp("Q0", Tripartite::FALSE);
+    for (int i = 1; i < numProps / 2; ++i) {
+        std::string prevP = "P" + std::to_string(i - 1);
+        std::string currP = "P" + std::to_string(i);
+        base[currP] = makeImplication("imp_" + currP, prevP, currP);
         
-        // Manually set up propositions (simulating file load)
-        engine.setPropositionTruthValue("P0", Tripartite::TRUE);
+        std::string prevQ = "Q" + std::to_string(i - 1);
+        std::string currQ = "Q" + std::to_string(i);
+        base[currQ] = makeImplication("imp_" + currQ, prevQ, currQ);
+    }
+    LiteralIndex index;
+    index.rebuild(base);
+    
+    InferenceEngine engine;
+    std::vector<Expression> exprs;
+    size_t rulesInScope = 0;
+    std::unordered_map<std::string, Proposition> props;
+    for (auto _ : state) {
+        state.PauseTiming();
+        props = base;  // Also frees the last iteration's copy untimed
+        state.ResumeTiming();
         
-        for (int i = 1; i < numProps; ++i) {
-            std::string prev = "P" + std::to_string(i - 1);
-            std::string curr = "P" + std::to_string(i);
-            Proposition imp = makeImplication("imp_" + curr, prev, curr);
-            engine.setProposition(curr, imp);
+        Tripartite value;
+        if (query) {
+            value = engine.query(props, exprs, index, goal, nullptr, &rulesInScope);
+        } else {
+            engine.deduceAll(props, exprs, index);
+            value = props[goal].getTruthValue();
         }
-        
-        engine.deduce();
-        
-        std::string results = engine.formatResults();
-        benchmark::DoNotOptimize(results);
+        benchmark::DoNotOptimize(value);
     }
     
+    if (query) {
+        state.counters["rules_in_scope"] = static_cast<double>(rulesInScope);
+    }
     state.SetComplexityN(numProps);
 }
-BENCHMARK(BM_Ratiocinator_Workflow)->Range(4, 128)->Complexity();
 
 /**
- * Benchmark: Inference tracing overhead
- * Measure: Time to trace inference chain
+ * Benchmark: Backward chaining query for one goal
  */
-static void BM_TraceInference(benchmark::State& state) {
-    const int chainLength = state.range(0);
-    
-    // Set up once outside the benchmark loop
-    Ratiocinator engine;
-    engine.setPropositionTruthValue("P0", Tripartite::TRUE);
-    
+static void BM_Query_Size(benchmark::State& state) {
+    runGoalSize(state, true);
+}
+BENCHMARK(BM_Query_Size)->ArgsProduct({{64, 1024, 16384}, {0, 1}});
+
+/**
+ * Benchmark: The same goal answered by a full deduction (baseline)
+ */
+static void BM_Query_Size_DeduceAll(benchmark::State& state) {
+    runGoalSize(state, false);
+}
+BENCHMARK(BM_Query_Size_DeduceAll)->ArgsProduct({{64, 1024, 16384}, {0, 1}});
+
+/**
+ * Benchmark: Full deduction under the FULL_SWEEP reference strategy
+ */
+static void BM_DeduceAll_Size_FullSweep(benchmark::State& state) {
+    runDeduceAllSize(state, DeductionStrategy::FULL_SWEEP);
+}
+BENCHMARK(BM_DeduceAll_Size_FullSweep)->Range(4, 256)->Complexity();
+
+/**
+ * Benchmark: Deduction at each provenance level (0 = FULL, 1 = COMPACT, 2 = NONE)
+ * Args: level, chain length. Every link derives one value, so items are inferences.
+ */
+static void BM_DeduceAll_Provenance(benchmark::State& state) {
+    static const ProvenanceLevel kLevels[] = {ProvenanceLevel::FULL, ProvenanceLevel::COMPACT,
+                                              ProvenanceLevel::NONE};
+    static const char* const kLevelNames[] = {"full", "compact", "none"};
+    const ProvenanceLevel level = kLevels[state.range(0)];
+    const int chainLength = static_cast<int>(state.range(1));
+
+    std::unordered_map<std::string, Proposition> base;
+    base["P0"] = makeProp("P0", Tripartite::TRUE);
     for (int i = 1; i <= chainLength; ++i) {
         std::string prev = "P" + std::to_string(i - 1);
         std::string curr = "P" + std::to_string(i);
-        Proposition imp = makeImplication("imp_" + curr, prev, curr);
+        base[curr] = makeImplication("imp_" + curr, prev, curr);
+    }
+    std::vector<Expression> exprs;
+
+    InferenceEngine::Options options;
+    options.provenance = level;
+    InferenceEngine engine(options);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unordered_map<std::string, Proposition> props = base;
+        state.ResumeTiming();
+
+        engine.deduceAll(props, exprs);
+        benchmark::DoNotOptimize(props.size());
+
+        state.PauseTiming();
+        props.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * chainLength);
+    state.SetLabel(kLevelNames[state.range(0)]);
+}
+BENCHMARK(BM_DeduceAll_Provenance)
+    ->ArgsProduct({{0, 1, 2}, {1024, 16384}})
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark: Deduction with statistics collection off (0) and on (1)
+ * Args: collect, chain length. Measures the cost of InferenceEngine::Options::collectStats.
+ */
+static void BM_DeduceAll_Stats(benchmark::State& state) {
+    const bool collect = state.range(0) != 0;
+    const int chainLength = static_cast<int>(state.range(1));
+
+    std::unordered_map<std::string, Proposition> base;
+    base["P0"] = makeProp("P0", Tripartite::TRUE);
+    for (int i = 1; i <= chainLength; ++i) {
+        std::string prev = "P" + std::to_string(i - 1);
+        std::string curr = "P" + std::to_string(i);
+        base[curr] = makeImplication("imp_" + curr, prev, curr);
+    }
+    std::vector<Expression> exprs;
+
+    InferenceEngine::Options options;
+    options.collectStats = collect;
+    InferenceEngine engine(options);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unordered_map<std::string, Proposition> props = base;
+        state.ResumeTiming();
+
+        engine.deduceAll(props, exprs);
+        benchmark::DoNotOptimize(props.size());
+
+        state.PauseTiming();
+        props.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * chainLength);
+    state.SetLabel(collect ? "on" : "off");
+}
+BENCHMARK(BM_DeduceAll_Stats)
+    ->ArgsProduct({{0, 1}, {1024, 16384}})
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark: Expressions repeating one wide conjunction, evaluated separately
+ * (0) and over the shared expression DAG (1). Expression j is
+ * Q0 && ... && Q31 && R_j. Args: share, expressions, strategy (0 = WORKLIST,
+ * 1 = FULL_SWEEP).
+ * Counters: instructions (total over all programs) and dag_nodes.
+ */
+static void BM_DeduceAll_SharedExpressions(benchmark::State& state) {
+    const bool share = state.range(0) != 0;
+    const int count = static_cast<int>(state.range(1));
+    const int width = 32;
+
+    std::unordered_map<std::string, Proposition> base;
+    base["Q0"] = makeProp("Q0", Tripartite::TRUE);
+    for (int i = 1; i < width; ++i) {
+        std::string prev = "Q" + std::to_string(i - 1);
+        std::string curr = "Q" + std::to_string(i);
+        base[curr] = makeImplication("imp_" + curr, prev, curr);
+    }
+    std::vector<Expression> exprs(count);
+    for (int j = 0; j < count; ++j) {
+        std::string r = "R" + std::to_string(j);
+        std::string subject = "S" + std::to_string(j);
+        base[r] = makeProp(r, Tripartite::TRUE);
+        Proposition target(subject, Tripartite::UNKNOWN);
+        target.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+        base[subject] = target;
+        for (int i = 0; i < width; ++i) {
+            exprs[j].addToken(makeProp("Q" + std::to_string(i), Tripartite::UNKNOWN));
+            exprs[j].addToken(LogicalOperator::AND);
+        }
+        exprs[j].addToken(base[r]);
+        exprs[j].setPrefix(subject);
+    }
+
+    InferenceEngine::Options options;
+    options.shareExpressions = share;
+    options.strategy = state.range(2) ? DeductionStrategy::FULL_SWEEP : DeductionStrategy::WORKLIST;
+    InferenceEngine engine(options);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unordered_map<std::string, Proposition> props = base;
+        state.ResumeTiming();
+
+        engine.deduceAll(props, exprs);
+        benchmark::DoNotOptimize(props.size());
+
+        state.PauseTiming();
+        props.clear();
+        state.ResumeTiming();
+    }
+
+    SymbolTable symbols;
+    ExpressionDag dag;
+    size_t instructions = 0;
+    for (Expression& expr : exprs) {
+        expr.bind(symbols);
+        instructions += expr.getInstructionCount();
+        dag.add(expr);
+    }
+    state.counters["instructions"] = static_cast<double>(instructions);
+    state.counters["dag_nodes"] = static_cast<double>(dag.nodeCount());
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(share ? "shared" : "separate");
+}
+BENCHMARK(BM_DeduceAll_SharedExpressions)
+    ->ArgsProduct({{0, 1}, {256, 4096}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark: Contradictory rules under each conflict recording policy
+ * (0 = OFF, 1 = COUNT, 2 = RECENT, 3 = ALL). Each pair X -> Y, X := !Y,
+ * Y := !X flips Y until the oscillation limit stops the run.
+ * Args: policy, pairs
+ */
+static void BM_DeduceAll_Conflicts(benchmark::State& state) {
+    static const ConflictRecording kPolicies[] = {ConflictRecording::OFF, ConflictRecording::COUNT,
+                                                  ConflictRecording::RECENT, ConflictRecording::ALL};
+    static const char* const kPolicyNames[] = {"off", "count", "recent", "all"};
+    const int pairs = static_cast<int>(state.range(1));
+
+    InferenceEngine::Options options;
+    options.conflicts = kPolicies[state.range(0)];
+    options.oscillationLimit = 256;
+
+    size_t iterations = 0;
+    int64_t conflicts = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Ratiocinator engine;
+        engine.setInferenceOptions(options);
+        for (int i = 0; i < pairs; ++i) {
+            std::string n = std::to_string(i);
+            Proposition x("X" + n, Tripartite::TRUE);
+            x.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+            engine.setProposition("X" + n, x);
+            Proposition y("Y" + n, Tripartite::UNKNOWN);
+            y.setPropositionScope(Quantifier::UNIVERSAL_NEGATIVE);
+            engine.setProposition("Y" + n, y);
+            engine.setProposition("imp_" + n, makeImplication("imp_" + n, "X" + n, "Y" + n));
+            engine.addExpressionFromString("!Y" + n, "X" + n);
+            engine.addExpressionFromString("!X" + n, "Y" + n);
+        }
+        std::streambuf* saved = std::cerr.rdbuf(nullptr);
+        state.ResumeTiming();
+
+        engine.deduce();
+
+        state.PauseTiming();
+        std::cerr.rdbuf(saved);
+        iterations = engine.getConvergence().iterations;
+        conflicts += static_cast<int64_t>(engine.getConvergence().conflicts);
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(conflicts);
+    state.counters["iterations"] = static_cast<double>(iterations);
+    state.SetLabel(kPolicyNames[state.range(0)]);
+}
+BENCHMARK(BM_DeduceAll_Conflicts)
+    ->ArgsProduct({{0, 1, 2, 3}, {256, 4096}})
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark: Deduction over independent tenants with 1..8 threads
+ * Args: threads, tenants (each a 64-link chain plus a disjunction)
+ */
+static void BM_DeduceAll_Parallel(benchmark::State& state) {
+    const size_t threads = static_cast<size_t>(state.range(0));
+    const int tenants = static_cast<int>(state.range(1));
+    const int chainLength = 64;
+    
+    std::unordered_map<std::string, Proposition> base;
+    for (int t = 0; t < tenants; ++t) {
+        std::string id = "T" + std::to_string(t) + "_";
+        base[id + "P0"] = makeProp(id + "P0", Tripartite::TRUE);
+        for (int i = 1; i < chainLength; ++i) {
+            std::string prev = id + "P" + std::to_string(i - 1);
+            std::string curr = id + "P" + std::to_string(i);
+            base[curr] = makeImplication("imp_" + curr, prev, curr);
+        }
+        base[id + "Q"] = makeProp(id + "Q", Tripartite::FALSE);
+        base[id + "disj"] = makeDisjunction(id + "disj", id + "Q", id + "R");
+    }
+    
+    InferenceEngine::Options options;
+    options.threads = threads;
+    InferenceEngine engine(options);
+    std::vector<Expression> exprs;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unordered_map<std::string, Proposition> props = base;
+        state.ResumeTiming();
+        
+        engine.deduceAll(props, exprs);
+        benchmark::DoNotOptimize(props.size());
+    }
+    
+    state.SetItemsProcessed(state.iterations() * tenants * chainLength);
+}
+BENCHMARK(BM_DeduceAll_Parallel)
+    ->ArgsProduct({{1, 2, 4, 8}, {64, 1024}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Build independent tenants in a Ratiocinator: T<t>_P0 -> ... -> T<t>_P31
+ */
+static void buildTenants(Ratiocinator& engine, int tenants) {
+    for (int t = 0; t < tenants; ++t) {
+        std::string id = "T" + std::to_string(t) + "_";
+        for (int i = 1; i < 32; ++i) {
+            std::string prev = id + "P" + std::to_string(i - 1);
+            std::string curr = id + "P" + std::to_string(i);
+            engine.setProposition("imp_" + curr, makeImplication("imp_" + curr, prev, curr));
+        }
+        engine.setPropositionTruthValue(id + "P0", Tripartite::TRUE);
+    }
+}
+
+/**
+ * Benchmark: Flip one tenant's root fact and bring the deduction up to date
+ * Measure: Retraction and re-derivation cost vs knowledge base size (tenants * 31 rules)
+ */
+static void runSingleFactUpdate(benchmark::State& state, bool incremental) {
+    const int tenants = state.range(0);
+    
+    Ratiocinator engine;
+    buildTenants(engine, tenants);
+    engine.deduce();
+    
+    int tenant = 0;
+    bool value = false;
+    for (auto _ : state) {
+        std::string root = "T" + std::to_string(tenant) + "_P0";
+        engine.updatePropositionTruthValue(root, value ? Tripartite::TRUE : Tripartite::FALSE,
+                                           InferenceProvenance());
+        if (incremental) {
+            engine.deduceIncremental();
+        } else {
+            engine.deduce();
+        }
+        tenant = (tenant + 1) % tenants;
+        if (tenant == 0) {
+            value = !value;
+        }
+    }
+    
+    state.SetComplexityN(tenants);
+}
+
+static void BM_DeduceIncremental_SingleFact(benchmark::State& state) {
+    runSingleFactUpdate(state, true);
+}
+BENCHMARK(BM_DeduceIncremental_SingleFact)->Range(16, 4096)->Complexity()->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark: The same updates followed by a full deduce() (baseline)
+ */
+static void BM_Deduce_SingleFact_Full(benchmark::State& state) {
+    runSingleFactUpdate(state, false);
+}
+BENCHMARK(BM_Deduce_SingleFact_Full)->Range(16, 4096)->Complexity()->Unit(benchmark::kMicrosecond);
+
+/**
+ * What-if scenarios over 1024 tenants, only the even ones with their root set:
+ * each scenario decides an odd tenant's root, and every eighth instead retracts
+ * an even one (which needs a full deduction)
+ */
+static std::vector<std::string> tenantScenarios(int count, int tenants) {
+    std::vector<std::string> scenarios;
+    for (int i = 0; i < count; ++i) {
+        int tenant = (2 * i) % tenants;
+        scenarios.push_back(i % 8 == 7 ? "!T" + std::to_string(tenant) + "_P0"
+                                       : "T" + std::to_string(tenant + 1) + "_P0");
+    }
+    return scenarios;
+}
+
+static void buildScenarioTenants(Ratiocinator& engine, int tenants) {
+    buildTenants(engine, tenants);
+    for (int t = 1; t < tenants; t += 2) {
+        engine.setPropositionTruthValue("T" + std::to_string(t) + "_P0", Tripartite::UNKNOWN);
+    }
+}
+
+/**
+ * Benchmark: RuleBase::evaluateAll over one compiled base
+ * Arg: threads
+ * Measure: Scenarios per second
+ */
+static void BM_Scenarios_RuleBase(benchmark::State& state) {
+    const int tenants = 1024;
+    Ratiocinator engine;
+    buildScenarioTenants(engine, tenants);
+    std::shared_ptr<const RuleBase> rules = engine.compileRuleBase(static_cast<size_t>(state.range(0)));
+    std::vector<std::string> scenarios = tenantScenarios(256, tenants);
+    
+    for (auto _ : state) {
+        std::vector<ScenarioResult> results = rules->evaluateAll(scenarios);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(scenarios.size()));
+}
+BENCHMARK(BM_Scenarios_RuleBase)->DenseRange(1, 4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark: The same scenarios, each deduced on its own copy of the base (baseline)
+ */
+static void BM_Scenarios_Copy(benchmark::State& state) {
+    const int tenants = 1024;
+    Ratiocinator engine;
+    buildScenarioTenants(engine, tenants);
+    std::vector<std::string> scenarios = tenantScenarios(256, tenants);
+    
+    InferenceEngine inference;
+    Parser parser;
+    for (auto _ : state) {
+        for (const std::string& scenario : scenarios) {
+            std::unordered_map<std::string, Proposition> propositions = engine.getPropositions();
+            std::vector<Expression> expressions;
+            parser.parseFacts(scenario, propositions, expressions);
+            inference.deduceAll(propositions, expressions);
+            benchmark::DoNotOptimize(propositions.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(scenarios.size()));
+}
+BENCHMARK(BM_Scenarios_Copy)->Unit(benchmark::kMillisecond);
+
+/**
+ * Query tenant leaves from reader threads while the benchmark loop (the writer)
+ * flips a root fact and runs a full deduce() per iteration. Readers either
+ * query the latest published snapshot or share a mutex with the writer.
+ * Reports read latency percentiles and total reads per second.
+ */
+static void runConcurrentReads(benchmark::State& state, bool snapshots) {
+    constexpr int kTenants = 256;
+    constexpr size_t kMaxSamples = 1 << 20;
+    const int readerCount = state.range(0);
+    
+    Ratiocinator engine;
+    buildTenants(engine, kTenants);
+    engine.deduce();
+    engine.setSnapshotPublishing(snapshots);
+    std::mutex engineMutex;
+    
+    std::atomic<bool> done{false};
+    std::vector<std::vector<double>> latencies(readerCount);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r]() {
+            std::vector<double>& samples = latencies[r];
+            samples.reserve(kMaxSamples);
+            size_t next = r;
+            while (!done.load(std::memory_order_relaxed)) {
+                std::string name = "T" + std::to_string(next++ % kTenants) + "_P31";
+                auto start = std::chrono::steady_clock::now();
+                Tripartite value;
+                if (snapshots) {
+                    value = engine.snapshot()->getPropositionTruthValue(name);
+                } else {
+                    std::lock_guard<std::mutex> lock(engineMutex);
+                    value = engine.getPropositionTruthValue(name);
+                }
+                auto stop = std::chrono::steady_clock::now();
+                benchmark::DoNotOptimize(value);
+                if (samples.size() < kMaxSamples) {
+                    samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+                }
+            }
+        });
+    }
+    
+    int tenant = 0;
+    bool value = false;
+    for (auto _ : state) {
+        std::string root = "T" + std::to_string(tenant) + "_P0";
+        std::unique_lock<std::mutex> lock(engineMutex, std::defer_lock);
+        if (!snapshots) {
+            lock.lock();
+        }
+        engine.setPropositionTruthValue(root, value ? Tripartite::TRUE : Tripartite::FALSE);
+        engine.deduce();
+        tenant = (tenant + 1) % kTenants;
+        if (tenant == 0) {
+            value = !value;
+        }
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    
+    std::vector<double> all;
+    for (const std::vector<double>& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    if (!all.empty()) {
+        auto percentile = [&](double p) {
+            size_t rank = std::min(all.size() - 1, static_cast<size_t>(p * all.size()));
+            std::nth_element(all.begin(), all.begin() + rank, all.end());
+            return all[rank];
+        };
+        state.counters["read_p50_ns"] = percentile(0.50);
+        state.counters["read_p99_ns"] = percentile(0.99);
+        state.counters["read_max_ns"] = *std::max_element(all.begin(), all.end());
+        state.counters["reads"] = benchmark::Counter(static_cast<double>(all.size()),
+                                                     benchmark::Counter::kIsRate);
+    }
+}
+
+/**
+ * Benchmark: Readers query published snapshots during deductions
+ * Args: reader threads (real time)
+ */
+static void BM_ConcurrentReads_Snapshot(benchmark::State& state) {
+    runConcurrentReads(state, true);
+}
+BENCHMARK(BM_ConcurrentReads_Snapshot)
+    ->Arg(1)->Arg(2)->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark: Readers serialized against deductions with a mutex (baseline)
+ */
+static void BM_ConcurrentReads_Mutex(benchmark::State& state) {
+    runConcurrentReads(state, false);
+}
+BENCHMARK(BM_ConcurrentReads_Mutex)
+    ->Arg(1)->Arg(2)->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark: Ratiocinator full workflow
+ * Measure: Load + deduce + format results
+ */
+static void BM_Ratiocinator_Workflow(benchmark::State& state) {
+    const int numProps = state.range(0);
+    
+    for (auto _ : state) {
+        Ratiocinator engine;
+        
+        // Manually set up propositions (simulating file load)
+        engine.setPropositionTruthValue("P0", Tripartite::TRUE);
+        
+        for (int i = 1; i < numProps; ++i) {
+            std::string prev = "P" + std::to_string(i - 1);
+            std::string curr = "P" + std::to_string(i);
+            Proposition imp = makeImplication("imp_" + curr, prev, curr);
+            engine.setProposition(curr, imp);
+        }
+        
+        engine.deduce();
+        
+        std::string results = engine.formatResults();
+        benchmark::DoNotOptimize(results);
+    }
+    
+    state.SetComplexityN(numProps);
+}
+BENCHMARK(BM_Ratiocinator_Workflow)->Range(4, 128)->Complexity();
+
+/**
+ * Benchmark: Inference tracing overhead
+ * Measure: Time to trace inference chain
+ */
+static void BM_TraceInference(benchmark::State& state) {
+    const int chainLength = state.range(0);
+    
+    // Set up once outside the benchmark loop
+    Ratiocinator engine;
+    engine.setPropositionTruthValue("P0", Tripartite::TRUE);
+    
+    for (int i = 1; i <= chainLength; ++i) {
+        std::string prev = "P" + std::to_string(i - 1);
+        std::string curr = "P" + std::to_string(i);
+        Proposition imp = makeImplication("imp_" + curr, prev, curr);
         engine.setProposition(curr, imp);
     }
     
@@ -472,6 +1589,36 @@ static void BM_TraceInference(benchmark::State& state) {
 }
 BENCHMARK(BM_TraceInference)->Range(2, 64)->Complexity();
 
+/**
+ * Benchmark: Tracing every derived proposition of a chain
+ * Measure: Time to stream all traces; each trace reuses the premises the
+ * previous ones resolved, so the cost is the output rather than re-resolution
+ */
+static void BM_FormatAllTraces(benchmark::State& state) {
+    const int chainLength = state.range(0);
+    
+    Ratiocinator engine;
+    engine.setPropositionTruthValue("P0", Tripartite::TRUE);
+    
+    for (int i = 1; i <= chainLength; ++i) {
+        std::string prev = "P" + std::to_string(i - 1);
+        std::string curr = "P" + std::to_string(i);
+        Proposition imp = makeImplication("imp_" + curr, prev, curr);
+        engine.setProposition(curr, imp);
+    }
+    
+    engine.deduce();
+    
+    for (auto _ : state) {
+        std::ostringstream out;
+        engine.writeAllTraces(out);
+        benchmark::DoNotOptimize(out);
+    }
+    
+    state.SetComplexityN(chainLength);
+}
+BENCHMARK(BM_FormatAllTraces)->Range(8, 512)->Complexity();
+
 /**
  * Benchmark: Result filtering overhead
  */
@@ -500,6 +1647,370 @@ static void BM_ResultFiltering(benchmark::State& state) {
 }
 BENCHMARK(BM_ResultFiltering)->Range(10, 1000)->Complexity();
 
+/**
+ * Build a knowledge base of `tenants` tenants with 16 propositions each (every
+ * other one TRUE), named tenant_<t>_<i>, for the filtered query benchmarks.
+ */
+static void buildTenantFacts(Ratiocinator& engine, int tenants) {
+    for (int t = 0; t < tenants; ++t) {
+        for (int i = 0; i < 16; ++i) {
+            engine.setPropositionTruthValue("tenant_" + std::to_string(t) + "_" + std::to_string(i),
+                                            i % 2 ? Tripartite::TRUE : Tripartite::FALSE);
+        }
+    }
+}
+
+/**
+ * Benchmark: --true-only --prefix=tenant_<t>_ style query through the result index
+ * Measure: Cost should stay flat as the knowledge base grows (the result is 8 names)
+ */
+static void BM_FilteredQuery_Indexed(benchmark::State& state) {
+    const int numProps = state.range(0);
+    Ratiocinator engine;
+    buildTenantFacts(engine, numProps / 16);
+    ResultFilter filter = ResultFilter::trueOnly().withPrefix("tenant_7_");
+    engine.getFilteredPropositionNames(filter);  // Build the index
+    
+    for (auto _ : state) {
+        auto names = engine.getFilteredPropositionNames(filter);
+        benchmark::DoNotOptimize(names);
+    }
+    
+    state.SetComplexityN(numProps);
+}
+BENCHMARK(BM_FilteredQuery_Indexed)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Complexity();
+
+/**
+ * Benchmark: The same query scanning every proposition (a published KnowledgeView)
+ */
+static void BM_FilteredQuery_Scan(benchmark::State& state) {
+    const int numProps = state.range(0);
+    Ratiocinator engine;
+    buildTenantFacts(engine, numProps / 16);
+    engine.publishSnapshot();
+    std::shared_ptr<const KnowledgeView> view = engine.snapshot();
+    ResultFilter filter = ResultFilter::trueOnly().withPrefix("tenant_7_");
+    
+    for (auto _ : state) {
+        auto names = view->getFilteredPropositionNames(filter);
+        benchmark::DoNotOptimize(names);
+    }
+    
+    state.SetComplexityN(numProps);
+}
+BENCHMARK(BM_FilteredQuery_Scan)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Complexity();
+
+/**
+ * Benchmark: Streaming a report to a file
+ * Args: proposition count, format (0 = text, 1 = JSON, 2 = NDJSON), limit (0 = all)
+ * Measure: Bytes per second written through OutputFile, sorted by truth value
+ */
+static void BM_WriteResults(benchmark::State& state) {
+    const int numProps = state.range(0);
+    const ResultFormat format = static_cast<ResultFormat>(state.range(1));
+    
+    Ratiocinator engine;
+    for (int i = 0; i < numProps; ++i) {
+        std::string name = "P" + std::to_string(i);
+        Tripartite value = (i % 3 == 0) ? Tripartite::TRUE : 
+                          (i % 3 == 1) ? Tripartite::FALSE : 
+                                         Tripartite::UNKNOWN;
+        engine.setPropositionTruthValue(name, value);
+    }
+    
+    ResultFilter filter = ResultFilter().withSort(ResultSortOrder::BY_TRUTH_VALUE)
+                                        .withFormat(format)
+                                        .withLimit(static_cast<size_t>(state.range(2)));
+    
+    for (auto _ : state) {
+        OutputFile out;
+        out.open("/dev/null");
+        engine.writeResults(out, filter);
+        out.close();
+    }
+    
+    int64_t reportBytes = static_cast<int64_t>(engine.formatResults(filter).size());
+    state.SetBytesProcessed(reportBytes * state.iterations());
+}
+BENCHMARK(BM_WriteResults)
+    ->ArgsProduct({{1 << 12, 1 << 18}, {0, 1, 2}, {0, 100}})
+    ->Unit(benchmark::kMillisecond);
+
+// ============================================================
+// MEMORY BENCHMARKS
+// ============================================================
+
+/**
+ * Benchmark: Heap bytes per proposition in a deduced knowledge base.
+ * Three facts per implication rule, half the rules firing, so the
+ * base mixes plain facts, rules, and derived propositions with provenance.
+ */
+static void BM_Proposition_Memory(benchmark::State& state) {
+    const int numRules = state.range(0);
+    long long bytes = 0;
+    size_t propositions = 0;
+
+    for (auto _ : state) {
+        long long before = liveHeapBytes.load();
+        {
+            Ratiocinator engine;
+            for (int i = 0; i < numRules; ++i) {
+                std::string id = std::to_string(i);
+                engine.setPropositionTruthValue("A" + id, (i % 2 == 0) ? Tripartite::TRUE : Tripartite::UNKNOWN);
+                engine.setPropositionTruthValue("F" + id, Tripartite::FALSE);
+                engine.setPropositionTruthValue("G" + id, Tripartite::TRUE);
+                engine.addProposition("R" + id,
+                                      makeProp("R" + id, Tripartite::TRUE, LogicalOperator::IMPLIES, "A" + id, "B" + id));
+            }
+            engine.deduce();
+            bytes = liveHeapBytes.load() - before;
+            propositions = engine.getPropositionCount();
+            benchmark::DoNotOptimize(propositions);
+        }
+    }
+
+    state.counters["bytes_per_prop"] = static_cast<double>(bytes) / static_cast<double>(propositions);
+    state.counters["sizeof_prop"] = static_cast<double>(sizeof(Proposition));
+    state.counters["props"] = static_cast<double>(propositions);
+}
+BENCHMARK(BM_Proposition_Memory)->Arg(1024)->Arg(16384)->Unit(benchmark::kMillisecond);
+
+// ============================================================
+// LARGE-SCALE AND ADVERSARIAL WORKLOADS
+// ============================================================
+
+/**
+ * Shapes of generated knowledge base, each stressing a different part of deduction.
+ */
+enum class WorkloadShape {
+    FAN_OUT,             ///< One fact implies every other proposition
+    DEEP_CHAIN,          ///< P0 -> P1 -> ... -> Pn, one link firing per step
+    DENSE_DISJUNCTIONS,  ///< Every clause shares one pivot, so every pair is a resolution candidate
+    QUANTIFIERS,         ///< Chained expressions assigning subjects of all four quantifiers
+};
+
+/**
+ * A generated knowledge base in the assumptions and facts file formats.
+ * Disjunctions use either(left, right) and either_not(left, right) (~left || right),
+ * and subjects scope(name, all|none|some|some-not); workloadParser() reads them.
+ */
+struct Workload {
+    std::string assumptions;
+    std::string facts;
+};
+
+/**
+ * Generate a workload of the given shape with about `size` rules.
+ */
+static Workload makeWorkload(WorkloadShape shape, int size) {
+    std::ostringstream assumptions;
+    std::ostringstream facts;
+    switch (shape) {
+        case WorkloadShape::FAN_OUT:
+            for (int i = 0; i < size; ++i) {
+                std::string id = std::to_string(i);
+                assumptions << "f" << id << ", implies(root, holds, leaf-" << id << ", holds)\n";
+            }
+            facts << "root\n";
+            break;
+        case WorkloadShape::DEEP_CHAIN:
+            for (int i = 1; i <= size; ++i) {
+                assumptions << "c" << i << ", implies(link-" << (i - 1) << ", holds, link-" << i
+                            << ", holds)\n";
+            }
+            facts << "link-0\n";
+            break;
+        case WorkloadShape::DENSE_DISJUNCTIONS:
+            // pivot || Q_i and ~pivot || R_i; Q_0 FALSE settles the pivot
+            for (int i = 0; i < size / 2; ++i) {
+                std::string id = std::to_string(i);
+                assumptions << "dq" << id << ", either(pivot, q-" << id << ")\n";
+                assumptions << "dr" << id << ", either_not(pivot, r-" << id << ")\n";
+            }
+            facts << "!q-0\n";
+            break;
+        case WorkloadShape::QUANTIFIERS: {
+            static const char* const kScopes[] = {"all", "none", "some", "some-not"};
+            for (int i = 0; i < size; ++i) {
+                std::string id = std::to_string(i);
+                assumptions << "s" << id << ", scope(subject-" << id << ", " << kScopes[i % 4] << ")\n";
+            }
+            // Affirmative (even) subjects are fact || subject two back, negative (odd)
+            // ones fact && subject two back. Only every fourth pair of facts is known,
+            // so values travel down both chains through the subjects. Assignments are
+            // written last to first, before the facts, so the parser settles none of them.
+            for (int i = size - 1; i >= 0; --i) {
+                std::string id = std::to_string(i);
+                facts << "subject-" << id << " = a-" << id;
+                if (i >= 2) {
+                    facts << (i % 2 ? " && subject-" : " || subject-") << (i - 2);
+                }
+                facts << "\n";
+            }
+            for (int i = 0; i < size; ++i) {
+                if (i % 8 < 2) {
+                    facts << (i % 2 ? "!" : "") << "a-" << i << "\n";
+                }
+            }
+            break;
+        }
+    }
+    return Workload{assumptions.str(), facts.str()};
+}
+
+/**
+ * A parser that also reads the generator's either(), either_not() and scope() relations.
+ */
+static Parser workloadParser() {
+    Parser parser;
+    parser.registerRelation("either", [](const std::string& prefix, const std::vector<std::string>& args,
+                                         std::unordered_map<std::string, Proposition>& propositions) {
+        if (args.size() != 2) return false;
+        propositions[prefix] = makeDisjunction(prefix, args[0], args[1]);
+        return true;
+    });
+    parser.registerRelation("either_not", [](const std::string& prefix, const std::vector<std::string>& args,
+                                             std::unordered_map<std::string, Proposition>& propositions) {
+        if (args.size() != 2) return false;
+        propositions[prefix] = makeDisjunction(prefix, "~" + args[0], args[1]);
+        return true;
+    });
+    parser.registerRelation("scope", [](const std::string& prefix, const std::vector<std::string>& args,
+                                        std::unordered_map<std::string, Proposition>& propositions) {
+        static const std::pair<const char*, Quantifier> kScopes[] = {
+            {"all", Quantifier::UNIVERSAL_AFFIRMATIVE}, {"none", Quantifier::UNIVERSAL_NEGATIVE},
+            {"some", Quantifier::PARTICULAR_AFFIRMATIVE}, {"some-not", Quantifier::PARTICULAR_NEGATIVE}};
+        if (args.size() != 2) return false;
+        for (const auto& [name, scope] : kScopes) {
+            if (args[1] == name) {
+                Proposition subject;
+                subject.setPrefix(prefix);
+                subject.setSubject(args[0]);
+                subject.setPropositionScope(scope);
+                propositions[args[0]] = subject;
+                return true;
+            }
+        }
+        return false;
+    });
+    return parser;
+}
+
+/**
+ * Benchmark: Deduction over a generated workload held in memory
+ * Args: shape (see WorkloadShape), rules. Reports values changed (or propositions
+ * created) per second and the heap high-water mark of deduction alone.
+ */
+static void BM_Workload_Deduce(benchmark::State& state) {
+    static const char* const kShapeNames[] = {"fan-out", "deep-chain", "dense-disjunctions", "quantifiers"};
+    const WorkloadShape shape = static_cast<WorkloadShape>(state.range(0));
+    const Workload workload = makeWorkload(shape, static_cast<int>(state.range(1)));
+
+    Parser parser = workloadParser();
+    std::unordered_map<std::string, Proposition> base;
+    std::vector<Expression> exprs;
+    parser.parseAssumptions(workload.assumptions, base);
+    parser.parseFacts(workload.facts, base, exprs);
+
+    InferenceEngine engine;
+    long long peak = 0;
+    int64_t inferences = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unordered_map<std::string, Proposition> props = base;
+        long long mark = markHeapPeak();
+        state.ResumeTiming();
+
+        engine.deduceAll(props, exprs);
+        benchmark::DoNotOptimize(props.size());
+
+        state.PauseTiming();
+        peak = std::max(peak, heapPeakSince(mark));
+        for (const auto& entry : props) {
+            auto before = base.find(entry.first);
+            inferences += before == base.end() ||
+                          before->second.getTruthValue() != entry.second.getTruthValue();
+        }
+        props.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(inferences);
+    reportMemory(state, peak);
+    state.SetLabel(kShapeNames[state.range(0)]);
+}
+BENCHMARK(BM_Workload_Deduce)
+    ->ArgsProduct({{static_cast<int>(WorkloadShape::FAN_OUT), static_cast<int>(WorkloadShape::DEEP_CHAIN)},
+                   {10000, 100000}})
+    ->ArgsProduct({{static_cast<int>(WorkloadShape::DENSE_DISJUNCTIONS)}, {256, 2048}})
+    ->ArgsProduct({{static_cast<int>(WorkloadShape::QUANTIFIERS)}, {10000, 100000}})
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Write a realistic pair of input files with about `propositions` propositions:
+ * groups of eight rules (a four-link chain whose head also fans out to three
+ * rules), some() and not() assumptions, asserted heads and compound assignments.
+ */
+static void writeWorkloadFiles(int propositions, const std::string& assumptionsPath,
+                               const std::string& factsPath) {
+    std::ofstream assumptions(assumptionsPath, std::ios::binary | std::ios::trunc);
+    std::ofstream facts(factsPath, std::ios::binary | std::ios::trunc);
+    for (int g = 0; g < propositions / 10; ++g) {
+        std::string id = "g" + std::to_string(g) + "_";
+        for (int i = 1; i <= 4; ++i) {
+            assumptions << id << "c" << i << ", implies(" << id << "stage-" << (i - 1) << ", observed, "
+                        << id << "stage-" << i << ", observed)\n";
+        }
+        for (int i = 0; i < 3; ++i) {
+            assumptions << id << "f" << i << ", implies(" << id << "stage-0, observed, " << id
+                        << "effect-" << i << ", present)\n";
+        }
+        assumptions << id << "m, some(" << id << "sample, " << id << "residue)\n";
+        assumptions << id << "n, not(" << id << "noise)\n";
+        facts << (g % 5 ? "" : "!") << id << "stage-0\n";
+        if (g % 4 == 0) {
+            facts << id << "summary = " << id << "stage-4 && !" << id << "noise\n";
+        }
+    }
+}
+
+/**
+ * Benchmark: Load assumptions and facts files and deduce, end to end
+ * Args: propositions (10^4 to 10^6). Reports propositions per second and the
+ * heap high-water mark of the whole run.
+ */
+static void BM_Workload_EndToEnd(benchmark::State& state) {
+    const int propositions = static_cast<int>(state.range(0));
+    const std::string assumptionsPath = "bench_workload_assumptions_" + std::to_string(propositions) + ".txt";
+    const std::string factsPath = "bench_workload_facts_" + std::to_string(propositions) + ".txt";
+    writeWorkloadFiles(propositions, assumptionsPath, factsPath);
+
+    long long peak = 0;
+    size_t loaded = 0;
+    for (auto _ : state) {
+        long long mark = markHeapPeak();
+        {
+            Ratiocinator rationator;
+            rationator.loadAssumptions(assumptionsPath);
+            rationator.loadFacts(factsPath);
+            rationator.deduce();
+            loaded = rationator.getPropositionCount();
+            benchmark::DoNotOptimize(loaded);
+        }
+        peak = std::max(peak, heapPeakSince(mark));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(loaded));
+    state.counters["props"] = static_cast<double>(loaded);
+    reportMemory(state, peak);
+    std::remove(assumptionsPath.c_str());
+    std::remove(factsPath.c_str());
+}
+BENCHMARK(BM_Workload_EndToEnd)
+    ->RangeMultiplier(10)->Range(10000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 // ============================================================
 // MAIN
 // ============================================================
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Compare a Google Benchmark JSON run against a stored baseline.
+
+Benchmarks present in both files are matched by name. A benchmark regresses
+when its time (or a memory counter) grows by more than the threshold; the
+script then exits with status 1. Benchmarks found in only one file are
+listed but never fail the comparison.
+
+Usage:
+  benchmarks/compare.py BASELINE.json CURRENT.json [--threshold PCT]
+"""
+
+import argparse
+import json
+import math
+import re
+import sys
+
+UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+# Counters where larger is worse; compared alongside time when both runs report them
+MEMORY_COUNTERS = ("peak_heap_mb", "bytes_per_prop")
+
+
+def load(path):
+    """Map benchmark name -> run, skipping aggregates and complexity fits."""
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    runs = {}
+    for run in data.get("benchmarks", []):
+        if run.get("run_type", "iteration") != "iteration" or "error_occurred" in run:
+            continue
+        if run["name"].endswith(("_BigO", "_RMS")):
+            continue
+        runs[run["name"]] = run
+    return runs
+
+
+def time_ns(run, metric):
+    return run[metric] * UNIT_NS.get(run.get("time_unit", "ns"), 1.0)
+
+
+def format_ns(ns):
+    for unit in ("s", "ms", "us"):
+        if ns >= UNIT_NS[unit]:
+            return f"{ns / UNIT_NS[unit]:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+
+def change(before, after):
+    if before <= 0:
+        return 0.0 if after <= 0 else math.inf
+    return (after - before) / before * 100.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=15.0,
+                        help="allowed growth in percent (default: 15)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="cpu_time",
+                        help="time to compare (default: cpu_time)")
+    parser.add_argument("--filter", default="",
+                        help="only compare benchmarks whose name matches this regex")
+    parser.add_argument("--min-time-ns", type=float, default=1000.0,
+                        help="ignore time changes of benchmarks faster than this (default: 1000)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    pattern = re.compile(args.filter) if args.filter else None
+    names = [n for n in current if n in baseline and (not pattern or pattern.search(n))]
+
+    regressions = []
+    width = max([len(n) for n in names] + [9])
+    print(f"baseline: {args.baseline}")
+    print(f"current:  {args.current}")
+    print(f"threshold: +{args.threshold:g}% ({args.metric})")
+    print()
+    print(f"{'benchmark':<{width}}  {'baseline':>10}  {'current':>10}  {'change':>8}")
+    for name in names:
+        before = time_ns(baseline[name], args.metric)
+        after = time_ns(current[name], args.metric)
+        delta = change(before, after)
+        status = ""
+        if delta > args.threshold and max(before, after) >= args.min_time_ns:
+            status = "  REGRESSION"
+            regressions.append(name)
+        print(f"{name:<{width}}  {format_ns(before):>10}  {format_ns(after):>10}  {delta:>+7.1f}%{status}")
+
+        for counter in MEMORY_COUNTERS:
+            if counter in baseline[name] and counter in current[name]:
+                old, new = baseline[name][counter], current[name][counter]
+                delta = change(old, new)
+                status = ""
+                if delta > args.threshold:
+                    status = "  REGRESSION"
+                    regressions.append(f"{name} ({counter})")
+                label = f"  {counter}"
+                print(f"{label:<{width}}  {old:>10.3g}  {new:>10.3g}  {delta:>+7.1f}%{status}")
+
+    added = sorted(n for n in current if n not in baseline)
+    removed = sorted(n for n in baseline if n not in current)
+    if added:
+        print(f"\nnot in baseline ({len(added)}): " + ", ".join(added))
+    if removed and not pattern:
+        print(f"\nnot in current run ({len(removed)}): " + ", ".join(removed))
+
+    print()
+    if regressions:
+        print(f"{len(regressions)} regression(s) beyond +{args.threshold:g}%:")
+        for name in regressions:
+            print(f"  {name}")
+        return 1
+    print(f"no regressions beyond +{args.threshold:g}% across {len(names)} benchmark(s)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
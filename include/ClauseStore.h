@@ -0,0 +1,98 @@
+#ifndef CLAUSE_STORE_H
+#define CLAUSE_STORE_H
+
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Dense handle for a rule (IMPLIES or OR proposition, or n-ary clause) registered in a LiteralIndex
+using RuleSlot = uint32_t;
+
+/**
+ * What an n-ary clause asserts about its literals.
+ */
+enum class ClauseKind : uint8_t {
+    DISJUNCTION,  ///< or(...): at least one literal holds
+    CONJUNCTION   ///< and(...): every literal holds
+};
+
+/**
+ * ClauseStore keeps the literals of n-ary clauses back to back in one array.
+ *
+ * Each clause is an extent (offset and length) of that array, found by the
+ * RuleSlot its LiteralIndex gave it, so walking a clause of 50 literals is a
+ * scan of 50 adjacent PropIds instead of 49 binary disjunctions. Removing a
+ * clause leaves a hole that is reclaimed once holes outweigh live literals;
+ * views returned by literals() are invalidated by add(), remove() and clear().
+ *
+ * Usage:
+ *   ClauseStore store;
+ *   store.add(slot, ClauseKind::DISJUNCTION, {a, b, notC});
+ *   for (PropId literal : store.literals(slot)) { ... }
+ */
+class ClauseStore {
+public:
+    /// A clause's literals, in the order they were written
+    class Literals {
+    public:
+        Literals(const PropId* first, const PropId* last) : first_(first), last_(last) {}
+
+        const PropId* begin() const { return first_; }
+        const PropId* end() const { return last_; }
+        size_t size() const { return static_cast<size_t>(last_ - first_); }
+        bool empty() const { return first_ == last_; }
+        PropId operator[](size_t i) const { return first_[i]; }
+
+    private:
+        const PropId* first_;
+        const PropId* last_;
+    };
+
+    ClauseStore() = default;
+
+    /**
+     * Store a clause under a slot, replacing any clause stored there. A literal
+     * written twice is kept once, at its first position.
+     */
+    void add(RuleSlot slot, ClauseKind kind, const std::vector<PropId>& literals);
+
+    /// Remove the clause stored under a slot (returns false if none)
+    bool remove(RuleSlot slot);
+
+    /// Remove every clause
+    void clear();
+
+    /// Check whether a slot holds a clause
+    bool contains(RuleSlot slot) const;
+
+    /// Kind of the clause in a slot (the slot must hold one)
+    ClauseKind kind(RuleSlot slot) const;
+
+    /// Literals of the clause in a slot (empty if the slot holds none)
+    Literals literals(RuleSlot slot) const;
+
+    /// Number of clauses stored
+    size_t clauseCount() const;
+
+    /// Number of literals over all stored clauses
+    size_t literalCount() const;
+
+private:
+    /// Where a slot's clause lives in literals_ (length 0: no clause)
+    struct Extent {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        ClauseKind kind = ClauseKind::DISJUNCTION;
+    };
+
+    std::vector<PropId> literals_;  ///< Every clause's literals, back to back
+    std::vector<Extent> extents_;   ///< Slot -> its clause
+    size_t clauses_ = 0;
+    size_t garbage_ = 0;            ///< Literals of removed clauses still in literals_
+
+    /// Close the holes removed clauses left, keeping clauses in offset order
+    void compact();
+};
+
+#endif // CLAUSE_STORE_H
@@ -1,40 +1,88 @@
 #ifndef EXPRESSION_H
 #define EXPRESSION_H
 
-#include <map>
-#include <queue>
-#include <stack>
+#include <cstdint>
+#include <exception>
+#include <string>
 #include <vector>
 #include "Proposition.h"
+#include "SymbolTable.h"
+#include "TripartiteBatch.h"
 
 /**
- * Token represents either an operand (Proposition) or an operator in an expression.
+ * Token represents either an operand or an operator in an expression.
+ * An operand is a proposition name plus the truth value it had when the
+ * token was added; the name lets a bound expression read the live value.
  */
 struct Token {
   bool isOperand;
-  Proposition prop;       // Valid if isOperand == true
+  std::string name;       // Valid if isOperand == true ("" for an anonymous value)
+  Tripartite value;       // Valid if isOperand == true (value when added)
   LogicalOperator op;     // Valid if isOperand == false
-  
+
   // Construct operand token
-  explicit Token(const Proposition& p) : isOperand(true), prop(p), op(LogicalOperator::NONE) {}
-  
+  explicit Token(const Proposition& p)
+      : isOperand(true), name(p.getPrefix()), value(p.getTruthValue()), op(LogicalOperator::NONE) {}
+  Token(const std::string& n, Tripartite v)
+      : isOperand(true), name(n), value(v), op(LogicalOperator::NONE) {}
+
   // Construct operator token
-  explicit Token(LogicalOperator o) : isOperand(false), prop(), op(o) {}
+  explicit Token(LogicalOperator o)
+      : isOperand(false), name(), value(Tripartite::UNKNOWN), op(o) {}
+};
+
+/**
+ * Instruction is one step of a compiled expression. Programs are flat postfix:
+ * PUSH loads an operand, every other opcode pops its inputs and pushes the result.
+ */
+struct Instruction {
+  enum class Opcode : uint8_t { PUSH, NOT, AND, OR, IMPLIES, EQUIVALENT };
+
+  Opcode opcode;
+  uint32_t operand;  // PUSH: index of the operand token
+
+  Instruction(Opcode code, uint32_t index = 0) : opcode(code), operand(index) {}
 };
 
+/**
+ * Expression evaluates a logical formula over propositions.
+ *
+ * Tokens are compiled once (Shunting-Yard) into a flat postfix program with a
+ * preallocated value stack, so evaluation allocates nothing. evaluate() uses
+ * the operand values captured when tokens were added; after bind(), the
+ * evaluate(byId) overload reads each named operand's current truth value from
+ * the knowledge base instead, and evaluateBatch() runs the same program over
+ * many worlds at once on bit-plane columns.
+ */
 class Expression {
  private:
   std::vector<Token> tokens;                 // Unified token stream
-  std::vector<Proposition> operands;         // Legacy: Holds propositions
+  std::vector<Token> operands;               // Legacy: Holds operands
   std::vector<LogicalOperator> operators;    // Legacy: Holds logical operators
-  std::map<LogicalOperator, int> precedence; // Precedence map for logical operators
   Tripartite evaluatedValue;                 // Holds the evaluated value of the expression
   bool isEvaluated;                          // Flag to check if the expression has been evaluated
   std::string prefix;                        // Prefix for the expression
   bool useTokenStream;                       // True if using new token-based API
 
-  // Helper method to initialize operator precedence
-  void initializePrecedence();
+  // Compiled form (rebuilt lazily after the tokens change)
+  std::vector<Instruction> program;          // Flat postfix program over operand tokens
+  std::vector<Tripartite> valueStack;        // Sized to the program's maximum depth
+  std::exception_ptr compileError;           // Thrown by evaluate if the tokens are malformed
+  size_t maxDepth;                           // Deepest value stack the program reaches
+  bool isCompiled;
+  // Connective of a program that folds its operands left to right with just
+  // that connective (a && b && c), PUSH otherwise; such programs skip the stack
+  Instruction::Opcode foldOpcode;
+
+  // Bit-plane stack for evaluateBatch: maxDepth slots of (known, value) blocks
+  std::vector<uint64_t> batchStack;
+
+  // Bound form (operand token -> literal, kUnboundOperand for anonymous operands)
+  std::vector<PropId> operandLiterals;
+  std::vector<PropId> boundLiterals;         // Literals of the named operands
+
+  // Fresh whenever the program or its literals change; copies share it
+  uint64_t revision;
 
   // Helper to check if an operator is unary
   static bool isUnaryOperator(LogicalOperator op);
@@ -43,24 +91,37 @@ class Expression {
   static bool isLeftParen(LogicalOperator op);
   static bool isRightParen(LogicalOperator op);
 
-  // Helper method to perform a unary logical operation
-  static Tripartite applyUnaryOperator(Tripartite value, LogicalOperator op);
+  // Helper methods to compile the token stream / legacy operands to postfix
+  void compile();
+  void compileTokenStream();
+  void compileLegacy();
+
+  // Operand tokens of whichever API built the expression
+  const std::vector<Token>& operandTokens() const;
+
+  // Run the compiled program (byId may be null to use the captured values)
+  Tripartite run(const std::vector<Proposition*>* byId);
 
-  // Helper method to perform a binary logical operation
-  static Tripartite applyBinaryOperator(Tripartite left, Tripartite right, LogicalOperator op);
+  // Run a fold program with its connective's truth table fixed at compile time
+  template <Connective C>
+  Tripartite runFold(const std::vector<Proposition*>* byId) const;
 
-  // Helper method to convert token stream to postfix (new API)
-  Tripartite evaluateTokenStream();
+  // Value of an operand token: live from byId when bound, else as captured
+  Tripartite operandValue(uint32_t operand, const std::vector<Proposition*>* byId) const;
 
-  // Legacy: Helper method to convert the expression to postfix notation
-  void convertToPostfix(std::queue<Tripartite>& postfixQueue,
-                        std::queue<LogicalOperator>& opQueue);
+  // Compile if needed and rethrow a compile error
+  void prepare();
 
-  // Legacy: Helper method to evaluate the postfix expression
-  Tripartite evaluatePostfix(std::queue<Tripartite>& postfixQueue,
-                             std::queue<LogicalOperator>& opQueue);
+  // Drop the compiled and bound forms after the tokens change
+  void invalidate();
 
  public:
+  /// Literal of an operand with no name (always reads its captured value)
+  static constexpr PropId kUnboundOperand = UINT32_MAX;
+
+  /// Words of each bit plane evaluateBatch processes per block (512 worlds)
+  static constexpr size_t kBatchBlockWords = 8;
+
   // Constructors
   Expression();
 
@@ -76,11 +137,12 @@ class Expression {
   // Methods to add operands and operators (legacy API)
   void addOperand(const Proposition& prop);
   void addOperator(LogicalOperator op);
-  
+
   // Token-based API for expressions with parentheses
   void addToken(const Proposition& prop);    // Add operand token
+  void addToken(const std::string& name, Tripartite value);  // Add named operand token
   void addToken(LogicalOperator op);         // Add operator token
-  
+
   // Convenience methods for parentheses (uses token API)
   void openParen();   // Add LPAREN
   void closeParen();  // Add RPAREN
@@ -88,12 +150,61 @@ class Expression {
   // Evaluate the logical expression and return the result
   Tripartite evaluate();
 
+  /**
+   * Resolve operand names to literals so evaluate(byId) can read live values.
+   * Anonymous operands (empty name) keep their captured value.
+   */
+  void bind(SymbolTable& symbols);
+
+  /**
+   * Evaluate against live storage: a bound operand reads byId[literal], or its
+   * captured value if that proposition does not exist. Does not allocate.
+   */
+  Tripartite evaluate(const std::vector<Proposition*>& byId);
+
+  /**
+   * Evaluate over many worlds at once. columns[literal] holds a bound operand's
+   * value in every world; a null or missing column broadcasts its captured value.
+   * Every column must have result.worldCount() worlds (throws std::invalid_argument).
+   * Allocates only the first time a program needs a deeper stack.
+   */
+  void evaluateBatch(const std::vector<const TripartiteBatch*>& columns, TripartiteBatch& result);
+
+  /// Literals of the named operands (valid after bind)
+  const std::vector<PropId>& getBoundLiterals() const;
+
+  /// Number of instructions in the compiled program
+  size_t getInstructionCount();
+
+  /// The compiled program (empty if there is nothing to evaluate or the tokens are malformed)
+  const std::vector<Instruction>& getProgram();
+
+  /// Literal a PUSH operand reads (kUnboundOperand if anonymous or not bound)
+  PropId getOperandLiteral(uint32_t operand) const;
+
+  /// Value a PUSH operand was captured with
+  Tripartite getOperandValue(uint32_t operand) const;
+
+  /**
+   * Identifies the compiled program over its bound literals: two expressions
+   * with the same revision (one a copy of the other, say) evaluate alike. A new
+   * revision is taken whenever compilation or bind() changes either.
+   */
+  uint64_t getRevision() const;
+
   // Get the evaluated value of the expression
   Tripartite getEvaluatedValue() const;
 
   // Get the prefix of the expression
   const std::string& getPrefix() const;
 
+  // Tokens as added, for serialization: the token stream if the token API built
+  // the expression, otherwise the legacy operands and operators
+  bool usesTokenStream() const;
+  const std::vector<Token>& getTokens() const;
+  const std::vector<Token>& getOperands() const;
+  const std::vector<LogicalOperator>& getOperators() const;
+
   // Reset expression
   void reset();
 };
@@ -0,0 +1,168 @@
+#ifndef EXPRESSION_DAG_H
+#define EXPRESSION_DAG_H
+
+#include "Expression.h"
+#include "Proposition.h"
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * ExpressionDag evaluates many expressions over one hash-consed graph: every
+ * distinct subexpression (an operand, or an operator over distinct inputs) is a
+ * single node, however many expressions contain it. `t = p && n` and
+ * `u = (p && n) || r` share the node for `p && n`.
+ *
+ * Each node caches its value and a dirty bit. invalidate(literal) marks the
+ * operands reading a literal and every node above them; evaluate() recomputes
+ * only dirty nodes, so an expression whose inputs did not change costs one
+ * lookup. Operands of the commutative connectives are stored in a fixed order,
+ * and subexpressions of constants are folded when added.
+ *
+ * A dirty node's ancestors are always dirty, which is what lets invalidate()
+ * stop at a node that is already marked. Not safe for concurrent use, except
+ * that threads may evaluate and invalidate disjoint parts of the graph (nodes
+ * over disjoint literals) if each passes its own Scratch; nodes of constants
+ * are never written after add().
+ *
+ * Usage:
+ *   ExpressionDag dag;
+ *   uint32_t root = dag.add(expression);   // expression.bind() first
+ *   dag.evaluate(root, [&](PropId literal) { return byId[literal]; });
+ *   dag.invalidate(changedLiteral);
+ */
+class ExpressionDag {
+public:
+    /// Root of an expression add() could not compile
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+
+    /// Working memory of evaluate() and invalidate(), one per thread
+    struct Scratch {
+        std::vector<uint32_t> stack;
+        size_t evaluations = 0;  ///< Nodes recomputed with this scratch
+    };
+
+    ExpressionDag() = default;
+
+    /**
+     * Add an expression's compiled program and return its root. Operands read
+     * the literals bind() gave them. Returns kNoNode for an expression with an
+     * empty or malformed program; evaluate that one directly.
+     */
+    uint32_t add(Expression& expression);
+
+    /// Mark every node that reads a literal (directly or through its inputs) for re-evaluation
+    void invalidate(PropId literal) { invalidate(literal, scratch_); }
+    void invalidate(PropId literal, Scratch& scratch);
+
+    /// Mark every node for re-evaluation, as when all literals may have changed
+    void invalidateAll();
+
+    /**
+     * Value of a node, recomputing its dirty inputs first. read(literal) returns
+     * the literal's proposition, or nullptr to use the operand's captured value.
+     */
+    template <typename Read>
+    Tripartite evaluate(uint32_t root, Read read) { return evaluate(root, read, scratch_); }
+    template <typename Read>
+    Tripartite evaluate(uint32_t root, Read read, Scratch& scratch);
+
+    /// Remove every node
+    void clear();
+
+    /// Number of distinct subexpressions
+    size_t nodeCount() const { return nodes_.size(); }
+
+    /// Nodes recomputed by evaluate() without a scratch of its own
+    size_t evaluations() const { return scratch_.evaluations; }
+
+private:
+    enum class Kind : uint8_t { CONSTANT, OPERAND, NOT, BINARY };
+
+    struct Node {
+        Kind kind;
+        Connective connective;  ///< BINARY only
+        Tripartite value;       ///< Cached value (CONSTANT: the value; OPERAND: captured fallback until read)
+        bool dirty;
+        uint32_t left;          ///< OPERAND: literal; NOT, BINARY: input node
+        uint32_t right;         ///< OPERAND: captured value; BINARY: input node
+    };
+
+    /// Hash of a node's identity: kind, connective and inputs (not its value)
+    static uint64_t hash(const Node& node) {
+        uint64_t h = (static_cast<uint64_t>(node.left) << 32) | node.right;
+        h ^= (static_cast<uint64_t>(node.kind) << 8 | static_cast<uint64_t>(node.connective)) *
+             0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        return h ^ (h >> 32);
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<std::vector<uint32_t>> parents_;                  ///< Node -> nodes reading it
+    std::vector<uint32_t> slots_;                                 ///< Hash-consing table (open addressing, kNoNode = empty)
+    std::unordered_map<PropId, std::vector<uint32_t>> operands_;  ///< Literal -> OPERAND nodes
+    Scratch scratch_;                                             ///< For add and the calls without a scratch
+
+    /// The node equal to this one, creating it (dirty unless constant) on first use
+    uint32_t intern(const Node& node);
+    void growSlots();
+    uint32_t constant(Tripartite value);
+    uint32_t operand(PropId literal, Tripartite captured);
+    uint32_t negation(uint32_t input);
+    uint32_t binary(Connective connective, uint32_t left, uint32_t right);
+};
+
+template <typename Read>
+Tripartite ExpressionDag::evaluate(uint32_t root, Read read, Scratch& scratch) {
+    if (!nodes_[root].dirty) {
+        return nodes_[root].value;
+    }
+    // Post-order over the dirty part only: a node is computed once its inputs are clean
+    std::vector<uint32_t>& stack = scratch.stack;
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        Node& node = nodes_[stack.back()];
+        if (!node.dirty) {
+            stack.pop_back();
+            continue;
+        }
+        switch (node.kind) {
+            case Kind::OPERAND: {
+                const Proposition* prop = read(static_cast<PropId>(node.left));
+                node.value = prop ? prop->getTruthValue() : static_cast<Tripartite>(node.right);
+                break;
+            }
+            case Kind::NOT:
+                if (nodes_[node.left].dirty) {
+                    stack.push_back(node.left);
+                    continue;
+                }
+                node.value = !nodes_[node.left].value;
+                break;
+            case Kind::BINARY:
+                if (nodes_[node.left].dirty) {
+                    stack.push_back(node.left);
+                    continue;
+                }
+                if (nodes_[node.right].dirty) {
+                    stack.push_back(node.right);
+                    continue;
+                }
+                node.value = applyConnective(node.connective, nodes_[node.left].value,
+                                             nodes_[node.right].value);
+                break;
+            case Kind::CONSTANT:
+                break;
+        }
+        node.dirty = false;
+        ++scratch.evaluations;
+        stack.pop_back();
+    }
+    return nodes_[root].value;
+}
+
+#endif // EXPRESSION_DAG_H
@@ -2,85 +2,452 @@
 #define INFERENCE_ENGINE_H
 
 #include "Expression.h"
+#include "ExpressionDag.h"
+#include "InferenceStats.h"
+#include "LiteralIndex.h"
 #include "Proposition.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <string>
 
+/**
+ * Strategy used by InferenceEngine::deduceAll to reach the fixed point.
+ */
+enum class DeductionStrategy {
+    FULL_SWEEP,  ///< Re-run all five phases over the whole knowledge base until nothing changes
+    WORKLIST,    ///< Semi-naive: only revisit rules that mention a proposition whose value changed,
+                 ///< in FULL_SWEEP's order, so the same rules fire and record the same provenance
+    TOPOLOGICAL  ///< WORKLIST in dependency order: strongly connected components of the rule
+                 ///< graph run in topological order, so only cyclic ones iterate
+};
+
+/**
+ * What InferenceEngine records about each value it derives.
+ */
+enum class ProvenanceLevel {
+    FULL,     ///< Rule, premise names and timestamp (needed by traceInference)
+    COMPACT,  ///< Rule and premise literals only; no strings, no clock
+    NONE      ///< Final truth values only
+};
+
+/**
+ * Cooperative cancellation of a running deduction. Copies share one flag, so a
+ * caller keeps a copy and may cancel() from any thread; the engine polls it
+ * between agenda steps (FULL_SWEEP: between phases).
+ */
+class CancellationToken {
+public:
+    CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /// Ask every run holding this token to stop
+    void cancel() const { cancelled_->store(true, std::memory_order_relaxed); }
+
+    bool isCancelled() const { return cancelled_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/**
+ * Bounds on one deduction (see InferenceEngine::setLimits). A run that reaches
+ * one stops where it is: every value derived so far is kept, but the fixed
+ * point may not have been reached.
+ */
+struct DeductionLimits {
+    /// Stop once this time has passed (max() = no deadline)
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+    /// Stop after this many steps, counted as in Convergence::iterations (0 = no limit)
+    size_t maxSteps = 0;
+
+    /// Stop once cancelled
+    CancellationToken cancellation;
+
+    /// Limits ending after a time budget from now
+    static DeductionLimits within(std::chrono::steady_clock::duration budget) {
+        DeductionLimits limits;
+        limits.deadline = std::chrono::steady_clock::now() + budget;
+        return limits;
+    }
+};
+
+/**
+ * Why a deduction stopped before its fixed point because of its DeductionLimits.
+ */
+enum class Interruption {
+    NONE,       ///< Not interrupted
+    CANCELLED,  ///< DeductionLimits::cancellation was cancelled
+    DEADLINE,   ///< DeductionLimits::deadline passed
+    STEPS       ///< DeductionLimits::maxSteps were taken
+};
+
 /**
  * InferenceEngine class responsible for logical deduction.
  * Applies inference rules (Modus Ponens, Modus Tollens, etc.) to derive
  * new truth values from existing propositions and expressions.
- * 
+ *
  * Supported inference rules:
  * - Modus Ponens:          P → Q, P ⊢ Q
  * - Modus Tollens:         P → Q, ¬Q ⊢ ¬P
  * - Hypothetical Syllogism: P → Q, Q → R ⊢ P → R (with truth propagation)
  * - Disjunctive Syllogism: P ∨ Q, ¬P ⊢ Q
  * - Resolution:            P ∨ Q, ¬P ∨ R ⊢ Q ∨ R
+ * - Simplification:        P ∧ Q ⊢ P
+ *
+ * N-ary clauses (or(...) / and(...) rules, kept in the index's ClauseStore)
+ * are propagated SAT-style: each disjunction watches two literals that are
+ * not refuted and is only revisited when one of them is, so Disjunctive
+ * Syllogism and Resolution over wide clauses cost time in proportion to the
+ * watches touched rather than to clause width. A literal is refuted when it
+ * is FALSE, or when its complement was forced by another clause whose other
+ * literals are all FALSE (one Resolution step, as for binary disjunctions).
+ * Forced literals are remembered for one run and are not withdrawn if a
+ * conflict later overturns them.
  */
 class InferenceEngine {
+public:
+    /// Values a copy-on-write run wrote, by literal: copies of base propositions
+    /// (or new ones) holding that run's truth values and provenance
+    using Overlay = std::unordered_map<PropId, Proposition>;
+
+    /**
+     * Configuration options for the inference engine.
+     */
+    struct Options {
+        /// Fixed-point strategy of deduceAll (the other entry points always use WORKLIST)
+        DeductionStrategy strategy = DeductionStrategy::WORKLIST;
+
+        /// Threads for deduceAll (0 = one per hardware thread). With more than one,
+        /// connected components of the knowledge base reach their fixed points
+        /// concurrently; results are identical for every thread count.
+        size_t threads = 1;
+
+        /// Provenance recorded for derived values. COMPACT premises are PropIds of
+        /// the literal index's symbol table; NONE also skips conflict history.
+        ProvenanceLevel provenance = ProvenanceLevel::FULL;
+
+        /// Conflict history kept when a derived value overturns another (with
+        /// provenance only); RECENT keeps the last conflictHistory of them
+        ConflictRecording conflicts = ConflictRecording::RECENT;
+        size_t conflictHistory = 8;
+
+        /// A run stops, unconverged, once one literal has been overturned more
+        /// than this many times: contradictory rules would otherwise flip it
+        /// back and forth (0 = never stop)
+        size_t oscillationLimit = 64;
+
+        /// Count and time every phase and rule into getStats() (see InferenceStats)
+        bool collectStats = false;
+
+        /// Evaluate deduceAll()'s expressions over one hash-consed DAG (see
+        /// ExpressionDag), kept across calls: shared subexpressions are computed
+        /// once per run, and again only when an input changed. false runs each
+        /// expression's own program every time (the reference). Incremental,
+        /// overlay and query runs always do.
+        bool shareExpressions = true;
+
+        Options() = default;
+    };
+
+    /**
+     * How the last deduction reached its fixed point, or why it did not.
+     */
+    struct Convergence {
+        /// FULL_SWEEP passes, or WORKLIST / TOPOLOGICAL agenda steps, summed over
+        /// the runs (components, query rounds) of the call
+        size_t iterations = 0;
+
+        /// Passes over the knowledge base, the most any one run took: FULL_SWEEP
+        /// sweeps, or TOPOLOGICAL sweeps of the component order (a new one starts
+        /// when an overturned value reaches back into a component already swept,
+        /// so it is 1 on bases without conflicts). 0 for WORKLIST runs, which
+        /// include every deduceIncremental(), deduceOverlay() and query().
+        size_t passes = 0;
+
+        size_t conflicts = 0;                  ///< Known values overturned by a different one
+        bool converged = true;                 ///< False if a run was stopped for oscillating or interrupted
+        std::vector<std::string> oscillating;  ///< The literal that stopped each such run
+        Interruption interrupted = Interruption::NONE;  ///< Limit that stopped the call, if any
+    };
+
 private:
+    /// Knowledge base of one deduceAll call, resolved to PropId- and slot-indexed vectors
+    struct Binding;
+
+    /// Rules and expressions of one fixed-point run (a connected component, or everything)
+    struct Partition;
+
+    /// A premise cited by a rule firing (a literal or a rule slot)
+    struct Premise;
+
+    /// Rules and expressions that can influence a goal, discovered backward from it
+    struct GoalScope;
+
+    /// The limits_ of one call, with the steps its runs have taken so far
+    struct Budget;
+
+    Options options_;
+    Convergence convergence_;
+    InferenceStats stats_;
+
+    /// Bounds on each call, and the current call's budget (null without limits)
+    DeductionLimits limits_;
+    bool limited_ = false;
+    std::shared_ptr<Budget> budget_;
+
+    /// Threads for parallel deduction, created on first use and shared by copies
+    std::shared_ptr<WorkStealingPool> pool_;
+
+    /// Expressions of past calls, hash-consed (Options::shareExpressions). An
+    /// expression's root stays valid while its revision is the one recorded.
+    ExpressionDag expressionDag_;
+    std::vector<uint64_t> dagRevisions_;  ///< Expression -> revision its root was built from
+    std::vector<uint32_t> dagRoots_;      ///< Expression -> root (kNoNode: evaluate it directly)
+
     // Safe internal helper to find proposition (returns nullptr if not found)
     static Proposition* findProposition(const std::string& name,
                                         std::unordered_map<std::string, Proposition>& propositions);
     static const Proposition* findProposition(const std::string& name,
                                               const std::unordered_map<std::string, Proposition>& propositions);
 
+    /// Set a literal's truth value (creating its proposition if needed) and record the change
+    void assignTruthValue(Partition& part, PropId id, Tripartite value,
+                          InferenceRule rule, std::initializer_list<Premise> premises);
+    void assignTruthValue(Partition& part, PropId id, Tripartite value,
+                          InferenceRule rule, const Premise* premises, size_t count);
+
     // ========== Basic Inference Rules ==========
-    
+
     /// Modus Ponens: P → Q, P is TRUE ⊢ Q is TRUE
-    static bool applyModusPonens(const Proposition& implication,
-                                 std::unordered_map<std::string, Proposition>& propositions);
-    
+    bool applyModusPonens(Partition& part, RuleSlot implication);
+
     /// Modus Tollens: P → Q, Q is FALSE ⊢ P is FALSE
-    static bool applyModusTollens(const Proposition& implication,
-                                  std::unordered_map<std::string, Proposition>& propositions);
+    bool applyModusTollens(Partition& part, RuleSlot implication);
 
     // ========== Extended Inference Rules ==========
-    
+
     /// Hypothetical Syllogism: P → Q, Q → R ⊢ P → R
     /// When P is TRUE, transitively derives R is TRUE
-    static bool applyHypotheticalSyllogism(const Proposition& impl1,
-                                           const Proposition& impl2,
-                                           std::unordered_map<std::string, Proposition>& propositions);
+    bool applyHypotheticalSyllogism(Partition& part, RuleSlot impl1, RuleSlot impl2);
 
     /// Disjunctive Syllogism: P ∨ Q, ¬P ⊢ Q (and P ∨ Q, ¬Q ⊢ P)
     /// When one disjunct is FALSE, the other is TRUE
-    static bool applyDisjunctiveSyllogism(const Proposition& disjunction,
-                                          std::unordered_map<std::string, Proposition>& propositions);
+    bool applyDisjunctiveSyllogism(Partition& part, RuleSlot disjunction);
 
     /// Resolution: P ∨ Q, ¬P ∨ R ⊢ Q ∨ R
     /// Creates derived disjunctions from complementary literals
-    static bool applyResolution(const Proposition& disj1,
-                                const Proposition& disj2,
-                                std::unordered_map<std::string, Proposition>& propositions);
-
-    // ========== Helper Methods ==========
-    
-    /// Check if a proposition name represents a negation (starts with "~" or "!")
-    static bool isNegatedName(const std::string& name);
-    
-    /// Get the base name without negation prefix
-    static std::string getBaseName(const std::string& name);
-    
-    /// Get the negated form of a name
-    static std::string getNegatedName(const std::string& name);
+    bool applyResolution(Partition& part, RuleSlot disj1, RuleSlot disj2);
+
+    /// Unit propagation over an n-ary clause (see LiteralIndex::clauses): a
+    /// disjunction left with one literal that is not refuted makes it TRUE
+    /// (Disjunctive Syllogism, or Resolution when a refuted literal's complement
+    /// was forced by another clause); a conjunction makes every literal TRUE
+    /// (Simplification). Sets rule to the rule examined.
+    bool applyClause(Partition& part, RuleSlot clause, InferenceRule& rule);
+
+    /// Apply an expression's result to its subject according to the subject's quantifier
+    bool applyExpression(Partition& part, size_t expression);
+
+    // ========== Fixed-Point Strategies ==========
+
+    /// Repeat all five phases over the whole knowledge base until a pass changes nothing
+    void deduceFullSweep(Partition& part);
+
+    /// Agenda-driven propagation: a value change only re-enqueues the rules that mention it
+    void deduceWorklist(Partition& part);
+
+    /// Agenda-driven propagation ordered by the strongly connected components of
+    /// the dependency graph between derivable values
+    void deduceTopological(Partition& part);
+
+    /// One agenda step: a phase's rules applied to one rule slot or expression
+    void applyStep(Partition& part, InferenceStats::Phase phase, size_t item,
+                   std::vector<RuleSlot>& partners);
+
+    /// Run the configured strategy on one partition
+    void deducePartition(Partition& part);
+
+    /// Split the knowledge base into components that share no symbol and deduce them on the pool
+    void deduceParallel(Binding& kb, size_t threads);
+
+    /// Insert the propositions the partitions derived but that did not exist, in PropId order
+    static void commitCreated(Binding& kb, std::vector<Partition>& parts);
+
+    /// Count an overturned value, stopping the run if the literal keeps flipping
+    void noteOverturn(Partition& part, PropId id);
+
+    /// Apply per-run options to a fresh partition (its own stats counters, expression sharing)
+    void preparePartition(Partition& part);
+
+    /// Bring expressionDag_ up to date with a run's bound expressions, all nodes dirty
+    void syncExpressionDag(std::vector<Expression>& expressions);
+
+    /// Add a finished run to convergence_ (and its counters to stats_)
+    void noteConvergence(const Partition& part);
+
+    /// Count a public call into stats_ and start its budget; returns its timer
+    /// (null when not collecting)
+    uint64_t* beginCall();
 
 public:
     InferenceEngine() = default;
+    explicit InferenceEngine(const Options& opts);
     ~InferenceEngine() = default;
 
+    /// Set engine options
+    void setOptions(const Options& opts);
+
+    /// Get current engine options
+    const Options& getOptions() const;
+
+    /// How the last deduceAll(), deduceIncremental(), deduceOverlay() or query() converged
+    const Convergence& getConvergence() const;
+
+    /// Counters collected since the last resetStats() (while Options::collectStats is set)
+    const InferenceStats& getStats() const;
+
+    /// Zero the collected counters
+    void resetStats();
+
+    /**
+     * Bound every following call (deduceAll, deduceIncremental, deduceOverlay,
+     * query) by limits, until clearLimits(). Runs check them cooperatively
+     * between agenda steps, and FULL_SWEEP between phases; a run that reaches
+     * one keeps what it derived and getConvergence() reports the interruption.
+     * Parallel components share the step budget and all stop together.
+     */
+    void setLimits(const DeductionLimits& limits);
+
+    /// Remove the limits set by setLimits()
+    void clearLimits();
+
     /**
      * Deduce truth values of all propositions based on inference rules and expressions.
      * Iterates until no more changes can be made (fixed-point iteration).
-     * 
+     *
      * @param propositions Map of proposition names to Proposition objects (modified in-place)
      * @param expressions Vector of Expression objects to evaluate
      */
     void deduceAll(std::unordered_map<std::string, Proposition>& propositions,
                    std::vector<Expression>& expressions);
+
+    /**
+     * Deduce using a caller-maintained literal index instead of building one.
+     * Hypothetical Syllogism and Resolution only examine rule pairs that share
+     * a pivot literal in the index. Expression subjects are interned in the
+     * index's symbol table. If the index does not cover every rule in the
+     * knowledge base, a fresh one is built for this call.
+     *
+     * Names are resolved to PropIds once per call; the rules themselves run on
+     * id-indexed vectors and only touch strings to record provenance.
+     *
+     * Propositions derived for literals that had none are inserted after the
+     * fixed point is reached, in PropId order, so the map's contents do not
+     * depend on Options::threads.
+     *
+     * @param propositions Map of proposition names to Proposition objects (modified in-place)
+     * @param expressions Vector of Expression objects to evaluate
+     * @param index Literal-to-rule index for the rules in propositions
+     */
+    void deduceAll(std::unordered_map<std::string, Proposition>& propositions,
+                   std::vector<Expression>& expressions,
+                   LiteralIndex& index);
+
+    /**
+     * Propagate changes from a previous fixed point instead of starting over.
+     * Only the rules and expressions that mention a changed name are seeded;
+     * whatever they derive propagates as in the worklist strategy. Propositions
+     * and rules are looked up when the run reaches them, so the cost follows
+     * the affected region rather than the size of the knowledge base.
+     *
+     * The index must describe the rules in propositions (it is not verified).
+     * Rule pairs are visited in slot order, and Options::threads is ignored.
+     * Retracting values that lost their support is the caller's job (see
+     * Ratiocinator::deduceIncremental).
+     *
+     * @param propositions Map of proposition names to Proposition objects (modified in-place)
+     * @param expressions Vector of Expression objects to evaluate
+     * @param index Literal-to-rule index for the rules in propositions
+     * @param changed Names whose values changed, or operands of rules added or removed
+     * @param assigned If not null, receives each name this call assigned, once, in order
+     * @param previous If not null (with assigned), receives each assigned name's value
+     *                 before this call
+     */
+    void deduceIncremental(std::unordered_map<std::string, Proposition>& propositions,
+                           std::vector<Expression>& expressions,
+                           LiteralIndex& index,
+                           const std::vector<std::string>& changed,
+                           std::vector<std::string>* assigned = nullptr,
+                           std::vector<Tripartite>* previous = nullptr);
+
+    /**
+     * Deduce over a shared, read-only knowledge base, writing every value to an
+     * overlay instead. The base is never modified, so any number of runs may
+     * share it concurrently, each with its own overlay and engine.
+     *
+     * Values already in the overlay (e.g. a scenario's facts) are read in place
+     * of the base's. With changed, only the rules and expressions mentioning
+     * those literals are seeded, as in deduceIncremental(); without it, every
+     * rule and expression is. Propositions the run derives for literals with no
+     * proposition are created in the overlay. Rules run in slot order and
+     * Options::threads is ignored.
+     *
+     * @param base Knowledge base the overlay is layered over (not modified)
+     * @param expressions The run's own copy of the base's expressions, already
+     *                    bound to the index's symbols (evaluating updates them)
+     * @param index Literal-to-rule index for the rules in base
+     * @param overlay Values that differ from base, read and extended by the run
+     * @param changed If not null, the literals whose values differ from a fixed point of base
+     */
+    void deduceOverlay(const std::unordered_map<std::string, Proposition>& base,
+                       std::vector<Expression>& expressions,
+                       const LiteralIndex& index,
+                       Overlay& overlay,
+                       const std::vector<PropId>* changed = nullptr);
+
+    /// Decide one proposition by backward chaining, building a fresh literal index
+    Tripartite query(std::unordered_map<std::string, Proposition>& propositions,
+                     std::vector<Expression>& expressions,
+                     const std::string& goal);
+
+    /**
+     * Decide one proposition without deducing the whole knowledge base.
+     * Works backward from the goal through the rules that could assign it
+     * (Modus Ponens from implications that conclude it, Modus Tollens from
+     * implications it is the antecedent of, Disjunctive Syllogism and
+     * Resolution from disjunctions that contain it) to their premises, and
+     * so on. Each literal is expanded once, however many rules need it, so
+     * shared subgoals are tabled. The search grows in rounds that double the
+     * number of rules found; each round runs the new rules with the worklist
+     * strategy, and the query stops as soon as the goal has a value, so a
+     * goal decided near the top never explores the rest. A goal that already
+     * has a value is returned as is.
+     *
+     * Values derived on the way are written to propositions with the usual
+     * provenance, so traceInference() can explain the answer and later
+     * queries reuse them. On a consistent knowledge base the goal ends with
+     * the value deduceAll() would give it. Options::threads is ignored.
+     *
+     * @param propositions Map of proposition names to Proposition objects (modified in-place)
+     * @param expressions Vector of Expression objects to evaluate
+     * @param index Literal-to-rule index for the rules in propositions
+     * @param goal Name of the proposition to decide
+     * @param assigned If not null, receives each name this call assigned, once, in order
+     * @param rulesInScope If not null, receives the number of rules and expressions
+     *                     the search reached
+     * @return The goal's truth value (UNKNOWN if it cannot be decided)
+     */
+    Tripartite query(std::unordered_map<std::string, Proposition>& propositions,
+                     std::vector<Expression>& expressions,
+                     LiteralIndex& index,
+                     const std::string& goal,
+                     std::vector<std::string>* assigned = nullptr,
+                     size_t* rulesInScope = nullptr);
 };
 
 #endif // INFERENCE_ENGINE_H
-
@@ -0,0 +1,75 @@
+#ifndef INFERENCE_STATS_H
+#define INFERENCE_STATS_H
+
+#include "Proposition.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/**
+ * InferenceStats counts and times what deduction does, to explain where a slow
+ * deduce() spent its time: fixed-point iterations, time and steps per phase,
+ * and for each rule how many candidates (rules, or pairs of rules) it examined
+ * against how many times it fired.
+ *
+ * The engine only collects it when InferenceEngine::Options::collectStats is
+ * set; otherwise the cost is a null check per rule application. Building with
+ * ENABLE_INFERENCE_STATS=OFF (LOGOSLAB_NO_INFERENCE_STATS) compiles the
+ * collection out entirely. Counters accumulate over calls until reset.
+ *
+ * Usage:
+ *   options.collectStats = true;
+ *   engine.setInferenceOptions(options);
+ *   engine.deduce();
+ *   engine.getStats().writeJson(std::cout);
+ */
+struct InferenceStats {
+#ifdef LOGOSLAB_NO_INFERENCE_STATS
+    static constexpr bool kCompiled = false;
+#else
+    static constexpr bool kCompiled = true;
+#endif
+
+    /// The five phases of a fixed-point pass, in order
+    enum class Phase : uint8_t { IMPLICATIONS, SYLLOGISM, DISJUNCTIONS, RESOLUTION, EXPRESSIONS };
+    static constexpr size_t kPhaseCount = 5;
+
+    struct PhaseCounts {
+        uint64_t steps = 0;        ///< Agenda steps (WORKLIST, TOPOLOGICAL) or passes (FULL_SWEEP) in the phase
+        uint64_t nanoseconds = 0;  ///< Time spent in them
+    };
+
+    struct RuleCounts {
+        uint64_t candidates = 0;  ///< Rules (or pairs, for the pairwise rules) examined
+        uint64_t fired = 0;       ///< Examinations that assigned a value
+    };
+
+    uint64_t calls = 0;                ///< Deductions and queries
+    uint64_t nanoseconds = 0;          ///< Time spent in them
+    uint64_t iterations = 0;           ///< See InferenceEngine::Convergence::iterations
+    uint64_t conflicts = 0;            ///< Known values overturned
+    uint64_t oscillations = 0;         ///< Runs stopped for oscillating
+    uint64_t propositionsCreated = 0;  ///< Propositions inserted into the knowledge base
+
+    std::array<PhaseCounts, kPhaseCount> phases{};
+    std::array<RuleCounts, 7> rules{};  ///< By InferenceRule (CUSTOM is unused)
+    RuleCounts expressions;             ///< Expressions evaluated / that changed their subject
+
+    PhaseCounts& phase(Phase p) { return phases[static_cast<size_t>(p)]; }
+    const PhaseCounts& phase(Phase p) const { return phases[static_cast<size_t>(p)]; }
+    RuleCounts& rule(InferenceRule r) { return rules[static_cast<size_t>(r)]; }
+    const RuleCounts& rule(InferenceRule r) const { return rules[static_cast<size_t>(r)]; }
+
+    /// Add another set of counters to this one
+    void merge(const InferenceStats& other);
+
+    /// Write as one JSON object (no trailing newline)
+    void writeJson(std::ostream& out) const;
+
+    /// JSON key of a phase (e.g., "implications")
+    static std::string_view phaseName(Phase p);
+};
+
+#endif // INFERENCE_STATS_H
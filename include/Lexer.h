@@ -2,6 +2,7 @@
 #define LEXER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stdexcept>
 #include <optional>
@@ -76,6 +77,23 @@ struct LexerToken {
     std::string toString() const;
 };
 
+/**
+ * LexerTokenView is a LexerToken whose text is a view into the lexed input
+ * rather than an owned copy. It is valid only while that input is.
+ */
+struct LexerTokenView {
+    TokenType type;           ///< The type of token
+    std::string_view value;   ///< The original text of the token
+    SourceLocation location;  ///< Where the token starts in the source
+
+    LexerTokenView() : type(TokenType::UNKNOWN), value(), location() {}
+    LexerTokenView(TokenType t, std::string_view v, const SourceLocation& loc)
+        : type(t), value(v), location(loc) {}
+
+    /// Copy into an owning token
+    LexerToken toToken() const;
+};
+
 /**
  * LexerError provides detailed error information with source location.
  */
@@ -100,6 +118,8 @@ private:
  * 
  * Features:
  * - Line/column tracking for precise error messages
+ * - Table-driven character classes; runs of whitespace and identifier bytes
+ *   are skipped 16 at a time where the compiler supports vector extensions
  * - Support for identifiers with hyphens and underscores
  * - Multi-character operators (&&, ||, ->, <->)
  * - Optional newline tokens for line-based parsing
@@ -110,6 +130,10 @@ private:
  *   for (const auto& token : tokens) {
  *       std::cout << token.toString() << std::endl;
  *   }
+ *
+ * tokenizeView() lexes a buffer the caller keeps alive (e.g. a MappedFile)
+ * into views of it, and reuses the output vector, so it copies no text.
+ * tokenize(input, tokens) reuses an owning vector the same way.
  */
 class Lexer {
 public:
@@ -125,10 +149,10 @@ public:
     };
 
 private:
-    std::string input_;
+    std::string_view input_;  ///< The text being lexed (owned by the caller)
     size_t pos_;
-    size_t line_;
-    size_t column_;
+    size_t line_;             ///< Line of pos_ (1-based)
+    size_t lineStart_;        ///< Offset that line starts at; columns are counted from it
     Options options_;
     
     /// Current character or '\0' if at end
@@ -137,8 +161,11 @@ private:
     /// Peek ahead n characters (0 = current)
     char peek(size_t n = 0) const;
     
-    /// Advance position by one character
-    void advance();
+    /// Advance position by n characters, none of them a newline
+    void advance(size_t n = 1);
+    
+    /// Step over the newline at the current position
+    void advanceLine();
     
     /// Skip whitespace (except newlines if emitNewlines is true)
     void skipWhitespace();
@@ -156,16 +183,13 @@ private:
     std::string getContext() const;
     
     /// Scan a single token
-    LexerToken scanToken();
+    LexerTokenView scanToken();
     
     /// Scan an identifier (alphanumeric, hyphens, underscores)
-    LexerToken scanIdentifier();
+    LexerTokenView scanIdentifier();
     
     /// Check if character can start an identifier
     static bool isIdentifierStart(char c);
-    
-    /// Check if character can continue an identifier
-    bool isIdentifierContinue(char c) const;
 
 public:
     Lexer();
@@ -181,12 +205,30 @@ public:
      */
     std::vector<LexerToken> tokenize(const std::string& input);
     
+    /**
+     * Tokenize into a caller-owned vector, replacing its contents. The vector's
+     * capacity and the text buffers of the tokens already in it are reused, so
+     * lexing line after line into the same vector stops allocating.
+     * 
+     * @throws LexerError on invalid input
+     */
+    void tokenize(std::string_view input, std::vector<LexerToken>& tokens);
+    
     /**
      * Tokenize and return tokens without END_OF_INPUT marker.
      * Useful for simpler iteration.
      */
     std::vector<LexerToken> tokenizeContent(const std::string& input);
     
+    /**
+     * Tokenize without copying: tokens are views into input, which must
+     * outlive them. Replaces the contents of tokens (keeping its capacity)
+     * and, like tokenizeContent, omits END_OF_INPUT.
+     * 
+     * @throws LexerError on invalid input
+     */
+    void tokenizeView(std::string_view input, std::vector<LexerTokenView>& tokens);
+    
     /**
      * Set lexer options.
      */
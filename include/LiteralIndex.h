@@ -0,0 +1,153 @@
+#ifndef LITERAL_INDEX_H
+#define LITERAL_INDEX_H
+
+#include "ClauseStore.h"
+#include "Proposition.h"
+#include "SymbolTable.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * LiteralIndex maps each literal to the rules that mention it.
+ *
+ * Implications are indexed by the literal of their antecedent and of their
+ * consequent; disjunctions by the literal of each disjunct. N-ary clauses
+ * (propositions with operands) keep their literals in a ClauseStore and are
+ * indexed by each of them, apart from binary disjunctions. Rule operands are
+ * interned in the index's SymbolTable as rules are added, so each lookup is a
+ * vector access by PropId. Rules are identified by a RuleSlot that stays
+ * stable until the rule is removed, so the inference engine can keep per-rule
+ * state in plain vectors.
+ *
+ * Hypothetical Syllogism only needs the implications whose antecedent is the
+ * current rule's consequent, and Resolution only needs the disjunctions that
+ * contain a complementary literal; both are single lookups here.
+ *
+ * Usage:
+ *   LiteralIndex index;
+ *   index.rebuild(propositions);
+ *   for (RuleSlot slot : index.implicationsWithAntecedent("Q")) { ... }
+ */
+class LiteralIndex {
+private:
+    /// Rules that mention one literal, grouped by the position it appears in
+    struct Occurrences {
+        std::vector<RuleSlot> antecedentOf;  ///< Implications with this antecedent
+        std::vector<RuleSlot> consequentOf;  ///< Implications with this consequent
+        std::vector<RuleSlot> disjunctOf;    ///< Disjunctions containing this literal
+        std::vector<RuleSlot> clauseOf;      ///< N-ary clauses containing this literal
+    };
+
+    /// What was indexed for a slot, so it can be unindexed without the proposition
+    struct RuleRecord {
+        std::string key;             ///< Knowledge base key of the rule ("" if slot is free)
+        LogicalOperator relation;    ///< IMPLIES or OR (AND only for clauses)
+        bool clause;                 ///< Literals are in clauses_
+        PropId antecedent;           ///< Antecedent / left disjunct / first clause literal
+        PropId consequent;           ///< Consequent / right disjunct / last clause literal
+        PropId self;                 ///< The rule's own key as a literal (names it as a premise)
+    };
+
+    SymbolTable symbols_;                                  ///< Interned rule operands
+    std::vector<Occurrences> occurrences_;                 ///< PropId -> rules mentioning it
+    std::unordered_map<std::string, RuleSlot> slotByKey_;  ///< Rule key -> slot
+    std::vector<RuleRecord> rules_;                        ///< Slot -> indexed rule
+    std::vector<RuleSlot> freeSlots_;                      ///< Slots released by removeRule
+    ClauseStore clauses_;                                  ///< Literals of the n-ary clauses
+    std::vector<PropId> clauseScratch_;                    ///< Reused while interning a clause
+
+    static const std::vector<RuleSlot> kEmpty;
+
+    const Occurrences* findOccurrences(PropId id) const;
+    const Occurrences* findOccurrences(const std::string& name) const;
+    Occurrences& occurrences(PropId id);
+    static void eraseSlot(std::vector<RuleSlot>& slots, RuleSlot slot);
+    void indexRule(const std::string& key, const Proposition& prop);  ///< Index a rule whose key is not indexed
+
+public:
+    LiteralIndex() = default;
+    ~LiteralIndex() = default;
+    LiteralIndex(const LiteralIndex&) = default;
+    LiteralIndex& operator=(const LiteralIndex&) = default;
+    LiteralIndex(LiteralIndex&&) = default;
+    LiteralIndex& operator=(LiteralIndex&&) = default;
+
+    /// Check whether a proposition is a rule this index tracks: IMPLIES, OR, or an n-ary clause
+    static bool isIndexedRule(const Proposition& prop);
+
+    /// Check whether a proposition is an n-ary clause (OR or AND with operands)
+    static bool isClause(const Proposition& prop);
+
+    /**
+     * Index a rule under its knowledge base key. Replaces any rule previously
+     * indexed under the same key; non-rule propositions just unindex the key.
+     */
+    void addRule(const std::string& key, const Proposition& prop);
+
+    /// Remove the rule indexed under a key (returns false if none)
+    bool removeRule(const std::string& key);
+
+    /// Reindex every rule in a knowledge base (interned ids are kept)
+    void rebuild(const std::unordered_map<std::string, Proposition>& propositions);
+
+    /// Remove all rules and forget every interned symbol
+    void clear();
+
+    /// Symbols interned for the indexed rules
+    const SymbolTable& symbols() const;
+    SymbolTable& symbols();
+
+    /// Number of indexed rules
+    size_t ruleCount() const;
+
+    /// One past the highest slot ever handed out (size for per-slot vectors)
+    size_t slotCount() const;
+
+    /// Slot of the rule indexed under a key (returns false if none)
+    bool findSlot(const std::string& key, RuleSlot& slot) const;
+
+    /// Knowledge base key of the rule in a slot ("" if the slot is free)
+    const std::string& ruleKey(RuleSlot slot) const;
+
+    /// The rule's key interned as a literal, so compact provenance can cite the rule
+    PropId ruleLiteralOf(RuleSlot slot) const;
+
+    /// Antecedent (implication) or left disjunct (disjunction) of the rule in a slot
+    PropId antecedentOf(RuleSlot slot) const;
+
+    /// Consequent (implication) or right disjunct (disjunction) of the rule in a slot
+    PropId consequentOf(RuleSlot slot) const;
+
+    /// Check whether the rule in a slot is an n-ary clause
+    bool isClause(RuleSlot slot) const;
+
+    /// Literals of the n-ary clauses, by slot
+    const ClauseStore& clauses() const;
+
+    // ========== Lookups (polarity is significant) ==========
+
+    /// Implications whose antecedent is the given literal
+    const std::vector<RuleSlot>& implicationsWithAntecedent(PropId id) const;
+
+    /// Implications whose consequent is the given literal
+    const std::vector<RuleSlot>& implicationsWithConsequent(PropId id) const;
+
+    /// Disjunctions that contain the given literal
+    const std::vector<RuleSlot>& disjunctionsContaining(PropId id) const;
+
+    /// Disjunctions that contain the complement of the given literal
+    const std::vector<RuleSlot>& disjunctionsContainingComplement(PropId id) const;
+
+    /// N-ary clauses that contain the given literal
+    const std::vector<RuleSlot>& clausesContaining(PropId id) const;
+
+    // String forms of the lookups (empty if the name was never interned)
+    const std::vector<RuleSlot>& implicationsWithAntecedent(const std::string& name) const;
+    const std::vector<RuleSlot>& implicationsWithConsequent(const std::string& name) const;
+    const std::vector<RuleSlot>& disjunctionsContaining(const std::string& name) const;
+    const std::vector<RuleSlot>& disjunctionsContainingComplement(const std::string& name) const;
+};
+
+#endif // LITERAL_INDEX_H
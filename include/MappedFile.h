@@ -0,0 +1,75 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * MappedFile exposes a file's bytes as a read-only std::string_view.
+ *
+ * On POSIX systems the file is memory-mapped, so opening a large file costs
+ * no copy and the kernel pages bytes in as they are read. Elsewhere the file
+ * is read into an owned buffer. Views into contents() stay valid until the
+ * MappedFile is closed or destroyed.
+ *
+ * Usage:
+ *   MappedFile file;
+ *   if (file.open("rules.txt")) {
+ *       std::string_view bytes = file.contents();
+ *   }
+ */
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;    ///< data_ is a mapping (otherwise it points into buffer_)
+    bool open_ = false;
+    std::string buffer_;     ///< Fallback storage when the file cannot be mapped
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Map a file, closing any file already open. Returns false if it cannot be read.
+    bool open(const std::string& path);
+
+    /// Release the mapping
+    void close();
+
+    /// True if a file is open (an empty file is open with empty contents)
+    bool isOpen() const;
+
+    /// The file's bytes
+    std::string_view contents() const;
+
+    /// Size of the file in bytes
+    size_t size() const;
+};
+
+/**
+ * Call onLine for every line of text, without the line terminator.
+ * Like std::getline, a final '\n' does not start an extra empty line;
+ * a '\r' before the '\n' is kept.
+ */
+template <typename OnLine>
+void forEachLine(std::string_view text, OnLine onLine) {
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            onLine(text.substr(start));
+            return;
+        }
+        onLine(text.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,66 @@
+#ifndef OUTPUT_FILE_H
+#define OUTPUT_FILE_H
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/**
+ * OutputFile is an std::ostream that writes to a C stdio stream through its
+ * own buffer, handing the bytes over in large fwrite() calls.
+ *
+ * A report can be written straight to its destination as it is produced
+ * instead of being assembled in memory first. Write errors are sticky:
+ * once one fails, good() is false and nothing more is written.
+ *
+ * Usage:
+ *   OutputFile out;
+ *   if (out.open("report.txt")) {
+ *       engine.writeResults(out, filter);
+ *       out.close();
+ *   }
+ */
+class OutputFile : public std::ostream {
+private:
+    class Buffer : public std::streambuf {
+    public:
+        std::FILE* file = nullptr;
+        std::vector<char> bytes;
+
+        /// Hand the buffered bytes to fwrite(); false if it fails
+        bool drain();
+
+        /// Stop writing to the FILE
+        void release();
+
+    protected:
+        int_type overflow(int_type ch) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        int sync() override;
+    };
+
+    Buffer buffer_;
+    bool owned_ = false;     ///< The FILE was opened here and is closed here
+
+public:
+    /// Default buffer size in bytes
+    static constexpr size_t kBufferSize = 1 << 16;
+
+    OutputFile();
+    /// Write to an already open stream (not closed by OutputFile), e.g. stdout
+    explicit OutputFile(std::FILE* file, size_t bufferSize = kBufferSize);
+    ~OutputFile() override;
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    /// Create or truncate a file, closing any file already open. Returns false if it cannot.
+    bool open(const std::string& path, size_t bufferSize = kBufferSize);
+
+    /// Flush and close (an unowned FILE is only flushed). Returns false if any write failed.
+    bool close();
+};
+
+#endif // OUTPUT_FILE_H
@@ -4,7 +4,10 @@
 #include "Expression.h"
 #include "Lexer.h"
 #include "Proposition.h"
+#include "WorkStealingPool.h"
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <functional>
 #include <vector>
@@ -31,7 +34,8 @@ using RelationHandler = std::function<bool(
  * Parser class responsible for parsing input files and producing propositions.
  * 
  * Supports extensible relation types through a registry pattern.
- * Built-in relations: implies, some, not, discovered
+ * Built-in relations: implies, some, not, discovered, and the n-ary clauses
+ * or and and ("c1, or(a, ~b, c)"), which are keyed by their prefix
  * 
  * Usage:
  *   Parser parser;
@@ -43,11 +47,53 @@ using RelationHandler = std::function<bool(
  *       return true;
  *   });
  *   auto propositions = parser.parseAssumptionsFile("file.txt");
+ *
+ * Files are memory-mapped and parsed in place: lines and tokens are views
+ * into the mapped bytes, and names are copied once, into the strings that
+ * store them.
  */
 class Parser {
+public:
+    /**
+     * A truth value set by a facts line, with the value it replaced.
+     */
+    struct FactAssignment {
+        std::string name;
+        Tripartite previous;
+        Tripartite value;
+    };
+
+    /**
+     * Configuration options for the parser.
+     */
+    struct Options {
+        /// Threads for parsing assumptions and facts (0 = one per hardware thread).
+        /// With more than one, text longer than chunkBytes is split at line
+        /// boundaries; chunks are lexed and parsed concurrently and merged in
+        /// file order, so the result and diagnostics equal a serial parse.
+        /// Relation handlers then run concurrently, each on a map of its own
+        /// line's output, so they must be thread-safe and only add entries.
+        size_t threads = 1;
+
+        size_t chunkBytes = size_t(1) << 20;  ///< Target bytes per parallel chunk
+
+        Options() = default;
+    };
+
 private:
+    /// Reusable buffers for splitting one assumptions line
+    struct LineScratch;
+
+    /// Parsed output of one chunk of a parallel load
+    struct AssumptionsChunk;
+    struct FactsChunk;
+
     std::unordered_map<std::string, RelationHandler> relationHandlers_;
+    Options options_;
+    std::shared_ptr<WorkStealingPool> pool_;  ///< Created on the first parallel load
     Lexer lexer_;  ///< Lexer for tokenizing input
+    std::vector<LexerTokenView> lineTokens_;  ///< Reused token buffer for facts lines
+    std::string nameBuffer_;                  ///< Reused key for proposition lookups
     
     // Initialize built-in relation handlers
     void registerBuiltinHandlers();
@@ -69,31 +115,94 @@ private:
                                  const std::vector<std::string>& args,
                                  std::unordered_map<std::string, Proposition>& propositions);
 
+    static bool handleOr(const std::string& prefix,
+                         const std::vector<std::string>& args,
+                         std::unordered_map<std::string, Proposition>& propositions);
+
+    static bool handleAnd(const std::string& prefix,
+                          const std::vector<std::string>& args,
+                          std::unordered_map<std::string, Proposition>& propositions);
+
+    /// Store an or/and clause over args (one literal each) under its prefix
+    static bool storeClause(const std::string& prefix, LogicalOperator relation,
+                            const std::vector<std::string>& args,
+                            std::unordered_map<std::string, Proposition>& propositions);
+
     // ========== Expression Parsing Helpers ==========
     
     /// Convert lexer TokenType to LogicalOperator
     static LogicalOperator tokenTypeToLogicalOperator(TokenType type);
     
-    /// Build an Expression from a vector of lexer tokens
-    /// @param tokens The tokens to parse (should not include assignment target)
+    using TokenIterator = std::vector<LexerTokenView>::const_iterator;
+
+    /// Build an Expression from a range of lexer tokens
+    /// @param begin, end The tokens to parse (should not include assignment target)
     /// @param propositions Map to look up proposition truth values
     /// @param prefix Optional prefix for the resulting expression
-    static Expression buildExpression(const std::vector<LexerToken>& tokens,
+    static Expression buildExpression(TokenIterator begin, TokenIterator end,
                                       const std::unordered_map<std::string, Proposition>& propositions,
                                       const std::string& prefix = "");
     
+    /// Split "prefix, relation(arg, ...)" into views of the line
+    /// @return false if the line is not in that form
+    static bool splitAssumptionLine(std::string_view line, std::string_view& prefix,
+                                    std::string_view& relation, std::vector<std::string_view>& args);
+    
+    /// Split a line and run its relation handler, reporting problems to errors
+    void parseAssumptionLine(std::string_view line, LineScratch& scratch,
+                             std::unordered_map<std::string, Proposition>& propositions,
+                             std::ostream& errors) const;
+    
+    /// Apply one lexed facts line to the knowledge base
+    void applyFactsTokens(TokenIterator begin, TokenIterator end,
+                          std::unordered_map<std::string, Proposition>& propositions,
+                          std::vector<Expression>& expressions,
+                          std::vector<FactAssignment>* assignments);
+    
+    /// Set the truth value of a named proposition, logging it if assignments is not null
+    void assignFact(std::string_view name, Tripartite value,
+                    std::unordered_map<std::string, Proposition>& propositions,
+                    std::vector<FactAssignment>* assignments);
+    
+    /// Threads a load of this many bytes uses (1 = serial)
+    size_t loadThreads(size_t bytes) const;
+    
+    /// Pool with the given number of threads
+    WorkStealingPool& pool(size_t threads);
+    
+    /// Chunked loads: parse waves of chunks concurrently, merge each wave in order
+    void parseAssumptionsParallel(std::string_view text,
+                                  std::unordered_map<std::string, Proposition>& propositions,
+                                  size_t threads);
+    void parseFactsParallel(std::string_view text,
+                            std::unordered_map<std::string, Proposition>& propositions,
+                            std::vector<Expression>& expressions, size_t threads,
+                            std::vector<FactAssignment>* assignments);
+    
+    /// Proposition stored under a name, created if missing (copies the name only then)
+    Proposition& propositionNamed(std::string_view name,
+                                  std::unordered_map<std::string, Proposition>& propositions);
+    
     /// Parse a single line from facts file
     /// @param line The line to parse
     /// @param propositions Map to update with truth values
     /// @param expressions Vector to add compound expressions to
-    void parseFactsLine(const std::string& line,
+    void parseFactsLine(std::string_view line,
                         std::unordered_map<std::string, Proposition>& propositions,
-                        std::vector<Expression>& expressions);
+                        std::vector<Expression>& expressions,
+                        std::vector<FactAssignment>* assignments);
 
 public:
     Parser();
+    explicit Parser(const Options& opts);
     ~Parser() = default;
 
+    /// Set parser options
+    void setOptions(const Options& opts);
+
+    /// Get current parser options
+    const Options& getOptions() const;
+
     /**
      * Register a custom relation handler.
      * 
@@ -134,6 +243,15 @@ public:
      */
     std::unordered_map<std::string, Proposition> parseAssumptionsFile(const std::string& filename);
 
+    /**
+     * Parse assumptions from text already in memory, one per line.
+     * 
+     * @param text The assumptions, in the file format
+     * @param propositions Map to add the propositions to
+     */
+    void parseAssumptions(std::string_view text,
+                          std::unordered_map<std::string, Proposition>& propositions);
+
     /**
      * Parse a facts file and update truth values of existing propositions.
      * Now supports full expression syntax including:
@@ -159,6 +277,19 @@ public:
                         std::unordered_map<std::string, Proposition>& propositions,
                         std::vector<Expression>& expressions);
 
+    /**
+     * Parse facts from text already in memory, one per line.
+     * 
+     * @param text The facts, in the file format
+     * @param propositions Existing propositions map to update
+     * @param expressions Vector to populate with parsed expressions
+     * @param assignments If not null, receives every truth value set, in order
+     */
+    void parseFacts(std::string_view text,
+                    std::unordered_map<std::string, Proposition>& propositions,
+                    std::vector<Expression>& expressions,
+                    std::vector<FactAssignment>* assignments = nullptr);
+
     /**
      * Parse an expression string and return an Expression object.
      * 
@@ -1,22 +1,88 @@
 #ifndef PROPOSITION_H
 #define PROPOSITION_H
 
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 /**
  * Enum class to represent logical operators for propositions.
  * LPAREN and RPAREN are used for grouping in expressions.
  */
-enum class LogicalOperator { NONE, AND, OR, NOT, IMPLIES, EQUIVALENT, LPAREN, RPAREN };
+enum class LogicalOperator : uint8_t { NONE, AND, OR, NOT, IMPLIES, EQUIVALENT, LPAREN, RPAREN };
 
 /**
  * Enum to represent a three-valued logic: true, false, unknown.
+ * The values are 0, 1 and 2, so each fits in two bits and indexes truth tables directly.
  */
-enum class Tripartite { TRUE = 0, FALSE = 1, UNKNOWN = -1 };
+enum class Tripartite : uint8_t { TRUE = 0, FALSE = 1, UNKNOWN = 2 };
+
+/// Number of Tripartite values (the extent of each truth table axis)
+constexpr size_t kTripartiteValues = 3;
+
+/**
+ * The binary connectives, in truth table order.
+ */
+enum class Connective : uint8_t { AND, OR, IMPLIES, EQUIVALENT };
+
+/// Number of binary connectives
+constexpr size_t kConnectiveCount = 4;
+
+/**
+ * A connective's value worked out case by case. Only used at compile time to
+ * fill kTruthTables, which is what evaluation reads.
+ */
+constexpr Tripartite connectiveByCases(Connective connective, Tripartite left, Tripartite right) {
+  const Tripartite T = Tripartite::TRUE, F = Tripartite::FALSE, U = Tripartite::UNKNOWN;
+  switch (connective) {
+    case Connective::AND:
+      return (left == F || right == F) ? F : (left == U || right == U) ? U : T;
+    case Connective::OR:
+      return (left == T || right == T) ? T : (left == U || right == U) ? U : F;
+    case Connective::IMPLIES:
+      return (left == F || right == T) ? T : (left == T && right == F) ? F : U;
+    case Connective::EQUIVALENT:
+      // Both directions of the implication must hold; unknown is not equivalent
+      return (connectiveByCases(Connective::IMPLIES, left, right) == T &&
+              connectiveByCases(Connective::IMPLIES, right, left) == T) ? T : F;
+  }
+  return U;
+}
+
+/// Truth tables of the binary connectives, indexed [connective][left][right]
+using TruthTable = std::array<std::array<Tripartite, kTripartiteValues>, kTripartiteValues>;
+inline constexpr std::array<TruthTable, kConnectiveCount> kTruthTables = [] {
+  std::array<TruthTable, kConnectiveCount> tables{};
+  for (size_t c = 0; c < kConnectiveCount; ++c) {
+    for (size_t l = 0; l < kTripartiteValues; ++l) {
+      for (size_t r = 0; r < kTripartiteValues; ++r) {
+        tables[c][l][r] = connectiveByCases(static_cast<Connective>(c), static_cast<Tripartite>(l),
+                                            static_cast<Tripartite>(r));
+      }
+    }
+  }
+  return tables;
+}();
+
+/// Negation table, indexed by value
+inline constexpr std::array<Tripartite, kTripartiteValues> kNotTable = {
+    Tripartite::FALSE, Tripartite::TRUE, Tripartite::UNKNOWN};
+
+/**
+ * @brief Apply a binary connective by table lookup.
+ */
+constexpr Tripartite applyConnective(Connective connective, Tripartite left, Tripartite right) {
+  return kTruthTables[static_cast<size_t>(connective)][static_cast<size_t>(left)]
+                     [static_cast<size_t>(right)];
+}
 
 /**
  * @overload operator&&
@@ -25,7 +91,9 @@ enum class Tripartite { TRUE = 0, FALSE = 1, UNKNOWN = -1 };
  * @param right The right Tripartite value
  * @return True if both values are true, false otherwise
  */
-Tripartite operator&&(Tripartite left, Tripartite right);
+constexpr Tripartite operator&&(Tripartite left, Tripartite right) {
+  return applyConnective(Connective::AND, left, right);
+}
 
 /**
  * @overload operator||
@@ -34,7 +102,9 @@ Tripartite operator&&(Tripartite left, Tripartite right);
  * @param right The right Tripartite value
  * @return True if either value is true, false otherwise
  */
-Tripartite operator||(Tripartite left, Tripartite right);
+constexpr Tripartite operator||(Tripartite left, Tripartite right) {
+  return applyConnective(Connective::OR, left, right);
+}
 
 /**
  * @overload operator!
@@ -42,7 +112,9 @@ Tripartite operator||(Tripartite left, Tripartite right);
  * @param value The Tripartite value to negate
  * @return The negated Tripartite value
  */
-Tripartite operator!(Tripartite value);
+constexpr Tripartite operator!(Tripartite value) {
+  return kNotTable[static_cast<size_t>(value)];
+}
 
 /**
  * @overload implies
@@ -51,12 +123,26 @@ Tripartite operator!(Tripartite value);
  * @param right The right Tripartite value
  * @return True if left implies right, false otherwise
  */
-Tripartite implies(Tripartite left, Tripartite right);
+constexpr Tripartite implies(Tripartite left, Tripartite right) {
+  return applyConnective(Connective::IMPLIES, left, right);
+}
+
+/**
+ * @brief Biconditional: TRUE only when both directions of the implication hold.
+ */
+constexpr Tripartite equivalent(Tripartite left, Tripartite right) {
+  return applyConnective(Connective::EQUIVALENT, left, right);
+}
+
+static_assert((Tripartite::UNKNOWN && Tripartite::FALSE) == Tripartite::FALSE);
+static_assert((Tripartite::UNKNOWN || Tripartite::TRUE) == Tripartite::TRUE);
+static_assert(implies(Tripartite::UNKNOWN, Tripartite::FALSE) == Tripartite::UNKNOWN);
+static_assert(equivalent(Tripartite::UNKNOWN, Tripartite::UNKNOWN) == Tripartite::FALSE);
 
 /**
  * Enum to represent quantifiers for propositions.
  */
-enum class Quantifier {
+enum class Quantifier : uint8_t {
   UNIVERSAL_AFFIRMATIVE,
   UNIVERSAL_NEGATIVE,
   PARTICULAR_AFFIRMATIVE,
@@ -64,29 +150,111 @@ enum class Quantifier {
   NONE
 };
 
+/**
+ * Inference rules the engine can record as the source of a truth value.
+ * CUSTOM covers any other name given to InferenceProvenance.
+ */
+enum class InferenceRule : uint8_t {
+  CUSTOM,
+  MODUS_PONENS,
+  MODUS_TOLLENS,
+  HYPOTHETICAL_SYLLOGISM,
+  DISJUNCTIVE_SYLLOGISM,
+  RESOLUTION,
+  SIMPLIFICATION
+};
+
+/**
+ * Display name of a built-in rule (e.g., "ModusPonens"); "" for CUSTOM.
+ * The names have static storage.
+ */
+constexpr std::string_view inferenceRuleName(InferenceRule rule) {
+  switch (rule) {
+    case InferenceRule::MODUS_PONENS: return "ModusPonens";
+    case InferenceRule::MODUS_TOLLENS: return "ModusTollens";
+    case InferenceRule::HYPOTHETICAL_SYLLOGISM: return "HypotheticalSyllogism";
+    case InferenceRule::DISJUNCTIVE_SYLLOGISM: return "DisjunctiveSyllogism";
+    case InferenceRule::RESOLUTION: return "Resolution";
+    case InferenceRule::SIMPLIFICATION: return "Simplification";
+    case InferenceRule::CUSTOM: break;
+  }
+  return "";
+}
+
+/// Built-in rule with the given display name, or CUSTOM
+InferenceRule inferenceRuleFromName(std::string_view name);
+
+/**
+ * Rule name with static storage: the built-in name if it is one, otherwise
+ * the name interned for the life of the process.
+ */
+std::string_view internRuleName(const std::string& name);
+
 /**
  * InferenceProvenance tracks how a truth value was derived.
  * Used for explanation generation and debugging inference chains.
+ *
+ * Full provenance names its premises and records when it was made. Compact
+ * provenance, built with the InferenceRule-only constructor, keeps just the
+ * rule and up to kMaxPremiseIds premise literals (PropIds of the engine's
+ * symbol table); it reads no clock and allocates nothing.
  */
 struct InferenceProvenance {
-  std::string ruleFired;              ///< Name of the inference rule (e.g., "ModusPonens")
+  static constexpr size_t kMaxPremiseIds = 3;
+
+  InferenceRule rule;                 ///< Rule that fired (CUSTOM for other names)
+  std::string_view ruleFired;         ///< Name of the inference rule (e.g., "ModusPonens")
   std::vector<std::string> premises;  ///< Names of propositions used as premises
+  std::array<uint32_t, kMaxPremiseIds> premiseIds;  ///< Compact: premise literals
+  uint8_t premiseIdCount;             ///< Compact: number of premiseIds used
   std::chrono::steady_clock::time_point timestamp;  ///< When the inference was made
   float confidence;                   ///< Confidence score (0.0 to 1.0)
 
   InferenceProvenance()
-      : ruleFired(""),
+      : rule(InferenceRule::CUSTOM),
+        ruleFired(""),
         premises(),
+        premiseIds(),
+        premiseIdCount(0),
         timestamp(std::chrono::steady_clock::now()),
         confidence(1.0f) {}
 
-  InferenceProvenance(const std::string& rule,
+  InferenceProvenance(const std::string& name,
                       const std::vector<std::string>& prem,
                       float conf = 1.0f)
-      : ruleFired(rule),
+      : rule(inferenceRuleFromName(name)),
+        ruleFired(internRuleName(name)),
         premises(prem),
+        premiseIds(),
+        premiseIdCount(0),
         timestamp(std::chrono::steady_clock::now()),
         confidence(conf) {}
+
+  InferenceProvenance(InferenceRule rule, std::vector<std::string> prem, float conf = 1.0f)
+      : rule(rule),
+        ruleFired(inferenceRuleName(rule)),
+        premises(std::move(prem)),
+        premiseIds(),
+        premiseIdCount(0),
+        timestamp(std::chrono::steady_clock::now()),
+        confidence(conf) {}
+
+  /// Compact provenance: no premise names and no timestamp
+  explicit InferenceProvenance(InferenceRule rule)
+      : rule(rule),
+        ruleFired(inferenceRuleName(rule)),
+        premises(),
+        premiseIds(),
+        premiseIdCount(0),
+        timestamp(),
+        confidence(1.0f) {}
+
+  /// Record a premise literal of compact provenance (ignored past kMaxPremiseIds)
+  void addPremiseId(uint32_t id) {
+    if (premiseIdCount < kMaxPremiseIds) {
+      premiseIds[premiseIdCount++] = id;
+    }
+  }
 };
 
 /**
@@ -101,35 +269,68 @@ struct Conflict {
   std::chrono::steady_clock::time_point timestamp;  ///< When the conflict occurred
 
   Conflict(Tripartite oldVal, Tripartite newVal,
-           const InferenceProvenance& oldProv,
+           InferenceProvenance oldProv,
            const InferenceProvenance& newProv)
       : oldValue(oldVal),
         newValue(newVal),
-        oldProvenance(oldProv),
+        oldProvenance(std::move(oldProv)),
         newProvenance(newProv),
         timestamp(std::chrono::steady_clock::now()) {}
 };
 
+/**
+ * How much of its conflict history a proposition keeps.
+ */
+enum class ConflictRecording : uint8_t {
+  OFF,     ///< Nothing; hasConflicts() stays false
+  COUNT,   ///< Only how many conflicts occurred
+  RECENT,  ///< The count and the most recent conflicts, up to a limit
+  ALL      ///< The count and every conflict
+};
+
 /**
  * Class to represent a logical proposition with a prefix, relation, antecedent,
  * subject, consequent, predicate, and truth value.
+ *
+ * Most propositions in a knowledge base are plain facts, so only the prefix and
+ * the one-byte enums live inline. The relation's terms and the inference history
+ * are side records allocated the first time one is set; a fact costs one
+ * string and two null pointers.
+ *
+ * Each proposition owns its side records (a copy deep-copies them), because
+ * propositions are values that callers copy out of and into the knowledge base.
+ * They are not columns of a shared store, and there is no arena to reset: a
+ * rule with provenance still makes its own heap allocations.
  */
 class Proposition {
  private:
-  std::string prefix;        ///< Symbol or identifier (e.g., "n")
-  LogicalOperator relation;  ///< Type of relation (e.g., IMPLIES, NOT)
-  std::string antecedent;    ///< The antecedent in a relation (e.g., "big-bang")
-  Tripartite antecedentAssertion;  ///< Assertion of the antecedent
-  std::string subject;             ///< Context (e.g., "occurred")
-  std::string consequent;    ///< Consequent in a relation (e.g., "microwave-radiation")
-  Tripartite consequentAssertion;  ///< Assertion of the consequent
-  std::string predicate;           ///< State or outcome (e.g., "present")
+  /// Terms of a relation (allocated when any of them is set)
+  struct Terms {
+    std::string antecedent;   ///< The antecedent in a relation (e.g., "big-bang")
+    std::string subject;      ///< Context (e.g., "occurred")
+    std::string consequent;   ///< Consequent in a relation (e.g., "microwave-radiation")
+    std::string predicate;    ///< State or outcome (e.g., "present")
+    std::vector<std::string> operands;  ///< Literals of an n-ary OR / AND clause
+  };
+
+  /// Inference tracking (allocated when the value is derived or overwritten)
+  struct History {
+    std::optional<InferenceProvenance> provenance;  ///< How current truth value was derived
+    std::vector<Conflict> conflicts;                ///< History of value conflicts, oldest first
+    size_t conflictCount = 0;                       ///< Conflicts recorded, including those dropped
+  };
+
+  std::string prefix;              ///< Symbol or identifier (e.g., "n")
   Tripartite truth_value;          ///< Truth value of the proposition
+  LogicalOperator relation;        ///< Type of relation (e.g., IMPLIES, NOT)
   Quantifier proposition_scope;    ///< Scope of the proposition
+  Tripartite antecedentAssertion;  ///< Assertion of the antecedent
+  Tripartite consequentAssertion;  ///< Assertion of the consequent
+  std::unique_ptr<Terms> terms_;
+  std::unique_ptr<History> history_;
 
-  // Inference tracking
-  std::optional<InferenceProvenance> provenance_;  ///< How current truth value was derived
-  std::vector<Conflict> conflicts_;                ///< History of value conflicts
+  Terms& terms();
+  History& history();
 
  public:
   ///> Default constructor
@@ -141,6 +342,10 @@ class Proposition {
   ///> Simplified constructor for propositions with a prefix and truth value
   Proposition(const std::string& prefix, Tripartite truth_value);
 
+  Proposition(const Proposition& other);
+  Proposition(Proposition&& other) noexcept = default;
+  ~Proposition() = default;
+
   // Setters for updates
   void setPrefix(const std::string& p);
   void setRelation(LogicalOperator rel);
@@ -150,19 +355,27 @@ class Proposition {
   void setConsequent(const std::string& cons);
   void setConsequentAssertion(Tripartite assert);
   void setPredicate(const std::string& pred);
+  /// Make this an n-ary clause over the given literals (relation OR or AND);
+  /// such a rule has no antecedent or consequent
+  void setOperands(std::vector<std::string> ops);
   void setTruthValue(Tripartite value);
   void setTruthValue(Tripartite value, const InferenceProvenance& provenance);
+  /// Set a derived value, keeping as much conflict history as recording asks
+  /// for (RECENT keeps the last limit conflicts)
+  void setTruthValue(Tripartite value, const InferenceProvenance& provenance,
+                     ConflictRecording recording, size_t limit);
   void setPropositionScope(Quantifier scope);
 
   // Getters
-  std::string getPrefix() const;
+  const std::string& getPrefix() const;
   LogicalOperator getRelation() const;
-  std::string getAntecedent() const;
+  const std::string& getAntecedent() const;
   Tripartite getAntecedentAssertion() const;
-  std::string getSubject() const;
-  std::string getConsequent() const;
+  const std::string& getSubject() const;
+  const std::string& getConsequent() const;
   Tripartite getConsequentAssertion() const;
-  std::string getPredicate() const;
+  const std::string& getPredicate() const;
+  const std::vector<std::string>& getOperands() const;  ///< Empty unless an n-ary clause
   Tripartite getTruthValue() const;
   Quantifier getPropositionScope() const;
 
@@ -170,6 +383,7 @@ class Proposition {
   const std::optional<InferenceProvenance>& getProvenance() const;
   bool hasProvenance() const;
   const std::vector<Conflict>& getConflicts() const;
+  size_t getConflictCount() const;  ///< Conflicts recorded, including any no longer kept
   bool hasConflicts() const;
   void clearConflicts();
 
@@ -193,6 +407,7 @@ class Proposition {
       const Proposition& other) const;  ///> Logical IMPLIES operator
 
   Proposition& operator=(const Proposition& other);  ///> Assignment operator
+  Proposition& operator=(Proposition&& other) noexcept = default;  ///> Move assignment
 
   friend std::ostream& operator<<(
       std::ostream& out,
@@ -4,12 +4,25 @@
 #include "Expression.h"
 #include "Parser.h"
 #include "InferenceEngine.h"
+#include "LiteralIndex.h"
+#include "ResultIndex.h"
+#include "TraceGraph.h"
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
+#include <string_view>
 #include <functional>
 
+class RuleBase;
+
 /**
  * Sorting options for result output.
  */
@@ -21,6 +34,15 @@ enum class ResultSortOrder {
     BY_DERIVATION   ///< Group by derivation (derived first, then axioms)
 };
 
+/**
+ * Output formats for writeResults().
+ */
+enum class ResultFormat {
+    TEXT,   ///< Human-readable report (formatResults() layout)
+    JSON,   ///< One JSON document: summary fields and a "results" array
+    NDJSON  ///< One JSON object per result, one per line
+};
+
 /**
  * Filter criteria for result output.
  * Use to limit and organize output from formatResults().
@@ -52,6 +74,7 @@ struct ResultFilter {
     size_t limit = 0;           ///< Max results to return (0 = unlimited)
     bool includeTraces = false; ///< Include inference traces in output
     bool showProvenance = true; ///< Show "[derived via X]" annotations
+    ResultFormat format = ResultFormat::TEXT; ///< Output format of writeResults()/formatResults()
     
     // Custom filter function (optional)
     std::function<bool(const std::string&, const Proposition&)> customFilter;
@@ -84,6 +107,10 @@ struct ResultFilter {
         includeTraces = traces;
         return *this;
     }
+    ResultFilter& withFormat(ResultFormat f) {
+        format = f;
+        return *this;
+    }
     ResultFilter& derivedOnly() {
         showDerived = true; showAxioms = false;
         return *this;
@@ -123,22 +150,82 @@ struct ResultFilter {
 };
 
 /**
- * InferenceStep represents a single step in an inference trace.
- * Used to explain how a proposition's truth value was derived.
+ * A proposition whose truth value changed while a batch of streamed facts
+ * was applied and deduced.
  */
-struct InferenceStep {
-    std::string proposition;              ///< The proposition that was derived
-    Tripartite truthValue;                ///< The truth value that was derived
-    std::string rule;                     ///< The inference rule used (e.g., "ModusPonens")
-    std::vector<std::string> premises;    ///< The premises used in this step
-    int depth;                            ///< Depth in the inference chain (0 = target)
-    
-    InferenceStep() 
-        : proposition(""), truthValue(Tripartite::UNKNOWN), rule(""), premises(), depth(0) {}
-    
-    InferenceStep(const std::string& prop, Tripartite value, 
-                  const std::string& r, const std::vector<std::string>& prem, int d)
-        : proposition(prop), truthValue(value), rule(r), premises(prem), depth(d) {}
+struct PropositionChange {
+    std::string name;
+    Tripartite before;  ///< Value before the batch
+    Tripartite after;   ///< Value after the batch and its deduction
+};
+
+/**
+ * The answer to one goal (see Ratiocinator::query).
+ */
+struct QueryResult {
+    std::string name;
+    Tripartite value = Tripartite::UNKNOWN;
+    std::optional<InferenceProvenance> provenance;  ///< How the value was derived (empty for facts and UNKNOWN)
+    size_t rulesConsidered = 0;  ///< Rules and expressions that could influence the goal
+    size_t derivedCount = 0;     ///< Values derived to reach the answer
+};
+
+/**
+ * Batching options for streamed facts (see Ratiocinator::ingest).
+ */
+struct IngestOptions {
+    size_t batchSize = 256;                   ///< Lines per batch (0 = only flush() applies them)
+    std::chrono::milliseconds maxLatency{0};  ///< Apply once the oldest buffered line is this old (0 = no bound)
+
+    IngestOptions() = default;
+};
+
+/**
+ * KnowledgeView is an immutable version of a knowledge base, published by a
+ * Ratiocinator after each deduction (see Ratiocinator::setSnapshotPublishing).
+ *
+ * A published view never changes, so any number of threads can query it
+ * without locking while the writer deduces the next version. It stays valid
+ * for as long as a handle to it is held, however many versions follow.
+ *
+ * Usage:
+ *   std::shared_ptr<const KnowledgeView> view = engine.snapshot();
+ *   Tripartite value = view->getPropositionTruthValue("B");
+ */
+class KnowledgeView {
+private:
+    friend class Ratiocinator;
+
+    std::unordered_map<std::string, Proposition> propositions_;
+    std::shared_ptr<const SymbolTable> symbols_;   // Resolves compact premise literals
+    uint64_t version_ = 0;
+
+public:
+    KnowledgeView() = default;
+
+    /// Publication number (0 for the empty view before the first publication)
+    uint64_t getVersion() const;
+
+    /// Get the truth value of a proposition (returns UNKNOWN if not found)
+    Tripartite getPropositionTruthValue(const std::string& name) const;
+
+    /// Get a proposition by name (returns nullptr if not found)
+    const Proposition* getProposition(const std::string& name) const;
+
+    /// Check if a proposition exists
+    bool hasProposition(const std::string& name) const;
+
+    /// Get the number of propositions
+    size_t getPropositionCount() const;
+
+    /// Get all propositions
+    const std::unordered_map<std::string, Proposition>& getPropositions() const;
+
+    /// Same as Ratiocinator::getFilteredPropositionNames() for this version
+    std::vector<std::string> getFilteredPropositionNames(const ResultFilter& filter) const;
+
+    /// Same as Ratiocinator::traceInference() for this version
+    std::vector<InferenceStep> traceInference(const std::string& name) const;
 };
 
 /**
@@ -161,12 +248,95 @@ private:
     InferenceEngine inferenceEngine_;                            // Handles logical deduction
     std::unordered_map<std::string, Proposition> propositions_; // Knowledge base
     std::vector<Expression> expressions_;                       // Expressions to evaluate
+    
+    // Literal -> rule index, kept in step with propositions_ by every mutator.
+    // Handing out a mutable Proposition* may change a rule behind our back, so
+    // that marks the index stale and it is rebuilt before it is next used.
+    mutable LiteralIndex literalIndex_;
+    mutable bool literalIndexStale_ = false;
+
+    // Secondary indexes for filtered results. Names whose entries changed are
+    // queued and applied when the index is next used; bulk changes mark it
+    // stale and it is rebuilt instead.
+    mutable ResultIndex resultIndex_;
+    mutable bool resultIndexStale_ = true;
+    mutable std::vector<std::string> resultIndexPending_;
+
+    // Derivation DAG shared by every trace until the knowledge base next changes
+    mutable TraceGraph traces_;
+    mutable bool tracesStale_ = true;
+
+    // Truth maintenance for deduceIncremental(): what changed since the last
+    // deduction, and which derived propositions cite each premise. Dependents
+    // lists may hold stale names; they are checked against provenance on use.
+    std::vector<std::string> pendingChanges_;       // Names to propagate from
+    std::vector<std::string> pendingRetractions_;   // Premises whose old values no longer hold
+    std::unordered_map<std::string, std::vector<std::string>> dependents_;
+    bool fullDeductionNeeded_ = true;
+
+    // Streaming ingestion: facts lines buffered until the next batch is applied
+    IngestOptions ingestOptions_;
+    std::string ingestBuffer_;                              // Buffered lines, each ending in '\n'
+    size_t ingestLines_ = 0;
+    std::chrono::steady_clock::time_point ingestStarted_;   // When the oldest buffered line arrived
+    std::function<void(const std::vector<PropositionChange>&)> onChange_;
+
+    // Read snapshots: the latest published view, swapped with the atomic
+    // shared_ptr operations so readers never wait for a deduction, and the
+    // symbol table shared by successive views until it changes
+    std::shared_ptr<const KnowledgeView> published_ = std::make_shared<const KnowledgeView>();
+    std::shared_ptr<const SymbolTable> publishedSymbols_;
+    uint64_t publishedVersion_ = 0;
+    bool publishing_ = false;
+
+    /// Publish a new view if snapshot publishing is enabled
+    void publishIfEnabled();
+
+    /// Values before a batch of every proposition the batch touched
+    struct ChangeTracker;
+
+    /// deduceIncremental(), recording what it touches in tracker (if not null)
+    void deduceIncremental(ChangeTracker* tracker);
+
+    /// Rebuild the literal index if a mutable accessor may have invalidated it
+    void refreshLiteralIndex() const;
+
+    /// Warn on stderr if the last engine call stopped before a fixed point
+    void reportConvergence() const;
+
+    /// The result index, brought up to date with propositions_
+    const ResultIndex& resultIndex() const;
+
+    /// Queue a proposition whose value, provenance or existence changed for the result index
+    void noteIndexed(const std::string& name);
+
+    /// Mark the result index for a rebuild (after changes it was not told about)
+    void invalidateResultIndex();
+
+    /// The trace graph, reset first if the knowledge base changed since it was built
+    TraceGraph& traceGraph() const;
+
+    /// Record that a proposition is about to be replaced or removed
+    void noteReplaced(const std::string& name, const Proposition& before);
+
+    /// Record a truth value change of a proposition
+    void noteValueChange(const std::string& name, Tripartite before, Tripartite after);
+
+    /// Record a proposition that was added (operands of rules are propagated from)
+    void noteAdded(const std::string& name, const Proposition& prop);
+
+    /// Queue the literals a rule mentions (antecedent and consequent, or clause operands)
+    void noteRuleOperands(const Proposition& rule);
+
+    /// Premise names of a provenance record, resolving compact premise literals
+    std::vector<std::string> premiseNames(const InferenceProvenance& provenance) const;
+
+    /// Index a derived proposition under each of its premises
+    void recordDependents(const std::string& name, const Proposition& prop);
+
+    /// Forget pending changes and rebuild the dependents index from provenance
+    void resetTruthMaintenance();
 
-    /// Helper for recursive inference tracing
-    void traceInferenceRecursive(const std::string& name,
-                                  std::vector<InferenceStep>& trace,
-                                  std::unordered_set<std::string>& visited,
-                                  int depth) const;
 
 public:
     Ratiocinator() = default;
@@ -183,6 +353,158 @@ public:
     /// Run the inference engine to deduce all possible truth values
     void deduce();
     
+    /**
+     * deduce() within limits: it stops, keeping what it derived, once the
+     * deadline passes, the step budget is spent or the token is cancelled.
+     * An interrupted deduction is no fixed point, so the next
+     * deduceIncremental() runs a full deduce().
+     * @return How it ended (Convergence::interrupted says which limit stopped it)
+     */
+    InferenceEngine::Convergence deduce(const DeductionLimits& limits);
+    
+    /// Runs a task, e.g. by posting it to a thread pool or an event loop
+    using Executor = std::function<void(std::function<void()>)>;
+    
+    /**
+     * deduce(limits) as a task on an executor, or on a thread of its own if
+     * none is given. The future is ready once deduction has stopped. Until
+     * then this Ratiocinator must not be used or destroyed, except through
+     * snapshot() and the limits' cancellation token.
+     */
+    std::future<InferenceEngine::Convergence> deduceAsync(const DeductionLimits& limits = DeductionLimits(),
+                                                          Executor executor = nullptr);
+    
+    /**
+     * Bring the deduction up to date after incremental updates without a full
+     * fixed point. Derived values whose provenance depends (transitively) on a
+     * removed or changed fact are retracted to UNKNOWN, and only the rules that
+     * mention a changed or retracted proposition are run again, so values with
+     * other support are re-derived. Falls back to deduce() before the first
+     * deduction and after bulk changes (loading files, clearing, or handing out
+     * a mutable Proposition*).
+     *
+     * Values assigned by expressions carry no provenance and are not retracted.
+     */
+    void deduceIncremental();
+    
+    /**
+     * Decide one proposition by backward chaining instead of deducing the
+     * whole knowledge base (see InferenceEngine::query). Only the rules that
+     * can influence the goal are run, and only until it has a value. What is
+     * derived on the way stays in the knowledge base, so traceInference()
+     * explains the answer and later queries and deductions build on it.
+     * If edits since an earlier deduction undermine derived values,
+     * deduceIncremental() runs first so that no stale value answers.
+     */
+    QueryResult query(const std::string& name);
+    
+    /**
+     * Save the knowledge base to a binary snapshot (see Snapshot.h) that
+     * loadSnapshot() restores without re-parsing or re-deducing.
+     * @param includeProvenance Also store how derived values were inferred
+     * @return false if the file could not be written
+     */
+    bool saveSnapshot(const std::string& path, bool includeProvenance = true) const;
+    
+    /**
+     * Replace the knowledge base with a saved snapshot. The propositions,
+     * expressions and literal index are rebuilt from the file's records, which
+     * skips parsing and deduction but not the allocations. If it was saved after
+     * deduce() with provenance, deduceIncremental() continues from it;
+     * otherwise the next deduction is a full one.
+     * @return false (knowledge base unchanged) if the file is missing or invalid
+     */
+    bool loadSnapshot(const std::string& path);
+    
+    // ========== Read Snapshots ==========
+    
+    /**
+     * Publish an immutable KnowledgeView after every deduce(),
+     * deduceIncremental(), streamed batch and loadSnapshot(). Enabling it
+     * publishes the current state at once. Each publication copies the
+     * propositions, so leave it off unless other threads read snapshots.
+     */
+    void setSnapshotPublishing(bool enabled);
+    
+    /// Whether views are published after each deduction
+    bool isSnapshotPublishing() const;
+    
+    /// Publish the current state now (e.g. after edits made without deducing)
+    void publishSnapshot();
+    
+    /**
+     * The latest published view. Safe to call from any thread while this
+     * Ratiocinator is being modified or deduced on another; before anything is
+     * published it is an empty view with version 0.
+     */
+    std::shared_ptr<const KnowledgeView> snapshot() const;
+    
+    /**
+     * Compile the current knowledge base for what-if analysis: a copy of its
+     * propositions and expressions, indexed and deduced once, that evaluates
+     * alternative facts against it without changing this Ratiocinator.
+     * @param threads Threads for RuleBase::evaluateAll (0 = one per hardware thread)
+     */
+    std::shared_ptr<const RuleBase> compileRuleBase(size_t threads = 0) const;
+    
+    // ========== Streaming Ingestion ==========
+    
+    /// Receives the propositions whose value a batch changed
+    using ChangeCallback = std::function<void(const std::vector<PropositionChange>&)>;
+    
+    /// Configure how streamed facts are batched
+    void setIngestOptions(const IngestOptions& opts);
+    
+    /// Get the batching configuration
+    const IngestOptions& getIngestOptions() const;
+    
+    /// Set the callback run after each batch that changed a value (empty to remove)
+    void setChangeCallback(ChangeCallback callback);
+    
+    /**
+     * Buffer one facts line (facts file format, without the terminator).
+     * The buffer is flushed once it holds batchSize lines or its oldest line
+     * is older than maxLatency. Latency is checked as lines arrive, so call
+     * flush() from a timer if a stream may go quiet.
+     */
+    void ingest(std::string_view line);
+    
+    /// Ingest every line of a stream, then flush. Returns the number of lines read.
+    size_t ingest(std::istream& in);
+    
+    /**
+     * Apply the buffered lines in order, run one incremental deduction and
+     * report every proposition whose value differs from before the batch.
+     * @return The changes (also passed to the change callback if non-empty)
+     */
+    std::vector<PropositionChange> flush();
+    
+    /// Number of lines buffered and not yet applied
+    size_t getPendingLineCount() const;
+    
+    /// Configure the inference engine used by deduce()
+    void setInferenceOptions(const InferenceEngine::Options& opts);
+    
+    /// Get the inference engine configuration
+    const InferenceEngine::Options& getInferenceOptions() const;
+    
+    /// Iterations and conflicts of the last deduction or query, and whether it
+    /// reached a fixed point (a warning is written to stderr when it did not)
+    const InferenceEngine::Convergence& getConvergence() const;
+    
+    /// Phase timings and rule counters of the deductions and queries run since
+    /// the last resetStats(), if InferenceEngine::Options::collectStats is set
+    const InferenceStats& getStats() const;
+    
+    /// Zero the collected statistics
+    void resetStats();
+    
+    /// Configure the parser used to load assumptions and facts (e.g. parallel loading)
+    void setParserOptions(const Parser::Options& opts);
+    
+    /// Get the parser configuration
+    const Parser::Options& getParserOptions() const;
+    
     /// Format all proposition truth values as a string (no side effects)
     /// @param includeTraces If true, includes inference traces for derived propositions
     std::string formatResults(bool includeTraces = false) const;
@@ -192,6 +514,14 @@ public:
     /// @return Formatted string with filtered results
     std::string formatResults(const ResultFilter& filter) const;
 
+    /**
+     * Write filtered results to a stream as they are produced, in filter.format.
+     * Nothing is copied but the selected entries' addresses; with a limit only
+     * the first `limit` entries are sorted. Pair with OutputFile to write a
+     * report straight to disk.
+     */
+    void writeResults(std::ostream& out, const ResultFilter& filter) const;
+
     /// Print formatted results to stdout
     /// @param includeTraces If true, includes inference traces for derived propositions
     void printResults(bool includeTraces = false) const;
@@ -259,6 +589,9 @@ public:
     
     /// Get the number of expressions in the knowledge base
     size_t getExpressionCount() const;
+    
+    /// Get the literal -> rule index used to pair rules during deduction
+    const LiteralIndex& getLiteralIndex() const;
 
     // ========== Expression Accessors ==========
     
@@ -279,6 +612,9 @@ public:
     void clearExpressions();
 
     // ========== Inference Tracing API ==========
+    // Traces share one derivation DAG (see TraceGraph) that is built as traces
+    // reach it and kept until the knowledge base changes, so these methods are
+    // not safe to call from several threads at once; use snapshot() for that.
     
     /**
      * Trace the inference chain that led to a proposition's truth value.
@@ -305,6 +641,14 @@ public:
      */
     bool hasInferenceProvenance(const std::string& name) const;
     
+    /**
+     * Write an inference trace to a stream, in formatTrace() format.
+     * 
+     * @param out The stream to write to
+     * @param name The name of the proposition to trace
+     */
+    void writeTrace(std::ostream& out, const std::string& name) const;
+    
     /**
      * Print an inference trace for a proposition to stdout.
      * 
@@ -319,6 +663,14 @@ public:
      */
     std::string formatAllTraces() const;
     
+    /**
+     * Write all inference traces for derived propositions to a stream,
+     * in formatAllTraces() format.
+     * 
+     * @param out The stream to write to
+     */
+    void writeAllTraces(std::ostream& out) const;
+    
     /**
      * Print all inference traces for derived propositions to stdout.
      */
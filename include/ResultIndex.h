@@ -0,0 +1,116 @@
+#ifndef RESULT_INDEX_H
+#define RESULT_INDEX_H
+
+#include "Proposition.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * ResultIndex keeps secondary indexes over a knowledge base so filtered
+ * result queries can start from the entries they can match instead of
+ * scanning every proposition.
+ *
+ * Entries are bucketed by truth value and derivation (derived or axiom), and
+ * kept in name order so a prefix is one contiguous range found by binary
+ * search. A query visits the smaller of its prefix range and its buckets.
+ *
+ * The index points into the map it was built over. update() an entry after
+ * its value or provenance changes (or after it is added), remove() it before
+ * it is erased, and rebuild() after wholesale changes. Names added since the
+ * last query are merged into the name order when the next one needs it.
+ *
+ * Usage:
+ *   ResultIndex index;
+ *   index.rebuild(propositions);
+ *   index.forEachByName("tenant_", false, [](const ResultIndex::Entry& e) { return true; });
+ */
+class ResultIndex {
+public:
+    using Entry = std::pair<const std::string, Proposition>;
+
+private:
+    static constexpr uint8_t kBucketCount = 6;  ///< Truth value x derivation
+
+    struct Slot {
+        const Entry* entry;  ///< null once removed
+        uint8_t bucket;
+        uint32_t position;   ///< Index in buckets_[bucket]
+    };
+
+    std::vector<Slot> slots_;
+    std::unordered_map<std::string_view, uint32_t> ids_;  ///< Name -> slot (keys view the map's keys)
+    std::array<std::vector<uint32_t>, kBucketCount> buckets_;
+    mutable std::vector<uint32_t> byName_;   ///< Slots in name order, then unsorted additions
+    mutable size_t sortedCount_ = 0;         ///< Leading byName_ entries in name order
+    std::vector<uint32_t> freeSlots_;        ///< Slots released by remove()
+
+    static uint8_t bucketOf(Tripartite value, bool derived);
+    static uint8_t bucketOf(const Proposition& prop);
+    const std::string& nameOf(uint32_t id) const;
+
+    /// Merge slots added since the last query into the name order
+    void sortNames() const;
+
+    /// [first, last) of byName_ whose names start with prefix
+    std::pair<size_t, size_t> prefixRange(std::string_view prefix) const;
+
+public:
+    ResultIndex() = default;
+
+    /// Index every entry of a map, forgetting anything indexed before
+    void rebuild(const std::unordered_map<std::string, Proposition>& propositions);
+
+    /// Forget every entry
+    void clear();
+
+    /// Index an entry, or move it to the buckets its current value belongs in
+    void update(const Entry& entry);
+
+    /// Unindex an entry (call before erasing it from the map)
+    void remove(const std::string& name);
+
+    /// Number of indexed entries
+    size_t size() const;
+
+    /// Number of entries whose name starts with prefix
+    size_t countByName(std::string_view prefix) const;
+
+    /// Number of entries with this value and derivation
+    size_t bucketSize(Tripartite value, bool derived) const;
+
+    /**
+     * Visit the entries whose name starts with prefix in name order (or
+     * reverse name order). Stops early when visit returns false.
+     * @return false if visit stopped the walk
+     */
+    template <typename Visit>
+    bool forEachByName(std::string_view prefix, bool descending, Visit visit) const {
+        auto [first, last] = prefixRange(prefix);
+        for (size_t i = 0; i < last - first; ++i) {
+            const Slot& slot = slots_[byName_[descending ? last - 1 - i : first + i]];
+            if (!visit(*slot.entry)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Visit the entries with this value and derivation, in no particular order
+    template <typename Visit>
+    bool forEachInBucket(Tripartite value, bool derived, Visit visit) const {
+        for (uint32_t id : buckets_[bucketOf(value, derived)]) {
+            if (!visit(*slots_[id].entry)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // RESULT_INDEX_H
@@ -0,0 +1,98 @@
+#ifndef RULE_BASE_H
+#define RULE_BASE_H
+
+#include "Ratiocinator.h"
+#include "WorkStealingPool.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Outcome of one what-if scenario evaluated against a RuleBase.
+ */
+struct ScenarioResult {
+    /// Propositions whose value differs from the base's fixed point, by name
+    /// (before: the base's value, after: the scenario's)
+    std::vector<PropositionChange> changes;
+
+    /// Derived values of the base the scenario's facts withdrew support for
+    size_t retracted = 0;
+
+    /// The scenario was deduced from the undeduced base: its facts define
+    /// expressions, or overturn a decided value without provenance to trace
+    bool fullDeduction = false;
+};
+
+/**
+ * RuleBase is an immutable, compiled knowledge base for what-if analysis:
+ * the rules and facts are indexed and deduced once, and then any number of
+ * alternative facts sets (scenarios) are evaluated against it.
+ *
+ * A scenario is a facts text in the facts file syntax. Its assignments are
+ * layered over the shared base in a copy-on-write overlay, and deduction
+ * writes only to that overlay, so scenarios never copy the knowledge base and
+ * can run concurrently. Each scenario starts from the base's fixed point and
+ * propagates from its facts; facts that overturn a decided value first retract
+ * what the base derived from it (by provenance, as deduceIncremental() does),
+ * so the outcome is what a fresh deduction with the facts loaded would give.
+ * Scenarios whose facts define expressions are deduced on a private copy.
+ *
+ * Usage:
+ *   Ratiocinator engine;
+ *   engine.loadAssumptions("assumptions.txt");
+ *   std::shared_ptr<const RuleBase> rules = engine.compileRuleBase();
+ *   std::vector<ScenarioResult> results = rules->evaluateAll({"P", "!Q"});
+ */
+class RuleBase {
+public:
+    /**
+     * Configuration for compiling and evaluating scenarios.
+     */
+    struct Options {
+        InferenceEngine::Options inference;  ///< Engine used for the base and for every scenario
+
+        /// Threads for evaluateAll (0 = one per hardware thread)
+        size_t threads = 0;
+
+        Options() = default;
+    };
+
+private:
+    Options options_;
+    std::unordered_map<std::string, Proposition> base_;     ///< Rules and facts as given
+    std::unordered_map<std::string, Proposition> deduced_;  ///< base_ at its fixed point
+    std::vector<Expression> expressions_;                   ///< Bound to index_'s symbols
+    LiteralIndex index_;                                    ///< Rules of base_ (and of deduced_)
+    std::unordered_map<std::string, std::vector<std::string>> dependents_;  ///< Premise -> derived names citing it
+    std::shared_ptr<WorkStealingPool> pool_;                ///< evaluateAll threads (null: serial)
+
+    /// Deduce a scenario whose facts define expressions on a private copy of the base
+    ScenarioResult evaluateCopy(std::string_view facts) const;
+
+public:
+    /// Compile a knowledge base: index its rules and deduce it once
+    RuleBase(const std::unordered_map<std::string, Proposition>& propositions,
+             const std::vector<Expression>& expressions);
+    RuleBase(const std::unordered_map<std::string, Proposition>& propositions,
+             const std::vector<Expression>& expressions,
+             const Options& opts);
+
+    RuleBase(const RuleBase&) = delete;
+    RuleBase& operator=(const RuleBase&) = delete;
+
+    /// The base at its fixed point
+    const std::unordered_map<std::string, Proposition>& getPropositions() const;
+
+    /// Truth value of a proposition at the base's fixed point (UNKNOWN if not found)
+    Tripartite getPropositionTruthValue(const std::string& name) const;
+
+    /// Evaluate one scenario (safe to call from several threads at once)
+    ScenarioResult evaluate(std::string_view facts) const;
+
+    /// Evaluate scenarios in parallel; results are in the order of scenarios
+    std::vector<ScenarioResult> evaluateAll(const std::vector<std::string>& scenarios) const;
+};
+
+#endif // RULE_BASE_H
@@ -0,0 +1,130 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "Parser.h"
+#include "Ratiocinator.h"
+#include <iosfwd>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Server keeps one Ratiocinator resident and answers requests about it over a
+ * line protocol, so a client updates facts and asks questions without paying
+ * for loading and a full deduction each time.
+ *
+ * Each request is one line; blank lines and lines starting with '#' are
+ * skipped. Every other request gets exactly one response, in request order:
+ * "ok N" followed by N lines of body, or "error MESSAGE". Requests:
+ *
+ *   fact LINE        Buffer a facts line (facts file syntax)
+ *   assume LINE      Add or replace an assumption (assumptions file syntax)
+ *   retract NAME     Remove a proposition
+ *   query NAME       NAME's value, e.g. "B: True [derived via ModusPonens]"
+ *   trace NAME       NAME's inference trace
+ *   results [OPTS]   Filtered results; OPTS are the command-line filter
+ *                    options (--true-only, --prefix=P, --format=ndjson, ...)
+ *   changes          Values the applied fact batches changed since the last
+ *                    changes request, as "NAME: Before -> After"
+ *   save NAME        Save a snapshot (see Ratiocinator::saveSnapshot)
+ *   load NAME        Replace the knowledge base with a snapshot
+ *   stats            Inference statistics as JSON (if collected)
+ *   quit             End this connection
+ *   shutdown         End this connection and the server
+ *
+ * Requests are pipelined: a client may send any number of them before reading
+ * the responses. Buffered facts are applied as one batch, with one incremental
+ * deduction, when a request that reads the knowledge base arrives or the
+ * input runs dry, and responses are flushed only when the input runs dry, so a
+ * round trip of many requests costs one deduction and one write.
+ *
+ * Snapshots are files in the server's snapshot directory. A request names a
+ * file, not a path: names with a directory separator, "." and ".." are
+ * rejected, so a client cannot read or overwrite files elsewhere.
+ *
+ * Usage:
+ *   Ratiocinator engine;
+ *   engine.loadAssumptions("assumptions.txt");
+ *   Server server(engine, "/var/lib/logoslab");
+ *   server.serve(std::cin, std::cout);
+ */
+class Server {
+public:
+    /// Serve requests about an engine, which must outlive the server. Facts
+    /// are batched through the engine's ingest(), whose batchSize is set to 0.
+    /// save and load requests read and write files in snapshotDirectory.
+    explicit Server(Ratiocinator& engine, std::string snapshotDirectory = ".");
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * Answer the requests on a stream until it ends or a quit or shutdown
+     * request, flushing the responses each time no more input is buffered.
+     */
+    void serve(std::istream& in, std::ostream& out);
+
+    /**
+     * Listen on a Unix domain socket and serve its clients, one connection at
+     * a time, until a shutdown request. An existing file at the path is
+     * replaced, and removed again on return.
+     * @return false (with the reason in error) if the socket cannot be set up,
+     *         or Unix sockets are not available on this platform
+     */
+    bool serveSocket(const std::string& path, std::string& error);
+
+    /**
+     * Answer one request line. The response is written to out but not flushed.
+     * @return false if the request ends the connection (quit or shutdown)
+     */
+    bool handle(std::string_view request, std::ostream& out);
+
+    /// Apply buffered facts and pending edits with one incremental deduction
+    void settle();
+
+    /// Whether a shutdown request was received
+    bool isShutdownRequested() const;
+
+    /**
+     * Apply one command-line filter option (e.g. "--true-only", "--limit=10")
+     * to a filter. Shared by main and the results request.
+     * @return false if the option is not a filter option; true otherwise, with
+     *         error set if its value is invalid
+     */
+    static bool parseFilterOption(std::string_view option, ResultFilter& filter, std::string& error);
+
+private:
+    Ratiocinator& engine_;
+    std::string snapshotDirectory_;  // Where save and load requests find snapshots
+    Parser parser_;                  // Parses assume requests
+    bool edited_ = true;             // Assumptions or retractions not yet deduced
+    bool shutdown_ = false;
+
+    std::vector<PropositionChange> changes_;               // Since the last changes request
+    std::unordered_map<std::string, size_t> changeIndex_;  // Name -> entry in changes_
+    std::ostringstream body_;                              // Body of the response being built
+
+    /// Merge a batch's changes into changes_, keeping each name's first before value
+    void recordChanges(std::vector<PropositionChange> changes);
+
+    /// Run a request's command, writing any body to body_
+    /// @return An error message (empty on success)
+    std::string run(std::string_view command, std::string_view argument);
+
+    /// The file a save or load request names, or an error message for a name
+    /// that is not a plain file name
+    /// @return An error message (empty on success)
+    std::string snapshotPath(std::string_view name, std::string& path) const;
+
+    /// Write "ok N" and the body, or "error MESSAGE"
+    void respond(std::ostream& out, const std::string& error);
+
+#if defined(__unix__) || defined(__APPLE__)
+    /// Answer the requests of one socket connection until it closes or quits
+    void serveConnection(int fd);
+#endif
+};
+
+#endif // SERVER_H
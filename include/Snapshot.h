@@ -0,0 +1,64 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Expression.h"
+#include "Proposition.h"
+#include "SymbolTable.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Snapshot saves a knowledge base in a versioned binary file and loads it back.
+ *
+ * The file is a fixed header followed by flat sections of fixed-size records:
+ * a string table (every name is stored once and referred to by index), the
+ * interned symbols in id order, propositions, provenance records, premises,
+ * expressions and their tokens. Loading maps the file and reads the records
+ * in place; there is nothing to lex or parse, and nothing is re-derived. It
+ * is not a zero-copy load: the records are copied into the proposition map,
+ * expression list and symbol table the engine works on, so a load still
+ * allocates every name and costs time linear in the size of the base.
+ *
+ * Symbols are restored in their original order, so literal ids (and compact
+ * provenance that cites them) mean the same after a load. Provenance keeps
+ * its rule, premises and confidence; timestamps and conflict history are not
+ * saved. Files are written in host byte order and rejected on a host with
+ * a different one.
+ *
+ * Usage:
+ *   Snapshot::write("kb.snap", propositions, expressions, symbols, true, true);
+ *   Snapshot::read("kb.snap", propositions, expressions, symbols, deduced);
+ */
+class Snapshot {
+public:
+    /// Format version; files of any other version are rejected
+    static constexpr uint32_t kVersion = 3;
+
+    /**
+     * Write a knowledge base to a file, replacing it only once the new file is
+     * complete. Returns false (and reports to stderr) if it cannot be written.
+     * @param deduced Truth values are a fixed point of deduction
+     * @param includeProvenance Store how derived values were inferred
+     */
+    static bool write(const std::string& path,
+                      const std::unordered_map<std::string, Proposition>& propositions,
+                      const std::vector<Expression>& expressions,
+                      const SymbolTable& symbols,
+                      bool deduced,
+                      bool includeProvenance);
+
+    /**
+     * Read a knowledge base into empty containers (and an empty symbol table).
+     * Returns false (and reports to stderr) for a missing, truncated, corrupt or
+     * incompatible file; the outputs are then left in an unspecified state.
+     */
+    static bool read(const std::string& path,
+                     std::unordered_map<std::string, Proposition>& propositions,
+                     std::vector<Expression>& expressions,
+                     SymbolTable& symbols,
+                     bool& deduced);
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,83 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Dense handle for a literal: an interned proposition name plus its polarity.
+ * The low bit is the negation bit, so P and ~P are adjacent ids and a vector
+ * indexed by PropId holds both polarities of every symbol.
+ */
+using PropId = uint32_t;
+
+/// Check whether a literal id carries the negation bit
+inline bool isNegatedId(PropId id) { return (id & 1u) != 0; }
+
+/// The literal with the same symbol and opposite polarity
+inline PropId negateId(PropId id) { return id ^ 1u; }
+
+/// The positive literal of a symbol
+inline PropId positiveId(PropId id) { return id & ~1u; }
+
+/**
+ * SymbolTable interns proposition names as dense PropIds.
+ *
+ * "P" maps to the positive literal of symbol P; "~P" and "!P" both map to its
+ * negative literal. Ids are handed out in interning order and stay stable until
+ * clear(), so the inference engine can keep per-literal state in plain vectors
+ * and never hash or allocate a string on its hot path.
+ *
+ * Usage:
+ *   SymbolTable symbols;
+ *   PropId p = symbols.intern("P");
+ *   PropId notP = symbols.intern("~P");   // == negateId(p)
+ *   symbols.name(notP);                   // "~P"
+ */
+class SymbolTable {
+private:
+    std::unordered_map<std::string, PropId> idBySpelling_;  ///< Every spelling seen -> literal
+    std::vector<std::string> names_;                         ///< Literal -> canonical spelling
+
+public:
+    SymbolTable() = default;
+    ~SymbolTable() = default;
+    SymbolTable(const SymbolTable&) = default;
+    SymbolTable& operator=(const SymbolTable&) = default;
+    SymbolTable(SymbolTable&&) = default;
+    SymbolTable& operator=(SymbolTable&&) = default;
+
+    /// Check if a proposition name carries a negation prefix ("~" or "!")
+    static bool isNegatedName(const std::string& name);
+
+    /// Get the literal for a name, interning its symbol if it is new
+    PropId intern(const std::string& name);
+
+    /// Look up the literal for a name without interning (returns false if unknown)
+    bool find(const std::string& name, PropId& id) const;
+
+    /**
+     * Canonical spelling of a literal: the base name, or for a negative literal
+     * the first negated spelling interned ("~" + base if none was).
+     */
+    const std::string& name(PropId id) const;
+
+    /// Every spelling interned so far, with its literal
+    const std::unordered_map<std::string, PropId>& spellings() const;
+
+    /// One past the highest literal id (size for per-literal vectors)
+    size_t idCount() const;
+
+    /// Number of interned symbols (each has two literals)
+    size_t symbolCount() const;
+
+    /// Preallocate for a number of symbols and distinct spellings
+    void reserve(size_t symbols, size_t spellings);
+
+    /// Forget every symbol
+    void clear();
+};
+
+#endif // SYMBOL_TABLE_H
@@ -0,0 +1,105 @@
+#ifndef TRACE_GRAPH_H
+#define TRACE_GRAPH_H
+
+#include "Proposition.h"
+#include "SymbolTable.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * InferenceStep represents a single step in an inference trace.
+ * Used to explain how a proposition's truth value was derived.
+ */
+struct InferenceStep {
+    std::string proposition;              ///< The proposition that was derived
+    Tripartite truthValue;                ///< The truth value that was derived
+    std::string rule;                     ///< The inference rule used (e.g., "ModusPonens")
+    std::vector<std::string> premises;    ///< The premises used in this step
+    int depth;                            ///< Depth in the inference chain (0 = target)
+
+    InferenceStep()
+        : proposition(""), truthValue(Tripartite::UNKNOWN), rule(""), premises(), depth(0) {}
+
+    InferenceStep(const std::string& prop, Tripartite value,
+                  const std::string& r, const std::vector<std::string>& prem, int d)
+        : proposition(prop), truthValue(value), rule(r), premises(prem), depth(d) {}
+};
+
+/**
+ * TraceGraph is the derivation DAG of a knowledge base: one node per
+ * proposition, with an edge to each premise its provenance cites.
+ *
+ * Nodes are built the first time a trace reaches them and then shared by
+ * every later trace, so tracing all derived propositions resolves each
+ * premise list once instead of once per trace that passes through it.
+ * Walks mark nodes with an integer stamp instead of a set of names.
+ *
+ * The graph points into the propositions it was built over; reset() it
+ * whenever they change. It is not safe for concurrent use.
+ *
+ * Usage:
+ *   TraceGraph graph(propositions, &symbols);
+ *   graph.writeTrace(std::cout, "Q");
+ */
+class TraceGraph {
+private:
+    static constexpr uint32_t kMissing = UINT32_MAX;
+
+    struct Node {
+        const std::string* name;              ///< Key in the knowledge base
+        const Proposition* prop;
+        std::vector<std::string> premises;    ///< Premise names from provenance
+        std::vector<uint32_t> children;       ///< Premise -> node (kMissing if no such proposition)
+        bool resolved;                        ///< children is filled in
+    };
+
+    static constexpr std::string_view kAxiom = "Axiom";  ///< Rule shown for propositions without provenance
+
+    const std::unordered_map<std::string, Proposition>* propositions_ = nullptr;
+    const SymbolTable* symbols_ = nullptr;     ///< Resolves compact premise literals (may be null)
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string_view, uint32_t> ids_;  ///< Name -> node (keys view the map's keys)
+    std::vector<uint32_t> visited_;            ///< Node -> stamp of the last walk that reached it
+    uint32_t stamp_ = 0;
+
+    /// Node of a proposition, building it on first use (kMissing if there is none)
+    uint32_t nodeFor(const std::string& name);
+
+    /// Premise nodes of a node, resolved the first time a walk reaches it
+    const std::vector<uint32_t>& children(uint32_t id);
+
+    /// The rule that derived a node's value ("Axiom" without provenance)
+    static std::string_view ruleOf(const Node& node);
+
+    /// Visit (node, depth) in traceInference() order: depth-first, premises in order, each node once
+    template <typename Visit>
+    void walk(const std::string& name, Visit visit);
+
+public:
+    TraceGraph() = default;
+    TraceGraph(const std::unordered_map<std::string, Proposition>& propositions,
+               const SymbolTable* symbols);
+
+    /// Forget every node and trace a (possibly different) knowledge base from now on
+    void reset(const std::unordered_map<std::string, Proposition>& propositions,
+               const SymbolTable* symbols);
+
+    /// Steps from the target (depth 0) down to its axioms, as Ratiocinator::traceInference()
+    std::vector<InferenceStep> trace(const std::string& name);
+
+    /// Write a trace in Ratiocinator::formatTrace() format
+    void writeTrace(std::ostream& out, const std::string& name);
+
+    /// Number of nodes built so far
+    size_t nodeCount() const;
+
+    /// Premise names of a provenance record, resolving compact premise literals
+    static std::vector<std::string> premiseNames(const InferenceProvenance& provenance,
+                                                 const SymbolTable* symbols);
+};
+
+#endif // TRACE_GRAPH_H
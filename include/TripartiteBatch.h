@@ -0,0 +1,75 @@
+#ifndef TRIPARTITE_BATCH_H
+#define TRIPARTITE_BATCH_H
+
+#include "Proposition.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * TripartiteBatch holds one Tripartite value per world as two bit planes.
+ *
+ * Bit w of the known plane is set if world w is TRUE or FALSE; bit w of the
+ * value plane is set if it is TRUE. Value bits are always a subset of known
+ * bits, so UNKNOWN is (0, 0) and each three-valued connective is a handful of
+ * bitwise operations per 64 worlds.
+ *
+ * The plane kernels work in place on (known1, value1) and use 512-bit vector
+ * lanes where the compiler supports them, which lower to AVX-512, AVX2, NEON
+ * or SSE2 depending on the target (see ENABLE_NATIVE_ARCH); a scalar loop
+ * handles the tail and other compilers.
+ *
+ * Usage:
+ *   TripartiteBatch column(1000);
+ *   column.set(42, Tripartite::TRUE);
+ *   expr.evaluateBatch(columnsById, result);
+ */
+class TripartiteBatch {
+private:
+    std::vector<uint64_t> known_;   ///< Bit set: world's value is TRUE or FALSE
+    std::vector<uint64_t> value_;   ///< Bit set: world's value is TRUE
+    size_t worlds_;                 ///< Number of worlds (bits past it are unspecified)
+
+public:
+    static constexpr size_t kWorldsPerWord = 64;
+
+    explicit TripartiteBatch(size_t worlds = 0, Tripartite fill = Tripartite::UNKNOWN);
+
+    /// Change the number of worlds, setting every world to a value
+    void resize(size_t worlds, Tripartite fill = Tripartite::UNKNOWN);
+
+    /// Set every world to a value
+    void fill(Tripartite value);
+
+    /// Number of worlds
+    size_t worldCount() const;
+
+    /// Number of 64-bit words per plane
+    size_t wordCount() const;
+
+    void set(size_t world, Tripartite value);
+    Tripartite get(size_t world) const;
+
+    // Raw planes, wordCount() words each
+    const uint64_t* known() const;
+    const uint64_t* value() const;
+    uint64_t* known();
+    uint64_t* value();
+
+    // ========== Plane Kernels (in place on the first operand) ==========
+
+    /// Instruction set the kernels were compiled for ("avx512", "avx2", "neon", "sse2" or "scalar")
+    static const char* kernelName();
+
+    static void notPlanes(uint64_t* known, uint64_t* value, size_t count);
+    static void andPlanes(uint64_t* known1, uint64_t* value1,
+                          const uint64_t* known2, const uint64_t* value2, size_t count);
+    static void orPlanes(uint64_t* known1, uint64_t* value1,
+                         const uint64_t* known2, const uint64_t* value2, size_t count);
+    static void impliesPlanes(uint64_t* known1, uint64_t* value1,
+                              const uint64_t* known2, const uint64_t* value2, size_t count);
+    static void equivalentPlanes(uint64_t* known1, uint64_t* value1,
+                                 const uint64_t* known2, const uint64_t* value2, size_t count);
+};
+
+#endif // TRIPARTITE_BATCH_H
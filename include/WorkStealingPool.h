@@ -0,0 +1,78 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkStealingPool runs batches of independent tasks on a fixed set of threads.
+ *
+ * run() deals task indices round-robin onto one deque per thread. Each thread
+ * takes tasks from the front of its own deque and, once that is empty, steals
+ * from the back of the others, so a few large tasks do not leave the remaining
+ * threads idle. The calling thread works as thread 0 and run() returns when
+ * every task has finished.
+ *
+ * If tasks throw, the exception of the lowest-numbered failing task is
+ * rethrown after the batch completes, so errors do not depend on scheduling.
+ *
+ * Usage:
+ *   WorkStealingPool pool(4);
+ *   pool.run(components.size(), [&](size_t i) { solve(components[i]); });
+ */
+class WorkStealingPool {
+private:
+    /// Tasks dealt to one thread
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::thread> workers_;              ///< Threads 1..n-1 (the caller is thread 0)
+    std::vector<std::unique_ptr<Queue>> queues_;    ///< One per thread, including the caller
+
+    std::mutex mutex_;                              ///< Guards the batch state below
+    std::condition_variable wake_;                  ///< Signals a new batch or shutdown
+    std::condition_variable done_;                  ///< Signals that a worker finished the batch
+    const std::function<void(size_t)>* task_ = nullptr;
+    uint64_t generation_ = 0;                       ///< Incremented for every batch
+    size_t active_ = 0;                             ///< Workers still draining the batch
+    bool stopping_ = false;
+
+    std::mutex errorMutex_;
+    std::exception_ptr error_;                      ///< Exception of the lowest failing task
+    size_t errorTask_ = 0;
+
+    std::mutex runMutex_;                           ///< Serializes concurrent run() calls
+
+    void workerLoop(size_t thread);
+    void drain(size_t thread);
+    bool take(size_t thread, size_t& task);
+
+public:
+    /// Create a pool with the given total number of threads (at least 1)
+    explicit WorkStealingPool(size_t threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /// Number of threads that execute tasks, including the caller of run()
+    size_t threadCount() const;
+
+    /// Run task(0) ... task(taskCount - 1) and wait for all of them
+    void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+    /// Hardware concurrency, or 1 if it cannot be determined
+    static size_t defaultThreadCount();
+};
+
+#endif // WORK_STEALING_POOL_H
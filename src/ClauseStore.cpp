@@ -0,0 +1,92 @@
+#include "ClauseStore.h"
+
+#include <algorithm>
+#include <numeric>
+
+void ClauseStore::add(RuleSlot slot, ClauseKind kind, const std::vector<PropId>& literals) {
+    remove(slot);
+    if (literals.empty()) {
+        return;
+    }
+    if (slot >= extents_.size()) {
+        extents_.resize(slot + 1);
+    }
+
+    Extent& extent = extents_[slot];
+    extent.offset = static_cast<uint32_t>(literals_.size());
+    extent.kind = kind;
+    for (PropId literal : literals) {
+        auto first = literals_.begin() + extent.offset;
+        if (std::find(first, literals_.end(), literal) == literals_.end()) {
+            literals_.push_back(literal);
+        }
+    }
+    extent.length = static_cast<uint32_t>(literals_.size() - extent.offset);
+    ++clauses_;
+}
+
+bool ClauseStore::remove(RuleSlot slot) {
+    if (!contains(slot)) {
+        return false;
+    }
+    garbage_ += extents_[slot].length;
+    extents_[slot] = Extent();
+    --clauses_;
+    if (garbage_ > literals_.size() / 2) {
+        compact();
+    }
+    return true;
+}
+
+void ClauseStore::clear() {
+    literals_.clear();
+    extents_.clear();
+    clauses_ = 0;
+    garbage_ = 0;
+}
+
+bool ClauseStore::contains(RuleSlot slot) const {
+    return slot < extents_.size() && extents_[slot].length > 0;
+}
+
+ClauseKind ClauseStore::kind(RuleSlot slot) const {
+    return extents_[slot].kind;
+}
+
+ClauseStore::Literals ClauseStore::literals(RuleSlot slot) const {
+    if (!contains(slot)) {
+        return Literals(nullptr, nullptr);
+    }
+    const PropId* first = literals_.data() + extents_[slot].offset;
+    return Literals(first, first + extents_[slot].length);
+}
+
+size_t ClauseStore::clauseCount() const {
+    return clauses_;
+}
+
+size_t ClauseStore::literalCount() const {
+    return literals_.size() - garbage_;
+}
+
+void ClauseStore::compact() {
+    std::vector<RuleSlot> order(extents_.size());
+    std::iota(order.begin(), order.end(), 0);
+    order.erase(std::remove_if(order.begin(), order.end(), [this](RuleSlot slot) { return !contains(slot); }),
+                order.end());
+    std::sort(order.begin(), order.end(), [this](RuleSlot a, RuleSlot b) {
+        return extents_[a].offset < extents_[b].offset;
+    });
+
+    // Extents only move towards the front, so copying in offset order never overwrites a live one
+    uint32_t end = 0;
+    for (RuleSlot slot : order) {
+        Extent& extent = extents_[slot];
+        std::copy(literals_.begin() + extent.offset, literals_.begin() + extent.offset + extent.length,
+                  literals_.begin() + end);
+        extent.offset = end;
+        end += extent.length;
+    }
+    literals_.resize(end);
+    garbage_ = 0;
+}
@@ -1,6 +1,7 @@
 #include "Expression.h"
-#include <queue>
-#include <stack>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
 
 // Named constants for operator precedence
 namespace {
@@ -9,23 +10,66 @@ namespace {
     constexpr int PRECEDENCE_OR = 1;         // Disjunction
     constexpr int PRECEDENCE_IMPLIES = 0;    // Material implication
     constexpr int PRECEDENCE_EQUIVALENT = 0; // Biconditional
+
+    // Precedence of an operator (parentheses and NONE bind loosest)
+    constexpr int precedenceOf(LogicalOperator op) {
+        switch (op) {
+            case LogicalOperator::NOT:        return PRECEDENCE_NOT;
+            case LogicalOperator::AND:        return PRECEDENCE_AND;
+            case LogicalOperator::OR:         return PRECEDENCE_OR;
+            case LogicalOperator::IMPLIES:    return PRECEDENCE_IMPLIES;
+            case LogicalOperator::EQUIVALENT: return PRECEDENCE_EQUIVALENT;
+            default:                          return 0;
+        }
+    }
+
+    // Opcode for a binary operator
+    Instruction::Opcode binaryOpcode(LogicalOperator op) {
+        switch (op) {
+            case LogicalOperator::AND:        return Instruction::Opcode::AND;
+            case LogicalOperator::OR:         return Instruction::Opcode::OR;
+            case LogicalOperator::IMPLIES:    return Instruction::Opcode::IMPLIES;
+            case LogicalOperator::EQUIVALENT: return Instruction::Opcode::EQUIVALENT;
+            default:
+                throw std::invalid_argument("Invalid binary operator.");
+        }
+    }
+
+    // Binary opcodes follow Connective order, so an opcode selects its truth table
+    constexpr size_t kFirstBinaryOpcode = static_cast<size_t>(Instruction::Opcode::AND);
+    static_assert(static_cast<size_t>(Instruction::Opcode::OR) - kFirstBinaryOpcode ==
+                  static_cast<size_t>(Connective::OR));
+    static_assert(static_cast<size_t>(Instruction::Opcode::IMPLIES) - kFirstBinaryOpcode ==
+                  static_cast<size_t>(Connective::IMPLIES));
+    static_assert(static_cast<size_t>(Instruction::Opcode::EQUIVALENT) - kFirstBinaryOpcode ==
+                  static_cast<size_t>(Connective::EQUIVALENT));
+
+    constexpr const TruthTable& truthTableOf(Instruction::Opcode opcode) {
+        return kTruthTables[static_cast<size_t>(opcode) - kFirstBinaryOpcode];
+    }
+
+    // Revisions are unique across all expressions (0 = never compiled)
+    std::atomic<uint64_t> lastRevision{0};
+
+    uint64_t nextRevision() {
+        return lastRevision.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
 }
 
 // Default constructor
 Expression::Expression()
-    : evaluatedValue(Tripartite::UNKNOWN), isEvaluated(false), useTokenStream(false) {
-  initializePrecedence();
-}
+    : evaluatedValue(Tripartite::UNKNOWN), isEvaluated(false), useTokenStream(false),
+      maxDepth(0), isCompiled(false), foldOpcode(Instruction::Opcode::PUSH), revision(0) {}
 
 // Constructor for a simple two-operand expression
 Expression::Expression(const Proposition& left,
                        const Proposition& right,
                        LogicalOperator op)
-    : evaluatedValue(Tripartite::UNKNOWN), isEvaluated(false), useTokenStream(false) {
-  operands.push_back(left);
-  operands.push_back(right);
+    : evaluatedValue(Tripartite::UNKNOWN), isEvaluated(false), useTokenStream(false),
+      maxDepth(0), isCompiled(false), foldOpcode(Instruction::Opcode::PUSH), revision(0) {
+  operands.push_back(Token(left));
+  operands.push_back(Token(right));
   operators.push_back(op);
-  initializePrecedence();
 }
 
 // Set the prefix for the expression
@@ -35,24 +79,35 @@ void Expression::setPrefix(const std::string& p) {
 
 // Add a Proposition as an operand
 void Expression::addOperand(const Proposition& prop) {
-  operands.push_back(prop);
+  operands.push_back(Token(prop));
+  invalidate();
 }
 
 // Add a LogicalOperator as an operator (legacy API)
 void Expression::addOperator(LogicalOperator op) {
   operators.push_back(op);
+  invalidate();
 }
 
 // Token-based API: add operand token
 void Expression::addToken(const Proposition& prop) {
   tokens.push_back(Token(prop));
   useTokenStream = true;
+  invalidate();
+}
+
+// Token-based API: add operand token by name
+void Expression::addToken(const std::string& name, Tripartite value) {
+  tokens.push_back(Token(name, value));
+  useTokenStream = true;
+  invalidate();
 }
 
 // Token-based API: add operator token
 void Expression::addToken(LogicalOperator op) {
   tokens.push_back(Token(op));
   useTokenStream = true;
+  invalidate();
 }
 
 // Convenience method to add left parenthesis (uses token API)
@@ -65,15 +120,6 @@ void Expression::closeParen() {
   addToken(LogicalOperator::RPAREN);
 }
 
-// Initialize precedence for logical operators
-void Expression::initializePrecedence() {
-  precedence[LogicalOperator::NOT] = PRECEDENCE_NOT;
-  precedence[LogicalOperator::AND] = PRECEDENCE_AND;
-  precedence[LogicalOperator::OR] = PRECEDENCE_OR;
-  precedence[LogicalOperator::IMPLIES] = PRECEDENCE_IMPLIES;
-  precedence[LogicalOperator::EQUIVALENT] = PRECEDENCE_EQUIVALENT;
-}
-
 // Check if an operator is unary
 bool Expression::isUnaryOperator(LogicalOperator op) {
   return op == LogicalOperator::NOT;
@@ -89,325 +135,478 @@ bool Expression::isRightParen(LogicalOperator op) {
   return op == LogicalOperator::RPAREN;
 }
 
-// Apply a unary operator to a single value
-Tripartite Expression::applyUnaryOperator(Tripartite value, LogicalOperator op) {
-  switch (op) {
-    case LogicalOperator::NOT:
-      return !value;
-    default:
-      throw std::invalid_argument("Invalid unary operator.");
+// Operand tokens of whichever API built the expression
+const std::vector<Token>& Expression::operandTokens() const {
+  return useTokenStream ? tokens : operands;
+}
+
+// Drop the compiled and bound forms after the tokens change
+void Expression::invalidate() {
+  isCompiled = false;
+  isEvaluated = false;
+  program.clear();
+  operandLiterals.clear();
+  boundLiterals.clear();
+}
+
+// Compile the tokens once; malformed input is reported by every evaluate call
+void Expression::compile() {
+  program.clear();
+  valueStack.clear();
+  maxDepth = 0;
+  compileError = nullptr;
+  try {
+    if (useTokenStream) {
+      compileTokenStream();
+    } else {
+      compileLegacy();
+    }
+  } catch (...) {
+    program.clear();
+    compileError = std::current_exception();
   }
+
+  // PUSH, then (PUSH, op) pairs with one op throughout, is a left fold
+  foldOpcode = Instruction::Opcode::PUSH;
+  if (program.size() >= 3 && program.size() % 2 == 1 && program[0].opcode == Instruction::Opcode::PUSH) {
+    Instruction::Opcode op = program[2].opcode;
+    bool fold = op != Instruction::Opcode::PUSH && op != Instruction::Opcode::NOT;
+    for (size_t i = 1; fold && i < program.size(); i += 2) {
+      fold = program[i].opcode == Instruction::Opcode::PUSH && program[i + 1].opcode == op;
+    }
+    if (fold) {
+      foldOpcode = op;
+    }
+  }
+  isCompiled = true;
+  revision = nextRevision();
 }
 
-// Apply a binary operator to two values
-Tripartite Expression::applyBinaryOperator(Tripartite left, Tripartite right, LogicalOperator op) {
-  switch (op) {
-    case LogicalOperator::AND:
-      return left && right;
-    case LogicalOperator::OR:
-      return left || right;
-    case LogicalOperator::IMPLIES:
-      return implies(left, right);
-    case LogicalOperator::EQUIVALENT:
-      return (implies(left, right) == Tripartite::TRUE &&
-              implies(right, left) == Tripartite::TRUE)
-                 ? Tripartite::TRUE
-                 : Tripartite::FALSE;
-    default:
-      throw std::invalid_argument("Invalid binary operator.");
+// Compile the token stream with the Shunting-Yard algorithm. An operator is
+// emitted at the point the interpreter would apply it, so the program computes
+// exactly what evaluating the tokens directly would.
+void Expression::compileTokenStream() {
+  std::vector<LogicalOperator> opStack;
+  size_t depth = 0;
+
+  // Emit the operator on top of opStack, checking it has enough operands
+  auto emitOperator = [&]() {
+    LogicalOperator op = opStack.back();
+    opStack.pop_back();
+
+    if (isUnaryOperator(op)) {
+      if (depth < 1) {
+        throw std::runtime_error("Insufficient operands for unary operator");
+      }
+      program.emplace_back(Instruction::Opcode::NOT);
+    } else {
+      if (depth < 2) {
+        throw std::runtime_error("Insufficient operands for binary operator");
+      }
+      program.emplace_back(binaryOpcode(op));
+      --depth;
+    }
+  };
+
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    const Token& token = tokens[i];
+    if (token.isOperand) {
+      program.emplace_back(Instruction::Opcode::PUSH, static_cast<uint32_t>(i));
+      if (++depth > maxDepth) maxDepth = depth;
+
+      // After operand, apply any pending unary operators
+      while (!opStack.empty() && isUnaryOperator(opStack.back())) {
+        emitOperator();
+      }
+
+    } else if (isLeftParen(token.op)) {
+      opStack.push_back(token.op);
+
+    } else if (isRightParen(token.op)) {
+      // Emit operators until we find the matching left paren
+      while (!opStack.empty() && !isLeftParen(opStack.back())) {
+        emitOperator();
+      }
+      if (!opStack.empty() && isLeftParen(opStack.back())) {
+        opStack.pop_back();
+      }
+      // After closing paren, apply any pending unary operators
+      while (!opStack.empty() && isUnaryOperator(opStack.back())) {
+        emitOperator();
+      }
+
+    } else if (isUnaryOperator(token.op)) {
+      // Unary operator is applied after the next operand
+      opStack.push_back(token.op);
+
+    } else {
+      // Binary operator: emit higher-precedence operators first
+      while (!opStack.empty() &&
+             !isLeftParen(opStack.back()) &&
+             !isUnaryOperator(opStack.back()) &&
+             precedenceOf(token.op) <= precedenceOf(opStack.back())) {
+        emitOperator();
+      }
+      opStack.push_back(token.op);
+    }
+  }
+
+  // Emit remaining operators
+  while (!opStack.empty()) {
+    if (!isLeftParen(opStack.back()) && !isRightParen(opStack.back())) {
+      emitOperator();
+    } else {
+      opStack.pop_back();  // Skip unmatched parens
+    }
   }
+
+  if (depth == 0) {
+    program.clear();  // No operands: evaluates to UNKNOWN
+  } else if (depth > 1) {
+    throw std::runtime_error("Invalid expression: too many operands");
+  }
+  valueStack.assign(maxDepth, Tripartite::UNKNOWN);
 }
 
-// Convert infix expression to postfix notation using the Shunting-Yard
-// algorithm. Handles unary (NOT), binary operators, and parentheses.
-//
-// The key insight is that we need to track when to consume operands.
-// Operands are consumed:
+// Compile the legacy operand/operator lists. Operators are ordered with the
+// Shunting-Yard algorithm, tracking when an operand would be consumed:
 //   1. Before a binary operator (as its left operand)
 //   2. After a unary operator (as its single operand)
 //   3. Before a closing parenthesis (the last operand in the group)
 //   4. At the end of the expression
-//
-// We track: needsOperand - true when we're expecting an operand next
-//
-void Expression::convertToPostfix(std::queue<Tripartite>& postfixQueue,
-                                  std::queue<LogicalOperator>& opQueue) {
-  std::stack<LogicalOperator> opStack;
+// The legacy evaluator pushes every operand before applying the ordered
+// operators, so the program is all PUSHes followed by the operators.
+void Expression::compileLegacy() {
+  if (operands.empty()) {
+    return;  // Evaluates to UNKNOWN
+  }
+
+  std::vector<LogicalOperator> opStack;
+  std::vector<LogicalOperator> opQueue;
   size_t operandIndex = 0;
   bool needsOperand = true;  // We start expecting an operand (or unary op or LPAREN)
-  
-  // Helper to push an operand and apply pending unary operators
-  auto pushOperand = [&]() {
+
+  // Consume an operand and release any pending unary operators
+  auto consumeOperand = [&]() {
     if (operandIndex < operands.size()) {
-      postfixQueue.push(operands[operandIndex].getTruthValue());
       operandIndex++;
-      
-      // After pushing operand, apply any pending unary operators
-      // Stop at LPAREN since unary ops inside parens stay with their operand
-      while (!opStack.empty() && isUnaryOperator(opStack.top())) {
-        opQueue.push(opStack.top());
-        opStack.pop();
+      while (!opStack.empty() && isUnaryOperator(opStack.back())) {
+        opQueue.push_back(opStack.back());
+        opStack.pop_back();
       }
-      needsOperand = false;  // We just consumed an operand
+      needsOperand = false;
     }
   };
-  
-  for (size_t i = 0; i < operators.size(); ++i) {
-    LogicalOperator currentOp = operators[i];
-    
+
+  for (LogicalOperator currentOp : operators) {
     if (isLeftParen(currentOp)) {
-      // Left parenthesis: push onto stack, expect operand inside
-      opStack.push(currentOp);
+      opStack.push_back(currentOp);
       needsOperand = true;
-      
+
     } else if (isRightParen(currentOp)) {
-      // Right parenthesis: consume the last operand in the group if needed
       if (needsOperand) {
-        pushOperand();
+        consumeOperand();
       }
-      
-      // Pop operators until we find the matching left parenthesis
-      while (!opStack.empty() && !isLeftParen(opStack.top())) {
-        if (!isUnaryOperator(opStack.top())) {
-          opQueue.push(opStack.top());
+      while (!opStack.empty() && !isLeftParen(opStack.back())) {
+        if (!isUnaryOperator(opStack.back())) {
+          opQueue.push_back(opStack.back());
         }
-        opStack.pop();
+        opStack.pop_back();
       }
-      
-      // Pop the left parenthesis (don't add to output)
-      if (!opStack.empty() && isLeftParen(opStack.top())) {
-        opStack.pop();
+      if (!opStack.empty() && isLeftParen(opStack.back())) {
+        opStack.pop_back();
       }
-      
       // After closing paren, apply any pending unary operators from before the group
-      while (!opStack.empty() && isUnaryOperator(opStack.top())) {
-        opQueue.push(opStack.top());
-        opStack.pop();
+      while (!opStack.empty() && isUnaryOperator(opStack.back())) {
+        opQueue.push_back(opStack.back());
+        opStack.pop_back();
       }
-      
       needsOperand = false;  // The parenthesized expression is a complete operand
-      
+
     } else if (isUnaryOperator(currentOp)) {
-      // Unary operator (NOT): push to stack, still need an operand after it
-      opStack.push(currentOp);
-      // needsOperand stays true - we need the operand this unary applies to
-      
+      // Still need the operand this unary applies to
+      opStack.push_back(currentOp);
+
     } else {
-      // Binary operator: first consume the left operand if we haven't yet
       if (needsOperand) {
-        pushOperand();
+        consumeOperand();
       }
-      
-      // Move operators with higher or equal precedence from opStack to opQueue
-      // Stop at LPAREN (it acts as a barrier)
-      while (!opStack.empty() && 
-             !isLeftParen(opStack.top()) && 
-             !isUnaryOperator(opStack.top()) &&
-             precedence[currentOp] <= precedence[opStack.top()]) {
-        opQueue.push(opStack.top());
-        opStack.pop();
+      while (!opStack.empty() &&
+             !isLeftParen(opStack.back()) &&
+             !isUnaryOperator(opStack.back()) &&
+             precedenceOf(currentOp) <= precedenceOf(opStack.back())) {
+        opQueue.push_back(opStack.back());
+        opStack.pop_back();
       }
-      
-      // Push the current binary operator onto the stack
-      opStack.push(currentOp);
-      needsOperand = true;  // Now we need the right operand
+      opStack.push_back(currentOp);
+      needsOperand = true;
     }
   }
-  
-  // Push remaining operands (the final operand)
+
+  // Consume the remaining operands
   while (operandIndex < operands.size()) {
-    postfixQueue.push(operands[operandIndex].getTruthValue());
-    operandIndex++;
-    
-    // After pushing operand, apply any pending unary operators
-    while (!opStack.empty() && isUnaryOperator(opStack.top())) {
-      opQueue.push(opStack.top());
-      opStack.pop();
-    }
+    consumeOperand();
   }
 
-  // Move remaining operators in opStack to opQueue
+  // Move remaining operators, skipping unmatched parentheses
   while (!opStack.empty()) {
-    // Skip any unmatched parentheses (shouldn't happen with valid input)
-    if (!isLeftParen(opStack.top()) && !isRightParen(opStack.top())) {
-      opQueue.push(opStack.top());
+    if (!isLeftParen(opStack.back()) && !isRightParen(opStack.back())) {
+      opQueue.push_back(opStack.back());
     }
-    opStack.pop();
+    opStack.pop_back();
   }
-}
-
-Tripartite Expression::evaluatePostfix(std::queue<Tripartite>& postfixQueue,
-                                       std::queue<LogicalOperator>& opQueue) {
-  std::stack<Tripartite> evalStack;
 
-  // Push all operands onto evalStack in the order they appear in postfixQueue
-  while (!postfixQueue.empty()) {
-    evalStack.push(postfixQueue.front());
-    postfixQueue.pop();
+  for (size_t i = 0; i < operands.size(); ++i) {
+    program.emplace_back(Instruction::Opcode::PUSH, static_cast<uint32_t>(i));
   }
-
-  // Process each operator in opQueue
-  while (!opQueue.empty()) {
-    LogicalOperator op = opQueue.front();
-    opQueue.pop();
-
+  size_t depth = operands.size();
+  for (LogicalOperator op : opQueue) {
     if (isUnaryOperator(op)) {
-      // Unary operator: pop one operand
-      if (evalStack.empty()) {
+      if (depth < 1) {
         throw std::runtime_error(
             "Insufficient operands in the stack for unary operator.");
       }
-      Tripartite operand = evalStack.top();
-      evalStack.pop();
-      
-      Tripartite result = applyUnaryOperator(operand, op);
-      evalStack.push(result);
+      program.emplace_back(Instruction::Opcode::NOT);
     } else {
-      // Binary operator: pop two operands
-      if (evalStack.size() < 2) {
+      if (depth < 2) {
         throw std::runtime_error(
             "Insufficient operands in the stack for binary operator.");
       }
-      Tripartite right = evalStack.top();
-      evalStack.pop();
-      Tripartite left = evalStack.top();
-      evalStack.pop();
-      
-      Tripartite result = applyBinaryOperator(left, right, op);
-      evalStack.push(result);
+      program.emplace_back(binaryOpcode(op));
+      --depth;
     }
   }
-
-  // The final result should be the only remaining value on the stack
-  if (evalStack.size() == 1) {
-    return evalStack.top();
-  } else {
+  if (depth != 1) {
     throw std::runtime_error(
         "Invalid postfix expression: unbalanced operands/operators.");
   }
+  maxDepth = operands.size();
+  valueStack.assign(maxDepth, Tripartite::UNKNOWN);
 }
 
-// Evaluate token stream using Shunting-Yard algorithm with parentheses support
-Tripartite Expression::evaluateTokenStream() {
-  std::stack<LogicalOperator> opStack;
-  std::stack<Tripartite> valueStack;
-  
-  // Helper to apply an operator from opStack to values in valueStack
-  auto applyOperator = [&]() {
-    if (opStack.empty()) return;
-    
-    LogicalOperator op = opStack.top();
-    opStack.pop();
-    
-    if (isUnaryOperator(op)) {
-      if (valueStack.empty()) {
-        throw std::runtime_error("Insufficient operands for unary operator");
-      }
-      Tripartite operand = valueStack.top();
-      valueStack.pop();
-      valueStack.push(applyUnaryOperator(operand, op));
-    } else {
-      if (valueStack.size() < 2) {
-        throw std::runtime_error("Insufficient operands for binary operator");
-      }
-      Tripartite right = valueStack.top();
-      valueStack.pop();
-      Tripartite left = valueStack.top();
-      valueStack.pop();
-      valueStack.push(applyBinaryOperator(left, right, op));
-    }
-  };
-  
-  for (const Token& token : tokens) {
-    if (token.isOperand) {
-      // Push operand value onto value stack
-      valueStack.push(token.prop.getTruthValue());
-      
-      // After operand, apply any pending unary operators
-      while (!opStack.empty() && isUnaryOperator(opStack.top())) {
-        applyOperator();
-      }
-      
-    } else if (isLeftParen(token.op)) {
-      // Push left paren onto operator stack
-      opStack.push(token.op);
-      
-    } else if (isRightParen(token.op)) {
-      // Pop and apply operators until we find matching left paren
-      while (!opStack.empty() && !isLeftParen(opStack.top())) {
-        applyOperator();
-      }
-      // Pop the left paren
-      if (!opStack.empty() && isLeftParen(opStack.top())) {
-        opStack.pop();
-      }
-      // After closing paren, apply any pending unary operators
-      while (!opStack.empty() && isUnaryOperator(opStack.top())) {
-        applyOperator();
-      }
-      
-    } else if (isUnaryOperator(token.op)) {
-      // Push unary operator, it will be applied after the next operand
-      opStack.push(token.op);
-      
-    } else {
-      // Binary operator: apply higher-precedence operators first
-      while (!opStack.empty() && 
-             !isLeftParen(opStack.top()) && 
-             !isUnaryOperator(opStack.top()) &&
-             precedence[token.op] <= precedence[opStack.top()]) {
-        applyOperator();
-      }
-      opStack.push(token.op);
+// Compile if needed; malformed tokens throw on every evaluation
+void Expression::prepare() {
+  if (!isCompiled) {
+    compile();
+  }
+  if (compileError) {
+    std::rethrow_exception(compileError);
+  }
+}
+
+Tripartite Expression::operandValue(uint32_t operand, const std::vector<Proposition*>* byId) const {
+  if (byId && operand < operandLiterals.size()) {
+    PropId literal = operandLiterals[operand];
+    if (literal < byId->size() && (*byId)[literal]) {
+      return (*byId)[literal]->getTruthValue();
     }
   }
-  
-  // Apply remaining operators
-  while (!opStack.empty()) {
-    if (!isLeftParen(opStack.top()) && !isRightParen(opStack.top())) {
-      applyOperator();
-    } else {
-      opStack.pop();  // Skip unmatched parens
+  return operandTokens()[operand].value;
+}
+
+// Fold the operands through one truth table; AND stops at the first FALSE and
+// OR at the first TRUE, since nothing after them can change the result
+template <Connective C>
+Tripartite Expression::runFold(const std::vector<Proposition*>* byId) const {
+  constexpr const TruthTable& table = kTruthTables[static_cast<size_t>(C)];
+  Tripartite value = operandValue(program[0].operand, byId);
+  for (size_t i = 1; i < program.size(); i += 2) {
+    if constexpr (C == Connective::AND) {
+      if (value == Tripartite::FALSE) break;
+    } else if constexpr (C == Connective::OR) {
+      if (value == Tripartite::TRUE) break;
     }
+    value = table[static_cast<size_t>(value)][static_cast<size_t>(operandValue(program[i].operand, byId))];
   }
-  
-  if (valueStack.size() == 1) {
-    return valueStack.top();
-  } else if (valueStack.empty()) {
+  return value;
+}
+
+// Run the compiled program on the preallocated value stack
+Tripartite Expression::run(const std::vector<Proposition*>* byId) {
+  prepare();
+  if (program.empty()) {
     return Tripartite::UNKNOWN;
-  } else {
-    throw std::runtime_error("Invalid expression: too many operands");
   }
+
+  switch (foldOpcode) {
+    case Instruction::Opcode::AND:        return runFold<Connective::AND>(byId);
+    case Instruction::Opcode::OR:         return runFold<Connective::OR>(byId);
+    case Instruction::Opcode::IMPLIES:    return runFold<Connective::IMPLIES>(byId);
+    case Instruction::Opcode::EQUIVALENT: return runFold<Connective::EQUIVALENT>(byId);
+    default:                              break;
+  }
+
+  Tripartite* stack = valueStack.data();
+  size_t top = 0;
+
+  for (const Instruction& instruction : program) {
+    switch (instruction.opcode) {
+      case Instruction::Opcode::PUSH:
+        stack[top++] = operandValue(instruction.operand, byId);
+        break;
+      case Instruction::Opcode::NOT:
+        stack[top - 1] = !stack[top - 1];
+        break;
+      default: {
+        // Every binary connective is one table lookup
+        const TruthTable& table = truthTableOf(instruction.opcode);
+        --top;
+        stack[top - 1] = table[static_cast<size_t>(stack[top - 1])][static_cast<size_t>(stack[top])];
+        break;
+      }
+    }
+  }
+  return stack[0];
 }
 
-// Main evaluate function
+// Main evaluate function (captured operand values, cached)
 Tripartite Expression::evaluate() {
   if (isEvaluated)
     return evaluatedValue;
 
-  if (useTokenStream) {
-    // Use new token-based evaluation
-    if (tokens.empty()) {
-      evaluatedValue = Tripartite::UNKNOWN;
-    } else {
-      evaluatedValue = evaluateTokenStream();
-    }
-  } else {
-    // Use legacy evaluation
-    if (operands.empty()) {
-      evaluatedValue = Tripartite::UNKNOWN;
-    } else {
-      std::queue<Tripartite> postfixQueue;
-      std::queue<LogicalOperator> opQueue;
-      convertToPostfix(postfixQueue, opQueue);
-      evaluatedValue = evaluatePostfix(postfixQueue, opQueue);
+  evaluatedValue = run(nullptr);
+  isEvaluated = true;
+  return evaluatedValue;
+}
+
+// Resolve operand names to literals for evaluate(byId)
+void Expression::bind(SymbolTable& symbols) {
+  const std::vector<Token>& source = operandTokens();
+  bool changed = operandLiterals.size() != source.size();
+  operandLiterals.resize(source.size(), kUnboundOperand);
+  boundLiterals.clear();
+  for (size_t i = 0; i < source.size(); ++i) {
+    PropId literal = kUnboundOperand;
+    if (source[i].isOperand && !source[i].name.empty()) {
+      literal = symbols.intern(source[i].name);
+      boundLiterals.push_back(literal);
     }
+    changed = changed || operandLiterals[i] != literal;
+    operandLiterals[i] = literal;
+  }
+  if (changed) {
+    revision = nextRevision();
   }
+}
 
-  isEvaluated = true;
+// Evaluate against the live knowledge base (never cached)
+Tripartite Expression::evaluate(const std::vector<Proposition*>& byId) {
+  evaluatedValue = run(&byId);
   return evaluatedValue;
 }
 
+// Evaluate the program over blocks of worlds. Stack slot s holds a known
+// plane and a value plane of kBatchBlockWords words each.
+void Expression::evaluateBatch(const std::vector<const TripartiteBatch*>& columns,
+                               TripartiteBatch& result) {
+  prepare();
+  const size_t words = result.wordCount();
+  for (const TripartiteBatch* column : columns) {
+    if (column && column->worldCount() != result.worldCount()) {
+      throw std::invalid_argument("Batch column world count does not match the result.");
+    }
+  }
+  if (program.empty()) {
+    result.fill(Tripartite::UNKNOWN);
+    return;
+  }
+
+  constexpr size_t kSlotWords = 2 * kBatchBlockWords;
+  if (batchStack.size() < maxDepth * kSlotWords) {
+    batchStack.resize(maxDepth * kSlotWords);
+  }
+  const std::vector<Token>& source = operandTokens();
+  auto knownOf = [&](size_t slot) { return batchStack.data() + slot * kSlotWords; };
+  auto valueOf = [&](size_t slot) { return knownOf(slot) + kBatchBlockWords; };
+
+  for (size_t first = 0; first < words; first += kBatchBlockWords) {
+    const size_t count = std::min(kBatchBlockWords, words - first);
+    size_t top = 0;
+
+    for (const Instruction& instruction : program) {
+      switch (instruction.opcode) {
+        case Instruction::Opcode::PUSH: {
+          const TripartiteBatch* column = nullptr;
+          if (instruction.operand < operandLiterals.size()) {
+            PropId literal = operandLiterals[instruction.operand];
+            if (literal < columns.size()) {
+              column = columns[literal];
+            }
+          }
+          uint64_t* known = knownOf(top);
+          uint64_t* value = valueOf(top);
+          if (column) {
+            std::copy(column->known() + first, column->known() + first + count, known);
+            std::copy(column->value() + first, column->value() + first + count, value);
+          } else {
+            Tripartite captured = source[instruction.operand].value;
+            std::fill(known, known + count, captured == Tripartite::UNKNOWN ? 0 : ~uint64_t(0));
+            std::fill(value, value + count, captured == Tripartite::TRUE ? ~uint64_t(0) : 0);
+          }
+          ++top;
+          break;
+        }
+        case Instruction::Opcode::NOT:
+          TripartiteBatch::notPlanes(knownOf(top - 1), valueOf(top - 1), count);
+          break;
+        case Instruction::Opcode::AND:
+          --top;
+          TripartiteBatch::andPlanes(knownOf(top - 1), valueOf(top - 1),
+                                     knownOf(top), valueOf(top), count);
+          break;
+        case Instruction::Opcode::OR:
+          --top;
+          TripartiteBatch::orPlanes(knownOf(top - 1), valueOf(top - 1),
+                                    knownOf(top), valueOf(top), count);
+          break;
+        case Instruction::Opcode::IMPLIES:
+          --top;
+          TripartiteBatch::impliesPlanes(knownOf(top - 1), valueOf(top - 1),
+                                         knownOf(top), valueOf(top), count);
+          break;
+        case Instruction::Opcode::EQUIVALENT:
+          --top;
+          TripartiteBatch::equivalentPlanes(knownOf(top - 1), valueOf(top - 1),
+                                            knownOf(top), valueOf(top), count);
+          break;
+      }
+    }
+
+    std::copy(knownOf(0), knownOf(0) + count, result.known() + first);
+    std::copy(valueOf(0), valueOf(0) + count, result.value() + first);
+  }
+}
+
+const std::vector<PropId>& Expression::getBoundLiterals() const {
+  return boundLiterals;
+}
+
+size_t Expression::getInstructionCount() {
+  if (!isCompiled) {
+    compile();
+  }
+  return program.size();
+}
+
+const std::vector<Instruction>& Expression::getProgram() {
+  if (!isCompiled) {
+    compile();
+  }
+  return program;
+}
+
+PropId Expression::getOperandLiteral(uint32_t operand) const {
+  return operand < operandLiterals.size() ? operandLiterals[operand] : kUnboundOperand;
+}
+
+Tripartite Expression::getOperandValue(uint32_t operand) const {
+  return operandTokens()[operand].value;
+}
+
+uint64_t Expression::getRevision() const {
+  return revision;
+}
+
 // Get the evaluated value of the expression
 Tripartite Expression::getEvaluatedValue() const {
   return evaluatedValue;
@@ -418,12 +617,32 @@ const std::string& Expression::getPrefix() const {
   return prefix;
 }
 
+// Which API built the expression
+bool Expression::usesTokenStream() const {
+  return useTokenStream;
+}
+
+// Token stream of the token API
+const std::vector<Token>& Expression::getTokens() const {
+  return tokens;
+}
+
+// Operands of the legacy API
+const std::vector<Token>& Expression::getOperands() const {
+  return operands;
+}
+
+// Operators of the legacy API
+const std::vector<LogicalOperator>& Expression::getOperators() const {
+  return operators;
+}
+
 // Reset the expression
 void Expression::reset() {
   operands.clear();
   operators.clear();
   tokens.clear();
-  isEvaluated = false;
+  invalidate();
   evaluatedValue = Tripartite::UNKNOWN;
   useTokenStream = false;
 }
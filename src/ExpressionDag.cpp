@@ -0,0 +1,155 @@
+#include "ExpressionDag.h"
+
+#include <utility>
+
+uint32_t ExpressionDag::intern(const Node& node) {
+    // Keep the table at most half full
+    if (2 * (nodes_.size() + 1) > slots_.size()) {
+        growSlots();
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash(node) & mask;; i = (i + 1) & mask) {
+        uint32_t id = slots_[i];
+        if (id == kNoNode) {
+            id = static_cast<uint32_t>(nodes_.size());
+            slots_[i] = id;
+            nodes_.push_back(node);
+            parents_.emplace_back();
+            return id;
+        }
+        const Node& other = nodes_[id];
+        if (other.kind == node.kind && other.connective == node.connective &&
+            other.left == node.left && other.right == node.right) {
+            return id;
+        }
+    }
+}
+
+void ExpressionDag::growSlots() {
+    slots_.assign(slots_.empty() ? 64 : 2 * slots_.size(), kNoNode);
+    size_t mask = slots_.size() - 1;
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        size_t i = hash(nodes_[id]) & mask;
+        while (slots_[i] != kNoNode) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = id;
+    }
+}
+
+uint32_t ExpressionDag::constant(Tripartite value) {
+    return intern({Kind::CONSTANT, Connective::AND, value, false, static_cast<uint32_t>(value), 0});
+}
+
+uint32_t ExpressionDag::operand(PropId literal, Tripartite captured) {
+    if (literal == Expression::kUnboundOperand) {
+        return constant(captured);
+    }
+    size_t before = nodes_.size();
+    uint32_t id = intern({Kind::OPERAND, Connective::AND, captured, true, literal,
+                          static_cast<uint32_t>(captured)});
+    if (nodes_.size() != before) {
+        operands_[literal].push_back(id);
+    }
+    return id;
+}
+
+uint32_t ExpressionDag::negation(uint32_t input) {
+    if (nodes_[input].kind == Kind::CONSTANT) {
+        return constant(!nodes_[input].value);
+    }
+    size_t before = nodes_.size();
+    uint32_t id = intern({Kind::NOT, Connective::AND, Tripartite::UNKNOWN, true, input, 0});
+    if (nodes_.size() != before) {
+        parents_[input].push_back(id);
+    }
+    return id;
+}
+
+uint32_t ExpressionDag::binary(Connective connective, uint32_t left, uint32_t right) {
+    if (nodes_[left].kind == Kind::CONSTANT && nodes_[right].kind == Kind::CONSTANT) {
+        return constant(applyConnective(connective, nodes_[left].value, nodes_[right].value));
+    }
+    // AND, OR and EQUIVALENT are commutative: b && a is the node for a && b
+    if (connective != Connective::IMPLIES && right < left) {
+        std::swap(left, right);
+    }
+    size_t before = nodes_.size();
+    uint32_t id = intern({Kind::BINARY, connective, Tripartite::UNKNOWN, true, left, right});
+    if (nodes_.size() != before) {
+        parents_[left].push_back(id);
+        if (right != left) {
+            parents_[right].push_back(id);
+        }
+    }
+    return id;
+}
+
+uint32_t ExpressionDag::add(Expression& expression) {
+    const std::vector<Instruction>& program = expression.getProgram();
+    if (program.empty()) {
+        return kNoNode;
+    }
+    // Replay the postfix program on a stack of node ids
+    std::vector<uint32_t>& values = scratch_.stack;
+    values.clear();
+    for (const Instruction& instruction : program) {
+        switch (instruction.opcode) {
+            case Instruction::Opcode::PUSH:
+                values.push_back(operand(expression.getOperandLiteral(instruction.operand),
+                                         expression.getOperandValue(instruction.operand)));
+                break;
+            case Instruction::Opcode::NOT:
+                values.back() = negation(values.back());
+                break;
+            default: {
+                uint32_t right = values.back();
+                values.pop_back();
+                Connective connective = static_cast<Connective>(
+                    static_cast<size_t>(instruction.opcode) - static_cast<size_t>(Instruction::Opcode::AND));
+                values.back() = binary(connective, values.back(), right);
+                break;
+            }
+        }
+    }
+    return values.back();
+}
+
+void ExpressionDag::invalidate(PropId literal, Scratch& scratch) {
+    auto found = operands_.find(literal);
+    if (found == operands_.end()) {
+        return;
+    }
+    std::vector<uint32_t>& stack = scratch.stack;
+    stack.clear();
+    for (uint32_t id : found->second) {
+        stack.push_back(id);
+    }
+    while (!stack.empty()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        // A dirty node's ancestors are already dirty
+        if (nodes_[id].dirty) {
+            continue;
+        }
+        nodes_[id].dirty = true;
+        for (uint32_t parent : parents_[id]) {
+            if (!nodes_[parent].dirty) {
+                stack.push_back(parent);
+            }
+        }
+    }
+}
+
+void ExpressionDag::invalidateAll() {
+    for (Node& node : nodes_) {
+        node.dirty = node.kind != Kind::CONSTANT;
+    }
+}
+
+void ExpressionDag::clear() {
+    nodes_.clear();
+    parents_.clear();
+    slots_.clear();
+    operands_.clear();
+}
@@ -1,4 +1,1092 @@
 #include "InferenceEngine.h"
+#include "ExpressionDag.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+
+namespace {
+
+// Agenda of rule indices for one phase of the worklist strategy, drained in passes
+// like a FULL_SWEEP phase: a pass takes its items in sweep order (by key), and an
+// item queued during a pass joins it if the pass has not reached its key yet, or
+// waits for the next pass otherwise. A rule is queued at most once; popping it
+// allows it to be queued again. With a rank table, index i is tracked at rank[i]
+// so a component's agenda only needs room for the component's own rules.
+class Agenda {
+public:
+    explicit Agenda(size_t size, const std::vector<uint32_t>* rank = nullptr)
+        : queued_(size, false), rank_(rank) {}
+
+    void push(size_t index, uint64_t key) {
+        size_t slot = rank_ ? (*rank_)[index] : index;
+        if (queued_[slot]) {
+            return;
+        }
+        queued_[slot] = true;
+        if (passing_ && key <= cursor_) {
+            later_.emplace_back(key, index);
+        } else {
+            pass_.emplace(key, index);
+        }
+    }
+
+    bool empty() const { return pass_.empty() && later_.empty(); }
+
+    // Take the current pass's next item; false once it is over (the next call
+    // starts another pass)
+    bool next(size_t& index) {
+        if (pass_.empty()) {
+            passing_ = false;
+            for (const Entry& entry : later_) {
+                pass_.push(entry);
+            }
+            later_.clear();
+            return false;
+        }
+        passing_ = true;
+        cursor_ = pass_.top().first;
+        index = pass_.top().second;
+        pass_.pop();
+        queued_[rank_ ? (*rank_)[index] : index] = false;
+        return true;
+    }
+
+private:
+    using Entry = std::pair<uint64_t, size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pass_;
+    std::vector<Entry> later_;  // Queued behind the pass's position
+    std::vector<bool> queued_;
+    const std::vector<uint32_t>* rank_;
+    bool passing_ = false;      // A pass has taken an item and not ended
+    uint64_t cursor_ = 0;       // Key of the item the pass took last
+};
+
+// Dependency graph of one run's derivable values ("facts": a literal holding TRUE
+// or FALSE). An edge a -> b means some rule can derive b once a holds. build()
+// condenses it into strongly connected components and ranks them in topological
+// order: a fact on a cycle shares its component's rank, any other fact ranks after
+// every fact it can be derived from. Facts are numbered in the order their
+// literals first appear, so the ranks of one connected component keep the same
+// relative order whether it is ranked alone or with others. A hub stands for an
+// n-ary clause: its inputs all lead to it and it leads to all its outputs, so a
+// clause of width n needs 2n edges instead of n².
+class FactOrder {
+public:
+    void addEdge(PropId from, Tripartite fromValue, PropId to, Tripartite toValue) {
+        edges_.emplace_back(fact(from, fromValue), fact(to, toValue));
+    }
+
+    uint32_t addHub() {
+        return hubs_++;
+    }
+
+    void addEdgeToHub(PropId from, Tripartite fromValue, uint32_t hub) {
+        edges_.emplace_back(fact(from, fromValue), hub | kHubBit);
+    }
+
+    void addEdgeFromHub(uint32_t hub, PropId to, Tripartite toValue) {
+        edges_.emplace_back(hub | kHubBit, fact(to, toValue));
+    }
+
+    void addHubEdge(uint32_t from, uint32_t to) {
+        edges_.emplace_back(from | kHubBit, to | kHubBit);
+    }
+
+    // Tarjan's algorithm, iteratively; components are found in reverse topological order
+    void build() {
+        facts_ = static_cast<uint32_t>(2 * literals_.size());
+        const uint32_t nodes = facts_ + hubs_;  // Facts, then hubs
+        for (auto& edge : edges_) {
+            edge.first = node(edge.first);
+            edge.second = node(edge.second);
+        }
+        std::vector<uint32_t> start(nodes + 1, 0);
+        for (const auto& edge : edges_) {
+            ++start[edge.first + 1];
+        }
+        for (uint32_t i = 0; i < nodes; ++i) {
+            start[i + 1] += start[i];
+        }
+        std::vector<uint32_t> targets(edges_.size());
+        std::vector<uint32_t> next(start.begin(), start.end() - 1);
+        for (const auto& edge : edges_) {
+            targets[next[edge.first]++] = edge.second;
+        }
+
+        constexpr uint32_t kUnvisited = UINT32_MAX;
+        std::vector<uint32_t> order(nodes, kUnvisited);
+        std::vector<uint32_t> low(nodes, 0);
+        std::vector<bool> onStack(nodes, false);
+        std::vector<uint32_t> stack;
+        std::vector<uint32_t> path;
+        uint32_t visited = 0;
+        uint32_t components = 0;
+        rank_.assign(nodes, 0);
+        auto visit = [&](uint32_t f) {
+            order[f] = low[f] = visited++;
+            next[f] = start[f];
+            stack.push_back(f);
+            onStack[f] = true;
+            path.push_back(f);
+        };
+        for (uint32_t root = 0; root < nodes; ++root) {
+            if (order[root] != kUnvisited) continue;
+            visit(root);
+            while (!path.empty()) {
+                uint32_t f = path.back();
+                if (next[f] < start[f + 1]) {
+                    uint32_t to = targets[next[f]++];
+                    if (order[to] == kUnvisited) {
+                        visit(to);
+                    } else if (onStack[to]) {
+                        low[f] = std::min(low[f], order[to]);
+                    }
+                    continue;
+                }
+                path.pop_back();
+                if (!path.empty()) {
+                    low[path.back()] = std::min(low[path.back()], low[f]);
+                }
+                if (low[f] == order[f]) {
+                    uint32_t member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        onStack[member] = false;
+                        rank_[member] = components;
+                    } while (member != f);
+                    ++components;
+                }
+            }
+        }
+        for (uint32_t& rank : rank_) {
+            rank = components - 1 - rank;
+        }
+        edges_.clear();
+        edges_.shrink_to_fit();
+    }
+
+    // Rank of a fact after build() (0 for a literal no rule derives or reads)
+    uint32_t rank(PropId id, Tripartite value) const {
+        auto found = literals_.find(id);
+        return found == literals_.end() ? 0 : rank_[2 * found->second + (value == Tripartite::FALSE)];
+    }
+
+    uint32_t hubRank(uint32_t hub) const {
+        return rank_[facts_ + hub];
+    }
+
+private:
+    static constexpr uint32_t kHubBit = 1u << 31;
+
+    std::unordered_map<PropId, uint32_t> literals_;       // Literal -> its number (facts 2n, 2n + 1)
+    std::vector<std::pair<uint32_t, uint32_t>> edges_;    // Until build()
+    std::vector<uint32_t> rank_;                          // Node -> topological rank
+    uint32_t hubs_ = 0;
+    uint32_t facts_ = 0;
+
+    uint32_t node(uint32_t endpoint) const {
+        return (endpoint & kHubBit) ? facts_ + (endpoint & ~kHubBit) : endpoint;
+    }
+
+    uint32_t fact(PropId id, Tripartite value) {
+        uint32_t literal = literals_.emplace(id, static_cast<uint32_t>(literals_.size())).first->second;
+        return 2 * literal + (value == Tripartite::FALSE);
+    }
+};
+
+// Agenda of the topological strategy, one queue for all phases. Steps pop by
+// rank, then phase, then knowledge base order. Like Agenda, an item is queued at
+// most once per phase: pushing it again at a lower rank moves it earlier, and
+// the entry it leaves behind is skipped when popped.
+class RankedAgenda {
+public:
+    struct Step {
+        uint32_t rank;
+        uint32_t phase;
+        size_t order;
+        size_t item;
+
+        bool operator>(const Step& other) const {
+            if (rank != other.rank) return rank > other.rank;
+            if (phase != other.phase) return phase > other.phase;
+            return order > other.order;
+        }
+    };
+
+    RankedAgenda(size_t ruleSpace, size_t expressionSpace,
+                 const std::vector<uint32_t>* ruleRank, const std::vector<uint32_t>* expressionRank)
+        : ruleQueued_(kRulePhases, std::vector<uint32_t>(ruleSpace, kNotQueued)),
+          expressionQueued_(expressionSpace, kNotQueued), ruleRank_(ruleRank),
+          expressionRank_(expressionRank) {}
+
+    void push(uint32_t rank, InferenceStats::Phase phase, size_t item, size_t order) {
+        uint32_t& queued = queuedAt(static_cast<uint32_t>(phase), item);
+        if (rank < queued) {
+            queued = rank;
+            heap_.push({rank, static_cast<uint32_t>(phase), order, item});
+        }
+    }
+
+    // Next step, or false once every queue is empty
+    bool pop(Step& step) {
+        while (!heap_.empty()) {
+            step = heap_.top();
+            heap_.pop();
+            uint32_t& queued = queuedAt(step.phase, step.item);
+            if (queued == step.rank) {
+                queued = kNotQueued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr uint32_t kNotQueued = UINT32_MAX;
+    static constexpr size_t kRulePhases = InferenceStats::kPhaseCount - 1;  // All but EXPRESSIONS
+
+    std::priority_queue<Step, std::vector<Step>, std::greater<Step>> heap_;
+    std::vector<std::vector<uint32_t>> ruleQueued_;  // Phase -> rule key -> rank queued at
+    std::vector<uint32_t> expressionQueued_;
+    const std::vector<uint32_t>* ruleRank_;
+    const std::vector<uint32_t>* expressionRank_;
+
+    uint32_t& queuedAt(uint32_t phase, size_t item) {
+        if (phase == static_cast<uint32_t>(InferenceStats::Phase::EXPRESSIONS)) {
+            return expressionQueued_[expressionRank_ ? (*expressionRank_)[item] : item];
+        }
+        return ruleQueued_[phase][ruleRank_ ? (*ruleRank_)[item] : item];
+    }
+};
+
+// Positions of the two literals an n-ary disjunction watches (a conjunction,
+// once visited, watches every literal and records first = second = 0)
+struct ClauseWatch {
+    static constexpr uint32_t kUnwatched = UINT32_MAX;
+
+    uint32_t first = kUnwatched;
+    uint32_t second = kUnwatched;
+};
+
+// Union-find over symbols, used to split the knowledge base into components
+class SymbolSets {
+public:
+    explicit SymbolSets(size_t symbols) : parent_(symbols) {
+        for (size_t i = 0; i < symbols; ++i) {
+            parent_[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    uint32_t find(uint32_t symbol) {
+        while (parent_[symbol] != symbol) {
+            parent_[symbol] = parent_[parent_[symbol]];
+            symbol = parent_[symbol];
+        }
+        return symbol;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) {
+            parent_[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+private:
+    std::vector<uint32_t> parent_;
+};
+
+inline uint32_t symbolOf(PropId id) {
+    return id >> 1;
+}
+
+// Add every clause linked to one already listed through a complementary literal.
+// Literals a clause forced are not kept between runs, so a clause seeded without
+// the clauses that forced its complements could not see them refuted.
+void addComplementaryClauses(const LiteralIndex& index, std::vector<RuleSlot>& clauses) {
+    std::unordered_set<RuleSlot> listed(clauses.begin(), clauses.end());
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        for (PropId literal : index.clauses().literals(clauses[i])) {
+            for (RuleSlot other : index.clausesContaining(negateId(literal))) {
+                if (listed.insert(other).second) {
+                    clauses.push_back(other);
+                }
+            }
+        }
+    }
+}
+
+// Adds the time between construction and destruction to a counter (if not null)
+class StatsTimer {
+public:
+    explicit StatsTimer(uint64_t* nanoseconds)
+        : nanoseconds_(InferenceStats::kCompiled ? nanoseconds : nullptr) {
+        if (nanoseconds_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~StatsTimer() {
+        if (nanoseconds_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            *nanoseconds_ += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+private:
+    uint64_t* nanoseconds_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace
+
+// ========== Binding ==========
+
+// Knowledge base of one deduceAll call. Names are resolved to PropIds once here;
+// afterwards the rules read truth values through byId and never hash a string.
+// Pointers into an unordered_map stay valid across the insertions rules make.
+struct InferenceEngine::Binding {
+    std::unordered_map<std::string, Proposition>& propositions;
+    std::vector<Expression>& expressions;
+    const LiteralIndex& index;
+    const SymbolTable& symbols;
+
+    // Resolved by bind() up front, or on first use by bindLazily() for incremental runs.
+    // Lazy resolution only happens on the single thread running the partition, and
+    // keeps sparse caches so a run never touches memory proportional to the whole base.
+    mutable std::vector<Proposition*> byId;        // PropId -> proposition (nullptr until it exists)
+    std::vector<const Proposition*> rule;          // Slot -> rule (nullptr if unused)
+    mutable std::unordered_map<PropId, Proposition*> lazyProps;      // Lazy only
+    mutable std::unordered_map<RuleSlot, const Proposition*> lazyRules;  // Lazy only
+    bool lazy = false;
+    Overlay* overlay = nullptr;  // Copy-on-write runs: values written here, never to propositions
+
+    std::vector<size_t> position;             // Slot -> rank in knowledge base iteration order (eager only)
+    std::vector<RuleSlot> implications;       // IMPLIES slots in iteration order (eager only)
+    std::vector<RuleSlot> disjunctions;       // OR slots in iteration order (eager only)
+    std::vector<RuleSlot> clauses;            // N-ary clause slots in iteration order (eager only)
+    std::vector<PropId> subjectOf;            // Expression -> literal of its subject
+    std::vector<std::vector<size_t>> expressionsByLiteral;  // Literal -> expressions reading it
+
+    Binding(std::unordered_map<std::string, Proposition>& props,
+            std::vector<Expression>& exprs, LiteralIndex& literalIndex)
+        : propositions(props), expressions(exprs), index(literalIndex),
+          symbols(literalIndex.symbols()) {
+        subjectOf.reserve(expressions.size());
+        for (Expression& expr : expressions) {
+            subjectOf.push_back(literalIndex.symbols().intern(expr.getPrefix()));
+            expr.bind(literalIndex.symbols());
+        }
+    }
+
+    // A copy-on-write run over a shared base. The base, its index and the symbol
+    // table are only read; expressions must already be bound (and are the
+    // caller's own copies, since evaluating one updates its state).
+    Binding(const std::unordered_map<std::string, Proposition>& base,
+            std::vector<Expression>& exprs, const LiteralIndex& literalIndex, Overlay& values)
+        : propositions(const_cast<std::unordered_map<std::string, Proposition>&>(base)),
+          expressions(exprs), index(literalIndex), symbols(literalIndex.symbols()),
+          overlay(&values) {
+        subjectOf.reserve(expressions.size());
+        for (const Expression& expr : expressions) {
+            PropId subject = 0;
+            symbols.find(expr.getPrefix(), subject);
+            subjectOf.push_back(subject);
+        }
+        bindLazily();
+    }
+
+    // Returns false if some rule in the knowledge base is missing from the index
+    // or was indexed with different operands
+    bool bind() {
+        rule.assign(index.slotCount(), nullptr);
+        position.assign(index.slotCount(), 0);
+        implications.clear();
+        disjunctions.clear();
+        clauses.clear();
+
+        size_t rank = 0;
+        for (const auto& entry : propositions) {
+            if (!LiteralIndex::isIndexedRule(entry.second)) continue;
+
+            RuleSlot slot;
+            if (!index.findSlot(entry.first, slot)) return false;
+            if (!matchesIndex(slot, entry.second)) return false;
+            rule[slot] = &entry.second;
+            position[slot] = rank++;
+            if (index.isClause(slot)) {
+                clauses.push_back(slot);
+            } else if (entry.second.getRelation() == LogicalOperator::IMPLIES) {
+                implications.push_back(slot);
+            } else {
+                disjunctions.push_back(slot);
+            }
+        }
+        if (rank != index.ruleCount()) return false;
+
+        // Resolve every known spelling; the canonical one wins if both "~P" and "!P" exist
+        byId.assign(symbols.idCount(), nullptr);
+        for (const auto& spelling : symbols.spellings()) {
+            auto it = propositions.find(spelling.first);
+            if (it == propositions.end()) continue;
+            if (!byId[spelling.second] || spelling.first == symbols.name(spelling.second)) {
+                byId[spelling.second] = &it->second;
+            }
+        }
+
+        indexExpressions();
+        return true;
+    }
+
+    // Trust the caller's index and look propositions and rules up only when a rule
+    // reaches them, so the cost of a run follows the region it touches. Rules are
+    // ordered by slot instead of knowledge base position.
+    void bindLazily() {
+        lazy = true;
+        byId.clear();
+        rule.clear();
+        indexExpressions();
+    }
+
+    // An expression is revisited when its subject or any operand changes
+    void indexExpressions() {
+        expressionsByLiteral.clear();
+        auto add = [&](PropId literal, size_t expression) {
+            if (literal >= expressionsByLiteral.size()) {
+                expressionsByLiteral.resize(literal + 1);
+            }
+            expressionsByLiteral[literal].push_back(expression);
+        };
+        for (size_t i = 0; i < expressions.size(); ++i) {
+            add(subjectOf[i], i);
+            for (PropId literal : expressions[i].getBoundLiterals()) {
+                if (literal != subjectOf[i]) {
+                    add(literal, i);
+                }
+            }
+        }
+    }
+
+    const std::vector<size_t>& expressionsReading(PropId id) const {
+        static const std::vector<size_t> kNone;
+        return id < expressionsByLiteral.size() ? expressionsByLiteral[id] : kNone;
+    }
+
+    bool matchesIndex(RuleSlot slot, const Proposition& prop) const {
+        if (LiteralIndex::isClause(prop) || index.isClause(slot)) {
+            return LiteralIndex::isClause(prop) && index.isClause(slot) && matchesClause(slot, prop);
+        }
+        PropId antecedent, consequent;
+        return symbols.find(prop.getAntecedent(), antecedent) &&
+               symbols.find(prop.getConsequent(), consequent) &&
+               antecedent == index.antecedentOf(slot) &&
+               consequent == index.consequentOf(slot);
+    }
+
+    // The store keeps each literal once, at its first position
+    bool matchesClause(RuleSlot slot, const Proposition& prop) const {
+        const ClauseStore& store = index.clauses();
+        ClauseKind kind = prop.getRelation() == LogicalOperator::AND ? ClauseKind::CONJUNCTION
+                                                                     : ClauseKind::DISJUNCTION;
+        if (store.kind(slot) != kind) return false;
+        ClauseStore::Literals literals = store.literals(slot);
+        size_t matched = 0;
+        for (const std::string& operand : prop.getOperands()) {
+            PropId id;
+            if (!symbols.find(operand, id)) return false;
+            if (matched < literals.size() && literals[matched] == id) {
+                ++matched;
+            } else if (std::find(literals.begin(), literals.begin() + matched, id) == literals.begin() + matched) {
+                return false;
+            }
+        }
+        return matched == literals.size();
+    }
+
+    Proposition* prop(PropId id) const {
+        if (!lazy) {
+            return byId[id];
+        }
+        auto cached = lazyProps.find(id);
+        if (cached != lazyProps.end()) {
+            return cached->second;
+        }
+        if (overlay) {
+            auto copied = overlay->find(id);
+            if (copied != overlay->end()) {
+                setProp(id, &copied->second);
+                return &copied->second;
+            }
+        }
+        const std::string& spelling = symbols.name(id);
+        auto it = propositions.find(spelling);
+        if (it == propositions.end() && SymbolTable::isNegatedName(spelling)) {
+            // The other negation spelling of the same literal
+            it = propositions.find((spelling[0] == '~' ? "!" : "~") + spelling.substr(1));
+        }
+        Proposition* found = (it != propositions.end()) ? &it->second : nullptr;
+        setProp(id, found);
+        return found;
+    }
+
+    // The proposition to write a literal's value to. A copy-on-write run copies it
+    // into the overlay first (or creates it there); otherwise this is prop(id).
+    Proposition* writable(PropId id) const {
+        Proposition* p = prop(id);
+        if (!overlay) {
+            return p;
+        }
+        auto copied = overlay->find(id);
+        if (copied == overlay->end()) {
+            copied = overlay->emplace(id, p ? *p : Proposition()).first;
+            setProp(id, &copied->second);
+        }
+        return &copied->second;
+    }
+
+    void setProp(PropId id, Proposition* p) const {
+        if (lazy) {
+            lazyProps[id] = p;
+            if (byId.empty()) return;
+        }
+        byId[id] = p;
+    }
+
+    const Proposition* ruleAt(RuleSlot slot) const {
+        if (!lazy) {
+            return rule[slot];
+        }
+        auto cached = lazyRules.find(slot);
+        if (cached != lazyRules.end()) {
+            return cached->second;
+        }
+        const Proposition* found = nullptr;
+        auto it = propositions.find(index.ruleKey(slot));
+        if (it != propositions.end() && matchesIndex(slot, it->second)) {
+            found = &it->second;
+        }
+        lazyRules.emplace(slot, found);
+        return found;
+    }
+
+    // Live values for an expression's operands. A lazy binding only builds the
+    // dense byId vector Expression::evaluate needs once an expression runs.
+    const std::vector<Proposition*>& operandValues(size_t expression) const {
+        if (lazy) {
+            if (byId.empty()) {
+                byId.assign(symbols.idCount(), nullptr);
+                for (const auto& entry : lazyProps) {
+                    byId[entry.first] = entry.second;
+                }
+            }
+            for (PropId literal : expressions[expression].getBoundLiterals()) {
+                prop(literal);
+            }
+        }
+        return byId;
+    }
+
+    size_t rank(RuleSlot slot) const { return lazy ? slot : position[slot]; }
+
+    Tripartite truth(PropId id) const {
+        const Proposition* p = prop(id);
+        return p ? p->getTruthValue() : Tripartite::UNKNOWN;
+    }
+
+    PropId antecedent(RuleSlot slot) const { return index.antecedentOf(slot); }
+    PropId consequent(RuleSlot slot) const { return index.consequentOf(slot); }
+    const std::string& name(PropId id) const { return symbols.name(id); }
+    const std::string& prefix(RuleSlot slot) const { return ruleAt(slot)->getPrefix(); }
+
+    // Disjunctions holding the complement of one of a disjunction's literals,
+    // in knowledge base order and excluding the disjunction itself
+    void resolutionPartners(RuleSlot slot, std::vector<RuleSlot>& partners) const {
+        partners.clear();
+        for (PropId disjunct : {antecedent(slot), consequent(slot)}) {
+            for (RuleSlot other : index.disjunctionsContainingComplement(disjunct)) {
+                if (other != slot && ruleAt(other)) {
+                    partners.push_back(other);
+                }
+            }
+        }
+        std::sort(partners.begin(), partners.end(), [this](RuleSlot a, RuleSlot b) {
+            return rank(a) < rank(b);
+        });
+        partners.erase(std::unique(partners.begin(), partners.end()), partners.end());
+    }
+};
+
+// ========== Budget ==========
+
+// A call's DeductionLimits as its runs spend them. Every step is counted and the
+// cancellation flag polled; the clock is read on every kClockStride-th step.
+// The first run to reach a limit stops every other run of the call.
+struct InferenceEngine::Budget {
+    static constexpr size_t kClockStride = 16;
+
+    const DeductionLimits limits;
+    std::atomic<size_t> steps{0};
+    std::atomic<Interruption> stopped{Interruption::NONE};
+
+    explicit Budget(const DeductionLimits& bounds) : limits(bounds) {}
+
+    // Take a step; false (and the step is not taken) once the call must stop
+    bool spend() {
+        if (stopped.load(std::memory_order_relaxed) != Interruption::NONE) {
+            return false;
+        }
+        size_t taken = steps.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (limits.maxSteps != 0 && taken > limits.maxSteps) {
+            return stop(Interruption::STEPS);
+        }
+        return (taken - 1) % kClockStride != 0 ? !cancelled() : !expired();
+    }
+
+    // Whether the call must stop, without taking a step
+    bool exhausted() {
+        return stopped.load(std::memory_order_relaxed) != Interruption::NONE || expired();
+    }
+
+    Interruption interruption() const {
+        return stopped.load(std::memory_order_relaxed);
+    }
+
+private:
+    bool cancelled() {
+        return limits.cancellation.isCancelled() && !stop(Interruption::CANCELLED);
+    }
+
+    bool expired() {
+        if (cancelled()) {
+            return true;
+        }
+        return limits.deadline != std::chrono::steady_clock::time_point::max() &&
+               std::chrono::steady_clock::now() >= limits.deadline && !stop(Interruption::DEADLINE);
+    }
+
+    // Record why the call stopped (the first reason wins); always false
+    bool stop(Interruption why) {
+        Interruption none = Interruption::NONE;
+        stopped.compare_exchange_strong(none, why, std::memory_order_relaxed);
+        return false;
+    }
+};
+
+// ========== Partition ==========
+
+// The rules and expressions one fixed-point run visits, in knowledge base order.
+// Partitions never share a symbol, so concurrent runs read and write disjoint
+// propositions and byId entries. Propositions a run creates are kept here and
+// inserted into the map once every run has finished.
+struct InferenceEngine::Partition {
+    Binding& kb;
+    std::vector<RuleSlot> implications;
+    std::vector<RuleSlot> disjunctions;
+    std::vector<RuleSlot> clauses;
+    std::vector<size_t> expressions;
+
+    // Agenda sizing: slot / expression -> rank within the partition (nullptr: identity)
+    const std::vector<uint32_t>* ruleRank = nullptr;
+    const std::vector<uint32_t>* expressionRank = nullptr;
+    size_t ruleSpace = 0;
+    size_t expressionSpace = 0;
+
+    std::vector<PropId>* changeLog = nullptr;                // Worklist strategy only
+    std::vector<std::pair<PropId, Tripartite>>* assigned = nullptr;  // Literal and replaced value of
+                                                                      // every assignment (incremental only)
+    std::deque<std::pair<PropId, Proposition>> created;      // Stable addresses for byId
+
+    // Goal-directed runs only (query): the rules and expressions that can influence
+    // the goal, and the goal itself, whose value ends the run as soon as it is known
+    const std::vector<bool>* ruleScope = nullptr;
+    const std::vector<bool>* expressionScope = nullptr;
+    const PropId* goal = nullptr;
+
+    // Convergence: steps and passes taken, and how often each literal was overturned.
+    // A literal overturned past Options::oscillationLimit ends the run.
+    size_t iterations = 0;
+    size_t passes = 0;
+    size_t conflicts = 0;
+    std::unordered_map<PropId, uint32_t> overturns;
+    bool oscillated = false;
+    PropId oscillating = 0;
+
+    std::unique_ptr<InferenceStats> stats;  // Only while collecting statistics
+    Budget* budget = nullptr;               // Only while the engine has limits
+
+    // The engine's expression DAG (null unless Options::shareExpressions); roots
+    // are indexed by expression. Partitions evaluate disjoint parts of it.
+    ExpressionDag* dag = nullptr;
+    const std::vector<uint32_t>* dagRoots = nullptr;
+    ExpressionDag::Scratch dagScratch;
+
+    // N-ary clauses: watched positions by rule rank (allocated on the first clause
+    // step), the clauses watching each literal, the clause that forced each literal
+    // with all its other literals FALSE, and the complements of literals forced
+    // since the strategy last looked. With complete watches every clause of the run
+    // was seeded; otherwise one nobody visited yet watches nothing, so the clauses
+    // containing a refuted literal are checked instead.
+    std::vector<ClauseWatch> clauseWatches;
+    std::unordered_map<PropId, std::vector<RuleSlot>> watchers;
+    std::unordered_map<PropId, RuleSlot> forcedBy;
+    std::vector<PropId> refutations;
+    bool watchesComplete = false;
+
+    // Worklist only: a pair step visits the pairs a FULL_SWEEP pass visits from its
+    // rule (as the first link, or the earlier disjunction), and a change also wakes
+    // the rules whose pairs it can make fire
+    bool sweepOrder = false;
+
+    explicit Partition(Binding& binding) : kb(binding) {}
+
+    ClauseWatch& watchOf(RuleSlot slot) {
+        if (clauseWatches.empty()) {
+            clauseWatches.resize(ruleSpace);
+        }
+        return clauseWatches[ruleRank ? (*ruleRank)[slot] : slot];
+    }
+
+    void unwatch(PropId literal, RuleSlot slot) {
+        std::vector<RuleSlot>& list = watchers[literal];
+        auto found = std::find(list.begin(), list.end(), slot);
+        if (found != list.end()) {
+            *found = list.back();
+            list.pop_back();
+        }
+    }
+
+    // A clause derived literal with every other literal FALSE: its complement is refuted
+    void force(PropId literal, RuleSlot clause) {
+        if (forcedBy.emplace(literal, clause).second) {
+            refutations.push_back(negateId(literal));
+        }
+    }
+
+    // FALSE, or the complement of a forced literal
+    bool refuted(PropId literal) const {
+        return kb.truth(literal) == Tripartite::FALSE ||
+               (!forcedBy.empty() && forcedBy.count(negateId(literal)) > 0);
+    }
+
+    // Whether refuting literal can change what a clause derives
+    bool watching(RuleSlot slot, PropId literal) const {
+        if (clauseWatches.empty()) {
+            return true;
+        }
+        const ClauseWatch& watch = clauseWatches[ruleRank ? (*ruleRank)[slot] : slot];
+        if (watch.first == ClauseWatch::kUnwatched || watch.first == watch.second) {
+            return true;
+        }
+        ClauseStore::Literals literals = kb.index.clauses().literals(slot);
+        return literals[watch.first] == literal || literals[watch.second] == literal;
+    }
+
+    Tripartite evaluate(size_t expression) {
+        uint32_t root = dag ? (*dagRoots)[expression] : ExpressionDag::kNoNode;
+        if (root == ExpressionDag::kNoNode) {
+            return kb.expressions[expression].evaluate(kb.operandValues(expression));
+        }
+        return dag->evaluate(root, [this](PropId literal) { return kb.prop(literal); }, dagScratch);
+    }
+
+    // A literal's value changed: expressions reading it must be recomputed
+    void changed(PropId literal) {
+        if (dag) {
+            dag->invalidate(literal, dagScratch);
+        }
+        if (changeLog) {
+            changeLog->push_back(literal);
+        }
+    }
+
+    // Count a step of a phase; returns the phase's timer (null when not collecting)
+    uint64_t* phaseStep(InferenceStats::Phase phase) {
+        if (!InferenceStats::kCompiled || !stats) {
+            return nullptr;
+        }
+        InferenceStats::PhaseCounts& counts = stats->phase(phase);
+        ++counts.steps;
+        return &counts.nanoseconds;
+    }
+
+    // Count an examination of a rule (or pair) and whether it fired; returns fired
+    bool tally(InferenceRule rule, bool fired) {
+        if (InferenceStats::kCompiled && stats) {
+            InferenceStats::RuleCounts& counts = stats->rule(rule);
+            ++counts.candidates;
+            counts.fired += fired;
+        }
+        return fired;
+    }
+
+    bool tallyExpression(bool changed) {
+        if (InferenceStats::kCompiled && stats) {
+            ++stats->expressions.candidates;
+            stats->expressions.fired += changed;
+        }
+        return changed;
+    }
+
+    // A rule the run may visit (it exists, and it is in scope of a goal-directed run)
+    bool reaches(RuleSlot slot) const {
+        return kb.ruleAt(slot) && (!ruleScope || (*ruleScope)[slot]);
+    }
+
+    bool reachesExpression(size_t expression) const {
+        return !expressionScope || (*expressionScope)[expression];
+    }
+
+    bool goalDecided() const {
+        return goal && kb.truth(*goal) != Tripartite::UNKNOWN;
+    }
+
+    // Charge the next step to the call's limits; false if the run must stop instead
+    bool spend() {
+        return !budget || budget->spend();
+    }
+
+    // Whether the call's limits stop the run, without charging a step
+    bool exhausted() const {
+        return budget && budget->exhausted();
+    }
+
+    // Every agenda step that mentions a literal: visit(phase, rule slot or expression)
+    template <typename Visit>
+    void dependents(PropId id, Visit visit) const {
+        using Phase = InferenceStats::Phase;
+        auto implication = [&](RuleSlot slot) {
+            if (reaches(slot)) {
+                visit(Phase::IMPLICATIONS, slot);
+                visit(Phase::SYLLOGISM, slot);
+            }
+        };
+        for (RuleSlot slot : kb.index.implicationsWithAntecedent(id)) implication(slot);
+        for (RuleSlot slot : kb.index.implicationsWithConsequent(id)) {
+            implication(slot);
+            // (P → Q, Q → id) is visited from P → Q
+            if (sweepOrder && reaches(slot)) {
+                for (RuleSlot first : kb.index.implicationsWithConsequent(kb.antecedent(slot))) {
+                    if (first != slot && reaches(first)) {
+                        visit(Phase::SYLLOGISM, first);
+                    }
+                }
+            }
+        }
+        for (RuleSlot slot : kb.index.disjunctionsContaining(id)) {
+            if (!reaches(slot)) continue;
+            visit(Phase::DISJUNCTIONS, slot);
+            visit(Phase::RESOLUTION, slot);
+            // A pair is visited from its earlier disjunction
+            if (sweepOrder) {
+                for (PropId disjunct : {kb.antecedent(slot), kb.consequent(slot)}) {
+                    for (RuleSlot other : kb.index.disjunctionsContainingComplement(disjunct)) {
+                        if (other != slot && reaches(other) && kb.rank(other) < kb.rank(slot)) {
+                            visit(Phase::RESOLUTION, other);
+                        }
+                    }
+                }
+            }
+        }
+        clausesRefuting(id, visit);
+        for (size_t i : kb.expressionsReading(id)) {
+            if (reachesExpression(i)) {
+                visit(Phase::EXPRESSIONS, i);
+            }
+        }
+    }
+
+    // The clause steps a literal wakes: only clauses watching it, once it is refuted
+    template <typename Visit>
+    void clausesRefuting(PropId id, Visit visit) const {
+        using Phase = InferenceStats::Phase;
+        if (!refuted(id)) {
+            return;
+        }
+        if (watchesComplete) {
+            auto found = watchers.find(id);
+            if (found == watchers.end()) {
+                return;
+            }
+            for (RuleSlot slot : found->second) {
+                if (reaches(slot)) {
+                    visit(Phase::DISJUNCTIONS, slot);
+                }
+            }
+            return;
+        }
+        for (RuleSlot slot : kb.index.clausesContaining(id)) {
+            if (reaches(slot) && watching(slot, id)) {
+                visit(Phase::DISJUNCTIONS, slot);
+            }
+        }
+    }
+
+    // Everything in the knowledge base
+    static Partition whole(Binding& binding) {
+        Partition part(binding);
+        part.implications = binding.implications;
+        part.disjunctions = binding.disjunctions;
+        part.clauses = binding.clauses;
+        part.watchesComplete = true;
+        part.expressions.resize(binding.expressions.size());
+        for (size_t i = 0; i < part.expressions.size(); ++i) {
+            part.expressions[i] = i;
+        }
+        part.ruleSpace = binding.index.slotCount();
+        part.expressionSpace = binding.expressions.size();
+        return part;
+    }
+};
+
+// ========== Premise ==========
+
+// A premise of a rule firing: a literal, or a rule cited by its key
+struct InferenceEngine::Premise {
+    uint32_t id;
+    bool isRule;
+
+    static Premise literal(PropId id) { return {id, false}; }
+    static Premise rule(RuleSlot slot) { return {slot, true}; }
+};
+
+// ========== GoalScope ==========
+
+// Backward search from a goal literal. Each literal is expanded once; every rule
+// that can assign it joins the scope and asks for the premise that rule would
+// need (Modus Ponens: the antecedent; Modus Tollens: the consequent; Disjunctive
+// Syllogism and Resolution: the disjunct left over). Hypothetical Syllogism is
+// covered link by link. An n-ary disjunction containing the literal or its
+// complement asks for its other literals, since it can derive the literal or
+// force the complement; a conjunction needs nothing. Expressions ask for every
+// operand.
+struct InferenceEngine::GoalScope {
+    const Binding& kb;
+    std::vector<bool> rules;        // Slot -> in scope
+    std::vector<bool> expressions;  // Expression -> in scope
+    size_t size = 0;
+    std::unordered_set<PropId> tabled;
+    std::deque<PropId> pending;
+
+    GoalScope(const Binding& binding, PropId goal)
+        : kb(binding), rules(binding.index.slotCount(), false),
+          expressions(binding.expressions.size(), false) {
+        want(goal);
+    }
+
+    void want(PropId id) {
+        if (tabled.insert(id).second) {
+            pending.push_back(id);
+        }
+    }
+
+    // Add a rule to the scope (and to added, if new); false if it does not exist
+    bool join(RuleSlot slot, std::vector<RuleSlot>& added) {
+        if (!rules[slot] && kb.ruleAt(slot)) {
+            rules[slot] = true;
+            added.push_back(slot);
+            ++size;
+        }
+        return rules[slot];
+    }
+
+    PropId otherDisjunct(RuleSlot slot, PropId id) const {
+        return kb.antecedent(slot) == id ? kb.consequent(slot) : kb.antecedent(slot);
+    }
+
+    // Expand pending literals, nearest first, until the scope holds target items.
+    // What joins is appended to part's rule and expression lists. Returns false
+    // once nothing is left to expand.
+    bool grow(Partition& part, size_t target) {
+        const LiteralIndex& index = kb.index;
+        while (!pending.empty() && size < target) {
+            PropId id = pending.front();
+            pending.pop_front();
+
+            for (RuleSlot slot : index.implicationsWithConsequent(id)) {
+                if (join(slot, part.implications)) want(kb.antecedent(slot));
+            }
+            for (RuleSlot slot : index.implicationsWithAntecedent(id)) {
+                if (join(slot, part.implications)) want(kb.consequent(slot));
+            }
+            for (RuleSlot slot : index.disjunctionsContaining(id)) {
+                if (!join(slot, part.disjunctions)) continue;
+                PropId other = otherDisjunct(slot, id);
+                want(other);
+                // id ∨ Q with ¬Q ∨ R: R FALSE resolves to id
+                for (RuleSlot partner : index.disjunctionsContaining(negateId(other))) {
+                    if (partner != slot && join(partner, part.disjunctions)) {
+                        want(otherDisjunct(partner, negateId(other)));
+                    }
+                }
+            }
+            for (PropId literal : {id, negateId(id)}) {
+                for (RuleSlot slot : index.clausesContaining(literal)) {
+                    if (!join(slot, part.clauses) || index.clauses().kind(slot) == ClauseKind::CONJUNCTION) {
+                        continue;
+                    }
+                    for (PropId other : index.clauses().literals(slot)) {
+                        if (other != literal) want(other);
+                    }
+                }
+            }
+            for (size_t i : kb.expressionsReading(id)) {
+                if (kb.subjectOf[i] == id && !expressions[i]) {
+                    expressions[i] = true;
+                    part.expressions.push_back(i);
+                    ++size;
+                    for (PropId literal : kb.expressions[i].getBoundLiterals()) {
+                        want(literal);
+                    }
+                }
+            }
+        }
+        return !pending.empty();
+    }
+};
+
+// ========== Options ==========
+
+InferenceEngine::InferenceEngine(const Options& opts) : options_(opts) {}
+
+void InferenceEngine::setOptions(const Options& opts) {
+    options_ = opts;
+}
+
+const InferenceEngine::Options& InferenceEngine::getOptions() const {
+    return options_;
+}
+
+const InferenceEngine::Convergence& InferenceEngine::getConvergence() const {
+    return convergence_;
+}
+
+const InferenceStats& InferenceEngine::getStats() const {
+    return stats_;
+}
+
+void InferenceEngine::resetStats() {
+    stats_ = InferenceStats();
+}
+
+void InferenceEngine::setLimits(const DeductionLimits& limits) {
+    limits_ = limits;
+    limited_ = true;
+}
+
+void InferenceEngine::clearLimits() {
+    limits_ = DeductionLimits();
+    limited_ = false;
+}
 
 // ========== Helper Methods ==========
 
@@ -15,51 +1103,70 @@ const Proposition* InferenceEngine::findProposition(const std::string& name,
     return (it != propositions.end()) ? &it->second : nullptr;
 }
 
-// Check if a proposition name represents a negation (starts with "~" or "!")
-bool InferenceEngine::isNegatedName(const std::string& name) {
-    return !name.empty() && (name[0] == '~' || name[0] == '!');
+// Set a literal's truth value, creating its proposition if it does not exist yet,
+// and record the id so the worklist can re-enqueue the rules that mention it.
+// Only full provenance spells out premise names and reads the clock.
+void InferenceEngine::assignTruthValue(Partition& part, PropId id, Tripartite value,
+                                       InferenceRule rule, std::initializer_list<Premise> premises) {
+    assignTruthValue(part, id, value, rule, premises.begin(), premises.size());
 }
 
-// Get the base name without negation prefix
-std::string InferenceEngine::getBaseName(const std::string& name) {
-    if (isNegatedName(name)) {
-        return name.substr(1);
+void InferenceEngine::assignTruthValue(Partition& part, PropId id, Tripartite value,
+                                       InferenceRule rule, const Premise* premises, size_t count) {
+    const Binding& kb = part.kb;
+    Proposition* prop = kb.writable(id);
+    if (!prop) {
+        part.created.emplace_back(id, Proposition());
+        prop = &part.created.back().second;
+        kb.setProp(id, prop);
     }
-    return name;
-}
-
-// Get the negated form of a name
-std::string InferenceEngine::getNegatedName(const std::string& name) {
-    if (isNegatedName(name)) {
-        return name.substr(1);  // Double negation returns the base name
+    Tripartite previous = prop->getTruthValue();
+    if (previous != Tripartite::UNKNOWN && previous != value) {
+        noteOverturn(part, id);
+    }
+    switch (options_.provenance) {
+        case ProvenanceLevel::FULL: {
+            std::vector<std::string> names;
+            names.reserve(count);
+            for (const Premise* premise = premises; premise != premises + count; ++premise) {
+                names.push_back(premise->isRule ? kb.prefix(premise->id) : kb.name(premise->id));
+            }
+            prop->setTruthValue(value, InferenceProvenance(rule, std::move(names)),
+                                options_.conflicts, options_.conflictHistory);
+            break;
+        }
+        case ProvenanceLevel::COMPACT: {
+            InferenceProvenance provenance(rule);
+            for (const Premise* premise = premises; premise != premises + count; ++premise) {
+                provenance.addPremiseId(premise->isRule ? kb.index.ruleLiteralOf(premise->id) : premise->id);
+            }
+            prop->setTruthValue(value, provenance, options_.conflicts, options_.conflictHistory);
+            break;
+        }
+        case ProvenanceLevel::NONE:
+        default:
+            prop->setTruthValue(value);
+            break;
+    }
+    part.changed(id);
+    if (part.assigned) {
+        part.assigned->emplace_back(id, previous);
     }
-    return "~" + name;
 }
 
 // ========== Basic Inference Rules ==========
 
 // Apply Modus Ponens: P → Q, P is TRUE ⊢ Q is TRUE
 // Returns true if a change was made (consequent wasn't already TRUE)
-bool InferenceEngine::applyModusPonens(const Proposition& implication,
-                                       std::unordered_map<std::string, Proposition>& propositions) {
-    const std::string& antecedentName = implication.getAntecedent();
-    const std::string& consequentName = implication.getConsequent();
-    
-    // Safe lookup of antecedent and consequent
-    const Proposition* antecedentProp = findProposition(antecedentName, propositions);
-    Proposition* consequentProp = findProposition(consequentName, propositions);
-    
-    Tripartite antecedentTruth = antecedentProp ? antecedentProp->getTruthValue() : Tripartite::UNKNOWN;
-    Tripartite consequentTruth = consequentProp ? consequentProp->getTruthValue() : Tripartite::UNKNOWN;
+bool InferenceEngine::applyModusPonens(Partition& part, RuleSlot implication) {
+    const Binding& kb = part.kb;
+    PropId antecedent = kb.antecedent(implication);
+    PropId consequent = kb.consequent(implication);
     
     // Only apply if antecedent is TRUE and consequent is not already TRUE
-    if (antecedentTruth == Tripartite::TRUE && consequentTruth != Tripartite::TRUE) {
-        InferenceProvenance prov("ModusPonens", {antecedentName, implication.getPrefix()});
-        if (consequentProp) {
-            consequentProp->setTruthValue(Tripartite::TRUE, prov);
-        } else {
-            propositions[consequentName].setTruthValue(Tripartite::TRUE, prov);
-        }
+    if (kb.truth(antecedent) == Tripartite::TRUE && kb.truth(consequent) != Tripartite::TRUE) {
+        assignTruthValue(part, consequent, Tripartite::TRUE, InferenceRule::MODUS_PONENS,
+                         {Premise::literal(antecedent), Premise::rule(implication)});
         return true;
     }
     return false;
@@ -67,26 +1174,15 @@ bool InferenceEngine::applyModusPonens(const Proposition& implication,
 
 // Apply Modus Tollens: P → Q, Q is FALSE ⊢ P is FALSE
 // Returns true if a change was made (antecedent wasn't already FALSE)
-bool InferenceEngine::applyModusTollens(const Proposition& implication,
-                                        std::unordered_map<std::string, Proposition>& propositions) {
-    const std::string& antecedentName = implication.getAntecedent();
-    const std::string& consequentName = implication.getConsequent();
-    
-    // Safe lookup of antecedent and consequent
-    Proposition* antecedentProp = findProposition(antecedentName, propositions);
-    const Proposition* consequentProp = findProposition(consequentName, propositions);
-    
-    Tripartite antecedentTruth = antecedentProp ? antecedentProp->getTruthValue() : Tripartite::UNKNOWN;
-    Tripartite consequentTruth = consequentProp ? consequentProp->getTruthValue() : Tripartite::UNKNOWN;
+bool InferenceEngine::applyModusTollens(Partition& part, RuleSlot implication) {
+    const Binding& kb = part.kb;
+    PropId antecedent = kb.antecedent(implication);
+    PropId consequent = kb.consequent(implication);
     
     // Only apply if consequent is FALSE and antecedent is not already FALSE
-    if (consequentTruth == Tripartite::FALSE && antecedentTruth != Tripartite::FALSE) {
-        InferenceProvenance prov("ModusTollens", {consequentName, implication.getPrefix()});
-        if (antecedentProp) {
-            antecedentProp->setTruthValue(Tripartite::FALSE, prov);
-        } else {
-            propositions[antecedentName].setTruthValue(Tripartite::FALSE, prov);
-        }
+    if (kb.truth(consequent) == Tripartite::FALSE && kb.truth(antecedent) != Tripartite::FALSE) {
+        assignTruthValue(part, antecedent, Tripartite::FALSE, InferenceRule::MODUS_TOLLENS,
+                         {Premise::literal(consequent), Premise::rule(implication)});
         return true;
     }
     return false;
@@ -96,54 +1192,32 @@ bool InferenceEngine::applyModusTollens(const Proposition& implication,
 
 // Apply Hypothetical Syllogism: P → Q, Q → R ⊢ P → R
 // When P is TRUE, transitively infers R is TRUE through the chain
-bool InferenceEngine::applyHypotheticalSyllogism(const Proposition& impl1,
-                                                  const Proposition& impl2,
-                                                  std::unordered_map<std::string, Proposition>& propositions) {
+bool InferenceEngine::applyHypotheticalSyllogism(Partition& part, RuleSlot impl1, RuleSlot impl2) {
+    const Binding& kb = part.kb;
     // impl1: P → Q (antecedent = P, consequent = Q)
     // impl2: Q → R (antecedent = Q, consequent = R)
     // Check if impl1's consequent matches impl2's antecedent
-    if (impl1.getConsequent() != impl2.getAntecedent()) {
+    if (kb.consequent(impl1) != kb.antecedent(impl2)) {
         return false;
     }
     
-    const std::string& P = impl1.getAntecedent();
-    const std::string& R = impl2.getConsequent();
-    
-    // Get truth values
-    const Proposition* pProp = findProposition(P, propositions);
-    Proposition* rProp = findProposition(R, propositions);
-    
-    Tripartite pTruth = pProp ? pProp->getTruthValue() : Tripartite::UNKNOWN;
-    Tripartite rTruth = rProp ? rProp->getTruthValue() : Tripartite::UNKNOWN;
+    PropId P = kb.antecedent(impl1);
+    PropId R = kb.consequent(impl2);
     
+    Tripartite pTruth = kb.truth(P);
     bool changesMade = false;
     
     // Forward chaining: If P is TRUE, then R is TRUE
-    if (pTruth == Tripartite::TRUE && rTruth != Tripartite::TRUE) {
-        InferenceProvenance prov("HypotheticalSyllogism", 
-                                  {P, impl1.getPrefix(), impl2.getPrefix()});
-        if (rProp) {
-            rProp->setTruthValue(Tripartite::TRUE, prov);
-        } else {
-            propositions[R].setTruthValue(Tripartite::TRUE, prov);
-        }
+    if (pTruth == Tripartite::TRUE && kb.truth(R) != Tripartite::TRUE) {
+        assignTruthValue(part, R, Tripartite::TRUE, InferenceRule::HYPOTHETICAL_SYLLOGISM,
+                         {Premise::literal(P), Premise::rule(impl1), Premise::rule(impl2)});
         changesMade = true;
     }
     
-    // Re-fetch R's truth value after forward chaining may have modified it
-    rProp = findProposition(R, propositions);
-    rTruth = rProp ? rProp->getTruthValue() : Tripartite::UNKNOWN;
-    
-    // Backward chaining: If R is FALSE, then P is FALSE
-    Proposition* pPropMut = findProposition(P, propositions);
-    if (rTruth == Tripartite::FALSE && pTruth != Tripartite::FALSE) {
-        InferenceProvenance prov("HypotheticalSyllogism", 
-                                  {R, impl2.getPrefix(), impl1.getPrefix()});
-        if (pPropMut) {
-            pPropMut->setTruthValue(Tripartite::FALSE, prov);
-        } else {
-            propositions[P].setTruthValue(Tripartite::FALSE, prov);
-        }
+    // Backward chaining: If R is FALSE (read after forward chaining), then P is FALSE
+    if (kb.truth(R) == Tripartite::FALSE && pTruth != Tripartite::FALSE) {
+        assignTruthValue(part, P, Tripartite::FALSE, InferenceRule::HYPOTHETICAL_SYLLOGISM,
+                         {Premise::literal(R), Premise::rule(impl2), Premise::rule(impl1)});
         changesMade = true;
     }
     
@@ -152,52 +1226,26 @@ bool InferenceEngine::applyHypotheticalSyllogism(const Proposition& impl1,
 
 // Apply Disjunctive Syllogism: P ∨ Q, ¬P ⊢ Q (and P ∨ Q, ¬Q ⊢ P)
 // For disjunctions stored with relation = OR, antecedent = P, consequent = Q
-bool InferenceEngine::applyDisjunctiveSyllogism(const Proposition& disjunction,
-                                                 std::unordered_map<std::string, Proposition>& propositions) {
-    const std::string& leftDisjunct = disjunction.getAntecedent();   // P in P ∨ Q
-    const std::string& rightDisjunct = disjunction.getConsequent();  // Q in P ∨ Q
-    
-    // Safe lookup of disjuncts
-    const Proposition* leftProp = findProposition(leftDisjunct, propositions);
-    const Proposition* rightProp = findProposition(rightDisjunct, propositions);
-    Proposition* leftPropMut = findProposition(leftDisjunct, propositions);
-    Proposition* rightPropMut = findProposition(rightDisjunct, propositions);
-    
-    Tripartite leftTruth = leftProp ? leftProp->getTruthValue() : Tripartite::UNKNOWN;
-    Tripartite rightTruth = rightProp ? rightProp->getTruthValue() : Tripartite::UNKNOWN;
+bool InferenceEngine::applyDisjunctiveSyllogism(Partition& part, RuleSlot disjunction) {
+    const Binding& kb = part.kb;
+    PropId leftDisjunct = kb.antecedent(disjunction);   // P in P ∨ Q
+    PropId rightDisjunct = kb.consequent(disjunction);  // Q in P ∨ Q
     
     bool changesMade = false;
     
     // Case 1: P ∨ Q, ¬P ⊢ Q
     // If left disjunct is FALSE, right disjunct must be TRUE
-    if (leftTruth == Tripartite::FALSE && rightTruth != Tripartite::TRUE) {
-        InferenceProvenance prov("DisjunctiveSyllogism", 
-                                  {leftDisjunct, disjunction.getPrefix()});
-        if (rightPropMut) {
-            rightPropMut->setTruthValue(Tripartite::TRUE, prov);
-        } else {
-            propositions[rightDisjunct].setTruthValue(Tripartite::TRUE, prov);
-        }
+    if (kb.truth(leftDisjunct) == Tripartite::FALSE && kb.truth(rightDisjunct) != Tripartite::TRUE) {
+        assignTruthValue(part, rightDisjunct, Tripartite::TRUE, InferenceRule::DISJUNCTIVE_SYLLOGISM,
+                         {Premise::literal(leftDisjunct), Premise::rule(disjunction)});
         changesMade = true;
     }
     
-    // Re-fetch truth values and mutable pointers after Case 1 may have modified the right disjunct
-    leftProp = findProposition(leftDisjunct, propositions);
-    rightProp = findProposition(rightDisjunct, propositions);
-    leftPropMut = findProposition(leftDisjunct, propositions);  // Re-fetch mutable pointer too
-    leftTruth = leftProp ? leftProp->getTruthValue() : Tripartite::UNKNOWN;
-    rightTruth = rightProp ? rightProp->getTruthValue() : Tripartite::UNKNOWN;
-    
-    // Case 2: P ∨ Q, ¬Q ⊢ P
+    // Case 2: P ∨ Q, ¬Q ⊢ P (truth values re-read after Case 1)
     // If right disjunct is FALSE, left disjunct must be TRUE
-    if (rightTruth == Tripartite::FALSE && leftTruth != Tripartite::TRUE) {
-        InferenceProvenance prov("DisjunctiveSyllogism", 
-                                  {rightDisjunct, disjunction.getPrefix()});
-        if (leftPropMut) {
-            leftPropMut->setTruthValue(Tripartite::TRUE, prov);
-        } else {
-            propositions[leftDisjunct].setTruthValue(Tripartite::TRUE, prov);
-        }
+    if (kb.truth(rightDisjunct) == Tripartite::FALSE && kb.truth(leftDisjunct) != Tripartite::TRUE) {
+        assignTruthValue(part, leftDisjunct, Tripartite::TRUE, InferenceRule::DISJUNCTIVE_SYLLOGISM,
+                         {Premise::literal(rightDisjunct), Premise::rule(disjunction)});
         changesMade = true;
     }
     
@@ -206,238 +1254,1144 @@ bool InferenceEngine::applyDisjunctiveSyllogism(const Proposition& disjunction,
 
 // Apply Resolution: P ∨ Q, ¬P ∨ R ⊢ Q ∨ R
 // Creates a new disjunction when two disjunctions share a complementary literal
-bool InferenceEngine::applyResolution(const Proposition& disj1,
-                                       const Proposition& disj2,
-                                       std::unordered_map<std::string, Proposition>& propositions) {
+bool InferenceEngine::applyResolution(Partition& part, RuleSlot disj1, RuleSlot disj2) {
+    const Binding& kb = part.kb;
     // disj1: P ∨ Q (antecedent = P, consequent = Q)
     // disj2: ¬P ∨ R (antecedent = ¬P, consequent = R)
     // Result: Q ∨ R
     
-    const std::string& p1Left = disj1.getAntecedent();
-    const std::string& p1Right = disj1.getConsequent();
-    const std::string& p2Left = disj2.getAntecedent();
-    const std::string& p2Right = disj2.getConsequent();
+    PropId p1Left = kb.antecedent(disj1);
+    PropId p1Right = kb.consequent(disj1);
+    PropId p2Left = kb.antecedent(disj2);
+    PropId p2Right = kb.consequent(disj2);
     
     bool changesMade = false;
     
     // Check all four possible complementary pairs
-    auto tryResolve = [&](const std::string& lit1, const std::string& other1,
-                          const std::string& lit2, const std::string& other2) -> bool {
-        // Check if lit1 and lit2 are complementary (one is negation of the other)
-        std::string baseLit1 = getBaseName(lit1);
-        std::string baseLit2 = getBaseName(lit2);
-        bool lit1Negated = isNegatedName(lit1);
-        bool lit2Negated = isNegatedName(lit2);
-        
-        // They are complementary if same base name but different polarity
-        if (baseLit1 == baseLit2 && lit1Negated != lit2Negated) {
+    auto tryResolve = [&](PropId lit1, PropId other1, PropId lit2, PropId other2) -> bool {
+        // They are complementary if same symbol but different polarity
+        if (lit1 == negateId(lit2)) {
             // Get truth values of the remaining disjuncts
-            const Proposition* other1Prop = findProposition(other1, propositions);
-            const Proposition* other2Prop = findProposition(other2, propositions);
-            
-            Tripartite other1Truth = other1Prop ? other1Prop->getTruthValue() : Tripartite::UNKNOWN;
-            Tripartite other2Truth = other2Prop ? other2Prop->getTruthValue() : Tripartite::UNKNOWN;
+            Tripartite other1Truth = kb.truth(other1);
+            Tripartite other2Truth = kb.truth(other2);
             
             // If one of the resolved disjuncts is FALSE, the other must be TRUE
             if (other1Truth == Tripartite::FALSE && other2Truth != Tripartite::TRUE) {
-                Proposition* other2PropMut = findProposition(other2, propositions);
-                InferenceProvenance prov("Resolution", 
-                                          {disj1.getPrefix(), disj2.getPrefix(), other1});
-                if (other2PropMut) {
-                    other2PropMut->setTruthValue(Tripartite::TRUE, prov);
-                } else {
-                    propositions[other2].setTruthValue(Tripartite::TRUE, prov);
-                }
+                assignTruthValue(part, other2, Tripartite::TRUE, InferenceRule::RESOLUTION,
+                                 {Premise::rule(disj1), Premise::rule(disj2), Premise::literal(other1)});
+                return true;
+            }
+            
+            if (other2Truth == Tripartite::FALSE && other1Truth != Tripartite::TRUE) {
+                assignTruthValue(part, other1, Tripartite::TRUE, InferenceRule::RESOLUTION,
+                                 {Premise::rule(disj1), Premise::rule(disj2), Premise::literal(other2)});
                 return true;
             }
-            
-            if (other2Truth == Tripartite::FALSE && other1Truth != Tripartite::TRUE) {
-                Proposition* other1PropMut = findProposition(other1, propositions);
-                InferenceProvenance prov("Resolution", 
-                                          {disj1.getPrefix(), disj2.getPrefix(), other2});
-                if (other1PropMut) {
-                    other1PropMut->setTruthValue(Tripartite::TRUE, prov);
-                } else {
-                    propositions[other1].setTruthValue(Tripartite::TRUE, prov);
-                }
-                return true;
+        }
+        return false;
+    };
+    
+    // Try all four combinations
+    if (tryResolve(p1Left, p1Right, p2Left, p2Right)) changesMade = true;
+    if (tryResolve(p1Left, p1Right, p2Right, p2Left)) changesMade = true;
+    if (tryResolve(p1Right, p1Left, p2Left, p2Right)) changesMade = true;
+    if (tryResolve(p1Right, p1Left, p2Right, p2Left)) changesMade = true;
+    
+    return changesMade;
+}
+
+// Apply an n-ary clause. A conjunction makes every conjunct TRUE (Simplification).
+// A disjunction watches two literals that are not refuted; when one is, the watch
+// moves to another such literal, and only when none is left does the clause assert
+// its last open literal: by Disjunctive Syllogism when every other literal is FALSE,
+// by Resolution when some were refuted through a complement another clause forced.
+// Returns true if a change was made; rule is set to the rule the step used.
+bool InferenceEngine::applyClause(Partition& part, RuleSlot clause, InferenceRule& rule) {
+    const Binding& kb = part.kb;
+    const ClauseStore& store = kb.index.clauses();
+    ClauseStore::Literals literals = store.literals(clause);
+    ClauseWatch& watch = part.watchOf(clause);
+    const uint32_t width = static_cast<uint32_t>(literals.size());
+    bool changesMade = false;
+
+    if (store.kind(clause) == ClauseKind::CONJUNCTION) {
+        rule = InferenceRule::SIMPLIFICATION;
+        if (watch.first == ClauseWatch::kUnwatched) {
+            watch.first = 0;
+            watch.second = 0;
+            for (PropId literal : literals) {
+                part.watchers[literal].push_back(clause);
+            }
+        }
+        for (PropId literal : literals) {
+            if (kb.truth(literal) != Tripartite::TRUE) {
+                assignTruthValue(part, literal, Tripartite::TRUE, InferenceRule::SIMPLIFICATION,
+                                 {Premise::rule(clause)});
+                changesMade = true;
+            }
+            part.force(literal, clause);
+        }
+        return changesMade;
+    }
+
+    rule = InferenceRule::DISJUNCTIVE_SYLLOGISM;
+    if (watch.first == ClauseWatch::kUnwatched) {
+        watch.first = 0;
+        watch.second = width > 1 ? 1 : 0;
+        part.watchers[literals[watch.first]].push_back(clause);
+        if (watch.second != watch.first) {
+            part.watchers[literals[watch.second]].push_back(clause);
+        }
+    }
+
+    // Move each refuted watch to a literal that is neither watched nor refuted
+    for (uint32_t* position : {&watch.first, &watch.second}) {
+        if (watch.first == watch.second || !part.refuted(literals[*position])) {
+            continue;
+        }
+        for (uint32_t k = 0; k < width; ++k) {
+            if (k != watch.first && k != watch.second && !part.refuted(literals[k])) {
+                part.unwatch(literals[*position], clause);
+                *position = k;
+                part.watchers[literals[k]].push_back(clause);
+                break;
+            }
+        }
+    }
+
+    bool firstOpen = !part.refuted(literals[watch.first]);
+    bool secondOpen = watch.second != watch.first && !part.refuted(literals[watch.second]);
+    if (firstOpen && secondOpen) {
+        return false;
+    }
+
+    // Every other literal is refuted. With none open the clause is contradicted;
+    // like a binary disjunction it still asserts one, preferring a literal that
+    // is only refuted through its complement over one that is FALSE.
+    uint32_t unit = watch.second;
+    if (firstOpen) {
+        unit = watch.first;
+    } else if (!secondOpen && kb.truth(literals[watch.second]) == Tripartite::FALSE &&
+               kb.truth(literals[watch.first]) != Tripartite::FALSE) {
+        unit = watch.first;
+    }
+    PropId target = literals[unit];
+
+    bool resolved = false;
+    for (uint32_t k = 0; k < width && !resolved; ++k) {
+        resolved = k != unit && kb.truth(literals[k]) != Tripartite::FALSE;
+    }
+    if (resolved) {
+        rule = InferenceRule::RESOLUTION;
+    }
+
+    if (kb.truth(target) != Tripartite::TRUE) {
+        std::vector<Premise> premises;
+        premises.reserve(width + 1);
+        premises.push_back(Premise::rule(clause));
+        for (uint32_t k = 0; k < width; ++k) {
+            if (k == unit) {
+                continue;
+            }
+            PropId literal = literals[k];
+            if (kb.truth(literal) == Tripartite::FALSE) {
+                premises.push_back(Premise::literal(literal));
+            } else {
+                PropId complement = negateId(literal);
+                premises.push_back(Premise::rule(part.forcedBy.at(complement)));
+                premises.push_back(Premise::literal(complement));
+            }
+        }
+        assignTruthValue(part, target, Tripartite::TRUE, rule, premises.data(), premises.size());
+        changesMade = true;
+    }
+    // Only a literal derived from FALSE literals alone refutes its complement, so
+    // a chain of clauses resolves one link per step, as binary Resolution does
+    if (!resolved) {
+        part.force(target, clause);
+    }
+    return changesMade;
+}
+
+// Apply an expression's result to its subject according to the subject's quantifier.
+// Returns true if the subject's value changed. PARTICULAR_AFFIRMATIVE re-asserts
+// TRUE even when the subject already holds it (dropping its provenance), but that
+// is not a change, or FULL_SWEEP would never finish.
+bool InferenceEngine::applyExpression(Partition& part, size_t expression) {
+    const Binding& kb = part.kb;
+    Tripartite resultValue = part.evaluate(expression);
+    PropId subject = kb.subjectOf[expression];
+
+    // Skip if subject proposition doesn't exist
+    Proposition* subjectProp = kb.prop(subject);
+    if (!subjectProp) {
+        return false;
+    }
+    Tripartite currentValue = subjectProp->getTruthValue();
+    Quantifier scope = subjectProp->getPropositionScope();
+    Tripartite newValue = Tripartite::UNKNOWN;
+    bool assigned = false;
+
+    switch (scope) {
+        case Quantifier::UNIVERSAL_AFFIRMATIVE:
+            if (currentValue != resultValue && resultValue == Tripartite::TRUE) {
+                newValue = Tripartite::TRUE;
+                assigned = true;
+            }
+            break;
+
+        case Quantifier::UNIVERSAL_NEGATIVE:
+            if (currentValue != resultValue && resultValue == Tripartite::FALSE) {
+                newValue = Tripartite::FALSE;
+                assigned = true;
+            }
+            break;
+
+        case Quantifier::PARTICULAR_AFFIRMATIVE:
+            if (resultValue == Tripartite::TRUE) {
+                newValue = Tripartite::TRUE;
+                assigned = true;
+            }
+            break;
+
+        case Quantifier::PARTICULAR_NEGATIVE:
+            if (resultValue == Tripartite::FALSE && currentValue != Tripartite::TRUE) {
+                newValue = Tripartite::FALSE;
+                assigned = true;
             }
-        }
+            break;
+
+        default:
+            break;
+    }
+
+    if (!assigned) {
         return false;
-    };
-    
-    // Try all four combinations
-    if (tryResolve(p1Left, p1Right, p2Left, p2Right)) changesMade = true;
-    if (tryResolve(p1Left, p1Right, p2Right, p2Left)) changesMade = true;
-    if (tryResolve(p1Right, p1Left, p2Left, p2Right)) changesMade = true;
-    if (tryResolve(p1Right, p1Left, p2Right, p2Left)) changesMade = true;
-    
-    return changesMade;
+    }
+    subjectProp = kb.writable(subject);
+    subjectProp->setTruthValue(newValue);
+    if (newValue == currentValue) {
+        return false;
+    }
+    if (currentValue != Tripartite::UNKNOWN) {
+        noteOverturn(part, subject);
+    }
+    part.changed(subject);
+    if (part.assigned) {
+        part.assigned->emplace_back(subject, currentValue);
+    }
+    return true;
 }
 
-void InferenceEngine::deduceAll(std::unordered_map<std::string, Proposition>& propositions,
-                                std::vector<Expression>& expressions) {
+// ========== Fixed-Point Strategies ==========
+
+void InferenceEngine::deduceFullSweep(Partition& part) {
+    const Binding& kb = part.kb;
+    std::vector<RuleSlot> partners;
+    using Phase = InferenceStats::Phase;
+    
     bool changesMade;
     do {
+        if (!part.spend()) {
+            return;
+        }
         changesMade = false;
+        ++part.iterations;
+        ++part.passes;
         
         // ============================================================
         // PHASE 1: Apply basic inference rules to IMPLIES propositions
         // ============================================================
-        // Collect all IMPLIES proposition keys first to avoid iterator invalidation
-        std::vector<std::string> impliesKeys;
-        for (const auto& entry : propositions) {
-            if (entry.second.getRelation() == LogicalOperator::IMPLIES) {
-                impliesKeys.push_back(entry.first);
+        {
+            StatsTimer timer(part.phaseStep(Phase::IMPLICATIONS));
+            for (RuleSlot slot : part.implications) {
+                // Apply Modus Ponens: P → Q, P is TRUE ⊢ Q is TRUE
+                if (part.tally(InferenceRule::MODUS_PONENS, applyModusPonens(part, slot))) {
+                    changesMade = true;
+                }
+                
+                // Apply Modus Tollens: P → Q, Q is FALSE ⊢ P is FALSE
+                if (part.tally(InferenceRule::MODUS_TOLLENS, applyModusTollens(part, slot))) {
+                    changesMade = true;
+                }
             }
         }
-        
-        // Now iterate over the collected keys
-        for (const auto& key : impliesKeys) {
-            auto it = propositions.find(key);
-            if (it == propositions.end()) continue;  // Skip if key was removed
-            
-            const Proposition& prop = it->second;
-            // Apply Modus Ponens: P → Q, P is TRUE ⊢ Q is TRUE
-            if (applyModusPonens(prop, propositions)) {
-                changesMade = true;
-            }
-            
-            // Re-fetch after possible insertion
-            it = propositions.find(key);
-            if (it == propositions.end()) continue;
-            
-            // Apply Modus Tollens: P → Q, Q is FALSE ⊢ P is FALSE
-            if (applyModusTollens(it->second, propositions)) {
-                changesMade = true;
-            }
+        if (part.exhausted()) {
+            return;
         }
         
         // ============================================================
         // PHASE 2: Apply Hypothetical Syllogism to pairs of implications
         // P → Q, Q → R ⊢ derives truth through the chain
         // ============================================================
-        // Store keys instead of pointers to avoid dangling pointers after rehashing
-        std::vector<std::string> implicationKeys;
-        for (const auto& entry : propositions) {
-            if (entry.second.getRelation() == LogicalOperator::IMPLIES) {
-                implicationKeys.push_back(entry.first);
-            }
-        }
-        
-        for (size_t i = 0; i < implicationKeys.size(); ++i) {
-            for (size_t j = 0; j < implicationKeys.size(); ++j) {
-                if (i != j) {
-                    // Fetch propositions by key each time to ensure valid references
-                    auto it_i = propositions.find(implicationKeys[i]);
-                    auto it_j = propositions.find(implicationKeys[j]);
-                    
-                    if (it_i != propositions.end() && it_j != propositions.end()) {
-                        if (applyHypotheticalSyllogism(it_i->second, it_j->second, propositions)) {
+        // Only implications whose antecedent is impl1's consequent can chain with it
+        {
+            StatsTimer timer(part.phaseStep(Phase::SYLLOGISM));
+            for (RuleSlot i : part.implications) {
+                for (RuleSlot j : kb.index.implicationsWithAntecedent(kb.consequent(i))) {
+                    if (i != j && kb.ruleAt(j)) {
+                        if (part.tally(InferenceRule::HYPOTHETICAL_SYLLOGISM,
+                                       applyHypotheticalSyllogism(part, i, j))) {
                             changesMade = true;
                         }
                     }
                 }
             }
         }
+        if (part.exhausted()) {
+            return;
+        }
         
         // ============================================================
         // PHASE 3: Apply Disjunctive Syllogism to OR propositions
         // P ∨ Q, ¬P ⊢ Q
         // ============================================================
-        // Collect all OR proposition keys first to avoid iterator invalidation
-        std::vector<std::string> orKeys;
-        for (const auto& entry : propositions) {
-            if (entry.second.getRelation() == LogicalOperator::OR) {
-                orKeys.push_back(entry.first);
+        {
+            StatsTimer timer(part.phaseStep(Phase::DISJUNCTIONS));
+            for (RuleSlot slot : part.disjunctions) {
+                if (part.tally(InferenceRule::DISJUNCTIVE_SYLLOGISM, applyDisjunctiveSyllogism(part, slot))) {
+                    changesMade = true;
+                }
             }
-        }
-        
-        // Now iterate over the collected keys
-        for (const auto& key : orKeys) {
-            auto it = propositions.find(key);
-            if (it == propositions.end()) continue;  // Skip if key was removed
-            
-            if (applyDisjunctiveSyllogism(it->second, propositions)) {
+            // N-ary clauses; a literal forced without changing value still refutes
+            // its complement, which another clause may only see on the next pass
+            for (RuleSlot slot : part.clauses) {
+                InferenceRule rule;
+                bool fired = applyClause(part, slot, rule);
+                if (part.tally(rule, fired)) {
+                    changesMade = true;
+                }
+            }
+            if (!part.refutations.empty()) {
+                part.refutations.clear();
                 changesMade = true;
             }
         }
+        if (part.exhausted()) {
+            return;
+        }
         
         // ============================================================
         // PHASE 4: Apply Resolution to pairs of OR propositions
         // P ∨ Q, ¬P ∨ R ⊢ Q ∨ R
         // ============================================================
-        // Store keys instead of pointers to avoid dangling pointers after rehashing
-        std::vector<std::string> disjunctionKeys;
-        for (const auto& entry : propositions) {
-            if (entry.second.getRelation() == LogicalOperator::OR) {
-                disjunctionKeys.push_back(entry.first);
-            }
-        }
-        
-        for (size_t i = 0; i < disjunctionKeys.size(); ++i) {
-            for (size_t j = i + 1; j < disjunctionKeys.size(); ++j) {
-                // Fetch propositions by key each time to ensure valid references
-                auto it_i = propositions.find(disjunctionKeys[i]);
-                auto it_j = propositions.find(disjunctionKeys[j]);
-                
-                if (it_i != propositions.end() && it_j != propositions.end()) {
-                    if (applyResolution(it_i->second, it_j->second, propositions)) {
-                        changesMade = true;
+        // Only disjunctions sharing a complementary literal can resolve;
+        // each unordered pair is visited once, earlier rule first
+        {
+            StatsTimer timer(part.phaseStep(Phase::RESOLUTION));
+            for (RuleSlot i : part.disjunctions) {
+                kb.resolutionPartners(i, partners);
+                for (RuleSlot j : partners) {
+                    if (kb.rank(j) > kb.rank(i)) {
+                        if (part.tally(InferenceRule::RESOLUTION, applyResolution(part, i, j))) {
+                            changesMade = true;
+                        }
                     }
                 }
             }
         }
+        if (part.exhausted()) {
+            return;
+        }
         
         // ============================================================
         // PHASE 5: Evaluate explicit Expression objects (if any)
         // ============================================================
-        for (auto& expr : expressions) {
-            Tripartite resultValue = expr.evaluate();
-            const std::string& subject = expr.getPrefix();
-
-            // Safe lookup of subject proposition
-            Proposition* subjectProp = findProposition(subject, propositions);
-            if (!subjectProp) {
-                // Skip if subject proposition doesn't exist
-                continue;
+        {
+            StatsTimer timer(part.phaseStep(Phase::EXPRESSIONS));
+            for (size_t i : part.expressions) {
+                if (part.tallyExpression(applyExpression(part, i))) {
+                    changesMade = true;
+                }
             }
+        }
+    } while (changesMade && !part.oscillated);
+}
 
-            Tripartite currentValue = subjectProp->getTruthValue();
-            Quantifier scope = subjectProp->getPropositionScope();
+// Semi-naive fixed point. Every rule starts on the agenda of each phase it takes part
+// in; afterwards a rule is only revisited when a proposition it mentions (antecedent,
+// consequent or disjunct) changes value. The agendas are drained in rounds that
+// mirror FULL_SWEEP passes: each phase in turn, each in knowledge base order, pairs
+// visited from the same rule as the sweep. A rule left off the agenda would not
+// fire if the sweep visited it, so the rules that do fire, and the provenance they
+// record, are the sweep's.
+void InferenceEngine::deduceWorklist(Partition& part) {
+    const Binding& kb = part.kb;
+    using Phase = InferenceStats::Phase;
 
-            switch (scope) {
-                case Quantifier::UNIVERSAL_AFFIRMATIVE:
-                    if (currentValue != resultValue && resultValue == Tripartite::TRUE) {
-                        subjectProp->setTruthValue(Tripartite::TRUE);
-                        changesMade = true;
-                    }
-                    break;
+    // One agenda per phase: Modus Ponens / Tollens, Hypothetical Syllogism,
+    // Disjunctive Syllogism, Resolution, Expressions
+    std::vector<Agenda> agendas;
+    agendas.reserve(InferenceStats::kPhaseCount);
+    for (size_t phase = 0; phase + 1 < InferenceStats::kPhaseCount; ++phase) {
+        agendas.emplace_back(part.ruleSpace, part.ruleRank);
+    }
+    agendas.emplace_back(part.expressionSpace, part.expressionRank);
+    // Sweep order: knowledge base order, binary disjunctions before clauses
+    auto enqueue = [&](Phase phase, size_t item) {
+        uint64_t key = item;
+        if (phase != Phase::EXPRESSIONS) {
+            RuleSlot slot = static_cast<RuleSlot>(item);
+            bool clause = phase == Phase::DISJUNCTIONS && kb.index.isClause(slot);
+            key = (static_cast<uint64_t>(clause) << 32) | kb.rank(slot);
+        }
+        agendas[static_cast<size_t>(phase)].push(item, key);
+    };
 
-                case Quantifier::UNIVERSAL_NEGATIVE:
-                    if (currentValue != resultValue && resultValue == Tripartite::FALSE) {
-                        subjectProp->setTruthValue(Tripartite::FALSE);
-                        changesMade = true;
-                    }
-                    break;
+    for (RuleSlot slot : part.implications) {
+        enqueue(Phase::IMPLICATIONS, slot);
+        enqueue(Phase::SYLLOGISM, slot);
+    }
+    for (RuleSlot slot : part.disjunctions) {
+        enqueue(Phase::DISJUNCTIONS, slot);
+        enqueue(Phase::RESOLUTION, slot);
+    }
+    for (RuleSlot slot : part.clauses) {
+        enqueue(Phase::DISJUNCTIONS, slot);
+    }
+    for (size_t i : part.expressions) {
+        enqueue(Phase::EXPRESSIONS, i);
+    }
 
-                case Quantifier::PARTICULAR_AFFIRMATIVE:
-                    if (resultValue == Tripartite::TRUE) {
-                        subjectProp->setTruthValue(Tripartite::TRUE);
-                        changesMade = true;
-                    }
-                    break;
+    std::vector<PropId> changed;
+    std::vector<RuleSlot> partners;
+    part.changeLog = &changed;
+    part.sweepOrder = true;
 
-                case Quantifier::PARTICULAR_NEGATIVE:
-                    if (resultValue == Tripartite::FALSE && currentValue != Tripartite::TRUE) {
-                        subjectProp->setTruthValue(Tripartite::FALSE);
-                        changesMade = true;
-                    }
-                    break;
+    // One pass per phase per round, until no agenda holds anything
+    auto step = [&](size_t phase, size_t item) {
+        if (!part.spend()) {
+            return false;
+        }
+        applyStep(part, static_cast<Phase>(phase), item, partners);
+
+        ++part.iterations;
+        if (part.goalDecided() || part.oscillated) {
+            return false;
+        }
+        // Re-enqueue every rule that mentions a literal changed by the step,
+        // and the clauses watching a literal a forced complement refuted
+        for (PropId id : changed) {
+            part.dependents(id, enqueue);
+        }
+        changed.clear();
+        for (PropId id : part.refutations) {
+            part.clausesRefuting(id, enqueue);
+        }
+        part.refutations.clear();
+        return true;
+    };
+    bool running = true;
+    while (running && std::any_of(agendas.begin(), agendas.end(), [](const Agenda& a) { return !a.empty(); })) {
+        for (size_t phase = 0; running && phase < agendas.size(); ++phase) {
+            size_t item;
+            while (running && agendas[phase].next(item)) {
+                running = step(phase, item);
+            }
+        }
+    }
+
+    part.changeLog = nullptr;
+    part.sweepOrder = false;
+}
+
+// The worklist, with every step ranked by the fact that made it worth running.
+// Facts (a literal holding TRUE or FALSE) form a dependency graph: Modus Ponens
+// leads from P to Q, Modus Tollens from not-Q to not-P, each Disjunctive Syllogism
+// and Resolution case from a FALSE disjunct to a TRUE one, and an expression from
+// each operand to its subject. Hypothetical Syllogism only shortcuts paths the
+// implications already have. A step is seeded at the lowest rank among the facts
+// that could trigger it and, after a change, queued at the rank of the new fact,
+// which ranks after the facts it was derived from. Steps therefore run in one
+// sweep through the component order; only a cyclic component sees its own facts
+// again, and only an overturned value (a fact the graph does not order) can send
+// the sweep back to an earlier component.
+void InferenceEngine::deduceTopological(Partition& part) {
+    const Binding& kb = part.kb;
+    using Phase = InferenceStats::Phase;
+    constexpr Tripartite T = Tripartite::TRUE;
+    constexpr Tripartite F = Tripartite::FALSE;
+
+    FactOrder facts;
+    std::vector<RuleSlot> partners;
+    for (RuleSlot slot : part.implications) {
+        facts.addEdge(kb.antecedent(slot), T, kb.consequent(slot), T);
+        facts.addEdge(kb.consequent(slot), F, kb.antecedent(slot), F);
+    }
+    for (RuleSlot slot : part.disjunctions) {
+        PropId left = kb.antecedent(slot);
+        PropId right = kb.consequent(slot);
+        facts.addEdge(left, F, right, T);
+        facts.addEdge(right, F, left, T);
+        // Resolving on a complementary pair relates the two disjuncts left over
+        kb.resolutionPartners(slot, partners);
+        for (RuleSlot other : partners) {
+            for (PropId pivot : {left, right}) {
+                PropId rest = pivot == left ? right : left;
+                PropId otherLeft = kb.antecedent(other);
+                PropId otherRight = kb.consequent(other);
+                for (PropId otherPivot : {otherLeft, otherRight}) {
+                    if (pivot != negateId(otherPivot)) continue;
+                    PropId otherRest = otherPivot == otherLeft ? otherRight : otherLeft;
+                    facts.addEdge(rest, F, otherRest, T);
+                    facts.addEdge(otherRest, F, rest, T);
+                }
+            }
+        }
+    }
+    // A disjunction derives each literal once every other one is refuted, and a
+    // conjunction derives them all; a literal one clause forces refutes its
+    // complement in every other clause
+    std::unordered_map<RuleSlot, uint32_t> hubOf;
+    for (RuleSlot slot : part.clauses) {
+        uint32_t hub = facts.addHub();
+        hubOf.emplace(slot, hub);
+        bool disjunction = kb.index.clauses().kind(slot) == ClauseKind::DISJUNCTION;
+        for (PropId literal : kb.index.clauses().literals(slot)) {
+            if (disjunction) {
+                facts.addEdgeToHub(literal, F, hub);
+            }
+            facts.addEdgeFromHub(hub, literal, T);
+        }
+    }
+    for (RuleSlot slot : part.clauses) {
+        for (PropId literal : kb.index.clauses().literals(slot)) {
+            for (RuleSlot other : kb.index.clausesContaining(negateId(literal))) {
+                auto found = hubOf.find(other);
+                if (found != hubOf.end() && other != slot) {
+                    facts.addHubEdge(hubOf[slot], found->second);
+                }
+            }
+        }
+    }
+    for (size_t i : part.expressions) {
+        PropId subject = kb.subjectOf[i];
+        for (PropId literal : kb.expressions[i].getBoundLiterals()) {
+            for (Tripartite from : {T, F}) {
+                facts.addEdge(literal, from, subject, T);
+                facts.addEdge(literal, from, subject, F);
+            }
+        }
+    }
+    facts.build();
+
+    RankedAgenda agenda(part.ruleSpace, part.expressionSpace, part.ruleRank, part.expressionRank);
+    auto push = [&](uint32_t rank, Phase phase, size_t item) {
+        agenda.push(rank, phase, item, phase == Phase::EXPRESSIONS ? item : kb.rank(static_cast<RuleSlot>(item)));
+    };
+
+    // Rank a step is due at once a literal holds a value, or kNever if that
+    // value cannot make it fire. A Hypothetical Syllogism step shortcuts what
+    // Modus Ponens / Tollens derive from the same fact, so it waits for that
+    // derivation's rank and the single-step rules still fire first.
+    constexpr uint32_t kNever = UINT32_MAX;
+    auto dueAt = [&](Phase phase, size_t item, PropId id, Tripartite value) -> uint32_t {
+        RuleSlot slot = static_cast<RuleSlot>(item);
+        switch (phase) {
+            case Phase::IMPLICATIONS:
+            case Phase::SYLLOGISM: {
+                uint32_t due = kNever;
+                bool shortcut = phase == Phase::SYLLOGISM;
+                if (id == kb.antecedent(slot) && value == T) {
+                    due = shortcut ? facts.rank(kb.consequent(slot), T) : facts.rank(id, T);
+                }
+                if (id == kb.consequent(slot) && value == F) {
+                    due = std::min(due, shortcut ? facts.rank(kb.antecedent(slot), F) : facts.rank(id, F));
+                }
+                return due;
+            }
+            case Phase::DISJUNCTIONS:
+                // A clause only wakes for a refuted watch; it is due when its hub is
+                if (kb.index.isClause(slot)) {
+                    return facts.hubRank(hubOf.at(slot));
+                }
+                return value == F ? facts.rank(id, F) : kNever;
+            case Phase::RESOLUTION:
+                return value == F ? facts.rank(id, F) : kNever;
+            case Phase::EXPRESSIONS:
+            default:
+                return facts.rank(id, value);
+        }
+    };
+    // Seed each step at the earliest of the values it mentions that already hold.
+    // Steps with none wait for one, except expressions (constants may decide them).
+    auto seed = [&](Phase phase, size_t item, const auto& literals) {
+        uint32_t due = kNever;
+        for (PropId literal : literals) {
+            Tripartite value = kb.truth(literal);
+            if (value != Tripartite::UNKNOWN) {
+                due = std::min(due, dueAt(phase, item, literal, value));
+            }
+        }
+        if (due == kNever && phase == Phase::EXPRESSIONS) {
+            due = 0;
+        }
+        push(due, phase, item);
+    };
+    for (RuleSlot slot : part.implications) {
+        std::initializer_list<PropId> literals{kb.antecedent(slot), kb.consequent(slot)};
+        seed(Phase::IMPLICATIONS, slot, literals);
+        seed(Phase::SYLLOGISM, slot, literals);
+    }
+    for (RuleSlot slot : part.disjunctions) {
+        std::initializer_list<PropId> literals{kb.antecedent(slot), kb.consequent(slot)};
+        seed(Phase::DISJUNCTIONS, slot, literals);
+        seed(Phase::RESOLUTION, slot, literals);
+    }
+    // Every clause runs once to set up its watches
+    for (RuleSlot slot : part.clauses) {
+        push(facts.hubRank(hubOf.at(slot)), Phase::DISJUNCTIONS, slot);
+    }
+    for (size_t i : part.expressions) {
+        seed(Phase::EXPRESSIONS, i, kb.expressions[i].getBoundLiterals());
+    }
+
+    std::vector<PropId> changed;
+    part.changeLog = &changed;
+
+    RankedAgenda::Step step;
+    uint32_t swept = 0;
+    part.passes = 1;
+    while (agenda.pop(step) && part.spend()) {
+        if (step.rank < swept) {
+            ++part.passes;
+        }
+        swept = step.rank;
+        applyStep(part, static_cast<Phase>(step.phase), step.item, partners);
+
+        ++part.iterations;
+        if (part.goalDecided() || part.oscillated) {
+            break;
+        }
+        for (PropId id : changed) {
+            Tripartite value = kb.truth(id);
+            part.dependents(id, [&](Phase phase, size_t item) {
+                push(dueAt(phase, item, id, value), phase, item);
+            });
+        }
+        changed.clear();
+        for (PropId id : part.refutations) {
+            part.clausesRefuting(id, [&](Phase phase, size_t item) {
+                push(dueAt(phase, item, id, F), phase, item);
+            });
+        }
+        part.refutations.clear();
+    }
+
+    part.changeLog = nullptr;
+}
+
+void InferenceEngine::applyStep(Partition& part, InferenceStats::Phase phase, size_t item,
+                                std::vector<RuleSlot>& partners) {
+    const Binding& kb = part.kb;
+    const LiteralIndex& index = kb.index;
+    using Phase = InferenceStats::Phase;
+    StatsTimer timer(part.phaseStep(phase));
+
+    switch (phase) {
+        case Phase::IMPLICATIONS: {
+            RuleSlot implication = static_cast<RuleSlot>(item);
+            part.tally(InferenceRule::MODUS_PONENS, applyModusPonens(part, implication));
+            part.tally(InferenceRule::MODUS_TOLLENS, applyModusTollens(part, implication));
+            break;
+        }
+        case Phase::SYLLOGISM: {
+            RuleSlot i = static_cast<RuleSlot>(item);
+            // As the first link: (P → Q) with every (Q → R)
+            for (RuleSlot j : index.implicationsWithAntecedent(kb.consequent(i))) {
+                if (j != i && part.reaches(j)) {
+                    part.tally(InferenceRule::HYPOTHETICAL_SYLLOGISM, applyHypotheticalSyllogism(part, i, j));
+                }
+            }
+            // As the second link: every (P → Q) with (Q → R)
+            if (part.sweepOrder) {
+                break;
+            }
+            for (RuleSlot j : index.implicationsWithConsequent(kb.antecedent(i))) {
+                if (j != i && part.reaches(j)) {
+                    part.tally(InferenceRule::HYPOTHETICAL_SYLLOGISM, applyHypotheticalSyllogism(part, j, i));
+                }
+            }
+            break;
+        }
+        case Phase::DISJUNCTIONS: {
+            RuleSlot slot = static_cast<RuleSlot>(item);
+            if (index.isClause(slot)) {
+                InferenceRule rule;
+                bool fired = applyClause(part, slot, rule);
+                part.tally(rule, fired);
+            } else {
+                part.tally(InferenceRule::DISJUNCTIVE_SYLLOGISM, applyDisjunctiveSyllogism(part, slot));
+            }
+            break;
+        }
+        case Phase::RESOLUTION: {
+            RuleSlot i = static_cast<RuleSlot>(item);
+            // Pairs keep FULL_SWEEP's (earlier, later) argument order
+            kb.resolutionPartners(i, partners);
+            for (RuleSlot j : partners) {
+                if (!part.reaches(j) || (part.sweepOrder && kb.rank(j) < kb.rank(i))) continue;
+                bool earlier = kb.rank(i) < kb.rank(j);
+                part.tally(InferenceRule::RESOLUTION, applyResolution(part, earlier ? i : j, earlier ? j : i));
+            }
+            break;
+        }
+        case Phase::EXPRESSIONS:
+            part.tallyExpression(applyExpression(part, item));
+            break;
+    }
+}
+
+void InferenceEngine::deducePartition(Partition& part) {
+    switch (options_.strategy) {
+        case DeductionStrategy::FULL_SWEEP:
+            deduceFullSweep(part);
+            break;
+        case DeductionStrategy::TOPOLOGICAL:
+            deduceTopological(part);
+            break;
+        case DeductionStrategy::WORKLIST:
+        default:
+            deduceWorklist(part);
+            break;
+    }
+}
+
+// Components are numbered by their first rule or expression in knowledge base order,
+// and each keeps that order internally, so a component's run is exactly the
+// subsequence of the serial run that touches it.
+void InferenceEngine::deduceParallel(Binding& kb, size_t threads) {
+    SymbolSets sets(kb.symbols.symbolCount());
+    for (const std::vector<RuleSlot>* rules : {&kb.implications, &kb.disjunctions}) {
+        for (RuleSlot slot : *rules) {
+            sets.unite(symbolOf(kb.antecedent(slot)), symbolOf(kb.consequent(slot)));
+        }
+    }
+    for (RuleSlot slot : kb.clauses) {
+        ClauseStore::Literals literals = kb.index.clauses().literals(slot);
+        for (PropId literal : literals) {
+            sets.unite(symbolOf(literals[0]), symbolOf(literal));
+        }
+    }
+    for (size_t i = 0; i < kb.expressions.size(); ++i) {
+        for (PropId literal : kb.expressions[i].getBoundLiterals()) {
+            sets.unite(symbolOf(kb.subjectOf[i]), symbolOf(literal));
+        }
+    }
+
+    std::vector<Partition> parts;
+    std::vector<uint32_t> componentOf(kb.symbols.symbolCount(), UINT32_MAX);
+    auto partitionOf = [&](PropId literal) -> Partition& {
+        uint32_t& component = componentOf[sets.find(symbolOf(literal))];
+        if (component == UINT32_MAX) {
+            component = static_cast<uint32_t>(parts.size());
+            parts.emplace_back(kb);
+        }
+        return parts[component];
+    };
+
+    std::vector<uint32_t> ruleRank(kb.index.slotCount(), 0);
+    std::vector<uint32_t> expressionRank(kb.expressions.size(), 0);
+    for (RuleSlot slot : kb.implications) {
+        Partition& part = partitionOf(kb.antecedent(slot));
+        ruleRank[slot] = static_cast<uint32_t>(part.ruleSpace++);
+        part.implications.push_back(slot);
+    }
+    for (RuleSlot slot : kb.disjunctions) {
+        Partition& part = partitionOf(kb.antecedent(slot));
+        ruleRank[slot] = static_cast<uint32_t>(part.ruleSpace++);
+        part.disjunctions.push_back(slot);
+    }
+    for (RuleSlot slot : kb.clauses) {
+        Partition& part = partitionOf(kb.antecedent(slot));
+        ruleRank[slot] = static_cast<uint32_t>(part.ruleSpace++);
+        part.clauses.push_back(slot);
+    }
+    for (size_t i = 0; i < kb.expressions.size(); ++i) {
+        Partition& part = partitionOf(kb.subjectOf[i]);
+        expressionRank[i] = static_cast<uint32_t>(part.expressionSpace++);
+        part.expressions.push_back(i);
+    }
+    for (Partition& part : parts) {
+        part.ruleRank = &ruleRank;
+        part.expressionRank = &expressionRank;
+        part.watchesComplete = true;
+        preparePartition(part);
+    }
+
+    if (!pool_ || pool_->threadCount() != threads) {
+        pool_ = std::make_shared<WorkStealingPool>(threads);
+    }
+
+    // Hand out the largest components first so stealing only has to even out the tail
+    std::vector<size_t> order(parts.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    auto work = [&](size_t i) {
+        const Partition& part = parts[i];
+        return part.ruleSpace + part.expressionSpace;
+    };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return work(a) > work(b);
+    });
+
+    try {
+        pool_->run(order.size(), [&](size_t task) { deducePartition(parts[order[task]]); });
+    } catch (...) {
+        commitCreated(kb, parts);
+        throw;
+    }
+    commitCreated(kb, parts);
+    for (const Partition& part : parts) {
+        noteConvergence(part);
+    }
+}
+
+void InferenceEngine::noteOverturn(Partition& part, PropId id) {
+    ++part.conflicts;
+    if (options_.oscillationLimit == 0 || part.oscillated) {
+        return;
+    }
+    if (++part.overturns[id] > options_.oscillationLimit) {
+        part.oscillated = true;
+        part.oscillating = id;
+    }
+}
+
+void InferenceEngine::preparePartition(Partition& part) {
+    part.budget = budget_.get();
+    // Lazy runs touch a few expressions; refreshing the whole DAG would cost more
+    if (options_.shareExpressions && !part.kb.lazy) {
+        part.dag = &expressionDag_;
+        part.dagRoots = &dagRoots_;
+    }
+    if (InferenceStats::kCompiled && options_.collectStats) {
+        part.stats = std::make_unique<InferenceStats>();
+    }
+}
+
+void InferenceEngine::syncExpressionDag(std::vector<Expression>& expressions) {
+    if (!options_.shareExpressions) {
+        return;
+    }
+    // A changed or removed expression leaves nodes behind that no root reaches: start over
+    bool stale = dagRevisions_.size() > expressions.size();
+    for (size_t i = 0; !stale && i < dagRevisions_.size(); ++i) {
+        expressions[i].getProgram();  // A recompiled program has a new revision
+        stale = expressions[i].getRevision() != dagRevisions_[i];
+    }
+    if (stale) {
+        expressionDag_.clear();
+        dagRevisions_.clear();
+        dagRoots_.clear();
+    }
+    for (size_t i = dagRevisions_.size(); i < expressions.size(); ++i) {
+        dagRoots_.push_back(expressionDag_.add(expressions[i]));
+        dagRevisions_.push_back(expressions[i].getRevision());
+    }
+    // Any proposition may have changed since the last run
+    expressionDag_.invalidateAll();
+}
+
+void InferenceEngine::noteConvergence(const Partition& part) {
+    convergence_.iterations += part.iterations;
+    convergence_.passes = std::max(convergence_.passes, part.passes);
+    convergence_.conflicts += part.conflicts;
+    if (part.oscillated) {
+        convergence_.converged = false;
+        convergence_.oscillating.push_back(part.kb.name(part.oscillating));
+    }
+    if (part.budget && part.budget->interruption() != Interruption::NONE) {
+        convergence_.converged = false;
+        convergence_.interrupted = part.budget->interruption();
+    }
+    if (part.stats) {
+        stats_.merge(*part.stats);
+        stats_.iterations += part.iterations;
+        stats_.conflicts += part.conflicts;
+        stats_.oscillations += part.oscillated;
+    }
+}
+
+uint64_t* InferenceEngine::beginCall() {
+    budget_ = limited_ ? std::make_shared<Budget>(limits_) : nullptr;
+    if (!InferenceStats::kCompiled || !options_.collectStats) {
+        return nullptr;
+    }
+    ++stats_.calls;
+    return &stats_.nanoseconds;
+}
+
+void InferenceEngine::commitCreated(Binding& kb, std::vector<Partition>& parts) {
+    std::vector<std::pair<PropId, Proposition>*> created;
+    for (Partition& part : parts) {
+        for (auto& entry : part.created) {
+            created.push_back(&entry);
+        }
+    }
+    std::sort(created.begin(), created.end(), [](const auto* a, const auto* b) {
+        return a->first < b->first;
+    });
+    for (auto* entry : created) {
+        Proposition& stored = kb.propositions.emplace(kb.name(entry->first), std::move(entry->second)).first->second;
+        kb.setProp(entry->first, &stored);
+    }
+    for (Partition& part : parts) {
+        if (part.stats) {
+            part.stats->propositionsCreated += part.created.size();
+        }
+        part.created.clear();
+    }
+}
+
+void InferenceEngine::deduceAll(std::unordered_map<std::string, Proposition>& propositions,
+                                std::vector<Expression>& expressions) {
+    LiteralIndex index;
+    index.rebuild(propositions);
+    deduceAll(propositions, expressions, index);
+}
+
+void InferenceEngine::deduceAll(std::unordered_map<std::string, Proposition>& propositions,
+                                std::vector<Expression>& expressions,
+                                LiteralIndex& index) {
+    convergence_ = Convergence();
+    Binding kb(propositions, expressions, index);
+    // Fall back to a private index if the caller's does not match the rules
+    if (!kb.bind()) {
+        LiteralIndex rebuilt;
+        rebuilt.rebuild(propositions);
+        deduceAll(propositions, expressions, rebuilt);
+        return;
+    }
+    StatsTimer timer(beginCall());
+    syncExpressionDag(expressions);
+
+    size_t threads = options_.threads == 0 ? WorkStealingPool::defaultThreadCount() : options_.threads;
+    if (threads > 1) {
+        deduceParallel(kb, threads);
+        return;
+    }
+
+    std::vector<Partition> parts;
+    parts.push_back(Partition::whole(kb));
+    preparePartition(parts.front());
+    try {
+        deducePartition(parts.front());
+    } catch (...) {
+        commitCreated(kb, parts);
+        throw;
+    }
+    commitCreated(kb, parts);
+    noteConvergence(parts.front());
+}
+
+void InferenceEngine::deduceIncremental(std::unordered_map<std::string, Proposition>& propositions,
+                                        std::vector<Expression>& expressions,
+                                        LiteralIndex& index,
+                                        const std::vector<std::string>& changed,
+                                        std::vector<std::string>* assigned,
+                                        std::vector<Tripartite>* previous) {
+    convergence_ = Convergence();
+    StatsTimer timer(beginCall());
+    Binding kb(propositions, expressions, index);
+    kb.bindLazily();
+
+    std::vector<Partition> parts;
+    parts.emplace_back(kb);
+    Partition& part = parts.front();
+    preparePartition(part);
+    part.ruleSpace = index.slotCount();
+    part.expressionSpace = expressions.size();
+
+    // Seed only what mentions a changed literal, in slot / expression order
+    for (const std::string& name : changed) {
+        PropId id;
+        if (!kb.symbols.find(name, id)) continue;
+        for (RuleSlot slot : index.implicationsWithAntecedent(id)) part.implications.push_back(slot);
+        for (RuleSlot slot : index.implicationsWithConsequent(id)) part.implications.push_back(slot);
+        for (RuleSlot slot : index.disjunctionsContaining(id)) part.disjunctions.push_back(slot);
+        for (RuleSlot slot : index.clausesContaining(id)) part.clauses.push_back(slot);
+        for (size_t i : kb.expressionsReading(id)) part.expressions.push_back(i);
+    }
+    addComplementaryClauses(index, part.clauses);
+    auto normalize = [](auto& items) {
+        std::sort(items.begin(), items.end());
+        items.erase(std::unique(items.begin(), items.end()), items.end());
+    };
+    normalize(part.implications);
+    normalize(part.disjunctions);
+    normalize(part.clauses);
+    normalize(part.expressions);
+    auto isMissing = [&](RuleSlot slot) { return kb.ruleAt(slot) == nullptr; };
+    for (std::vector<RuleSlot>* rules : {&part.implications, &part.disjunctions, &part.clauses}) {
+        rules->erase(std::remove_if(rules->begin(), rules->end(), isMissing), rules->end());
+    }
 
-                default:
-                    break;
+    std::vector<std::pair<PropId, Tripartite>> assignedIds;
+    part.assigned = &assignedIds;
+    try {
+        deduceWorklist(part);
+    } catch (...) {
+        commitCreated(kb, parts);
+        throw;
+    }
+    commitCreated(kb, parts);
+    noteConvergence(part);
+
+    if (assigned) {
+        std::unordered_set<PropId> seen;
+        for (const auto& assignment : assignedIds) {
+            if (seen.insert(assignment.first).second) {
+                assigned->push_back(kb.name(assignment.first));
+                if (previous) {
+                    previous->push_back(assignment.second);
+                }
+            }
+        }
+    }
+}
+
+Tripartite InferenceEngine::query(std::unordered_map<std::string, Proposition>& propositions,
+                                  std::vector<Expression>& expressions,
+                                  const std::string& goal) {
+    LiteralIndex index;
+    index.rebuild(propositions);
+    return query(propositions, expressions, index, goal);
+}
+
+Tripartite InferenceEngine::query(std::unordered_map<std::string, Proposition>& propositions,
+                                  std::vector<Expression>& expressions,
+                                  LiteralIndex& index,
+                                  const std::string& goal,
+                                  std::vector<std::string>* assigned,
+                                  size_t* rulesInScope) {
+    convergence_ = Convergence();
+    StatsTimer timer(beginCall());
+    if (rulesInScope) {
+        *rulesInScope = 0;
+    }
+    Binding kb(propositions, expressions, index);
+    kb.bindLazily();
+    PropId goalId;
+    if (!kb.symbols.find(goal, goalId)) {
+        // No rule or expression mentions it, so only its own value can answer
+        const Proposition* prop = findProposition(goal, propositions);
+        return prop ? prop->getTruthValue() : Tripartite::UNKNOWN;
+    }
+    if (kb.truth(goalId) != Tripartite::UNKNOWN) {
+        return kb.truth(goalId);
+    }
+
+    std::vector<Partition> parts;
+    parts.emplace_back(kb);
+    Partition& part = parts.front();
+    preparePartition(part);
+    part.ruleSpace = index.slotCount();
+    part.expressionSpace = expressions.size();
+    GoalScope scope(kb, goalId);
+    part.ruleScope = &scope.rules;
+    part.expressionScope = &scope.expressions;
+    part.goal = &goalId;
+    std::vector<std::pair<PropId, Tripartite>> assignedIds;
+    part.assigned = &assignedIds;
+
+    // Rules already in scope saw every change as it happened, so each round only
+    // seeds the rules that just joined
+    constexpr size_t kFirstRound = 16;
+    size_t target = kFirstRound;
+    try {
+        while (true) {
+            part.implications.clear();
+            part.disjunctions.clear();
+            part.clauses.clear();
+            part.expressions.clear();
+            bool more = scope.grow(part, target);
+            std::sort(part.implications.begin(), part.implications.end());
+            std::sort(part.disjunctions.begin(), part.disjunctions.end());
+            std::sort(part.clauses.begin(), part.clauses.end());
+            std::sort(part.expressions.begin(), part.expressions.end());
+            deduceWorklist(part);
+            if (part.goalDecided() || part.oscillated || !more || part.exhausted()) {
+                break;
+            }
+            target = scope.size * 2;
+        }
+    } catch (...) {
+        commitCreated(kb, parts);
+        throw;
+    }
+    commitCreated(kb, parts);
+    noteConvergence(part);
+    if (rulesInScope) {
+        *rulesInScope = scope.size;
+    }
+
+    if (assigned) {
+        std::unordered_set<PropId> seen;
+        for (const auto& assignment : assignedIds) {
+            if (seen.insert(assignment.first).second) {
+                assigned->push_back(kb.name(assignment.first));
+            }
+        }
+    }
+    return kb.truth(goalId);
+}
+
+void InferenceEngine::deduceOverlay(const std::unordered_map<std::string, Proposition>& base,
+                                    std::vector<Expression>& expressions,
+                                    const LiteralIndex& index,
+                                    Overlay& overlay,
+                                    const std::vector<PropId>* changed) {
+    convergence_ = Convergence();
+    StatsTimer timer(beginCall());
+    Binding kb(base, expressions, index, overlay);
+    Partition part(kb);
+    preparePartition(part);
+    part.ruleSpace = index.slotCount();
+    part.expressionSpace = expressions.size();
+
+    if (changed) {
+        // Seed only what mentions a changed literal, as deduceIncremental does
+        for (PropId id : *changed) {
+            for (RuleSlot slot : index.implicationsWithAntecedent(id)) part.implications.push_back(slot);
+            for (RuleSlot slot : index.implicationsWithConsequent(id)) part.implications.push_back(slot);
+            for (RuleSlot slot : index.disjunctionsContaining(id)) part.disjunctions.push_back(slot);
+            for (RuleSlot slot : index.clausesContaining(id)) part.clauses.push_back(slot);
+            for (size_t i : kb.expressionsReading(id)) part.expressions.push_back(i);
+        }
+        addComplementaryClauses(index, part.clauses);
+        auto normalize = [](auto& items) {
+            std::sort(items.begin(), items.end());
+            items.erase(std::unique(items.begin(), items.end()), items.end());
+        };
+        normalize(part.implications);
+        normalize(part.disjunctions);
+        normalize(part.clauses);
+        normalize(part.expressions);
+    } else {
+        // Everything, in slot order
+        for (RuleSlot slot = 0; slot < index.slotCount(); ++slot) {
+            const Proposition* rule = kb.ruleAt(slot);
+            if (!rule) continue;
+            if (index.isClause(slot)) {
+                part.clauses.push_back(slot);
+            } else if (rule->getRelation() == LogicalOperator::IMPLIES) {
+                part.implications.push_back(slot);
+            } else {
+                part.disjunctions.push_back(slot);
             }
         }
-    } while (changesMade);
-}
\ No newline at end of file
+        for (size_t i = 0; i < expressions.size(); ++i) {
+            part.expressions.push_back(i);
+        }
+        part.watchesComplete = true;
+    }
+    auto isMissing = [&](RuleSlot slot) { return kb.ruleAt(slot) == nullptr; };
+    for (std::vector<RuleSlot>* rules : {&part.implications, &part.disjunctions, &part.clauses}) {
+        rules->erase(std::remove_if(rules->begin(), rules->end(), isMissing), rules->end());
+    }
+
+    deduceWorklist(part);
+    noteConvergence(part);
+}
@@ -0,0 +1,64 @@
+#include "InferenceStats.h"
+
+namespace {
+
+void writeRule(std::ostream& out, std::string_view name, const InferenceStats::RuleCounts& counts) {
+    out << "\"" << name << "\":{\"candidates\":" << counts.candidates
+        << ",\"fired\":" << counts.fired << "}";
+}
+
+}  // namespace
+
+void InferenceStats::merge(const InferenceStats& other) {
+    calls += other.calls;
+    nanoseconds += other.nanoseconds;
+    iterations += other.iterations;
+    conflicts += other.conflicts;
+    oscillations += other.oscillations;
+    propositionsCreated += other.propositionsCreated;
+    for (size_t i = 0; i < phases.size(); ++i) {
+        phases[i].steps += other.phases[i].steps;
+        phases[i].nanoseconds += other.phases[i].nanoseconds;
+    }
+    for (size_t i = 0; i < rules.size(); ++i) {
+        rules[i].candidates += other.rules[i].candidates;
+        rules[i].fired += other.rules[i].fired;
+    }
+    expressions.candidates += other.expressions.candidates;
+    expressions.fired += other.expressions.fired;
+}
+
+std::string_view InferenceStats::phaseName(Phase p) {
+    switch (p) {
+        case Phase::IMPLICATIONS: return "implications";
+        case Phase::SYLLOGISM:    return "syllogism";
+        case Phase::DISJUNCTIONS: return "disjunctions";
+        case Phase::RESOLUTION:   return "resolution";
+        case Phase::EXPRESSIONS:  return "expressions";
+    }
+    return "";
+}
+
+void InferenceStats::writeJson(std::ostream& out) const {
+    out << "{\"calls\":" << calls
+        << ",\"nanoseconds\":" << nanoseconds
+        << ",\"iterations\":" << iterations
+        << ",\"conflicts\":" << conflicts
+        << ",\"oscillations\":" << oscillations
+        << ",\"propositionsCreated\":" << propositionsCreated
+        << ",\"phases\":{";
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+        if (i > 0) out << ",";
+        out << "\"" << phaseName(static_cast<Phase>(i)) << "\":{\"steps\":" << phases[i].steps
+            << ",\"nanoseconds\":" << phases[i].nanoseconds << "}";
+    }
+    out << "},\"rules\":{";
+    for (InferenceRule r : {InferenceRule::MODUS_PONENS, InferenceRule::MODUS_TOLLENS,
+                            InferenceRule::HYPOTHETICAL_SYLLOGISM, InferenceRule::DISJUNCTIVE_SYLLOGISM,
+                            InferenceRule::RESOLUTION, InferenceRule::SIMPLIFICATION}) {
+        writeRule(out, inferenceRuleName(r), rule(r));
+        out << ",";
+    }
+    writeRule(out, "Expression", expressions);
+    out << "}}";
+}
@@ -1,8 +1,11 @@
 #include "Lexer.h"
 
-#include <sstream>
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
 
 // ========== TokenType Utilities ==========
 
@@ -66,6 +69,12 @@ std::string LexerToken::toString() const {
     return oss.str();
 }
 
+// ========== LexerTokenView ==========
+
+LexerToken LexerTokenView::toToken() const {
+    return LexerToken(type, std::string(value), location);
+}
+
 // ========== LexerError ==========
 
 std::string LexerError::formatMessage(const std::string& msg,
@@ -87,11 +96,106 @@ std::string LexerError::formatMessage(const std::string& msg,
     return oss.str();
 }
 
+// ========== Character Classes ==========
+
+namespace {
+
+// What a byte can be part of; bytes outside ASCII belong to no class
+enum CharClass : uint8_t {
+    kSpace = 1 << 0,            // ' ', '\t', '\r' (newlines are handled apart)
+    kIdentifierStart = 1 << 1,  // Letters, '_' and '~'
+    kIdentifierPart = 1 << 2,   // Letters, digits and '_'
+    kHyphen = 1 << 3            // '-', part of an identifier if the options allow
+};
+
+constexpr std::array<uint8_t, 256> makeCharClasses() {
+    std::array<uint8_t, 256> classes{};
+    for (int c = 0; c < 256; ++c) {
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool digit = c >= '0' && c <= '9';
+        uint8_t cls = 0;
+        if (c == ' ' || c == '\t' || c == '\r') cls |= kSpace;
+        if (letter || c == '_' || c == '~') cls |= kIdentifierStart;
+        if (letter || digit || c == '_') cls |= kIdentifierPart;
+        if (c == '-') cls |= kHyphen;
+        classes[c] = cls;
+    }
+    return classes;
+}
+
+constexpr std::array<uint8_t, 256> kCharClasses = makeCharClasses();
+
+inline uint8_t classOf(char c) {
+    return kCharClasses[static_cast<unsigned char>(c)];
+}
+
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// 16 bytes at a time; the compiler maps the block onto SSE2, the low half of
+// an AVX2 register or NEON, whichever the target has
+typedef unsigned char Bytes __attribute__((vector_size(16)));
+#define LOGOSLAB_LEXER_VECTORS 1
+#endif
+
+// Offset of the first byte at or after pos outside a run. inRun flags (all ones)
+// the bytes of a 16-byte block that belong to the run; the tail shorter than a
+// block is classified byte by byte through the table.
+template <typename InRun>
+size_t skipRun(std::string_view text, size_t pos, uint8_t classes, InRun inRun) {
+#ifdef LOGOSLAB_LEXER_VECTORS
+    for (; pos + sizeof(Bytes) <= text.size(); pos += sizeof(Bytes)) {
+        Bytes block;
+        std::memcpy(&block, text.data() + pos, sizeof(Bytes));
+        Bytes outside = (Bytes)~inRun(block);
+        uint64_t words[2];
+        std::memcpy(words, &outside, sizeof(words));
+        if (words[0]) return pos + __builtin_ctzll(words[0]) / 8;
+        if (words[1]) return pos + 8 + __builtin_ctzll(words[1]) / 8;
+    }
+#else
+    (void)inRun;
+#endif
+    while (pos < text.size() && (classOf(text[pos]) & classes)) {
+        ++pos;
+    }
+    return pos;
+}
+
+size_t skipSpaces(std::string_view text, size_t pos) {
+    return skipRun(text, pos, kSpace, [](auto block) {
+        return (block == ' ') | (block == '\t') | (block == '\r');
+    });
+}
+
+// Letters, digits, '_' and, if hyphens are allowed, '-'
+size_t skipIdentifierPart(std::string_view text, size_t pos, bool hyphens) {
+    uint8_t classes = kIdentifierPart | (hyphens ? kHyphen : 0);
+    const unsigned char extra = hyphens ? '-' : '_';
+    return skipRun(text, pos, classes, [extra](auto block) {
+        auto lower = block | 0x20;
+        return ((lower - 'a') < 26) | ((block - '0') < 10) | (block == '_') | (block == extra);
+    });
+}
+
+// Case-insensitive comparison against a lowercase keyword
+bool equalsKeyword(std::string_view text, std::string_view keyword) {
+    if (text.size() != keyword.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[i])) != keyword[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 // ========== Lexer Implementation ==========
 
-Lexer::Lexer() : pos_(0), line_(1), column_(1), options_() {}
+Lexer::Lexer() : pos_(0), line_(1), lineStart_(0), options_() {}
 
-Lexer::Lexer(const Options& opts) : pos_(0), line_(1), column_(1), options_(opts) {}
+Lexer::Lexer(const Options& opts) : pos_(0), line_(1), lineStart_(0), options_(opts) {}
 
 void Lexer::setOptions(const Options& opts) {
     options_ = opts;
@@ -104,8 +208,8 @@ const Lexer::Options& Lexer::getOptions() const {
 void Lexer::reset() {
     pos_ = 0;
     line_ = 1;
-    column_ = 1;
-    input_.clear();
+    lineStart_ = 0;
+    input_ = std::string_view();
 }
 
 char Lexer::current() const {
@@ -119,51 +223,41 @@ char Lexer::peek(size_t n) const {
     return input_[idx];
 }
 
-void Lexer::advance() {
-    if (pos_ < input_.length()) {
-        if (input_[pos_] == '\n') {
-            line_++;
-            column_ = 1;
-        } else {
-            column_++;
-        }
-        pos_++;
-    }
+void Lexer::advance(size_t n) {
+    pos_ = std::min(pos_ + n, input_.length());
+}
+
+void Lexer::advanceLine() {
+    ++pos_;
+    ++line_;
+    lineStart_ = pos_;
 }
 
 bool Lexer::isAtEnd() const {
     return pos_ >= input_.length();
 }
 
+// Columns are not tracked per character; they follow from the line's start
 SourceLocation Lexer::currentLocation() const {
-    return SourceLocation(line_, column_, pos_);
+    return SourceLocation(line_, pos_ - lineStart_ + 1, pos_);
 }
 
 std::string Lexer::getContext() const {
-    // Find start of current line
-    size_t lineStart = pos_;
-    while (lineStart > 0 && input_[lineStart - 1] != '\n') {
-        lineStart--;
+    // The current line, limited in length
+    size_t lineEnd = input_.find('\n', lineStart_);
+    if (lineEnd == std::string_view::npos) {
+        lineEnd = input_.length();
     }
-    
-    // Find end of current line
-    size_t lineEnd = pos_;
-    while (lineEnd < input_.length() && input_[lineEnd] != '\n') {
-        lineEnd++;
-    }
-    
-    // Extract line, limiting length
-    std::string context = input_.substr(lineStart, std::min(lineEnd - lineStart, size_t(60)));
-    return context;
+    return std::string(input_.substr(lineStart_, std::min(lineEnd - lineStart_, size_t(60))));
 }
 
 void Lexer::skipWhitespace() {
     while (!isAtEnd()) {
         char c = current();
-        if (c == ' ' || c == '\t' || c == '\r') {
-            advance();
+        if (classOf(c) & kSpace) {
+            pos_ = skipSpaces(input_, pos_ + 1);
         } else if (c == '\n' && !options_.emitNewlines) {
-            advance();
+            advanceLine();
         } else if (c == '#') {
             // Skip line comments starting with #
             skipLineComment();
@@ -175,69 +269,48 @@ void Lexer::skipWhitespace() {
 
 void Lexer::skipLineComment() {
     // Skip until end of line
-    while (!isAtEnd() && current() != '\n') {
-        advance();
-    }
+    size_t end = input_.find('\n', pos_);
+    pos_ = (end == std::string_view::npos) ? input_.length() : end;
 }
 
 bool Lexer::isIdentifierStart(char c) {
-    return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '~';
+    return (classOf(c) & kIdentifierStart) != 0;
 }
 
-bool Lexer::isIdentifierContinue(char c) const {
-    if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
-        return true;
-    }
-    // Allow hyphens in identifiers if enabled (e.g., "big-bang")
-    if (options_.allowHyphensInIds && c == '-') {
-        return true;
-    }
-    return false;
-}
-
-LexerToken Lexer::scanIdentifier() {
+LexerTokenView Lexer::scanIdentifier() {
     SourceLocation startLoc = currentLocation();
-    std::string value;
-    
-    // First character
-    value += current();
-    advance();
+    size_t start = pos_;
     
-    // Subsequent characters
-    while (!isAtEnd() && isIdentifierContinue(current())) {
-        value += current();
-        advance();
-    }
+    // First character, then the run of characters that continue an identifier
+    // (hyphens too if enabled, e.g. "big-bang")
+    pos_ = skipIdentifierPart(input_, pos_ + 1, options_.allowHyphensInIds);
+    std::string_view value = input_.substr(start, pos_ - start);
     
     // Check for keyword operators
     if (options_.treatKeywordsAsOps) {
-        std::string lower = value;
-        std::transform(lower.begin(), lower.end(), lower.begin(),
-                       [](unsigned char c) { return std::tolower(c); });
-        
-        if (lower == "and") {
-            return LexerToken(TokenType::AND, value, startLoc);
-        } else if (lower == "or") {
-            return LexerToken(TokenType::OR, value, startLoc);
-        } else if (lower == "not") {
-            return LexerToken(TokenType::NOT, value, startLoc);
-        } else if (lower == "implies") {
+        if (equalsKeyword(value, "and")) {
+            return LexerTokenView(TokenType::AND, value, startLoc);
+        } else if (equalsKeyword(value, "or")) {
+            return LexerTokenView(TokenType::OR, value, startLoc);
+        } else if (equalsKeyword(value, "not")) {
+            return LexerTokenView(TokenType::NOT, value, startLoc);
+        } else if (equalsKeyword(value, "implies")) {
             // Note: "implies" as a keyword is only treated as operator in expression context
             // In assumption files, it's a function name (identifier)
             // We return IDENTIFIER here; the parser decides based on context
-        } else if (lower == "iff") {
-            return LexerToken(TokenType::EQUIVALENT, value, startLoc);
+        } else if (equalsKeyword(value, "iff")) {
+            return LexerTokenView(TokenType::EQUIVALENT, value, startLoc);
         }
     }
     
-    return LexerToken(TokenType::IDENTIFIER, value, startLoc);
+    return LexerTokenView(TokenType::IDENTIFIER, value, startLoc);
 }
 
-LexerToken Lexer::scanToken() {
+LexerTokenView Lexer::scanToken() {
     skipWhitespace();
     
     if (isAtEnd()) {
-        return LexerToken(TokenType::END_OF_INPUT, "", currentLocation());
+        return LexerTokenView(TokenType::END_OF_INPUT, "", currentLocation());
     }
     
     SourceLocation startLoc = currentLocation();
@@ -245,24 +318,24 @@ LexerToken Lexer::scanToken() {
     
     // Newline (only if emitNewlines is true)
     if (c == '\n' && options_.emitNewlines) {
-        advance();
-        return LexerToken(TokenType::NEWLINE, "\\n", startLoc);
+        advanceLine();
+        return LexerTokenView(TokenType::NEWLINE, "\\n", startLoc);
     }
     
     // Single-character tokens
     switch (c) {
         case '(':
             advance();
-            return LexerToken(TokenType::LPAREN, "(", startLoc);
+            return LexerTokenView(TokenType::LPAREN, "(", startLoc);
         case ')':
             advance();
-            return LexerToken(TokenType::RPAREN, ")", startLoc);
+            return LexerTokenView(TokenType::RPAREN, ")", startLoc);
         case ',':
             advance();
-            return LexerToken(TokenType::COMMA, ",", startLoc);
+            return LexerTokenView(TokenType::COMMA, ",", startLoc);
         case '!':
             advance();
-            return LexerToken(TokenType::NOT, "!", startLoc);
+            return LexerTokenView(TokenType::NOT, "!", startLoc);
         case '~':
             // Could be negation operator or start of identifier like ~P
             if (peek(1) != '\0' && isIdentifierStart(peek(1))) {
@@ -270,49 +343,44 @@ LexerToken Lexer::scanToken() {
                 return scanIdentifier();
             }
             advance();
-            return LexerToken(TokenType::NOT, "~", startLoc);
+            return LexerTokenView(TokenType::NOT, "~", startLoc);
         default:
             break;
     }
     
     // Multi-character operators
     if (c == '&' && peek(1) == '&') {
-        advance(); advance();
-        return LexerToken(TokenType::AND, "&&", startLoc);
+        advance(2);
+        return LexerTokenView(TokenType::AND, "&&", startLoc);
     }
     
     if (c == '|' && peek(1) == '|') {
-        advance(); advance();
-        return LexerToken(TokenType::OR, "||", startLoc);
+        advance(2);
+        return LexerTokenView(TokenType::OR, "||", startLoc);
     }
     
     if (c == '-' && peek(1) == '>') {
-        advance(); advance();
-        return LexerToken(TokenType::IMPLIES, "->", startLoc);
+        advance(2);
+        return LexerTokenView(TokenType::IMPLIES, "->", startLoc);
     }
     
     if (c == '<' && peek(1) == '-' && peek(2) == '>') {
-        advance(); advance(); advance();
-        return LexerToken(TokenType::EQUIVALENT, "<->", startLoc);
+        advance(3);
+        return LexerTokenView(TokenType::EQUIVALENT, "<->", startLoc);
     }
     
     if (c == '=') {
         // Check for == (equality) vs = (assignment)
         if (peek(1) == '=') {
-            advance(); advance();
-            return LexerToken(TokenType::EQUIVALENT, "==", startLoc);
+            advance(2);
+            return LexerTokenView(TokenType::EQUIVALENT, "==", startLoc);
         }
         advance();
-        return LexerToken(TokenType::ASSIGN, "=", startLoc);
+        return LexerTokenView(TokenType::ASSIGN, "=", startLoc);
     }
     
-    // Identifiers
-    if (isIdentifierStart(c)) {
-        return scanIdentifier();
-    }
-    
-    // Digits can start identifiers in this language (e.g., "4-fundamental-forces")
-    if (std::isdigit(static_cast<unsigned char>(c))) {
+    // Identifiers; digits can start them too (e.g., "4-fundamental-forces")
+    if (classOf(c) & (kIdentifierStart | kIdentifierPart)) {
         return scanIdentifier();
     }
     
@@ -323,21 +391,36 @@ LexerToken Lexer::scanToken() {
 }
 
 std::vector<LexerToken> Lexer::tokenize(const std::string& input) {
+    std::vector<LexerToken> tokens;
+    tokenize(std::string_view(input), tokens);
+    return tokens;
+}
+
+void Lexer::tokenize(std::string_view input, std::vector<LexerToken>& tokens) {
     reset();
     input_ = input;
     
-    std::vector<LexerToken> tokens;
-    
+    // Overwrite the tokens already there so their strings keep their buffers
+    size_t count = 0;
     while (true) {
-        LexerToken token = scanToken();
-        tokens.push_back(token);
+        LexerTokenView token = scanToken();
+        if (count < tokens.size()) {
+            LexerToken& reused = tokens[count];
+            reused.type = token.type;
+            reused.value.assign(token.value.data(), token.value.size());
+            reused.location = token.location;
+        } else {
+            tokens.push_back(token.toToken());
+        }
+        ++count;
         
         if (token.type == TokenType::END_OF_INPUT) {
             break;
         }
     }
+    tokens.resize(count);
     
-    return tokens;
+    input_ = std::string_view();
 }
 
 std::vector<LexerToken> Lexer::tokenizeContent(const std::string& input) {
@@ -351,3 +434,18 @@ std::vector<LexerToken> Lexer::tokenizeContent(const std::string& input) {
     return tokens;
 }
 
+void Lexer::tokenizeView(std::string_view input, std::vector<LexerTokenView>& tokens) {
+    reset();
+    input_ = input;
+    tokens.clear();
+    
+    while (true) {
+        LexerTokenView token = scanToken();
+        if (token.type == TokenType::END_OF_INPUT) {
+            break;
+        }
+        tokens.push_back(token);
+    }
+    
+    input_ = std::string_view();
+}
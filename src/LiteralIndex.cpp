@@ -0,0 +1,241 @@
+#include "LiteralIndex.h"
+
+#include <algorithm>
+
+const std::vector<RuleSlot> LiteralIndex::kEmpty;
+
+bool LiteralIndex::isIndexedRule(const Proposition& prop) {
+    return prop.getRelation() == LogicalOperator::IMPLIES || prop.getRelation() == LogicalOperator::OR ||
+           isClause(prop);
+}
+
+bool LiteralIndex::isClause(const Proposition& prop) {
+    return (prop.getRelation() == LogicalOperator::OR || prop.getRelation() == LogicalOperator::AND) &&
+           !prop.getOperands().empty();
+}
+
+const LiteralIndex::Occurrences* LiteralIndex::findOccurrences(PropId id) const {
+    return id < occurrences_.size() ? &occurrences_[id] : nullptr;
+}
+
+const LiteralIndex::Occurrences* LiteralIndex::findOccurrences(const std::string& name) const {
+    PropId id;
+    return symbols_.find(name, id) ? findOccurrences(id) : nullptr;
+}
+
+LiteralIndex::Occurrences& LiteralIndex::occurrences(PropId id) {
+    if (id >= occurrences_.size()) {
+        occurrences_.resize(symbols_.idCount());
+    }
+    return occurrences_[id];
+}
+
+// Order-preserving erase so lookups keep returning rules in insertion order
+void LiteralIndex::eraseSlot(std::vector<RuleSlot>& slots, RuleSlot slot) {
+    slots.erase(std::remove(slots.begin(), slots.end(), slot), slots.end());
+}
+
+void LiteralIndex::addRule(const std::string& key, const Proposition& prop) {
+    removeRule(key);
+    if (isIndexedRule(prop)) {
+        indexRule(key, prop);
+    }
+}
+
+void LiteralIndex::indexRule(const std::string& key, const Proposition& prop) {
+    RuleSlot slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<RuleSlot>(rules_.size());
+        rules_.emplace_back();
+    }
+
+    RuleRecord& record = rules_[slot];
+    record.key = key;
+    record.relation = prop.getRelation();
+    record.clause = isClause(prop);
+    record.self = symbols_.intern(key);
+    slotByKey_[key] = slot;
+
+    if (record.clause) {
+        clauseScratch_.clear();
+        for (const std::string& operand : prop.getOperands()) {
+            clauseScratch_.push_back(symbols_.intern(operand));
+        }
+        ClauseKind kind = record.relation == LogicalOperator::AND ? ClauseKind::CONJUNCTION
+                                                                  : ClauseKind::DISJUNCTION;
+        clauses_.add(slot, kind, clauseScratch_);
+        ClauseStore::Literals literals = clauses_.literals(slot);
+        record.antecedent = literals[0];
+        record.consequent = literals[literals.size() - 1];
+        for (PropId literal : literals) {
+            occurrences(literal).clauseOf.push_back(slot);
+        }
+        return;
+    }
+
+    record.antecedent = symbols_.intern(prop.getAntecedent());
+    record.consequent = symbols_.intern(prop.getConsequent());
+    if (record.relation == LogicalOperator::IMPLIES) {
+        occurrences(record.antecedent).antecedentOf.push_back(slot);
+        occurrences(record.consequent).consequentOf.push_back(slot);
+    } else {
+        occurrences(record.antecedent).disjunctOf.push_back(slot);
+        occurrences(record.consequent).disjunctOf.push_back(slot);
+    }
+}
+
+bool LiteralIndex::removeRule(const std::string& key) {
+    auto it = slotByKey_.find(key);
+    if (it == slotByKey_.end()) {
+        return false;
+    }
+    RuleSlot slot = it->second;
+    slotByKey_.erase(it);
+
+    RuleRecord& record = rules_[slot];
+    if (record.clause) {
+        for (PropId literal : clauses_.literals(slot)) {
+            eraseSlot(occurrences_[literal].clauseOf, slot);
+        }
+        clauses_.remove(slot);
+    } else if (record.relation == LogicalOperator::IMPLIES) {
+        eraseSlot(occurrences_[record.antecedent].antecedentOf, slot);
+        eraseSlot(occurrences_[record.consequent].consequentOf, slot);
+    } else {
+        eraseSlot(occurrences_[record.antecedent].disjunctOf, slot);
+        eraseSlot(occurrences_[record.consequent].disjunctOf, slot);
+    }
+
+    record = RuleRecord();
+    freeSlots_.push_back(slot);
+    return true;
+}
+
+void LiteralIndex::rebuild(const std::unordered_map<std::string, Proposition>& propositions) {
+    occurrences_.clear();
+    slotByKey_.clear();
+    rules_.clear();
+    freeSlots_.clear();
+    clauses_.clear();
+
+    size_t ruleCount = 0;
+    for (const auto& entry : propositions) {
+        ruleCount += isIndexedRule(entry.second) ? 1 : 0;
+    }
+    rules_.reserve(ruleCount);
+    slotByKey_.reserve(ruleCount);
+
+    // Keys are unique, so there is no earlier rule to unindex
+    for (const auto& entry : propositions) {
+        if (isIndexedRule(entry.second)) {
+            indexRule(entry.first, entry.second);
+        }
+    }
+}
+
+void LiteralIndex::clear() {
+    symbols_.clear();
+    occurrences_.clear();
+    slotByKey_.clear();
+    rules_.clear();
+    freeSlots_.clear();
+    clauses_.clear();
+}
+
+const SymbolTable& LiteralIndex::symbols() const {
+    return symbols_;
+}
+
+SymbolTable& LiteralIndex::symbols() {
+    return symbols_;
+}
+
+size_t LiteralIndex::ruleCount() const {
+    return slotByKey_.size();
+}
+
+size_t LiteralIndex::slotCount() const {
+    return rules_.size();
+}
+
+bool LiteralIndex::findSlot(const std::string& key, RuleSlot& slot) const {
+    auto it = slotByKey_.find(key);
+    if (it == slotByKey_.end()) {
+        return false;
+    }
+    slot = it->second;
+    return true;
+}
+
+const std::string& LiteralIndex::ruleKey(RuleSlot slot) const {
+    return rules_[slot].key;
+}
+
+PropId LiteralIndex::ruleLiteralOf(RuleSlot slot) const {
+    return rules_[slot].self;
+}
+
+PropId LiteralIndex::antecedentOf(RuleSlot slot) const {
+    return rules_[slot].antecedent;
+}
+
+PropId LiteralIndex::consequentOf(RuleSlot slot) const {
+    return rules_[slot].consequent;
+}
+
+bool LiteralIndex::isClause(RuleSlot slot) const {
+    return rules_[slot].clause;
+}
+
+const ClauseStore& LiteralIndex::clauses() const {
+    return clauses_;
+}
+
+// ========== Lookups ==========
+
+const std::vector<RuleSlot>& LiteralIndex::implicationsWithAntecedent(PropId id) const {
+    const Occurrences* occ = findOccurrences(id);
+    return occ ? occ->antecedentOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::implicationsWithConsequent(PropId id) const {
+    const Occurrences* occ = findOccurrences(id);
+    return occ ? occ->consequentOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::disjunctionsContaining(PropId id) const {
+    const Occurrences* occ = findOccurrences(id);
+    return occ ? occ->disjunctOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::disjunctionsContainingComplement(PropId id) const {
+    return disjunctionsContaining(negateId(id));
+}
+
+const std::vector<RuleSlot>& LiteralIndex::clausesContaining(PropId id) const {
+    const Occurrences* occ = findOccurrences(id);
+    return occ ? occ->clauseOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::implicationsWithAntecedent(const std::string& name) const {
+    const Occurrences* occ = findOccurrences(name);
+    return occ ? occ->antecedentOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::implicationsWithConsequent(const std::string& name) const {
+    const Occurrences* occ = findOccurrences(name);
+    return occ ? occ->consequentOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::disjunctionsContaining(const std::string& name) const {
+    const Occurrences* occ = findOccurrences(name);
+    return occ ? occ->disjunctOf : kEmpty;
+}
+
+const std::vector<RuleSlot>& LiteralIndex::disjunctionsContainingComplement(const std::string& name) const {
+    PropId id;
+    return symbols_.find(name, id) ? disjunctionsContainingComplement(id) : kEmpty;
+}
@@ -0,0 +1,99 @@
+#include "OutputFile.h"
+
+#include <cstring>
+
+bool OutputFile::Buffer::drain() {
+    size_t pending = static_cast<size_t>(pptr() - pbase());
+    if (pending > 0 && (!file || std::fwrite(pbase(), 1, pending, file) != pending)) {
+        return false;
+    }
+    setp(bytes.data(), bytes.data() + bytes.size());
+    return true;
+}
+
+OutputFile::Buffer::int_type OutputFile::Buffer::overflow(int_type ch) {
+    if (!drain()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize OutputFile::Buffer::xsputn(const char* s, std::streamsize n) {
+    std::streamsize room = epptr() - pptr();
+    if (n <= room) {
+        std::memcpy(pptr(), s, static_cast<size_t>(n));
+        pbump(static_cast<int>(n));
+        return n;
+    }
+    if (!drain()) {
+        return 0;
+    }
+    if (static_cast<size_t>(n) >= bytes.size()) {
+        // Larger than the buffer: no point copying it through
+        return static_cast<std::streamsize>(std::fwrite(s, 1, static_cast<size_t>(n), file));
+    }
+    std::memcpy(pptr(), s, static_cast<size_t>(n));
+    pbump(static_cast<int>(n));
+    return n;
+}
+
+void OutputFile::Buffer::release() {
+    file = nullptr;
+    setp(nullptr, nullptr);
+}
+
+int OutputFile::Buffer::sync() {
+    if (!drain()) {
+        return -1;
+    }
+    return file && std::fflush(file) == 0 ? 0 : -1;
+}
+
+OutputFile::OutputFile() : std::ostream(&buffer_) {
+    setstate(std::ios::badbit);
+}
+
+OutputFile::OutputFile(std::FILE* file, size_t bufferSize) : std::ostream(&buffer_) {
+    buffer_.file = file;
+    buffer_.bytes.resize(bufferSize > 0 ? bufferSize : 1);
+    buffer_.drain();
+    if (!file) {
+        setstate(std::ios::badbit);
+    }
+}
+
+OutputFile::~OutputFile() {
+    close();
+}
+
+bool OutputFile::open(const std::string& path, size_t bufferSize) {
+    close();
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    buffer_.file = file;
+    buffer_.bytes.resize(bufferSize > 0 ? bufferSize : 1);
+    buffer_.drain();
+    owned_ = true;
+    clear();
+    return true;
+}
+
+bool OutputFile::close() {
+    if (!buffer_.file) {
+        return true;
+    }
+    bool ok = !bad() && buffer_.pubsync() == 0;
+    if (owned_ && std::fclose(buffer_.file) != 0) {
+        ok = false;
+    }
+    buffer_.release();
+    owned_ = false;
+    setstate(std::ios::badbit);  // Closed: later writes go nowhere
+    return ok;
+}
@@ -1,21 +1,62 @@
 #include "Parser.h"
+#include "MappedFile.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <sstream>
-#include <regex>
+
+// ========== Chunk State ==========
+
+struct Parser::LineScratch {
+    std::string prefix;
+    std::string relation;
+    std::vector<std::string> args;
+    std::vector<std::string_view> argViews;
+};
+
+// Entries in the order the serial parser would have stored them
+struct Parser::AssumptionsChunk {
+    std::vector<std::pair<std::string, Proposition>> entries;
+    std::string diagnostics;
+};
+
+// Tokens of every line, as views into the file; a line with an error has no tokens
+struct Parser::FactsChunk {
+    struct Line {
+        size_t first;
+        size_t count;
+        std::string error;
+    };
+    std::vector<LexerTokenView> tokens;
+    std::vector<Line> lines;
+};
 
 // Constructor: register built-in handlers
 Parser::Parser() {
     registerBuiltinHandlers();
 }
 
+Parser::Parser(const Options& opts) : options_(opts) {
+    registerBuiltinHandlers();
+}
+
+void Parser::setOptions(const Options& opts) {
+    options_ = opts;
+}
+
+const Parser::Options& Parser::getOptions() const {
+    return options_;
+}
+
 // Register all built-in relation handlers
 void Parser::registerBuiltinHandlers() {
     registerRelation("implies", handleImplies);
     registerRelation("some", handleSome);
     registerRelation("not", handleNot);
     registerRelation("discovered", handleDiscovered);
+    registerRelation("or", handleOr);
+    registerRelation("and", handleAnd);
 }
 
 // Built-in handler: implies(antecedent, subject, consequent, predicate)
@@ -84,6 +125,37 @@ bool Parser::handleDiscovered(const std::string& prefix,
     return true;
 }
 
+// Built-in handler: or(literal1, ..., literalN)
+bool Parser::handleOr(const std::string& prefix,
+                      const std::vector<std::string>& args,
+                      std::unordered_map<std::string, Proposition>& propositions) {
+    return storeClause(prefix, LogicalOperator::OR, args, propositions);
+}
+
+// Built-in handler: and(literal1, ..., literalN)
+bool Parser::handleAnd(const std::string& prefix,
+                       const std::vector<std::string>& args,
+                       std::unordered_map<std::string, Proposition>& propositions) {
+    return storeClause(prefix, LogicalOperator::AND, args, propositions);
+}
+
+// A clause has no single subject, so it is keyed by its prefix
+bool Parser::storeClause(const std::string& prefix, LogicalOperator relation,
+                         const std::vector<std::string>& args,
+                         std::unordered_map<std::string, Proposition>& propositions) {
+    if (args.empty()) return false;
+    for (const std::string& arg : args) {
+        if (arg.empty()) return false;
+    }
+
+    Proposition proposition;
+    proposition.setPrefix(prefix);
+    proposition.setRelation(relation);
+    proposition.setOperands(args);
+    propositions[prefix] = proposition;  // Key is prefix
+    return true;
+}
+
 // Register a custom relation handler
 void Parser::registerRelation(const std::string& relationName, RelationHandler handler) {
     relationHandlers_[relationName] = std::move(handler);
@@ -113,53 +185,270 @@ std::vector<std::string> Parser::getRegisteredRelations() const {
 std::unordered_map<std::string, Proposition> Parser::parseAssumptionsFile(const std::string& filename) {
     std::unordered_map<std::string, Proposition> propositions;
     
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "Error: Could not open file " << filename << std::endl;
         return propositions;
     }
+    parseAssumptions(file.contents(), propositions);
+    
+    return propositions;
+}
+
+namespace {
+
+// Character classes of the assumption line grammar (ECMAScript \w and \s)
+bool isWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isSpaceChar(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool isArgumentChar(char c) {
+    return isWordChar(c) || isSpaceChar(c) || c == '-' || c == ',' || c == '~' || c == '!';
+}
+
+size_t skipSpaces(std::string_view text, size_t pos) {
+    while (pos < text.size() && isSpaceChar(text[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+size_t skipWord(std::string_view text, size_t pos) {
+    while (pos < text.size() && isWordChar(text[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+bool isBlankLine(std::string_view line) {
+    return line.find_first_not_of(" \t\n\r") == std::string_view::npos;
+}
+
+std::string_view trimBlanks(std::string_view text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        return std::string_view();
+    }
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+}  // namespace
+
+// Lines look like "prefix, relation(arg1, arg2, arg3, arg4)": word prefix and
+// relation, then one or more comma-separated arguments made of word characters,
+// hyphens, spaces and negation marks ("~p" or "!p"), with optional whitespace
+// around every part
+bool Parser::splitAssumptionLine(std::string_view line, std::string_view& prefix,
+                                 std::string_view& relation, std::vector<std::string_view>& args) {
+    size_t pos = skipSpaces(line, 0);
+    size_t end = skipWord(line, pos);
+    if (end == pos) return false;
+    prefix = line.substr(pos, end - pos);
+
+    pos = skipSpaces(line, end);
+    if (pos >= line.size() || line[pos] != ',') return false;
+    pos = skipSpaces(line, pos + 1);
+    end = skipWord(line, pos);
+    if (end == pos) return false;
+    relation = line.substr(pos, end - pos);
+
+    pos = skipSpaces(line, end);
+    if (pos >= line.size() || line[pos] != '(') return false;
+    size_t open = pos + 1;
+    size_t close = line.find(')', open);
+    if (close == std::string_view::npos || skipSpaces(line, close + 1) != line.size()) return false;
+
+    std::string_view inner = line.substr(open, close - open);
+    if (inner.empty()) return false;
+    for (char c : inner) {
+        if (!isArgumentChar(c)) return false;
+    }
+
+    // Surrounding whitespace belongs to the delimiters, unless that is all there is
+    size_t first = skipSpaces(inner, 0);
+    size_t last = inner.size();
+    while (last > first && isSpaceChar(inner[last - 1])) {
+        --last;
+    }
+    std::string_view arguments = (first == inner.size()) ? inner.substr(0, 1)
+                                                          : inner.substr(first, last - first);
+
+    // Split like std::getline on ',': a trailing comma adds no empty argument
+    args.clear();
+    size_t start = 0;
+    while (start < arguments.size()) {
+        size_t comma = arguments.find(',', start);
+        if (comma == std::string_view::npos) {
+            comma = arguments.size();
+        }
+        args.push_back(trimBlanks(arguments.substr(start, comma - start)));
+        start = comma + 1;
+    }
+    return true;
+}
+
+void Parser::parseAssumptionLine(std::string_view line, LineScratch& scratch,
+                                 std::unordered_map<std::string, Proposition>& propositions,
+                                 std::ostream& errors) const {
+    std::string_view prefix, relation;
+    if (!splitAssumptionLine(line, prefix, relation, scratch.argViews)) {
+        errors << "Error parsing line: " << line
+               << " (check for unbalanced parentheses or incorrect format)" << std::endl;
+        return;
+    }
+
+    // Look up and invoke the registered handler
+    scratch.relation.assign(relation);
+    auto it = relationHandlers_.find(scratch.relation);
+    if (it == relationHandlers_.end()) {
+        errors << "Warning: Unknown relation type '" << relation
+               << "' in line: " << line << std::endl;
+        return;
+    }
+
+    // Strings are reused across lines, so handlers receive them without reallocation
+    scratch.prefix.assign(prefix);
+    scratch.args.resize(scratch.argViews.size());
+    for (size_t i = 0; i < scratch.argViews.size(); ++i) {
+        scratch.args[i].assign(scratch.argViews[i]);
+    }
+    bool success = it->second(scratch.prefix, scratch.args, propositions);
+    if (!success) {
+        errors << "Warning: Handler for '" << relation
+               << "' failed to process: " << line << std::endl;
+    }
+}
+
+void Parser::parseAssumptions(std::string_view text,
+                              std::unordered_map<std::string, Proposition>& propositions) {
+    size_t threads = loadThreads(text.size());
+    if (threads > 1) {
+        parseAssumptionsParallel(text, propositions, threads);
+        return;
+    }
 
-    std::string line;
-    // Regex pattern to match lines like "prefix, relation(arg1, arg2, arg3, arg4)"
-    std::regex linePattern(R"(^\s*(\w+)\s*,\s*(\w+)\s*\(\s*([-\w\s\d,]+?)\s*\)\s*$)");
-    std::smatch match;
-
-    while (std::getline(file, line)) {
-        if (std::regex_match(line, match, linePattern)) {
-            std::string prefix = match[1];
-            std::string relation = match[2];
-            std::string arguments = match[3];
-
-            // Split arguments
-            std::istringstream argsStream(arguments);
-            std::vector<std::string> args;
-            std::string arg;
-            while (std::getline(argsStream, arg, ',')) {
-                arg.erase(0, arg.find_first_not_of(" \t"));
-                arg.erase(arg.find_last_not_of(" \t") + 1);
-                args.push_back(arg);
+    LineScratch scratch;
+    forEachLine(text, [&](std::string_view line) {
+        parseAssumptionLine(line, scratch, propositions, std::cerr);
+    });
+}
+
+// ========== Parallel Loading ==========
+
+namespace {
+
+// Pieces of about chunkBytes, each ending just after a newline (or at the end),
+// so every chunk holds whole lines and splits into the same lines as the text
+std::vector<std::string_view> splitChunks(std::string_view text, size_t chunkBytes) {
+    std::vector<std::string_view> chunks;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = std::min(text.size(), start + std::max<size_t>(chunkBytes, 1));
+        if (end < text.size()) {
+            size_t newline = text.find('\n', end - 1);
+            end = (newline == std::string_view::npos) ? text.size() : newline + 1;
+        }
+        chunks.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return chunks;
+}
+
+}  // namespace
+
+size_t Parser::loadThreads(size_t bytes) const {
+    size_t threads = options_.threads == 0 ? WorkStealingPool::defaultThreadCount() : options_.threads;
+    return (threads > 1 && bytes > options_.chunkBytes) ? threads : 1;
+}
+
+WorkStealingPool& Parser::pool(size_t threads) {
+    if (!pool_ || pool_->threadCount() != threads) {
+        pool_ = std::make_shared<WorkStealingPool>(threads);
+    }
+    return *pool_;
+}
+
+// A few chunks per thread per wave lets stealing even out uneven lines, while
+// only one wave of parsed output is held in memory at a time
+void Parser::parseAssumptionsParallel(std::string_view text,
+                                      std::unordered_map<std::string, Proposition>& propositions,
+                                      size_t threads) {
+    std::vector<std::string_view> chunks = splitChunks(text, options_.chunkBytes);
+    const size_t wave = threads * 4;
+    for (size_t waveStart = 0; waveStart < chunks.size(); waveStart += wave) {
+        size_t count = std::min(wave, chunks.size() - waveStart);
+        std::vector<AssumptionsChunk> parsed(count);
+
+        pool(threads).run(count, [&](size_t i) {
+            AssumptionsChunk& out = parsed[i];
+            LineScratch scratch;
+            std::unordered_map<std::string, Proposition> lineOutput;
+            std::ostringstream errors;
+            forEachLine(chunks[waveStart + i], [&](std::string_view line) {
+                parseAssumptionLine(line, scratch, lineOutput, errors);
+                while (!lineOutput.empty()) {
+                    auto node = lineOutput.extract(lineOutput.begin());
+                    out.entries.emplace_back(std::move(node.key()), std::move(node.mapped()));
+                }
+            });
+            out.diagnostics = errors.str();
+        });
+
+        for (AssumptionsChunk& chunk : parsed) {
+            std::cerr << chunk.diagnostics;
+            for (auto& entry : chunk.entries) {
+                // Later lines win; the first occurrence fixes the insertion order
+                propositions.try_emplace(std::move(entry.first)).first->second = std::move(entry.second);
             }
+        }
+    }
+}
+
+// Lexing runs concurrently; applying lines stays serial because every line
+// reads the truth values the lines before it assigned
+void Parser::parseFactsParallel(std::string_view text,
+                                std::unordered_map<std::string, Proposition>& propositions,
+                                std::vector<Expression>& expressions, size_t threads,
+                                std::vector<FactAssignment>* assignments) {
+    std::vector<std::string_view> chunks = splitChunks(text, options_.chunkBytes);
+    const size_t wave = threads * 4;
+    for (size_t waveStart = 0; waveStart < chunks.size(); waveStart += wave) {
+        size_t count = std::min(wave, chunks.size() - waveStart);
+        std::vector<FactsChunk> lexed(count);
+
+        pool(threads).run(count, [&](size_t i) {
+            FactsChunk& out = lexed[i];
+            Lexer lexer(lexer_.getOptions());
+            std::vector<LexerTokenView> lineTokens;
+            forEachLine(chunks[waveStart + i], [&](std::string_view line) {
+                if (isBlankLine(line)) return;
+                try {
+                    lexer.tokenizeView(line, lineTokens);
+                } catch (const LexerError& e) {
+                    out.lines.push_back({out.tokens.size(), 0, e.what()});
+                    return;
+                }
+                out.lines.push_back({out.tokens.size(), lineTokens.size(), std::string()});
+                out.tokens.insert(out.tokens.end(), lineTokens.begin(), lineTokens.end());
+            });
+        });
 
-            // Look up and invoke the registered handler
-            auto it = relationHandlers_.find(relation);
-            if (it != relationHandlers_.end()) {
-                bool success = it->second(prefix, args, propositions);
-                if (!success) {
-                    std::cerr << "Warning: Handler for '" << relation 
-                              << "' failed to process: " << line << std::endl;
+        for (const FactsChunk& chunk : lexed) {
+            for (const FactsChunk::Line& line : chunk.lines) {
+                if (!line.error.empty()) {
+                    std::cerr << "Error parsing facts line: " << line.error << std::endl;
+                    continue;
                 }
-            } else {
-                std::cerr << "Warning: Unknown relation type '" << relation 
-                          << "' in line: " << line << std::endl;
+                TokenIterator begin = chunk.tokens.begin() + line.first;
+                applyFactsTokens(begin, begin + line.count, propositions, expressions, assignments);
             }
-        } else {
-            std::cerr << "Error parsing line: " << line 
-                      << " (check for unbalanced parentheses or incorrect format)" << std::endl;
         }
     }
-    file.close();
-    
-    return propositions;
 }
 
 // ========== Expression Parsing Helpers ==========
@@ -177,26 +466,21 @@ LogicalOperator Parser::tokenTypeToLogicalOperator(TokenType type) {
     }
 }
 
-Expression Parser::buildExpression(const std::vector<LexerToken>& tokens,
+Expression Parser::buildExpression(TokenIterator begin, TokenIterator end,
                                    const std::unordered_map<std::string, Proposition>& propositions,
                                    const std::string& prefix) {
     Expression expr;
     expr.setPrefix(prefix);
     
-    for (const auto& token : tokens) {
-        switch (token.type) {
+    for (TokenIterator token = begin; token != end; ++token) {
+        switch (token->type) {
             case TokenType::IDENTIFIER: {
-                // Look up the proposition's truth value
-                Proposition prop;
-                auto it = propositions.find(token.value);
-                if (it != propositions.end()) {
-                    prop = it->second;
-                } else {
-                    // Create a new proposition with the identifier
-                    prop.setPrefix(token.value);
-                    prop.setTruthValue(Tripartite::UNKNOWN);
-                }
-                expr.addToken(prop);
+                // Capture the current truth value; a bound expression re-reads it by name
+                std::string name(token->value);
+                auto it = propositions.find(name);
+                Tripartite value = (it != propositions.end()) ? it->second.getTruthValue()
+                                                             : Tripartite::UNKNOWN;
+                expr.addToken(name, value);
                 break;
             }
             case TokenType::AND:
@@ -206,7 +490,7 @@ Expression Parser::buildExpression(const std::vector<LexerToken>& tokens,
             case TokenType::EQUIVALENT:
             case TokenType::LPAREN:
             case TokenType::RPAREN:
-                expr.addToken(tokenTypeToLogicalOperator(token.type));
+                expr.addToken(tokenTypeToLogicalOperator(token->type));
                 break;
             default:
                 // Skip other tokens (COMMA, ASSIGN, etc.)
@@ -217,94 +501,117 @@ Expression Parser::buildExpression(const std::vector<LexerToken>& tokens,
     return expr;
 }
 
-void Parser::parseFactsLine(const std::string& line,
-                            std::unordered_map<std::string, Proposition>& propositions,
-                            std::vector<Expression>& expressions) {
-    // Skip empty lines
-    if (line.empty() || line.find_first_not_of(" \t\n\r") == std::string::npos) {
-        return;
+Proposition& Parser::propositionNamed(std::string_view name,
+                                      std::unordered_map<std::string, Proposition>& propositions) {
+    nameBuffer_.assign(name);
+    return propositions[nameBuffer_];
+}
+
+void Parser::assignFact(std::string_view name, Tripartite value,
+                        std::unordered_map<std::string, Proposition>& propositions,
+                        std::vector<FactAssignment>* assignments) {
+    Proposition& prop = propositionNamed(name, propositions);
+    if (assignments) {
+        assignments->push_back({nameBuffer_, prop.getTruthValue(), value});
     }
+    prop.setTruthValue(value);
+}
+
+void Parser::applyFactsTokens(TokenIterator begin, TokenIterator end,
+                              std::unordered_map<std::string, Proposition>& propositions,
+                              std::vector<Expression>& expressions,
+                              std::vector<FactAssignment>* assignments) {
+    size_t count = static_cast<size_t>(end - begin);
+    if (count == 0) return;
     
-    try {
-        auto tokens = lexer_.tokenizeContent(line);
-        if (tokens.empty()) return;
-        
-        // Check if this is an assignment: identifier = expression
-        size_t assignIndex = SIZE_MAX;
-        for (size_t i = 0; i < tokens.size(); ++i) {
-            if (tokens[i].type == TokenType::ASSIGN) {
-                assignIndex = i;
-                break;
-            }
+    // Check if this is an assignment: identifier = expression
+    size_t assignIndex = SIZE_MAX;
+    for (size_t i = 0; i < count; ++i) {
+        if (begin[i].type == TokenType::ASSIGN) {
+            assignIndex = i;
+            break;
         }
+    }
+    
+    if (assignIndex != SIZE_MAX && assignIndex > 0) {
+        // Assignment: target = expression
+        std::string targetName(begin[0].value);
         
-        if (assignIndex != SIZE_MAX && assignIndex > 0) {
-            // Assignment: target = expression
-            std::string targetName = tokens[0].value;
-            
-            // Extract RHS tokens (after the =)
-            std::vector<LexerToken> rhsTokens(tokens.begin() + assignIndex + 1, tokens.end());
+        // RHS tokens (after the =)
+        TokenIterator rhsBegin = begin + assignIndex + 1;
+        
+        if (rhsBegin != end) {
+            // Build and evaluate the expression
+            Expression expr = buildExpression(rhsBegin, end, propositions, targetName);
+            Tripartite result = expr.evaluate();
             
-            if (!rhsTokens.empty()) {
-                // Build and evaluate the expression
-                Expression expr = buildExpression(rhsTokens, propositions, targetName);
-                Tripartite result = expr.evaluate();
-                
-                // Set the target's truth value
-                propositions[targetName].setTruthValue(result);
-                
-                // Store the expression for potential re-evaluation
-                expressions.push_back(expr);
-            }
-        } else {
-            // No assignment - process as assertion(s)
-            // Handle patterns like: !q, p && n, (a || b)
+            // Set the target's truth value
+            assignFact(targetName, result, propositions, assignments);
             
-            // Check if it's a simple negation: !identifier
-            if (tokens.size() == 2 && tokens[0].type == TokenType::NOT && 
-                tokens[1].type == TokenType::IDENTIFIER) {
-                propositions[tokens[1].value].setTruthValue(Tripartite::FALSE);
-                return;
-            }
+            // Store the expression for potential re-evaluation
+            expressions.push_back(expr);
+        }
+    } else {
+        // No assignment - process as assertion(s)
+        // Handle patterns like: !q, p && n, (a || b)
+        
+        // Check if it's a simple negation: !identifier
+        if (count == 2 && begin[0].type == TokenType::NOT && 
+            begin[1].type == TokenType::IDENTIFIER) {
+            assignFact(begin[1].value, Tripartite::FALSE, propositions, assignments);
+            return;
+        }
+        
+        // Check if it's a simple assertion: identifier
+        if (count == 1 && begin[0].type == TokenType::IDENTIFIER) {
+            assignFact(begin[0].value, Tripartite::TRUE, propositions, assignments);
+            return;
+        }
+        
+        // For compound expressions without assignment, set identifiers based on whether
+        // they are negated, and build an expression for potential evaluation
+        bool hasOperators = false;
+        for (size_t i = 0; i < count; ++i) {
+            const auto& token = begin[i];
             
-            // Check if it's a simple assertion: identifier
-            if (tokens.size() == 1 && tokens[0].type == TokenType::IDENTIFIER) {
-                propositions[tokens[0].value].setTruthValue(Tripartite::TRUE);
-                return;
+            if (token.type == TokenType::AND || token.type == TokenType::OR ||
+                token.type == TokenType::IMPLIES) {
+                hasOperators = true;
             }
             
-            // For compound expressions without assignment, set identifiers based on whether
-            // they are negated, and build an expression for potential evaluation
-            bool hasOperators = false;
-            for (size_t i = 0; i < tokens.size(); ++i) {
-                const auto& token = tokens[i];
-                
-                if (token.type == TokenType::AND || token.type == TokenType::OR ||
-                    token.type == TokenType::IMPLIES) {
-                    hasOperators = true;
-                }
+            if (token.type == TokenType::IDENTIFIER) {
+                // Check for preceding NOT operator
+                bool isNegated = (i > 0 && begin[i - 1].type == TokenType::NOT);
                 
-                if (token.type == TokenType::IDENTIFIER) {
-                    // Check for preceding NOT operator
-                    bool isNegated = (i > 0 && tokens[i - 1].type == TokenType::NOT);
-                    
-                    if (isNegated) {
-                        propositions[token.value].setTruthValue(Tripartite::FALSE);
-                    } else {
-                        propositions[token.value].setTruthValue(Tripartite::TRUE);
-                    }
-                }
-            }
-            
-            // If there are operators, also create an expression
-            if (hasOperators) {
-                Expression expr = buildExpression(tokens, propositions, "");
-                expressions.push_back(expr);
+                assignFact(token.value, isNegated ? Tripartite::FALSE : Tripartite::TRUE,
+                           propositions, assignments);
             }
         }
+        
+        // If there are operators, also create an expression
+        if (hasOperators) {
+            Expression expr = buildExpression(begin, end, propositions, "");
+            expressions.push_back(expr);
+        }
+    }
+}
+
+void Parser::parseFactsLine(std::string_view line,
+                            std::unordered_map<std::string, Proposition>& propositions,
+                            std::vector<Expression>& expressions,
+                            std::vector<FactAssignment>* assignments) {
+    // Skip empty lines
+    if (isBlankLine(line)) {
+        return;
+    }
+    
+    try {
+        lexer_.tokenizeView(line, lineTokens_);
     } catch (const LexerError& e) {
         std::cerr << "Error parsing facts line: " << e.what() << std::endl;
+        return;
     }
+    applyFactsTokens(lineTokens_.begin(), lineTokens_.end(), propositions, expressions, assignments);
 }
 
 void Parser::parseFactsFile(const std::string& filename, 
@@ -316,25 +623,34 @@ void Parser::parseFactsFile(const std::string& filename,
 void Parser::parseFactsFile(const std::string& filename,
                             std::unordered_map<std::string, Proposition>& propositions,
                             std::vector<Expression>& expressions) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "Error: Could not open file " << filename << std::endl;
         return;
     }
+    parseFacts(file.contents(), propositions, expressions);
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        parseFactsLine(line, propositions, expressions);
+void Parser::parseFacts(std::string_view text,
+                        std::unordered_map<std::string, Proposition>& propositions,
+                        std::vector<Expression>& expressions,
+                        std::vector<FactAssignment>* assignments) {
+    size_t threads = loadThreads(text.size());
+    if (threads > 1) {
+        parseFactsParallel(text, propositions, expressions, threads, assignments);
+        return;
     }
-    file.close();
+    forEachLine(text, [&](std::string_view line) {
+        parseFactsLine(line, propositions, expressions, assignments);
+    });
 }
 
 Expression Parser::parseExpressionString(const std::string& exprString,
                                          const std::unordered_map<std::string, Proposition>& propositions,
                                          const std::string& prefix) {
     try {
-        auto tokens = lexer_.tokenizeContent(exprString);
-        return buildExpression(tokens, propositions, prefix);
+        lexer_.tokenizeView(exprString, lineTokens_);
+        return buildExpression(lineTokens_.begin(), lineTokens_.end(), propositions, prefix);
     } catch (const LexerError& e) {
         std::cerr << "Error parsing expression: " << e.what() << std::endl;
         return Expression();  // Return empty expression on error
@@ -1,62 +1,49 @@
 #include "Proposition.h"
 
 #include <iostream>
+#include <mutex>
+#include <unordered_set>
 
-//***  Tripartite Operators ***//
-
-// Logical AND operator for Tripartite
-Tripartite operator&&(Tripartite left, Tripartite right) {
-  if (left == Tripartite::FALSE || right == Tripartite::FALSE)
-    return Tripartite::FALSE;
-  if (left == Tripartite::UNKNOWN || right == Tripartite::UNKNOWN)
-    return Tripartite::UNKNOWN;
-  return Tripartite::TRUE;
-}
-
-// Logical OR operator for Tripartite
-Tripartite operator||(Tripartite left, Tripartite right) {
-  if (left == Tripartite::TRUE || right == Tripartite::TRUE)
-    return Tripartite::TRUE;
-  if (left == Tripartite::UNKNOWN || right == Tripartite::UNKNOWN)
-    return Tripartite::UNKNOWN;
-  return Tripartite::FALSE;
-}
-
-// Logical NOT operator for Tripartite
-Tripartite operator!(Tripartite value) {
-  switch (value) {
-    case Tripartite::TRUE:
-      return Tripartite::FALSE;
-    case Tripartite::FALSE:
-      return Tripartite::TRUE;
-    case Tripartite::UNKNOWN:
-    default:
-      return Tripartite::UNKNOWN;
+//*** Proposition Class ***//
+
+InferenceRule inferenceRuleFromName(std::string_view name) {
+  for (InferenceRule rule : {InferenceRule::MODUS_PONENS, InferenceRule::MODUS_TOLLENS,
+                             InferenceRule::HYPOTHETICAL_SYLLOGISM,
+                             InferenceRule::DISJUNCTIVE_SYLLOGISM, InferenceRule::RESOLUTION,
+                             InferenceRule::SIMPLIFICATION}) {
+    if (name == inferenceRuleName(rule)) {
+      return rule;
+    }
   }
+  return InferenceRule::CUSTOM;
 }
 
-// Logical IMPLIES operator for Tripartite
-Tripartite implies(Tripartite left, Tripartite right) {
-  if (left == Tripartite::FALSE || right == Tripartite::TRUE)
-    return Tripartite::TRUE;
-  if (left == Tripartite::TRUE && right == Tripartite::FALSE)
-    return Tripartite::FALSE;
-  return Tripartite::UNKNOWN;
+std::string_view internRuleName(const std::string& name) {
+  InferenceRule rule = inferenceRuleFromName(name);
+  if (rule != InferenceRule::CUSTOM) {
+    return inferenceRuleName(rule);
+  }
+  // Custom names (direct assertions, tests) are few; set nodes never move
+  static std::mutex mutex;
+  static std::unordered_set<std::string> names;
+  std::lock_guard<std::mutex> lock(mutex);
+  return *names.insert(name).first;
 }
 
-//*** Proposition Class ***//
+namespace {
+const std::string kEmptyString;
+const std::vector<std::string> kNoOperands;
+const std::optional<InferenceProvenance> kNoProvenance;
+const std::vector<Conflict> kNoConflicts;
+}  // namespace
 
 Proposition::Proposition()
     : prefix(""),
+      truth_value(Tripartite::UNKNOWN),
       relation(LogicalOperator::NONE),
-      antecedent(""),
+      proposition_scope(Quantifier::NONE),
       antecedentAssertion(Tripartite::UNKNOWN),
-      subject(""),
-      consequent(""),
-      consequentAssertion(Tripartite::UNKNOWN),
-      predicate(""),
-      truth_value(Tripartite::UNKNOWN),
-      proposition_scope(Quantifier::NONE) {}
+      consequentAssertion(Tripartite::UNKNOWN) {}
 
 Proposition::Proposition(Tripartite truth_value)
     : Proposition() {
@@ -65,15 +52,35 @@ Proposition::Proposition(Tripartite truth_value)
 
 Proposition::Proposition(const std::string& prefix, Tripartite truth_value)
     : prefix(prefix),
+      truth_value(truth_value),
       relation(LogicalOperator::NONE),
-      antecedent(""),
+      proposition_scope(Quantifier::NONE),
       antecedentAssertion(Tripartite::UNKNOWN),
-      subject(""),
-      consequent(""),
-      consequentAssertion(Tripartite::UNKNOWN),
-      predicate(""),
-      truth_value(truth_value),
-      proposition_scope(Quantifier::NONE) {}
+      consequentAssertion(Tripartite::UNKNOWN) {}
+
+Proposition::Proposition(const Proposition& other)
+    : prefix(other.prefix),
+      truth_value(other.truth_value),
+      relation(other.relation),
+      proposition_scope(other.proposition_scope),
+      antecedentAssertion(other.antecedentAssertion),
+      consequentAssertion(other.consequentAssertion),
+      terms_(other.terms_ ? std::make_unique<Terms>(*other.terms_) : nullptr),
+      history_(other.history_ ? std::make_unique<History>(*other.history_) : nullptr) {}
+
+Proposition::Terms& Proposition::terms() {
+  if (!terms_) {
+    terms_ = std::make_unique<Terms>();
+  }
+  return *terms_;
+}
+
+Proposition::History& Proposition::history() {
+  if (!history_) {
+    history_ = std::make_unique<History>();
+  }
+  return *history_;
+}
 
 void Proposition::setPrefix(const std::string& prefixToSet) {
   prefix = prefixToSet;
@@ -82,68 +89,103 @@ void Proposition::setRelation(LogicalOperator relationToSet) {
   relation = relationToSet;
 }
 void Proposition::setAntecedent(const std::string& antcedentToSet) {
-  antecedent = antcedentToSet;
+  if (terms_ || !antcedentToSet.empty()) {
+    terms().antecedent = antcedentToSet;
+  }
 }
 
 void Proposition::setAntecedentAssertion(Tripartite assertionToSet) {
   antecedentAssertion = assertionToSet;
 }
 void Proposition::setSubject(const std::string& subjectToSet) {
-  subject = subjectToSet;
+  if (terms_ || !subjectToSet.empty()) {
+    terms().subject = subjectToSet;
+  }
 }
 void Proposition::setConsequent(const std::string& consequentToSet) {
-  consequent = consequentToSet;
+  if (terms_ || !consequentToSet.empty()) {
+    terms().consequent = consequentToSet;
+  }
 }
 void Proposition::setConsequentAssertion(Tripartite assertionToSet) {
   consequentAssertion = assertionToSet;
 }
 void Proposition::setPredicate(const std::string& predicateToSet) {
-  predicate = predicateToSet;
+  if (terms_ || !predicateToSet.empty()) {
+    terms().predicate = predicateToSet;
+  }
 }
+void Proposition::setOperands(std::vector<std::string> operandsToSet) {
+  if (terms_ || !operandsToSet.empty()) {
+    terms().operands = std::move(operandsToSet);
+  }
+}
+
 void Proposition::setTruthValue(Tripartite valueToSet) {
   // Simple setter without provenance - used for direct assignments
   truth_value = valueToSet;
-  provenance_.reset();  // Clear provenance when set without tracking
+  if (history_) {
+    history_->provenance.reset();  // Clear provenance when set without tracking
+  }
 }
 
 void Proposition::setTruthValue(Tripartite valueToSet, const InferenceProvenance& provenance) {
+  setTruthValue(valueToSet, provenance, ConflictRecording::ALL, 0);
+}
+
+void Proposition::setTruthValue(Tripartite valueToSet, const InferenceProvenance& provenance,
+                                ConflictRecording recording, size_t limit) {
+  History& record = history();
   // Check for conflict: overwriting a non-UNKNOWN value with a different value
-  if (truth_value != Tripartite::UNKNOWN && truth_value != valueToSet) {
-    // Record the conflict before overwriting
-    InferenceProvenance oldProv = provenance_.value_or(InferenceProvenance());
-    conflicts_.emplace_back(truth_value, valueToSet, oldProv, provenance);
+  if (truth_value != Tripartite::UNKNOWN && truth_value != valueToSet &&
+      recording != ConflictRecording::OFF) {
+    ++record.conflictCount;
+    bool keep = recording == ConflictRecording::ALL || (recording == ConflictRecording::RECENT && limit > 0);
+    if (keep) {
+      // The old provenance is replaced below, so the conflict can take it
+      InferenceProvenance oldProv = record.provenance ? std::move(*record.provenance) : InferenceProvenance();
+      if (recording == ConflictRecording::RECENT && record.conflicts.size() >= limit) {
+        // Full: drop the oldest, keeping the rest in order
+        std::move(record.conflicts.begin() + 1, record.conflicts.end(), record.conflicts.begin());
+        record.conflicts.pop_back();
+      }
+      record.conflicts.emplace_back(truth_value, valueToSet, std::move(oldProv), provenance);
+    }
   }
 
   truth_value = valueToSet;
-  provenance_ = provenance;
+  record.provenance = provenance;
 }
 void Proposition::setPropositionScope(Quantifier scopeToSet) {
   proposition_scope = scopeToSet;
 }
 
-std::string Proposition::getPrefix() const {
+const std::string& Proposition::getPrefix() const {
   return prefix;
 }
 LogicalOperator Proposition::getRelation() const {
   return relation;
 }
-std::string Proposition::getAntecedent() const {
-  return antecedent;
+const std::string& Proposition::getAntecedent() const {
+  return terms_ ? terms_->antecedent : kEmptyString;
 }
 Tripartite Proposition::getAntecedentAssertion() const {
   return antecedentAssertion;
 }
-std::string Proposition::getSubject() const {
-  return subject;
+const std::string& Proposition::getSubject() const {
+  return terms_ ? terms_->subject : kEmptyString;
 }
-std::string Proposition::getConsequent() const {
-  return consequent;
+const std::string& Proposition::getConsequent() const {
+  return terms_ ? terms_->consequent : kEmptyString;
 }
 Tripartite Proposition::getConsequentAssertion() const {
   return consequentAssertion;
 }
-std::string Proposition::getPredicate() const {
-  return predicate;
+const std::string& Proposition::getPredicate() const {
+  return terms_ ? terms_->predicate : kEmptyString;
+}
+const std::vector<std::string>& Proposition::getOperands() const {
+  return terms_ ? terms_->operands : kNoOperands;
 }
 Tripartite Proposition::getTruthValue() const {
   return truth_value;
@@ -154,23 +196,30 @@ Quantifier Proposition::getPropositionScope() const {
 
 // Inference tracking getters
 const std::optional<InferenceProvenance>& Proposition::getProvenance() const {
-  return provenance_;
+  return history_ ? history_->provenance : kNoProvenance;
 }
 
 bool Proposition::hasProvenance() const {
-  return provenance_.has_value();
+  return history_ && history_->provenance.has_value();
 }
 
 const std::vector<Conflict>& Proposition::getConflicts() const {
-  return conflicts_;
+  return history_ ? history_->conflicts : kNoConflicts;
+}
+
+size_t Proposition::getConflictCount() const {
+  return history_ ? history_->conflictCount : 0;
 }
 
 bool Proposition::hasConflicts() const {
-  return !conflicts_.empty();
+  return history_ && history_->conflictCount > 0;
 }
 
 void Proposition::clearConflicts() {
-  conflicts_.clear();
+  if (history_) {
+    history_->conflicts.clear();
+    history_->conflictCount = 0;
+  }
 }
 
 // Operator Overloads //
@@ -220,16 +269,12 @@ Proposition& Proposition::operator=(const Proposition& other) {
   if (this != &other) {
     prefix = other.prefix;
     relation = other.relation;
-    antecedent = other.antecedent;
     antecedentAssertion = other.antecedentAssertion;
-    subject = other.subject;
-    consequent = other.consequent;
     consequentAssertion = other.consequentAssertion;
-    predicate = other.predicate;
     truth_value = other.truth_value;
     proposition_scope = other.proposition_scope;
-    provenance_ = other.provenance_;
-    conflicts_ = other.conflicts_;
+    terms_ = other.terms_ ? std::make_unique<Terms>(*other.terms_) : nullptr;
+    history_ = other.history_ ? std::make_unique<History>(*other.history_) : nullptr;
   }
   return *this;
 }
@@ -1,6 +1,8 @@
 #include "Ratiocinator.h"
 #include "Expression.h"
 #include "Proposition.h"
+#include "RuleBase.h"
+#include "Snapshot.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -21,7 +23,7 @@ bool ResultFilter::matches(const std::string& name, const Proposition& prop) con
     
     // Check prefix pattern
     if (!prefixPattern.empty()) {
-        if (name.substr(0, prefixPattern.length()) != prefixPattern) {
+        if (name.compare(0, prefixPattern.length(), prefixPattern) != 0) {
             return false;
         }
     }
@@ -41,23 +43,766 @@ bool ResultFilter::matches(const std::string& name, const Proposition& prop) con
     return true;
 }
 
+namespace {
+
+using ResultEntry = std::pair<const std::string, Proposition>;
+
+// Entries a filter selects from the candidates forEachCandidate visits,
+// sorted and limited as it asks. Candidates that arrive in the filter's sort
+// order (inOrder) are not sorted again, and stop at the limit.
+template <typename ForEachCandidate>
+std::vector<const ResultEntry*> selectResults(const ResultFilter& filter, bool inOrder,
+                                              ForEachCandidate forEachCandidate) {
+    // Sort keys computed once per entry instead of looked up per comparison:
+    // the group, then the name's first 8 bytes, so most comparisons never
+    // touch the map node
+    struct Keyed {
+        int key;
+        uint64_t prefix;
+        const ResultEntry* entry;
+    };
+    auto namePrefix = [](const std::string& name) {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            prefix = (prefix << 8) | (i < name.size() ? static_cast<unsigned char>(name[i]) : 0);
+        }
+        return prefix;
+    };
+    std::vector<Keyed> rows;
+    
+    // Collect matching entries
+    bool sorted = filter.sortOrder != ResultSortOrder::NONE && !inOrder;
+    forEachCandidate([&](const ResultEntry& entry) {
+        if (!filter.matches(entry.first, entry.second)) {
+            return true;
+        }
+        int key = 0;
+        if (filter.sortOrder == ResultSortOrder::BY_TRUTH_VALUE) {
+            // UNKNOWN, TRUE, FALSE: the order of the enum's old signed encoding
+            Tripartite value = entry.second.getTruthValue();
+            key = value == Tripartite::UNKNOWN ? -1 : static_cast<int>(value);
+        } else if (filter.sortOrder == ResultSortOrder::BY_DERIVATION) {
+            key = entry.second.hasProvenance() ? 0 : 1;  // Derived first
+        }
+        rows.push_back({key, sorted ? namePrefix(entry.first) : 0, &entry});
+        // Unsorted or already in order: the first matches are the answer
+        return sorted || filter.limit == 0 || rows.size() < filter.limit;
+    });
+    
+    // Apply sorting (only the first `limit` rows when limited)
+    if (sorted) {
+        auto ascending = [](const Keyed& a, const Keyed& b) {
+            if (a.key != b.key) return a.key < b.key;
+            if (a.prefix != b.prefix) return a.prefix < b.prefix;
+            return a.entry->first < b.entry->first;  // Secondary sort by name
+        };
+        auto descending = [](const Keyed& a, const Keyed& b) {
+            if (a.prefix != b.prefix) return a.prefix > b.prefix;
+            return a.entry->first > b.entry->first;
+        };
+        auto order = [&](auto less) {
+            if (filter.limit > 0 && filter.limit < rows.size()) {
+                std::partial_sort(rows.begin(), rows.begin() + filter.limit, rows.end(), less);
+                rows.resize(filter.limit);
+            } else {
+                std::sort(rows.begin(), rows.end(), less);
+            }
+        };
+        if (filter.sortOrder == ResultSortOrder::ALPHABETICAL_DESC) {
+            order(descending);
+        } else {
+            order(ascending);
+        }
+    }
+    
+    std::vector<const ResultEntry*> entries;
+    entries.reserve(rows.size());
+    for (const Keyed& row : rows) {
+        entries.push_back(row.entry);
+    }
+    return entries;
+}
+
+// Entries a filter selects by scanning every proposition
+std::vector<const ResultEntry*> selectResults(const std::unordered_map<std::string, Proposition>& propositions,
+                                              const ResultFilter& filter) {
+    return selectResults(filter, false, [&](auto visit) {
+        for (const auto& entry : propositions) {
+            if (!visit(entry)) {
+                return;
+            }
+        }
+    });
+}
+
+// Entries a filter selects, starting from the smaller of its prefix range and
+// its truth value / derivation buckets
+std::vector<const ResultEntry*> selectResults(const ResultIndex& index, const ResultFilter& filter) {
+    const Tripartite values[] = {Tripartite::TRUE, Tripartite::FALSE, Tripartite::UNKNOWN};
+    const bool showValue[] = {filter.showTrue, filter.showFalse, filter.showUnknown};
+    size_t inBuckets = 0;
+    for (int v = 0; v < 3; ++v) {
+        if (showValue[v]) {
+            inBuckets += filter.showDerived ? index.bucketSize(values[v], true) : 0;
+            inBuckets += filter.showAxioms ? index.bucketSize(values[v], false) : 0;
+        }
+    }
+    size_t inRange = index.countByName(filter.prefixPattern);
+
+    if (inBuckets < inRange) {
+        return selectResults(filter, false, [&](auto visit) {
+            for (int v = 0; v < 3; ++v) {
+                if (!showValue[v]) continue;
+                if (filter.showDerived && !index.forEachInBucket(values[v], true, visit)) return;
+                if (filter.showAxioms && !index.forEachInBucket(values[v], false, visit)) return;
+            }
+        });
+    }
+    bool descending = filter.sortOrder == ResultSortOrder::ALPHABETICAL_DESC;
+    bool inOrder = descending || filter.sortOrder == ResultSortOrder::ALPHABETICAL;
+    return selectResults(filter, inOrder, [&](auto visit) {
+        index.forEachByName(filter.prefixPattern, descending, visit);
+    });
+}
+
+// Names of the propositions a filter selects, sorted and limited as it asks
+std::vector<std::string> filteredNames(const std::vector<const ResultEntry*>& entries) {
+    std::vector<std::string> names;
+    names.reserve(entries.size());
+    for (const ResultEntry* entry : entries) {
+        names.push_back(entry->first);
+    }
+    return names;
+}
+
+std::string_view textValue(Tripartite value) {
+    switch (value) {
+        case Tripartite::TRUE:    return "True";
+        case Tripartite::FALSE:   return "False";
+        case Tripartite::UNKNOWN: return "Unknown";
+    }
+    return "Unknown";
+}
+
+std::string_view jsonValue(Tripartite value) {
+    switch (value) {
+        case Tripartite::TRUE:    return "TRUE";
+        case Tripartite::FALSE:   return "FALSE";
+        case Tripartite::UNKNOWN: return "UNKNOWN";
+    }
+    return "UNKNOWN";
+}
+
+// Write a JSON string literal, escaping quotes, backslashes and control characters
+void writeJsonString(std::ostream& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out.put('"');
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.write(text.data() + start, static_cast<std::streamsize>(i - start));
+        start = i + 1;
+        switch (c) {
+            case '"':  out.write("\\\"", 2); break;
+            case '\\': out.write("\\\\", 2); break;
+            case '\n': out.write("\\n", 2); break;
+            case '\r': out.write("\\r", 2); break;
+            case '\t': out.write("\\t", 2); break;
+            default: {
+                char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.write(escape, 6);
+                break;
+            }
+        }
+    }
+    out.write(text.data() + start, static_cast<std::streamsize>(text.size() - start));
+    out.put('"');
+}
+
+void writeJsonNames(std::ostream& out, const std::vector<std::string>& names) {
+    out.put('[');
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (i > 0) out.put(',');
+        writeJsonString(out, names[i]);
+    }
+    out.put(']');
+}
+
+// One result as a JSON object: name, value, derivation and (optionally) its trace
+void writeJsonResult(std::ostream& out, const ResultEntry& entry, const ResultFilter& filter,
+                     const SymbolTable& symbols, TraceGraph& traces) {
+    const Proposition& prop = entry.second;
+    out.write("{\"name\":", 8);
+    writeJsonString(out, entry.first);
+    out << ",\"value\":\"" << jsonValue(prop.getTruthValue()) << "\",\"derived\":"
+        << (prop.hasProvenance() ? "true" : "false");
+    if (filter.showProvenance && prop.hasProvenance()) {
+        out.write(",\"rule\":", 8);
+        writeJsonString(out, prop.getProvenance()->ruleFired);
+        out.write(",\"premises\":", 12);
+        writeJsonNames(out, TraceGraph::premiseNames(*prop.getProvenance(), &symbols));
+    }
+    if (filter.includeTraces && prop.hasProvenance()) {
+        out.write(",\"trace\":[", 10);
+        std::vector<InferenceStep> steps = traces.trace(entry.first);
+        for (size_t i = 0; i < steps.size(); ++i) {
+            if (i > 0) out.put(',');
+            out.write("{\"proposition\":", 15);
+            writeJsonString(out, steps[i].proposition);
+            out << ",\"value\":\"" << jsonValue(steps[i].truthValue) << "\",\"rule\":";
+            writeJsonString(out, steps[i].rule);
+            out.write(",\"premises\":", 12);
+            writeJsonNames(out, steps[i].premises);
+            out << ",\"depth\":" << steps[i].depth << '}';
+        }
+        out.put(']');
+    }
+    out.put('}');
+}
+
+} // namespace
+
+// ========== KnowledgeView Implementation ==========
+
+uint64_t KnowledgeView::getVersion() const {
+    return version_;
+}
+
+Tripartite KnowledgeView::getPropositionTruthValue(const std::string& name) const {
+    auto it = propositions_.find(name);
+    return it != propositions_.end() ? it->second.getTruthValue() : Tripartite::UNKNOWN;
+}
+
+const Proposition* KnowledgeView::getProposition(const std::string& name) const {
+    auto it = propositions_.find(name);
+    return it != propositions_.end() ? &it->second : nullptr;
+}
+
+bool KnowledgeView::hasProposition(const std::string& name) const {
+    return propositions_.find(name) != propositions_.end();
+}
+
+size_t KnowledgeView::getPropositionCount() const {
+    return propositions_.size();
+}
+
+const std::unordered_map<std::string, Proposition>& KnowledgeView::getPropositions() const {
+    return propositions_;
+}
+
+std::vector<std::string> KnowledgeView::getFilteredPropositionNames(const ResultFilter& filter) const {
+    return filteredNames(selectResults(propositions_, filter));
+}
+
+std::vector<InferenceStep> KnowledgeView::traceInference(const std::string& name) const {
+    TraceGraph graph(propositions_, symbols_.get());
+    return graph.trace(name);
+}
+
 // ========== Facade Methods (Primary API) ==========
 
 void Ratiocinator::loadAssumptions(const std::string& filename) {
+    tracesStale_ = true;
+    invalidateResultIndex();
     auto parsed = parser_.parseAssumptionsFile(filename);
     for (auto& entry : parsed) {
-        propositions_[entry.first] = std::move(entry.second);
+        Proposition& stored = propositions_[entry.first];
+        stored = std::move(entry.second);
+        literalIndex_.addRule(entry.first, stored);
     }
+    fullDeductionNeeded_ = true;
 }
 
 void Ratiocinator::loadFacts(const std::string& filename) {
+    tracesStale_ = true;
+    invalidateResultIndex();
     // Use the enhanced parseFactsFile that builds Expression objects
     // from complex facts and populates the expressions_ vector
     parser_.parseFactsFile(filename, propositions_, expressions_);
+    fullDeductionNeeded_ = true;
 }
 
 void Ratiocinator::deduce() {
-    inferenceEngine_.deduceAll(propositions_, expressions_);
+    tracesStale_ = true;
+    invalidateResultIndex();
+    refreshLiteralIndex();
+    inferenceEngine_.deduceAll(propositions_, expressions_, literalIndex_);
+    reportConvergence();
+    resetTruthMaintenance();
+    // An interrupted deduction is no fixed point to continue from
+    fullDeductionNeeded_ = getConvergence().interrupted != Interruption::NONE;
+    publishIfEnabled();
+}
+
+InferenceEngine::Convergence Ratiocinator::deduce(const DeductionLimits& limits) {
+    inferenceEngine_.setLimits(limits);
+    try {
+        deduce();
+    } catch (...) {
+        inferenceEngine_.clearLimits();
+        throw;
+    }
+    inferenceEngine_.clearLimits();
+    return getConvergence();
+}
+
+std::future<InferenceEngine::Convergence> Ratiocinator::deduceAsync(const DeductionLimits& limits,
+                                                                    Executor executor) {
+    if (!executor) {
+        return std::async(std::launch::async, [this, limits]() { return deduce(limits); });
+    }
+    auto task = std::make_shared<std::packaged_task<InferenceEngine::Convergence()>>(
+        [this, limits]() { return deduce(limits); });
+    std::future<InferenceEngine::Convergence> result = task->get_future();
+    executor([task]() { (*task)(); });
+    return result;
+}
+
+struct Ratiocinator::ChangeTracker {
+    std::unordered_map<std::string, size_t> slots;   // Name -> index in changes
+    std::vector<PropositionChange> changes;
+
+    // Remember the value a proposition had before the batch first touched it
+    void touch(const std::string& name, Tripartite before) {
+        if (slots.emplace(name, changes.size()).second) {
+            changes.push_back({name, before, before});
+        }
+    }
+};
+
+void Ratiocinator::deduceIncremental() {
+    deduceIncremental(nullptr);
+}
+
+void Ratiocinator::deduceIncremental(ChangeTracker* tracker) {
+    tracesStale_ = true;
+    // Without provenance there is no telling which derived values a retraction undermines
+    bool untraceable = !pendingRetractions_.empty() &&
+                       getInferenceOptions().provenance == ProvenanceLevel::NONE;
+    if (fullDeductionNeeded_ || literalIndexStale_ || untraceable) {
+        // A full deduction may change anything, so every value is compared
+        if (tracker) {
+            for (const auto& entry : propositions_) {
+                tracker->touch(entry.first, entry.second.getTruthValue());
+            }
+        }
+        deduce();
+        if (tracker) {
+            for (const auto& entry : propositions_) {
+                tracker->touch(entry.first, Tripartite::UNKNOWN);
+            }
+        }
+        return;
+    }
+
+    // Retract everything whose provenance cites a premise that no longer holds
+    std::vector<std::string> seeds = pendingChanges_;
+    std::vector<std::string> frontier = pendingRetractions_;
+    for (const std::string& name : pendingRetractions_) {
+        PropId id;
+        // Provenance names literals by their canonical spelling
+        if (literalIndex_.symbols().find(name, id) && literalIndex_.symbols().name(id) != name) {
+            frontier.push_back(literalIndex_.symbols().name(id));
+        }
+    }
+    while (!frontier.empty()) {
+        std::string premise = std::move(frontier.back());
+        frontier.pop_back();
+        auto it = dependents_.find(premise);
+        if (it == dependents_.end()) {
+            continue;
+        }
+        std::vector<std::string> names = std::move(it->second);
+        dependents_.erase(it);
+
+        for (const std::string& name : names) {
+            auto prop = propositions_.find(name);
+            if (prop == propositions_.end() || !prop->second.hasProvenance()) {
+                continue;
+            }
+            std::vector<std::string> premises = premiseNames(*prop->second.getProvenance());
+            if (std::find(premises.begin(), premises.end(), premise) == premises.end()) {
+                continue;
+            }
+            if (tracker) {
+                tracker->touch(name, prop->second.getTruthValue());
+            }
+            prop->second.setTruthValue(Tripartite::UNKNOWN);
+            noteIndexed(name);
+            seeds.push_back(name);
+            frontier.push_back(name);
+        }
+    }
+
+    std::vector<std::string> assigned;
+    std::vector<Tripartite> previous;
+    inferenceEngine_.deduceIncremental(propositions_, expressions_, literalIndex_, seeds, &assigned,
+                                       tracker ? &previous : nullptr);
+    reportConvergence();
+    if (tracker) {
+        for (size_t i = 0; i < assigned.size(); ++i) {
+            tracker->touch(assigned[i], previous[i]);
+        }
+    }
+    for (const std::string& name : assigned) {
+        auto it = propositions_.find(name);
+        if (it != propositions_.end()) {
+            recordDependents(name, it->second);
+        }
+        noteIndexed(name);
+    }
+    pendingChanges_.clear();
+    pendingRetractions_.clear();
+    publishIfEnabled();
+}
+
+void Ratiocinator::noteReplaced(const std::string& name, const Proposition& before) {
+    tracesStale_ = true;
+    noteIndexed(name);
+    if (LiteralIndex::isIndexedRule(before)) {
+        // Values derived through the old rule lose that support. Full provenance
+        // cites the rule by prefix, compact provenance by its key.
+        pendingRetractions_.push_back(before.getPrefix());
+        if (before.getPrefix() != name) {
+            pendingRetractions_.push_back(name);
+        }
+        noteRuleOperands(before);
+    }
+    if (before.getTruthValue() != Tripartite::UNKNOWN) {
+        pendingRetractions_.push_back(name);
+    }
+    pendingChanges_.push_back(name);
+}
+
+void Ratiocinator::noteValueChange(const std::string& name, Tripartite before, Tripartite after) {
+    tracesStale_ = true;
+    noteIndexed(name);  // Provenance may change even when the value does not
+    if (before == after) {
+        return;
+    }
+    if (before != Tripartite::UNKNOWN) {
+        pendingRetractions_.push_back(name);
+    }
+    pendingChanges_.push_back(name);
+}
+
+void Ratiocinator::noteAdded(const std::string& name, const Proposition& prop) {
+    tracesStale_ = true;
+    noteIndexed(name);
+    if (LiteralIndex::isIndexedRule(prop)) {
+        noteRuleOperands(prop);
+    }
+    pendingChanges_.push_back(name);
+}
+
+void Ratiocinator::noteRuleOperands(const Proposition& rule) {
+    if (LiteralIndex::isClause(rule)) {
+        pendingChanges_.insert(pendingChanges_.end(), rule.getOperands().begin(), rule.getOperands().end());
+        return;
+    }
+    pendingChanges_.push_back(rule.getAntecedent());
+    pendingChanges_.push_back(rule.getConsequent());
+}
+
+std::vector<std::string> Ratiocinator::premiseNames(const InferenceProvenance& provenance) const {
+    return TraceGraph::premiseNames(provenance, &literalIndex_.symbols());
+}
+
+void Ratiocinator::recordDependents(const std::string& name, const Proposition& prop) {
+    if (!prop.hasProvenance()) {
+        return;
+    }
+    for (const std::string& premise : premiseNames(*prop.getProvenance())) {
+        std::vector<std::string>& names = dependents_[premise];
+        if (std::find(names.begin(), names.end(), name) == names.end()) {
+            names.push_back(name);
+        }
+    }
+}
+
+void Ratiocinator::resetTruthMaintenance() {
+    pendingChanges_.clear();
+    pendingRetractions_.clear();
+    dependents_.clear();
+    for (const auto& entry : propositions_) {
+        recordDependents(entry.first, entry.second);
+    }
+    fullDeductionNeeded_ = false;
+}
+
+const ResultIndex& Ratiocinator::resultIndex() const {
+    if (resultIndexStale_) {
+        resultIndex_.rebuild(propositions_);
+        resultIndexStale_ = false;
+    } else {
+        for (const std::string& name : resultIndexPending_) {
+            auto it = propositions_.find(name);
+            if (it != propositions_.end()) {
+                resultIndex_.update(*it);
+            }
+        }
+    }
+    resultIndexPending_.clear();
+    return resultIndex_;
+}
+
+void Ratiocinator::noteIndexed(const std::string& name) {
+    if (resultIndexStale_) {
+        return;
+    }
+    if (resultIndexPending_.size() >= propositions_.size()) {
+        // Touching most of the knowledge base: a rebuild is cheaper
+        invalidateResultIndex();
+        return;
+    }
+    resultIndexPending_.push_back(name);
+}
+
+void Ratiocinator::invalidateResultIndex() {
+    resultIndexStale_ = true;
+    resultIndexPending_.clear();
+}
+
+TraceGraph& Ratiocinator::traceGraph() const {
+    if (tracesStale_) {
+        traces_.reset(propositions_, &literalIndex_.symbols());
+        tracesStale_ = false;
+    }
+    return traces_;
+}
+
+void Ratiocinator::refreshLiteralIndex() const {
+    if (literalIndexStale_) {
+        literalIndex_.rebuild(propositions_);
+        literalIndexStale_ = false;
+    }
+}
+
+QueryResult Ratiocinator::query(const std::string& name) {
+    // A derived value that lost its support must not answer; new facts can wait
+    if (!fullDeductionNeeded_ && !literalIndexStale_ && !pendingRetractions_.empty()) {
+        deduceIncremental();
+    }
+    refreshLiteralIndex();
+
+    tracesStale_ = true;
+    QueryResult result;
+    result.name = name;
+    std::vector<std::string> assigned;
+    result.value = inferenceEngine_.query(propositions_, expressions_, literalIndex_, name,
+                                          &assigned, &result.rulesConsidered);
+    reportConvergence();
+    result.derivedCount = assigned.size();
+    for (const std::string& derived : assigned) {
+        auto it = propositions_.find(derived);
+        if (it != propositions_.end()) {
+            recordDependents(derived, it->second);
+        }
+        noteIndexed(derived);
+    }
+    auto it = propositions_.find(name);
+    if (it != propositions_.end()) {
+        result.provenance = it->second.getProvenance();
+    }
+    if (!assigned.empty()) {
+        publishIfEnabled();
+    }
+    return result;
+}
+
+// ========== Streaming Ingestion ==========
+
+void Ratiocinator::setIngestOptions(const IngestOptions& opts) {
+    ingestOptions_ = opts;
+}
+
+const IngestOptions& Ratiocinator::getIngestOptions() const {
+    return ingestOptions_;
+}
+
+void Ratiocinator::setChangeCallback(ChangeCallback callback) {
+    onChange_ = std::move(callback);
+}
+
+void Ratiocinator::ingest(std::string_view line) {
+    bool timed = ingestOptions_.maxLatency.count() > 0;
+    if (ingestLines_ == 0 && timed) {
+        ingestStarted_ = std::chrono::steady_clock::now();
+    }
+    ingestBuffer_.append(line.data(), line.size());
+    ingestBuffer_.push_back('\n');
+    ++ingestLines_;
+
+    bool full = ingestOptions_.batchSize > 0 && ingestLines_ >= ingestOptions_.batchSize;
+    bool late = timed && std::chrono::steady_clock::now() - ingestStarted_ >= ingestOptions_.maxLatency;
+    if (full || late) {
+        flush();
+    }
+}
+
+size_t Ratiocinator::ingest(std::istream& in) {
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        ingest(line);
+        ++lines;
+    }
+    flush();
+    return lines;
+}
+
+std::vector<PropositionChange> Ratiocinator::flush() {
+    if (ingestLines_ == 0) {
+        return {};
+    }
+    std::string batch;
+    batch.swap(ingestBuffer_);
+    ingestLines_ = 0;
+
+    std::vector<Parser::FactAssignment> assignments;
+    tracesStale_ = true;
+    parser_.parseFacts(batch, propositions_, expressions_, &assignments);
+
+    ChangeTracker tracker;
+    for (const Parser::FactAssignment& assignment : assignments) {
+        tracker.touch(assignment.name, assignment.previous);
+        noteValueChange(assignment.name, assignment.previous, assignment.value);
+    }
+    deduceIncremental(&tracker);
+
+    // Keep only what ends the batch with a different value
+    std::vector<PropositionChange> changes;
+    for (PropositionChange& change : tracker.changes) {
+        change.after = getPropositionTruthValue(change.name);
+        if (change.after != change.before) {
+            changes.push_back(std::move(change));
+        }
+    }
+    if (onChange_ && !changes.empty()) {
+        onChange_(changes);
+    }
+    return changes;
+}
+
+size_t Ratiocinator::getPendingLineCount() const {
+    return ingestLines_;
+}
+
+// ========== Read Snapshots ==========
+
+void Ratiocinator::setSnapshotPublishing(bool enabled) {
+    publishing_ = enabled;
+    publishIfEnabled();
+}
+
+bool Ratiocinator::isSnapshotPublishing() const {
+    return publishing_;
+}
+
+void Ratiocinator::publishSnapshot() {
+    refreshLiteralIndex();
+    // Symbols only grow between clears, so an unchanged size means an unchanged table
+    const SymbolTable& symbols = literalIndex_.symbols();
+    if (!publishedSymbols_ || publishedSymbols_->idCount() != symbols.idCount() ||
+        publishedSymbols_->spellings().size() != symbols.spellings().size()) {
+        publishedSymbols_ = std::make_shared<const SymbolTable>(symbols);
+    }
+
+    auto view = std::make_shared<KnowledgeView>();
+    view->propositions_ = propositions_;
+    view->symbols_ = publishedSymbols_;
+    view->version_ = ++publishedVersion_;
+    std::atomic_store(&published_, std::shared_ptr<const KnowledgeView>(std::move(view)));
+}
+
+std::shared_ptr<const KnowledgeView> Ratiocinator::snapshot() const {
+    return std::atomic_load(&published_);
+}
+
+std::shared_ptr<const RuleBase> Ratiocinator::compileRuleBase(size_t threads) const {
+    RuleBase::Options opts;
+    opts.inference = inferenceEngine_.getOptions();
+    opts.threads = threads;
+    return std::make_shared<const RuleBase>(propositions_, expressions_, opts);
+}
+
+void Ratiocinator::publishIfEnabled() {
+    if (publishing_) {
+        publishSnapshot();
+    }
+}
+
+bool Ratiocinator::saveSnapshot(const std::string& path, bool includeProvenance) const {
+    // Only a settled base with its provenance can continue incrementally
+    bool deduced = includeProvenance && !fullDeductionNeeded_ && !literalIndexStale_ &&
+                   pendingChanges_.empty() && pendingRetractions_.empty();
+    refreshLiteralIndex();
+    return Snapshot::write(path, propositions_, expressions_, literalIndex_.symbols(),
+                           deduced, includeProvenance);
+}
+
+bool Ratiocinator::loadSnapshot(const std::string& path) {
+    std::unordered_map<std::string, Proposition> propositions;
+    std::vector<Expression> expressions;
+    LiteralIndex index;
+    bool deduced = false;
+    if (!Snapshot::read(path, propositions, expressions, index.symbols(), deduced)) {
+        return false;
+    }
+    // Symbols were restored in id order, so rebuilding reuses their ids
+    index.rebuild(propositions);
+
+    invalidateResultIndex();
+    propositions_ = std::move(propositions);
+    expressions_ = std::move(expressions);
+    literalIndex_ = std::move(index);
+    literalIndexStale_ = false;
+    publishedSymbols_.reset();
+    tracesStale_ = true;
+    resetTruthMaintenance();
+    fullDeductionNeeded_ = !deduced;
+    publishIfEnabled();
+    return true;
+}
+
+void Ratiocinator::setInferenceOptions(const InferenceEngine::Options& opts) {
+    inferenceEngine_.setOptions(opts);
+}
+
+const InferenceEngine::Options& Ratiocinator::getInferenceOptions() const {
+    return inferenceEngine_.getOptions();
+}
+
+const InferenceEngine::Convergence& Ratiocinator::getConvergence() const {
+    return inferenceEngine_.getConvergence();
+}
+
+const InferenceStats& Ratiocinator::getStats() const {
+    return inferenceEngine_.getStats();
+}
+
+void Ratiocinator::resetStats() {
+    inferenceEngine_.resetStats();
+}
+
+void Ratiocinator::reportConvergence() const {
+    const InferenceEngine::Convergence& convergence = inferenceEngine_.getConvergence();
+    for (const std::string& name : convergence.oscillating) {
+        std::cerr << "Warning: deduction stopped before a fixed point: '" << name
+                  << "' was overturned more than " << getInferenceOptions().oscillationLimit
+                  << " times (contradictory rules?)" << std::endl;
+    }
+}
+
+void Ratiocinator::setParserOptions(const Parser::Options& opts) {
+    parser_.setOptions(opts);
+}
+
+const Parser::Options& Ratiocinator::getParserOptions() const {
+    return parser_.getOptions();
 }
 
 std::string Ratiocinator::formatResults(bool includeTraces) const {
@@ -89,7 +834,8 @@ std::string Ratiocinator::formatResults(bool includeTraces) const {
     }
     
     if (includeTraces) {
-        oss << "\n" << formatAllTraces();
+        oss << "\n";
+        writeAllTraces(oss);
     }
     
     return oss.str();
@@ -100,68 +846,43 @@ void Ratiocinator::printResults(bool includeTraces) const {
 }
 
 std::vector<std::string> Ratiocinator::getFilteredPropositionNames(const ResultFilter& filter) const {
-    std::vector<std::string> names;
-    
-    // Collect matching names
-    for (const auto& entry : propositions_) {
-        if (filter.matches(entry.first, entry.second)) {
-            names.push_back(entry.first);
-        }
-    }
-    
-    // Apply sorting
-    switch (filter.sortOrder) {
-        case ResultSortOrder::ALPHABETICAL:
-            std::sort(names.begin(), names.end());
-            break;
-        case ResultSortOrder::ALPHABETICAL_DESC:
-            std::sort(names.begin(), names.end(), std::greater<std::string>());
-            break;
-        case ResultSortOrder::BY_TRUTH_VALUE:
-            std::sort(names.begin(), names.end(), 
-                [this](const std::string& a, const std::string& b) {
-                    auto itA = propositions_.find(a);
-                    auto itB = propositions_.find(b);
-                    if (itA == propositions_.end() || itB == propositions_.end()) return false;
-                    int valA = static_cast<int>(itA->second.getTruthValue());
-                    int valB = static_cast<int>(itB->second.getTruthValue());
-                    if (valA != valB) return valA < valB;
-                    return a < b;  // Secondary sort by name
-                });
-            break;
-        case ResultSortOrder::BY_DERIVATION:
-            std::sort(names.begin(), names.end(),
-                [this](const std::string& a, const std::string& b) {
-                    auto itA = propositions_.find(a);
-                    auto itB = propositions_.find(b);
-                    if (itA == propositions_.end() || itB == propositions_.end()) return false;
-                    bool derivedA = itA->second.hasProvenance();
-                    bool derivedB = itB->second.hasProvenance();
-                    if (derivedA != derivedB) return derivedA > derivedB;  // Derived first
-                    return a < b;  // Secondary sort by name
-                });
-            break;
-        case ResultSortOrder::NONE:
-        default:
-            break;
-    }
-    
-    // Apply limit
-    if (filter.limit > 0 && names.size() > filter.limit) {
-        names.resize(filter.limit);
-    }
-    
-    return names;
+    return filteredNames(selectResults(resultIndex(), filter));
 }
 
 std::string Ratiocinator::formatResults(const ResultFilter& filter) const {
     std::ostringstream oss;
+    writeResults(oss, filter);
+    return oss.str();
+}
+
+void Ratiocinator::writeResults(std::ostream& out, const ResultFilter& filter) const {
+    // Get filtered and sorted entries
+    std::vector<const ResultEntry*> entries = selectResults(resultIndex(), filter);
     
-    // Get filtered and sorted names
-    std::vector<std::string> names = getFilteredPropositionNames(filter);
+    if (filter.format != ResultFormat::TEXT) {
+        bool ndjson = filter.format == ResultFormat::NDJSON;
+        if (!ndjson) {
+            out << "{\"total\":" << propositions_.size() << ",\"shown\":" << entries.size()
+                << ",\"results\":[";
+        }
+        TraceGraph& traces = traceGraph();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (!ndjson) {
+                out.write(i > 0 ? ",\n" : "\n", i > 0 ? 2 : 1);
+            }
+            writeJsonResult(out, *entries[i], filter, literalIndex_.symbols(), traces);
+            if (ndjson) {
+                out.put('\n');
+            }
+        }
+        if (!ndjson) {
+            out.write("\n]}\n", 4);
+        }
+        return;
+    }
     
     // Header with filter info
-    oss << "=== Proposition Truth Values ===\n";
+    out << "=== Proposition Truth Values ===\n";
     
     // Show filter summary if any filtering is active
     bool hasFilter = !filter.showTrue || !filter.showFalse || !filter.showUnknown ||
@@ -170,7 +891,7 @@ std::string Ratiocinator::formatResults(const ResultFilter& filter) const {
                      filter.limit > 0;
     
     if (hasFilter) {
-        oss << "(Filtered: ";
+        out << "(Filtered: ";
         std::vector<std::string> filterDesc;
         
         if (!filter.showTrue || !filter.showFalse || !filter.showUnknown) {
@@ -187,52 +908,45 @@ std::string Ratiocinator::formatResults(const ResultFilter& filter) const {
         if (filter.limit > 0) filterDesc.push_back("limit=" + std::to_string(filter.limit));
         
         for (size_t i = 0; i < filterDesc.size(); ++i) {
-            if (i > 0) oss << ", ";
-            oss << filterDesc[i];
+            if (i > 0) out << ", ";
+            out << filterDesc[i];
         }
-        oss << ")\n";
+        out << ")\n";
     }
     
-    oss << "Showing " << names.size() << " of " << propositions_.size() << " propositions\n\n";
+    out << "Showing " << entries.size() << " of " << propositions_.size() << " propositions\n\n";
     
     // Format each matching proposition
-    for (const auto& name : names) {
-        auto it = propositions_.find(name);
-        if (it == propositions_.end()) continue;
+    for (const ResultEntry* entry : entries) {
+        const Proposition& prop = entry->second;
+        std::string_view value = textValue(prop.getTruthValue());
         
-        const Proposition& prop = it->second;
-        
-        oss << name << ": ";
-        switch (prop.getTruthValue()) {
-            case Tripartite::TRUE:    oss << "True"; break;
-            case Tripartite::FALSE:   oss << "False"; break;
-            case Tripartite::UNKNOWN: oss << "Unknown"; break;
-        }
+        out.write(entry->first.data(), static_cast<std::streamsize>(entry->first.size()));
+        out.write(": ", 2);
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
         
         // Add provenance indicator if enabled
         if (filter.showProvenance && prop.hasProvenance()) {
-            oss << " [derived via " << prop.getProvenance()->ruleFired << "]";
+            out << " [derived via " << prop.getProvenance()->ruleFired << "]";
         }
-        oss << "\n";
+        out.put('\n');
     }
     
     // Add traces if requested
     if (filter.includeTraces) {
-        oss << "\n=== Inference Traces ===\n";
+        out << "\n=== Inference Traces ===\n";
         bool hasTraces = false;
-        for (const auto& name : names) {
-            auto it = propositions_.find(name);
-            if (it != propositions_.end() && it->second.hasProvenance()) {
-                oss << formatTrace(name) << "\n";
+        for (const ResultEntry* entry : entries) {
+            if (entry->second.hasProvenance()) {
+                writeTrace(out, entry->first);
+                out << "\n";
                 hasTraces = true;
             }
         }
         if (!hasTraces) {
-            oss << "No derived propositions in filtered results.\n";
+            out << "No derived propositions in filtered results.\n";
         }
     }
-    
-    return oss.str();
 }
 
 void Ratiocinator::printResults(const ResultFilter& filter) const {
@@ -242,7 +956,13 @@ void Ratiocinator::printResults(const ResultFilter& filter) const {
 // ========== Proposition Accessors ==========
 
 void Ratiocinator::setProposition(const std::string& name, const Proposition& prop) {
+    auto it = propositions_.find(name);
+    if (it != propositions_.end()) {
+        noteReplaced(name, it->second);
+    }
     propositions_[name] = prop;
+    literalIndex_.addRule(name, prop);
+    noteAdded(name, prop);
 }
 
 const Proposition* Ratiocinator::getProposition(const std::string& name) const {
@@ -252,7 +972,15 @@ const Proposition* Ratiocinator::getProposition(const std::string& name) const {
 
 Proposition* Ratiocinator::getProposition(const std::string& name) {
     auto it = propositions_.find(name);
-    return (it != propositions_.end()) ? &it->second : nullptr;
+    if (it == propositions_.end()) {
+        return nullptr;
+    }
+    // The caller may change the relation, its operands or its value
+    literalIndexStale_ = true;
+    tracesStale_ = true;
+    invalidateResultIndex();
+    fullDeductionNeeded_ = true;
+    return &it->second;
 }
 
 bool Ratiocinator::hasProposition(const std::string& name) const {
@@ -260,7 +988,9 @@ bool Ratiocinator::hasProposition(const std::string& name) const {
 }
 
 void Ratiocinator::setPropositionTruthValue(const std::string& name, Tripartite value) {
-    propositions_[name].setTruthValue(value);
+    Proposition& prop = propositions_[name];
+    noteValueChange(name, prop.getTruthValue(), value);
+    prop.setTruthValue(value);
 }
 
 Tripartite Ratiocinator::getPropositionTruthValue(const std::string& name) const {
@@ -280,6 +1010,8 @@ bool Ratiocinator::addProposition(const std::string& name, const Proposition& pr
         return false;
     }
     propositions_[name] = prop;
+    literalIndex_.addRule(name, prop);
+    noteAdded(name, prop);
     return true;
 }
 
@@ -288,7 +1020,12 @@ bool Ratiocinator::removeProposition(const std::string& name) {
     if (it == propositions_.end()) {
         return false;
     }
+    noteReplaced(name, it->second);
+    if (!resultIndexStale_) {
+        resultIndex_.remove(name);
+    }
     propositions_.erase(it);
+    literalIndex_.removeRule(name);
     return true;
 }
 
@@ -299,17 +1036,30 @@ bool Ratiocinator::updatePropositionTruthValue(const std::string& name,
     if (it == propositions_.end()) {
         return false;
     }
+    noteValueChange(name, it->second.getTruthValue(), value);
     it->second.setTruthValue(value, provenance);
     return true;
 }
 
 void Ratiocinator::clearPropositions() {
     propositions_.clear();
+    literalIndex_.clear();
+    publishedSymbols_.reset();
+    tracesStale_ = true;
+    invalidateResultIndex();
+    literalIndexStale_ = false;
+    fullDeductionNeeded_ = true;
 }
 
 void Ratiocinator::clearKnowledgeBase() {
     propositions_.clear();
     expressions_.clear();
+    literalIndex_.clear();
+    publishedSymbols_.reset();
+    tracesStale_ = true;
+    invalidateResultIndex();
+    literalIndexStale_ = false;
+    fullDeductionNeeded_ = true;
 }
 
 size_t Ratiocinator::getPropositionCount() const {
@@ -320,16 +1070,23 @@ size_t Ratiocinator::getExpressionCount() const {
     return expressions_.size();
 }
 
+const LiteralIndex& Ratiocinator::getLiteralIndex() const {
+    refreshLiteralIndex();
+    return literalIndex_;
+}
+
 // ========== Expression Accessors ==========
 
 void Ratiocinator::addExpression(const Expression& expr) {
     expressions_.push_back(expr);
+    pendingChanges_.push_back(expr.getPrefix());
 }
 
 Expression Ratiocinator::addExpressionFromString(const std::string& exprString,
                                                   const std::string& prefix) {
     Expression expr = parser_.parseExpressionString(exprString, propositions_, prefix);
     expressions_.push_back(expr);
+    pendingChanges_.push_back(expr.getPrefix());
     return expr;
 }
 
@@ -343,104 +1100,20 @@ void Ratiocinator::clearExpressions() {
 
 // ========== Inference Tracing API ==========
 
-void Ratiocinator::traceInferenceRecursive(const std::string& name,
-                                            std::vector<InferenceStep>& trace,
-                                            std::unordered_set<std::string>& visited,
-                                            int depth) const {
-    // Avoid infinite recursion on circular references
-    if (visited.count(name) > 0) {
-        return;
-    }
-    visited.insert(name);
-    
-    // Find the proposition
-    auto it = propositions_.find(name);
-    if (it == propositions_.end()) {
-        return;
-    }
-    
-    const Proposition& prop = it->second;
-    
-    // Create an inference step for this proposition
-    InferenceStep step;
-    step.proposition = name;
-    step.truthValue = prop.getTruthValue();
-    step.depth = depth;
-    
-    if (prop.hasProvenance()) {
-        const auto& prov = prop.getProvenance();
-        step.rule = prov->ruleFired;
-        step.premises = prov->premises;
-    } else {
-        // No provenance - this is an axiom or direct assertion
-        step.rule = "Axiom";
-        step.premises.clear();
-    }
-    
-    trace.push_back(step);
-    
-    // Recursively trace premises
-    if (prop.hasProvenance()) {
-        for (const auto& premise : prop.getProvenance()->premises) {
-            traceInferenceRecursive(premise, trace, visited, depth + 1);
-        }
-    }
-}
-
 std::vector<InferenceStep> Ratiocinator::traceInference(const std::string& name) const {
-    std::vector<InferenceStep> trace;
-    std::unordered_set<std::string> visited;
-    
-    traceInferenceRecursive(name, trace, visited, 0);
-    
-    return trace;
+    return traceGraph().trace(name);
 }
 
 std::string Ratiocinator::formatTrace(const std::string& name) const {
-    std::vector<InferenceStep> trace = traceInference(name);
-    
-    if (trace.empty()) {
-        return "No inference trace available for '" + name + "'\n";
-    }
-    
     std::ostringstream oss;
-    oss << "Inference trace for '" << name << "':\n";
-    oss << "========================================\n";
-    
-    for (const auto& step : trace) {
-        // Indent based on depth
-        std::string indent(step.depth * 2, ' ');
-        
-        // Format truth value
-        std::string truthStr;
-        switch (step.truthValue) {
-            case Tripartite::TRUE:    truthStr = "TRUE"; break;
-            case Tripartite::FALSE:   truthStr = "FALSE"; break;
-            case Tripartite::UNKNOWN: truthStr = "UNKNOWN"; break;
-        }
-        
-        oss << indent << step.proposition << " = " << truthStr;
-        
-        if (step.rule == "Axiom") {
-            oss << " [Axiom/Direct Assertion]\n";
-        } else {
-            oss << " [" << step.rule << "]\n";
-            
-            if (!step.premises.empty()) {
-                oss << indent << "  Premises: ";
-                for (size_t i = 0; i < step.premises.size(); ++i) {
-                    if (i > 0) oss << ", ";
-                    oss << step.premises[i];
-                }
-                oss << "\n";
-            }
-        }
-    }
-    
-    oss << "========================================\n";
+    writeTrace(oss, name);
     return oss.str();
 }
 
+void Ratiocinator::writeTrace(std::ostream& out, const std::string& name) const {
+    traceGraph().writeTrace(out, name);
+}
+
 bool Ratiocinator::hasInferenceProvenance(const std::string& name) const {
     auto it = propositions_.find(name);
     if (it == propositions_.end()) {
@@ -450,12 +1123,16 @@ bool Ratiocinator::hasInferenceProvenance(const std::string& name) const {
 }
 
 void Ratiocinator::printTrace(const std::string& name) const {
-    std::cout << formatTrace(name);
+    writeTrace(std::cout, name);
 }
 
 std::string Ratiocinator::formatAllTraces() const {
     std::ostringstream oss;
-    
+    writeAllTraces(oss);
+    return oss.str();
+}
+
+void Ratiocinator::writeAllTraces(std::ostream& out) const {
     // Collect propositions that have provenance (were derived)
     std::vector<std::string> derivedProps;
     for (const auto& entry : propositions_) {
@@ -464,22 +1141,20 @@ std::string Ratiocinator::formatAllTraces() const {
         }
     }
     
+    out << "=== Inference Traces ===\n";
     if (derivedProps.empty()) {
-        oss << "=== Inference Traces ===\n";
-        oss << "No derived propositions (all are axioms or unknown).\n";
-        return oss.str();
+        out << "No derived propositions (all are axioms or unknown).\n";
+        return;
     }
+    out << "(" << derivedProps.size() << " derived proposition(s))\n\n";
     
-    oss << "=== Inference Traces ===\n";
-    oss << "(" << derivedProps.size() << " derived proposition(s))\n\n";
-    
+    TraceGraph& graph = traceGraph();
     for (const auto& name : derivedProps) {
-        oss << formatTrace(name) << "\n";
+        graph.writeTrace(out, name);
+        out << "\n";
     }
-    
-    return oss.str();
 }
 
 void Ratiocinator::printAllTraces() const {
-    std::cout << formatAllTraces();
+    writeAllTraces(std::cout);
 }
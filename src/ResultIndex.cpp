@@ -0,0 +1,142 @@
+#include "ResultIndex.h"
+
+uint8_t ResultIndex::bucketOf(Tripartite value, bool derived) {
+    uint8_t group = value == Tripartite::TRUE ? 0 : value == Tripartite::FALSE ? 1 : 2;
+    return static_cast<uint8_t>(group * 2 + (derived ? 1 : 0));
+}
+
+uint8_t ResultIndex::bucketOf(const Proposition& prop) {
+    return bucketOf(prop.getTruthValue(), prop.hasProvenance());
+}
+
+const std::string& ResultIndex::nameOf(uint32_t id) const {
+    return slots_[id].entry->first;
+}
+
+void ResultIndex::rebuild(const std::unordered_map<std::string, Proposition>& propositions) {
+    clear();
+    slots_.reserve(propositions.size());
+    ids_.reserve(propositions.size());
+    byName_.reserve(propositions.size());
+    for (const auto& entry : propositions) {
+        update(entry);
+    }
+    sortNames();
+}
+
+void ResultIndex::clear() {
+    slots_.clear();
+    ids_.clear();
+    for (std::vector<uint32_t>& bucket : buckets_) {
+        bucket.clear();
+    }
+    byName_.clear();
+    sortedCount_ = 0;
+    freeSlots_.clear();
+}
+
+void ResultIndex::update(const Entry& entry) {
+    uint8_t bucket = bucketOf(entry.second);
+    auto known = ids_.find(entry.first);
+    if (known == ids_.end()) {
+        Slot added{&entry, bucket, static_cast<uint32_t>(buckets_[bucket].size())};
+        uint32_t id;
+        if (freeSlots_.empty()) {
+            id = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(added);
+        } else {
+            id = freeSlots_.back();
+            freeSlots_.pop_back();
+            slots_[id] = added;
+        }
+        buckets_[bucket].push_back(id);
+        ids_.emplace(entry.first, id);
+        byName_.push_back(id);
+        return;
+    }
+
+    Slot& slot = slots_[known->second];
+    slot.entry = &entry;
+    if (slot.bucket == bucket) {
+        return;
+    }
+    // Swap-remove from the old bucket, append to the new one
+    std::vector<uint32_t>& old = buckets_[slot.bucket];
+    uint32_t moved = old.back();
+    old[slot.position] = moved;
+    slots_[moved].position = slot.position;
+    old.pop_back();
+    slot.bucket = bucket;
+    slot.position = static_cast<uint32_t>(buckets_[bucket].size());
+    buckets_[bucket].push_back(known->second);
+}
+
+void ResultIndex::remove(const std::string& name) {
+    auto known = ids_.find(name);
+    if (known == ids_.end()) {
+        return;
+    }
+    uint32_t id = known->second;
+
+    Slot& slot = slots_[id];
+    std::vector<uint32_t>& bucket = buckets_[slot.bucket];
+    uint32_t moved = bucket.back();
+    bucket[slot.position] = moved;
+    slots_[moved].position = slot.position;
+    bucket.pop_back();
+
+    // Still named by the entry here, so it can be found in the name order
+    auto sortedEnd = byName_.begin() + static_cast<std::ptrdiff_t>(sortedCount_);
+    auto listed = std::lower_bound(byName_.begin(), sortedEnd, name,
+                                   [this](uint32_t other, const std::string& key) {
+                                       return nameOf(other) < key;
+                                   });
+    if (listed != sortedEnd && *listed == id) {
+        --sortedCount_;
+    } else {
+        listed = std::find(sortedEnd, byName_.end(), id);
+    }
+    byName_.erase(listed);
+
+    ids_.erase(known);
+    slot.entry = nullptr;
+    freeSlots_.push_back(id);
+}
+
+void ResultIndex::sortNames() const {
+    if (sortedCount_ == byName_.size()) {
+        return;
+    }
+    auto byName = [this](uint32_t a, uint32_t b) { return nameOf(a) < nameOf(b); };
+    auto added = byName_.begin() + static_cast<std::ptrdiff_t>(sortedCount_);
+    std::sort(added, byName_.end(), byName);
+    std::inplace_merge(byName_.begin(), added, byName_.end(), byName);
+    sortedCount_ = byName_.size();
+}
+
+std::pair<size_t, size_t> ResultIndex::prefixRange(std::string_view prefix) const {
+    sortNames();
+    if (prefix.empty()) {
+        return {0, byName_.size()};
+    }
+    auto first = std::partition_point(byName_.begin(), byName_.end(), [&](uint32_t id) {
+        return std::string_view(nameOf(id)) < prefix;
+    });
+    auto last = std::partition_point(first, byName_.end(), [&](uint32_t id) {
+        return std::string_view(nameOf(id)).substr(0, prefix.size()) == prefix;
+    });
+    return {static_cast<size_t>(first - byName_.begin()), static_cast<size_t>(last - byName_.begin())};
+}
+
+size_t ResultIndex::size() const {
+    return ids_.size();
+}
+
+size_t ResultIndex::countByName(std::string_view prefix) const {
+    auto [first, last] = prefixRange(prefix);
+    return last - first;
+}
+
+size_t ResultIndex::bucketSize(Tripartite value, bool derived) const {
+    return buckets_[bucketOf(value, derived)].size();
+}
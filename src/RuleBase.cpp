@@ -0,0 +1,218 @@
+#include "RuleBase.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+Tripartite valueIn(const std::unordered_map<std::string, Proposition>& propositions,
+                   const std::string& name) {
+    auto it = propositions.find(name);
+    return it == propositions.end() ? Tripartite::UNKNOWN : it->second.getTruthValue();
+}
+
+// Scenarios are small and already run in parallel, so each is parsed on one thread
+Parser::Options scenarioParsing() {
+    Parser::Options opts;
+    opts.threads = 1;
+    return opts;
+}
+
+void sortByName(std::vector<PropositionChange>& changes) {
+    std::sort(changes.begin(), changes.end(),
+              [](const PropositionChange& a, const PropositionChange& b) { return a.name < b.name; });
+}
+
+} // namespace
+
+RuleBase::RuleBase(const std::unordered_map<std::string, Proposition>& propositions,
+                   const std::vector<Expression>& expressions)
+    : RuleBase(propositions, expressions, Options()) {}
+
+RuleBase::RuleBase(const std::unordered_map<std::string, Proposition>& propositions,
+                   const std::vector<Expression>& expressions,
+                   const Options& opts)
+    : options_(opts), base_(propositions), deduced_(propositions), expressions_(expressions) {
+    index_.rebuild(base_);
+
+    // Deducing binds the expressions to the index's symbols (interning their
+    // subjects), so every scenario can copy them already bound
+    InferenceEngine engine(options_.inference);
+    engine.deduceAll(deduced_, expressions_, index_);
+
+    // Which derived values cite each premise, for retracting overturned facts
+    for (const auto& [name, prop] : deduced_) {
+        if (!prop.hasProvenance()) continue;
+        for (const std::string& premise : TraceGraph::premiseNames(*prop.getProvenance(), &index_.symbols())) {
+            std::vector<std::string>& names = dependents_[premise];
+            if (std::find(names.begin(), names.end(), name) == names.end()) {
+                names.push_back(name);
+            }
+        }
+    }
+
+    size_t threads = options_.threads == 0 ? WorkStealingPool::defaultThreadCount() : options_.threads;
+    if (threads > 1) {
+        pool_ = std::make_shared<WorkStealingPool>(threads);
+    }
+}
+
+const std::unordered_map<std::string, Proposition>& RuleBase::getPropositions() const {
+    return deduced_;
+}
+
+Tripartite RuleBase::getPropositionTruthValue(const std::string& name) const {
+    return valueIn(deduced_, name);
+}
+
+ScenarioResult RuleBase::evaluateCopy(std::string_view facts) const {
+    std::unordered_map<std::string, Proposition> propositions = base_;
+    std::vector<Expression> expressions = expressions_;
+    Parser parser(scenarioParsing());
+    parser.parseFacts(facts, propositions, expressions);
+
+    InferenceEngine engine(options_.inference);
+    engine.deduceAll(propositions, expressions);
+
+    ScenarioResult result;
+    result.fullDeduction = true;
+    for (const auto& [name, prop] : deduced_) {
+        Tripartite after = valueIn(propositions, name);
+        if (after != prop.getTruthValue()) {
+            result.changes.push_back({name, prop.getTruthValue(), after});
+        }
+    }
+    for (const auto& [name, prop] : propositions) {
+        if (!deduced_.count(name) && prop.getTruthValue() != Tripartite::UNKNOWN) {
+            result.changes.push_back({name, Tripartite::UNKNOWN, prop.getTruthValue()});
+        }
+    }
+    sortByName(result.changes);
+    return result;
+}
+
+ScenarioResult RuleBase::evaluate(std::string_view facts) const {
+    std::unordered_map<std::string, Proposition> assigned;
+    std::vector<Expression> scenarioExpressions;
+    Parser parser(scenarioParsing());
+    parser.parseFacts(facts, assigned, scenarioExpressions);
+    if (!scenarioExpressions.empty()) {
+        return evaluateCopy(facts);
+    }
+
+    // Facts that overturn a value the base decided withdraw what it derived;
+    // without provenance there is no telling what that was
+    std::vector<std::string> retractions;
+    for (const auto& [name, prop] : assigned) {
+        Tripartite decided = valueIn(deduced_, name);
+        if (decided != Tripartite::UNKNOWN && decided != prop.getTruthValue()) {
+            retractions.push_back(name);
+        }
+    }
+    bool untraceable = !retractions.empty() && options_.inference.provenance == ProvenanceLevel::NONE;
+    const std::unordered_map<std::string, Proposition>& start = untraceable ? base_ : deduced_;
+
+    // Layer the facts over the base; names no rule or expression mentions
+    // cannot derive anything and are reported as they are
+    const SymbolTable& symbols = index_.symbols();
+    InferenceEngine::Overlay overlay;
+    std::vector<PropId> changed;
+    ScenarioResult result;
+    result.fullDeduction = untraceable;
+    std::unordered_map<std::string, Tripartite> unbound;
+    for (const auto& [name, prop] : assigned) {
+        PropId id = 0;
+        if (!symbols.find(name, id)) {
+            unbound.emplace(name, prop.getTruthValue());
+            continue;
+        }
+        auto known = start.find(name);
+        Proposition copy = known == start.end() ? Proposition() : known->second;
+        copy.setTruthValue(prop.getTruthValue());
+        overlay.emplace(id, std::move(copy));
+        changed.push_back(id);
+    }
+
+    if (!untraceable) {
+        // Retract everything whose provenance cites an overturned value, as
+        // Ratiocinator::deduceIncremental does, and propagate from there
+        std::vector<std::string> frontier = retractions;
+        for (const std::string& name : retractions) {
+            PropId id = 0;
+            // Provenance names literals by their canonical spelling
+            if (symbols.find(name, id) && symbols.name(id) != name) {
+                frontier.push_back(symbols.name(id));
+            }
+        }
+        std::unordered_set<std::string> visited(frontier.begin(), frontier.end());
+        while (!frontier.empty()) {
+            std::string premise = std::move(frontier.back());
+            frontier.pop_back();
+            auto it = dependents_.find(premise);
+            if (it == dependents_.end()) {
+                continue;
+            }
+            for (const std::string& name : it->second) {
+                PropId id = 0;
+                if (assigned.count(name) || !visited.insert(name).second || !symbols.find(name, id)) {
+                    continue;
+                }
+                Proposition copy = deduced_.at(name);
+                copy.setTruthValue(Tripartite::UNKNOWN);
+                overlay.emplace(id, std::move(copy));
+                changed.push_back(id);
+                frontier.push_back(name);
+                ++result.retracted;
+            }
+        }
+    }
+
+    std::vector<Expression> expressions = expressions_;
+    InferenceEngine engine(options_.inference);
+    engine.deduceOverlay(start, expressions, index_, overlay, untraceable ? nullptr : &changed);
+
+    auto record = [&](const std::string& name, Tripartite after) {
+        Tripartite before = valueIn(deduced_, name);
+        if (before != after) {
+            result.changes.push_back({name, before, after});
+        }
+    };
+    for (const auto& [name, value] : unbound) {
+        record(name, value);
+    }
+    if (!untraceable) {
+        // Only the overlay differs from the fixed point
+        for (const auto& [id, prop] : overlay) {
+            record(symbols.name(id), prop.getTruthValue());
+        }
+    } else {
+        // Everything was re-derived from the undeduced base
+        for (const auto& [name, prop] : deduced_) {
+            PropId id = 0;
+            if (unbound.count(name)) continue;
+            auto copied = symbols.find(name, id) ? overlay.find(id) : overlay.end();
+            record(name, copied != overlay.end() ? copied->second.getTruthValue() : valueIn(base_, name));
+        }
+        for (const auto& [id, prop] : overlay) {
+            const std::string& name = symbols.name(id);
+            if (!deduced_.count(name)) {
+                record(name, prop.getTruthValue());
+            }
+        }
+    }
+    sortByName(result.changes);
+    return result;
+}
+
+std::vector<ScenarioResult> RuleBase::evaluateAll(const std::vector<std::string>& scenarios) const {
+    std::vector<ScenarioResult> results(scenarios.size());
+    if (!pool_ || scenarios.size() < 2) {
+        for (size_t i = 0; i < scenarios.size(); ++i) {
+            results[i] = evaluate(scenarios[i]);
+        }
+        return results;
+    }
+    pool_->run(scenarios.size(), [&](size_t i) { results[i] = evaluate(scenarios[i]); });
+    return results;
+}
@@ -0,0 +1,445 @@
+#include "Server.h"
+
+#include <charconv>
+#include <istream>
+#include <ostream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define LOGOSLAB_HAVE_UNIX_SOCKETS 1
+#endif
+
+namespace {
+
+std::string_view valueName(Tripartite value) {
+    switch (value) {
+        case Tripartite::TRUE:    return "True";
+        case Tripartite::FALSE:   return "False";
+        case Tripartite::UNKNOWN: return "Unknown";
+    }
+    return "Unknown";
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view trim(std::string_view text) {
+    size_t first = 0;
+    while (first < text.size() && isSpace(text[first])) {
+        ++first;
+    }
+    size_t last = text.size();
+    while (last > first && isSpace(text[last - 1])) {
+        --last;
+    }
+    return text.substr(first, last - first);
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+#ifdef LOGOSLAB_HAVE_UNIX_SOCKETS
+// Write all of data, retrying short writes; false once the peer is gone
+bool writeAll(int fd, std::string_view data) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;  // A closed peer is an error, not SIGPIPE
+#else
+    const int flags = 0;
+#endif
+    while (!data.empty()) {
+        ssize_t written = ::send(fd, data.data(), data.size(), flags);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
+}
+#endif
+
+}  // namespace
+
+Server::Server(Ratiocinator& engine, std::string snapshotDirectory)
+    : engine_(engine), snapshotDirectory_(std::move(snapshotDirectory)) {
+    // Batches end with the round trip, not at a line count
+    IngestOptions options = engine_.getIngestOptions();
+    options.batchSize = 0;
+    engine_.setIngestOptions(options);
+}
+
+bool Server::isShutdownRequested() const {
+    return shutdown_;
+}
+
+// ========== Serving ==========
+
+void Server::serve(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!handle(line, out)) {
+            break;
+        }
+        // Whatever is still buffered was sent in the same round trip
+        if (in.rdbuf()->in_avail() <= 0) {
+            settle();
+            out.flush();
+        }
+    }
+    settle();
+    out.flush();
+}
+
+#ifdef LOGOSLAB_HAVE_UNIX_SOCKETS
+
+bool Server::serveSocket(const std::string& path, std::string& error) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        error = "socket path must be 1 to " + std::to_string(sizeof(address.sun_path) - 1) + " bytes";
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listener, SOMAXCONN) < 0) {
+        error = path + ": " + std::strerror(errno);
+        ::close(listener);
+        return false;
+    }
+
+    bool ok = true;
+    while (!shutdown_) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = std::string("accept: ") + std::strerror(errno);
+            ok = false;
+            break;
+        }
+        serveConnection(client);
+        ::close(client);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+    return ok;
+}
+
+void Server::serveConnection(int fd) {
+    std::string pending;  // Bytes after the last complete line
+    std::ostringstream out;
+    char chunk[1 << 16];
+    bool open = true;
+    while (open) {
+        ssize_t received = ::read(fd, chunk, sizeof(chunk));
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        pending.append(chunk, static_cast<size_t>(received));
+
+        // Answer every complete line that arrived, then reply in one write
+        size_t start = 0;
+        size_t end;
+        while (open && (end = pending.find('\n', start)) != std::string::npos) {
+            open = handle(std::string_view(pending).substr(start, end - start), out);
+            start = end + 1;
+        }
+        pending.erase(0, start);
+        settle();
+        if (!writeAll(fd, out.str())) {
+            break;
+        }
+        out.str("");
+    }
+    settle();
+}
+
+#else
+
+bool Server::serveSocket(const std::string& path, std::string& error) {
+    (void)path;
+    error = "Unix domain sockets are not supported on this platform";
+    return false;
+}
+
+#endif
+
+// ========== Requests ==========
+
+bool Server::handle(std::string_view request, std::ostream& out) {
+    request = trim(request);
+    if (request.empty() || request[0] == '#') {
+        return true;
+    }
+    size_t space = request.find_first_of(" \t");
+    std::string_view command = request.substr(0, space);
+    std::string_view argument = space == std::string_view::npos ? std::string_view() : trim(request.substr(space));
+
+    body_.str("");
+    body_.clear();
+    if (command == "quit" || command == "shutdown") {
+        shutdown_ = shutdown_ || command == "shutdown";
+        respond(out, "");
+        return false;
+    }
+    respond(out, run(command, argument));
+    return true;
+}
+
+std::string Server::run(std::string_view command, std::string_view argument) {
+    if (command == "fact") {
+        if (argument.empty()) {
+            return "fact needs a facts line";
+        }
+        engine_.ingest(argument);
+        return "";
+    }
+
+    if (command == "assume") {
+        std::unordered_map<std::string, Proposition> parsed;
+        parser_.parseAssumptions(argument, parsed);
+        if (parsed.empty()) {
+            return "not an assumption: " + std::string(argument);
+        }
+        // Facts sent earlier come first, as if both were read in order
+        recordChanges(engine_.flush());
+        for (const auto& entry : parsed) {
+            engine_.setProposition(entry.first, entry.second);
+        }
+        edited_ = true;
+        return "";
+    }
+
+    if (command == "retract") {
+        recordChanges(engine_.flush());
+        if (!engine_.removeProposition(std::string(argument))) {
+            return "unknown proposition: " + std::string(argument);
+        }
+        edited_ = true;
+        return "";
+    }
+
+    if (command == "query") {
+        if (argument.empty()) {
+            return "query needs a proposition name";
+        }
+        settle();
+        QueryResult result = engine_.query(std::string(argument));
+        body_ << result.name << ": " << valueName(result.value);
+        if (result.provenance) {
+            body_ << " [derived via " << result.provenance->ruleFired << "]";
+        }
+        body_ << '\n';
+        return "";
+    }
+
+    if (command == "trace") {
+        if (argument.empty()) {
+            return "trace needs a proposition name";
+        }
+        settle();
+        engine_.writeTrace(body_, std::string(argument));
+        return "";
+    }
+
+    if (command == "results") {
+        ResultFilter filter;
+        std::string error;
+        while (!argument.empty()) {
+            size_t space = argument.find_first_of(" \t");
+            std::string_view option = argument.substr(0, space);
+            argument = space == std::string_view::npos ? std::string_view() : trim(argument.substr(space));
+            if (!parseFilterOption(option, filter, error)) {
+                return "unknown results option: " + std::string(option);
+            }
+            if (!error.empty()) {
+                return error;
+            }
+        }
+        settle();
+        engine_.writeResults(body_, filter);
+        return "";
+    }
+
+    if (command == "changes") {
+        settle();
+        for (const PropositionChange& change : changes_) {
+            if (change.before != change.after) {
+                body_ << change.name << ": " << valueName(change.before) << " -> " << valueName(change.after) << '\n';
+            }
+        }
+        changes_.clear();
+        changeIndex_.clear();
+        return "";
+    }
+
+    if (command == "save") {
+        std::string path;
+        std::string error = snapshotPath(argument, path);
+        if (!error.empty()) {
+            return error;
+        }
+        settle();
+        if (!engine_.saveSnapshot(path)) {
+            return "could not write " + std::string(argument);
+        }
+        return "";
+    }
+
+    if (command == "load") {
+        std::string path;
+        std::string error = snapshotPath(argument, path);
+        if (!error.empty()) {
+            return error;
+        }
+        settle();
+        if (!engine_.loadSnapshot(path)) {
+            return "not a snapshot: " + std::string(argument);
+        }
+        edited_ = true;
+        return "";
+    }
+
+    if (command == "stats") {
+        settle();
+        engine_.getStats().writeJson(body_);
+        body_ << '\n';
+        return "";
+    }
+
+    return "unknown request: " + std::string(command);
+}
+
+std::string Server::snapshotPath(std::string_view name, std::string& path) const {
+    if (name.empty()) {
+        return "needs a snapshot name";
+    }
+    if (name == "." || name == ".." || name.find_first_of("/\\") != std::string_view::npos) {
+        return "not a snapshot name: " + std::string(name);
+    }
+    path = snapshotDirectory_;
+    path += '/';
+    path += name;
+    return "";
+}
+
+void Server::respond(std::ostream& out, const std::string& error) {
+    if (!error.empty()) {
+        out << "error " << error << '\n';
+        return;
+    }
+    std::string body = body_.str();
+    if (!body.empty() && body.back() != '\n') {
+        body.push_back('\n');
+    }
+    size_t lines = 0;
+    for (char c : body) {
+        lines += c == '\n' ? 1 : 0;
+    }
+    out << "ok " << lines << '\n' << body;
+}
+
+void Server::settle() {
+    if (engine_.getPendingLineCount() > 0) {
+        // One incremental deduction covers the batch and any edits before it
+        recordChanges(engine_.flush());
+    } else if (edited_) {
+        engine_.deduceIncremental();
+    }
+    edited_ = false;
+}
+
+void Server::recordChanges(std::vector<PropositionChange> changes) {
+    for (PropositionChange& change : changes) {
+        auto it = changeIndex_.find(change.name);
+        if (it != changeIndex_.end()) {
+            changes_[it->second].after = change.after;
+            continue;
+        }
+        changeIndex_.emplace(change.name, changes_.size());
+        changes_.push_back(std::move(change));
+    }
+}
+
+// ========== Filter Options ==========
+
+bool Server::parseFilterOption(std::string_view option, ResultFilter& filter, std::string& error) {
+    error.clear();
+    if (option == "--traces") {
+        filter.includeTraces = true;
+    } else if (option == "--true-only") {
+        filter.withTruthValues(true, false, false);
+    } else if (option == "--false-only") {
+        filter.withTruthValues(false, true, false);
+    } else if (option == "--known-only") {
+        filter.withTruthValues(true, true, false);
+    } else if (option == "--unknown-only") {
+        filter.withTruthValues(false, false, true);
+    } else if (option == "--derived-only") {
+        filter.showDerived = true;
+        filter.showAxioms = false;
+    } else if (option == "--axioms-only") {
+        filter.showDerived = false;
+        filter.showAxioms = true;
+    } else if (startsWith(option, "--prefix=")) {
+        filter.prefixPattern = std::string(option.substr(9));
+    } else if (startsWith(option, "--contains=")) {
+        filter.containsPattern = std::string(option.substr(11));
+    } else if (startsWith(option, "--limit=")) {
+        std::string_view digits = option.substr(8);
+        size_t limit = 0;
+        auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), limit);
+        if (digits.empty() || ec != std::errc() || end != digits.data() + digits.size()) {
+            error = "Invalid limit: " + std::string(digits);
+        } else {
+            filter.limit = limit;
+        }
+    } else if (startsWith(option, "--sort=")) {
+        std::string_view sortOrder = option.substr(7);
+        if (sortOrder == "alpha") {
+            filter.sortOrder = ResultSortOrder::ALPHABETICAL;
+        } else if (sortOrder == "alpha-desc") {
+            filter.sortOrder = ResultSortOrder::ALPHABETICAL_DESC;
+        } else if (sortOrder == "truth") {
+            filter.sortOrder = ResultSortOrder::BY_TRUTH_VALUE;
+        } else if (sortOrder == "derivation") {
+            filter.sortOrder = ResultSortOrder::BY_DERIVATION;
+        } else {
+            error = "Unknown sort order: " + std::string(sortOrder);
+        }
+    } else if (startsWith(option, "--format=")) {
+        std::string_view format = option.substr(9);
+        if (format == "text") {
+            filter.format = ResultFormat::TEXT;
+        } else if (format == "json") {
+            filter.format = ResultFormat::JSON;
+        } else if (format == "ndjson") {
+            filter.format = ResultFormat::NDJSON;
+        } else {
+            error = "Unknown format: " + std::string(format);
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
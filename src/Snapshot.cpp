@@ -0,0 +1,603 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+// ========== File Layout ==========
+
+constexpr char kMagic[8] = {'L', 'O', 'G', 'O', 'S', 'K', 'B', '\0'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr uint32_t kNone = UINT32_MAX;     ///< No provenance record, or a literal never spelled
+constexpr size_t kSectionAlignment = 8;
+
+enum : uint32_t {
+    kFlagDeduced = 1u << 0,
+    kFlagProvenance = 1u << 1
+};
+
+struct Section {
+    uint64_t offset;  ///< Bytes from the start of the file
+    uint64_t count;   ///< Number of records
+};
+
+// String references are indices into the string table; string 0 is ""
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t flags;
+    uint32_t reserved;
+    Section stringEnds;    ///< uint64_t: end of each string in stringBytes
+    Section stringBytes;   ///< char
+    Section symbols;       ///< uint32_t: canonical spelling of each literal, by id (or kNone)
+    Section spellings;     ///< SpellingRecord: every spelling interned
+    Section propositions;  ///< PropositionRecord
+    Section provenance;    ///< ProvenanceRecord
+    Section premises;      ///< uint32_t: premise names of the provenance records
+    Section expressions;   ///< ExpressionRecord
+    Section tokens;        ///< TokenRecord
+    Section operands;      ///< uint32_t: literals of the n-ary clauses
+};
+
+struct SpellingRecord {
+    uint32_t spelling;
+    uint32_t id;
+};
+
+struct PropositionRecord {
+    uint32_t key;
+    uint32_t prefix;
+    uint32_t antecedent;
+    uint32_t subject;
+    uint32_t consequent;
+    uint32_t predicate;
+    uint32_t provenance;  ///< Index into the provenance section, or kNone
+    uint32_t firstOperand;  ///< Clause literals in the operands section
+    uint32_t operandCount;
+    int8_t truthValue;
+    uint8_t relation;
+    uint8_t scope;
+    int8_t antecedentAssertion;
+    int8_t consequentAssertion;
+    uint8_t reserved[3];
+};
+
+struct ProvenanceRecord {
+    uint32_t ruleName;
+    uint32_t firstPremise;
+    uint32_t premiseCount;
+    uint32_t premiseIds[3];
+    float confidence;
+    uint8_t rule;
+    uint8_t premiseIdCount;
+    uint8_t reserved[2];
+};
+
+struct ExpressionRecord {
+    uint32_t prefix;
+    uint32_t firstToken;
+    uint32_t tokenCount;
+    uint32_t operandCount;  ///< Legacy API: the first operandCount tokens are the operands
+    uint8_t tokenStream;    ///< Built with the token API
+    uint8_t reserved[3];
+};
+
+struct TokenRecord {
+    uint32_t name;
+    uint8_t isOperand;
+    int8_t value;
+    uint8_t op;
+    uint8_t reserved;
+};
+
+static_assert(InferenceProvenance::kMaxPremiseIds == 3, "ProvenanceRecord holds 3 premise ids");
+static_assert(std::is_trivially_copyable<Header>::value &&
+              std::is_trivially_copyable<PropositionRecord>::value &&
+              std::is_trivially_copyable<ProvenanceRecord>::value &&
+              std::is_trivially_copyable<ExpressionRecord>::value &&
+              std::is_trivially_copyable<TokenRecord>::value,
+              "snapshot records are copied as raw bytes");
+static_assert(sizeof(PropositionRecord) == 44 && sizeof(ProvenanceRecord) == 32 &&
+              sizeof(ExpressionRecord) == 20 && sizeof(TokenRecord) == 8,
+              "snapshot records must not change size within a version");
+
+class SnapshotError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// ========== Writing ==========
+
+/// Deduplicating string table; views must outlive it
+class StringPool {
+private:
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    std::vector<std::string_view> strings_;
+
+public:
+    StringPool() { add(""); }
+
+    uint32_t add(std::string_view text) {
+        auto result = ids_.emplace(text, static_cast<uint32_t>(strings_.size()));
+        if (result.second) {
+            strings_.push_back(text);
+        }
+        return result.first->second;
+    }
+
+    const std::vector<std::string_view>& strings() const { return strings_; }
+};
+
+class SectionWriter {
+private:
+    std::ofstream& out_;
+    uint64_t offset_;
+
+public:
+    SectionWriter(std::ofstream& out, uint64_t offset) : out_(out), offset_(offset) {}
+
+    template <typename T>
+    void write(Section& section, const T* records, size_t count) {
+        static const char padding[kSectionAlignment] = {};
+        uint64_t aligned = (offset_ + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+        out_.write(padding, static_cast<std::streamsize>(aligned - offset_));
+        section.offset = aligned;
+        section.count = count;
+        out_.write(reinterpret_cast<const char*>(records), static_cast<std::streamsize>(count * sizeof(T)));
+        offset_ = aligned + count * sizeof(T);
+    }
+
+    template <typename T>
+    void write(Section& section, const std::vector<T>& records) {
+        write(section, records.data(), records.size());
+    }
+};
+
+// ========== Reading ==========
+
+/// Bounds-checked access to the sections of a mapped snapshot
+class SnapshotImage {
+private:
+    std::string_view bytes_;
+    Header header_;
+    std::vector<std::string_view> strings_;
+
+public:
+    explicit SnapshotImage(std::string_view bytes) : bytes_(bytes) {
+        if (bytes_.size() < sizeof(Header)) {
+            throw SnapshotError("file is too short to be a snapshot");
+        }
+        std::memcpy(&header_, bytes_.data(), sizeof(Header));
+        if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0) {
+            throw SnapshotError("not a snapshot file");
+        }
+        if (header_.byteOrder != kByteOrderMark) {
+            throw SnapshotError("written on a host with a different byte order");
+        }
+        if (header_.version != Snapshot::kVersion) {
+            throw SnapshotError("unsupported version " + std::to_string(header_.version));
+        }
+
+        // Resolve every string once; records then refer to them by index
+        std::vector<uint64_t> ends = records<uint64_t>(header_.stringEnds);
+        const char* chars = base<char>(header_.stringBytes);
+        strings_.reserve(ends.size());
+        uint64_t begin = 0;
+        for (uint64_t end : ends) {
+            if (end < begin || end > header_.stringBytes.count) {
+                throw SnapshotError("corrupt string table");
+            }
+            strings_.emplace_back(chars + begin, static_cast<size_t>(end - begin));
+            begin = end;
+        }
+        if (strings_.empty()) {
+            throw SnapshotError("corrupt string table");
+        }
+    }
+
+    const Header& header() const { return header_; }
+
+    /// Start of a section of T, after checking it lies inside the file
+    template <typename T>
+    const char* base(const Section& section) const {
+        if (section.offset > bytes_.size() ||
+            section.count > (bytes_.size() - section.offset) / sizeof(T)) {
+            throw SnapshotError("section extends past the end of the file");
+        }
+        return bytes_.data() + section.offset;
+    }
+
+    /// Record i of a section (the section must have been checked with base)
+    template <typename T>
+    static T at(const char* base, size_t i) {
+        T record;
+        std::memcpy(&record, base + i * sizeof(T), sizeof(T));
+        return record;
+    }
+
+    template <typename T>
+    std::vector<T> records(const Section& section) const {
+        const char* start = base<T>(section);
+        std::vector<T> result(static_cast<size_t>(section.count));
+        if (!result.empty()) {
+            std::memcpy(result.data(), start, result.size() * sizeof(T));
+        }
+        return result;
+    }
+
+    std::string_view string(uint32_t id) const {
+        if (id >= strings_.size()) {
+            throw SnapshotError("string reference out of range");
+        }
+        return strings_[id];
+    }
+};
+
+Tripartite tripartiteAt(int8_t raw) {
+    if (raw != static_cast<int8_t>(Tripartite::TRUE) && raw != static_cast<int8_t>(Tripartite::FALSE) &&
+        raw != static_cast<int8_t>(Tripartite::UNKNOWN)) {
+        throw SnapshotError("invalid truth value");
+    }
+    return static_cast<Tripartite>(raw);
+}
+
+LogicalOperator operatorAt(uint8_t raw) {
+    if (raw > static_cast<uint8_t>(LogicalOperator::RPAREN)) {
+        throw SnapshotError("invalid logical operator");
+    }
+    return static_cast<LogicalOperator>(raw);
+}
+
+void readSymbols(const SnapshotImage& image, SymbolTable& symbols) {
+    const Header& header = image.header();
+    std::vector<uint32_t> canonical = image.records<uint32_t>(header.symbols);
+    std::vector<SpellingRecord> spellings = image.records<SpellingRecord>(header.spellings);
+    if (canonical.size() % 2 != 0) {
+        throw SnapshotError("corrupt symbol table");
+    }
+
+    // Interning each symbol and then its negative canonical spelling (the first
+    // negated spelling interned) reproduces the ids; other spellings follow
+    symbols.reserve(canonical.size() / 2, spellings.size());
+    std::string name;
+    for (size_t id = 0; id < canonical.size(); id += 2) {
+        name.assign(image.string(canonical[id]));
+        symbols.intern(name);
+        if (canonical[id + 1] != kNone) {
+            name.assign(image.string(canonical[id + 1]));
+            symbols.intern(name);
+        }
+    }
+    for (const SpellingRecord& spelling : spellings) {
+        if (spelling.id >= canonical.size()) {
+            throw SnapshotError("corrupt symbol table");
+        }
+        if (spelling.spelling == canonical[spelling.id]) {
+            continue;
+        }
+        name.assign(image.string(spelling.spelling));
+        if (symbols.intern(name) != spelling.id) {
+            throw SnapshotError("corrupt symbol table");
+        }
+    }
+    if (symbols.idCount() != canonical.size()) {
+        throw SnapshotError("corrupt symbol table");
+    }
+}
+
+InferenceProvenance readProvenance(const SnapshotImage& image, const ProvenanceRecord& record,
+                                   const char* premises, uint64_t premiseCount) {
+    if (record.rule > static_cast<uint8_t>(InferenceRule::SIMPLIFICATION) ||
+        record.premiseIdCount > InferenceProvenance::kMaxPremiseIds ||
+        record.firstPremise > premiseCount || record.premiseCount > premiseCount - record.firstPremise) {
+        throw SnapshotError("corrupt provenance record");
+    }
+
+    // The rule-only constructor reads no clock; load time is not inference time
+    InferenceProvenance provenance(static_cast<InferenceRule>(record.rule));
+    if (provenance.rule == InferenceRule::CUSTOM) {
+        provenance.ruleFired = internRuleName(std::string(image.string(record.ruleName)));
+    }
+    provenance.premises.reserve(record.premiseCount);
+    for (uint32_t i = 0; i < record.premiseCount; ++i) {
+        uint32_t premise = SnapshotImage::at<uint32_t>(premises, record.firstPremise + i);
+        provenance.premises.emplace_back(image.string(premise));
+    }
+    for (uint8_t i = 0; i < record.premiseIdCount; ++i) {
+        provenance.addPremiseId(record.premiseIds[i]);
+    }
+    provenance.confidence = record.confidence;
+    return provenance;
+}
+
+void readPropositions(const SnapshotImage& image,
+                      std::unordered_map<std::string, Proposition>& propositions) {
+    const Header& header = image.header();
+    const char* records = image.base<PropositionRecord>(header.propositions);
+    const char* provenance = image.base<ProvenanceRecord>(header.provenance);
+    const char* premises = image.base<uint32_t>(header.premises);
+    const char* operands = image.base<uint32_t>(header.operands);
+
+    propositions.reserve(static_cast<size_t>(header.propositions.count));
+    for (size_t i = 0; i < header.propositions.count; ++i) {
+        PropositionRecord record = SnapshotImage::at<PropositionRecord>(records, i);
+        if (record.scope > static_cast<uint8_t>(Quantifier::NONE)) {
+            throw SnapshotError("invalid quantifier");
+        }
+
+        Proposition prop(std::string(image.string(record.prefix)), Tripartite::UNKNOWN);
+        prop.setRelation(operatorAt(record.relation));
+        prop.setPropositionScope(static_cast<Quantifier>(record.scope));
+        prop.setAntecedentAssertion(tripartiteAt(record.antecedentAssertion));
+        prop.setConsequentAssertion(tripartiteAt(record.consequentAssertion));
+        // Terms are allocated only when set, so leave empty ones alone
+        std::string_view term = image.string(record.antecedent);
+        if (!term.empty()) prop.setAntecedent(std::string(term));
+        term = image.string(record.subject);
+        if (!term.empty()) prop.setSubject(std::string(term));
+        term = image.string(record.consequent);
+        if (!term.empty()) prop.setConsequent(std::string(term));
+        term = image.string(record.predicate);
+        if (!term.empty()) prop.setPredicate(std::string(term));
+        if (record.firstOperand > header.operands.count ||
+            record.operandCount > header.operands.count - record.firstOperand) {
+            throw SnapshotError("operand reference out of range");
+        }
+        if (record.operandCount > 0) {
+            std::vector<std::string> literals;
+            literals.reserve(record.operandCount);
+            for (uint32_t k = 0; k < record.operandCount; ++k) {
+                literals.emplace_back(image.string(SnapshotImage::at<uint32_t>(operands, record.firstOperand + k)));
+            }
+            prop.setOperands(std::move(literals));
+        }
+
+        Tripartite value = tripartiteAt(record.truthValue);
+        if (record.provenance == kNone) {
+            prop.setTruthValue(value);
+        } else {
+            if (record.provenance >= header.provenance.count) {
+                throw SnapshotError("provenance reference out of range");
+            }
+            ProvenanceRecord source = SnapshotImage::at<ProvenanceRecord>(provenance, record.provenance);
+            prop.setTruthValue(value, readProvenance(image, source, premises, header.premises.count));
+        }
+
+        if (!propositions.emplace(std::string(image.string(record.key)), std::move(prop)).second) {
+            throw SnapshotError("duplicate proposition key");
+        }
+    }
+}
+
+void readExpressions(const SnapshotImage& image, std::vector<Expression>& expressions) {
+    const Header& header = image.header();
+    const char* records = image.base<ExpressionRecord>(header.expressions);
+    const char* tokens = image.base<TokenRecord>(header.tokens);
+
+    expressions.reserve(static_cast<size_t>(header.expressions.count));
+    for (size_t i = 0; i < header.expressions.count; ++i) {
+        ExpressionRecord record = SnapshotImage::at<ExpressionRecord>(records, i);
+        if (record.firstToken > header.tokens.count ||
+            record.tokenCount > header.tokens.count - record.firstToken ||
+            record.operandCount > record.tokenCount) {
+            throw SnapshotError("corrupt expression record");
+        }
+
+        Expression expr;
+        expr.setPrefix(std::string(image.string(record.prefix)));
+        for (uint32_t t = 0; t < record.tokenCount; ++t) {
+            TokenRecord token = SnapshotImage::at<TokenRecord>(tokens, record.firstToken + t);
+            std::string name(image.string(token.name));
+            Tripartite value = tripartiteAt(token.value);
+            LogicalOperator op = operatorAt(token.op);
+            if (record.tokenStream) {
+                if (token.isOperand) {
+                    expr.addToken(name, value);
+                } else {
+                    expr.addToken(op);
+                }
+            } else if (t < record.operandCount) {
+                expr.addOperand(Proposition(name, value));
+            } else {
+                expr.addOperator(op);
+            }
+        }
+        expressions.push_back(std::move(expr));
+    }
+}
+
+TokenRecord tokenRecord(StringPool& pool, const Token& token) {
+    TokenRecord record{};
+    record.name = pool.add(token.name);
+    record.isOperand = token.isOperand ? 1 : 0;
+    record.value = static_cast<int8_t>(token.value);
+    record.op = static_cast<uint8_t>(token.op);
+    return record;
+}
+
+}  // namespace
+
+// ========== Snapshot ==========
+
+bool Snapshot::write(const std::string& path,
+                     const std::unordered_map<std::string, Proposition>& propositions,
+                     const std::vector<Expression>& expressions,
+                     const SymbolTable& symbols,
+                     bool deduced,
+                     bool includeProvenance) {
+    StringPool pool;
+
+    // A negative literal nobody spelled gets its default name back when its symbol is interned
+    std::vector<uint32_t> canonical(symbols.idCount(), kNone);
+    std::vector<SpellingRecord> spellings;
+    spellings.reserve(symbols.spellings().size());
+    for (const auto& entry : symbols.spellings()) {
+        uint32_t spelling = pool.add(entry.first);
+        if (entry.first == symbols.name(entry.second)) {
+            canonical[entry.second] = spelling;
+        }
+        spellings.push_back({spelling, entry.second});
+    }
+    // Spelling order does not affect the ids; sort so equal bases give equal files
+    std::sort(spellings.begin(), spellings.end(), [](const SpellingRecord& a, const SpellingRecord& b) {
+        return a.id != b.id ? a.id < b.id : a.spelling < b.spelling;
+    });
+
+    std::vector<PropositionRecord> propositionRecords;
+    std::vector<ProvenanceRecord> provenanceRecords;
+    std::vector<uint32_t> premises;
+    std::vector<uint32_t> operands;
+    propositionRecords.reserve(propositions.size());
+    for (const auto& entry : propositions) {
+        const Proposition& prop = entry.second;
+        PropositionRecord record{};
+        record.key = pool.add(entry.first);
+        record.prefix = pool.add(prop.getPrefix());
+        record.antecedent = pool.add(prop.getAntecedent());
+        record.subject = pool.add(prop.getSubject());
+        record.consequent = pool.add(prop.getConsequent());
+        record.predicate = pool.add(prop.getPredicate());
+        record.provenance = kNone;
+        record.firstOperand = static_cast<uint32_t>(operands.size());
+        record.operandCount = static_cast<uint32_t>(prop.getOperands().size());
+        for (const std::string& literal : prop.getOperands()) {
+            operands.push_back(pool.add(literal));
+        }
+        record.truthValue = static_cast<int8_t>(prop.getTruthValue());
+        record.relation = static_cast<uint8_t>(prop.getRelation());
+        record.scope = static_cast<uint8_t>(prop.getPropositionScope());
+        record.antecedentAssertion = static_cast<int8_t>(prop.getAntecedentAssertion());
+        record.consequentAssertion = static_cast<int8_t>(prop.getConsequentAssertion());
+
+        if (includeProvenance && prop.hasProvenance()) {
+            const InferenceProvenance& provenance = *prop.getProvenance();
+            ProvenanceRecord source{};
+            source.ruleName = pool.add(provenance.ruleFired);
+            source.firstPremise = static_cast<uint32_t>(premises.size());
+            source.premiseCount = static_cast<uint32_t>(provenance.premises.size());
+            for (const std::string& premise : provenance.premises) {
+                premises.push_back(pool.add(premise));
+            }
+            std::copy(provenance.premiseIds.begin(), provenance.premiseIds.end(), source.premiseIds);
+            source.premiseIdCount = provenance.premiseIdCount;
+            source.confidence = provenance.confidence;
+            source.rule = static_cast<uint8_t>(provenance.rule);
+            record.provenance = static_cast<uint32_t>(provenanceRecords.size());
+            provenanceRecords.push_back(source);
+        }
+        propositionRecords.push_back(record);
+    }
+
+    std::vector<ExpressionRecord> expressionRecords;
+    std::vector<TokenRecord> tokens;
+    expressionRecords.reserve(expressions.size());
+    for (const Expression& expr : expressions) {
+        ExpressionRecord record{};
+        record.prefix = pool.add(expr.getPrefix());
+        record.firstToken = static_cast<uint32_t>(tokens.size());
+        record.tokenStream = expr.usesTokenStream() ? 1 : 0;
+        if (expr.usesTokenStream()) {
+            for (const Token& token : expr.getTokens()) {
+                tokens.push_back(tokenRecord(pool, token));
+            }
+        } else {
+            for (const Token& token : expr.getOperands()) {
+                tokens.push_back(tokenRecord(pool, token));
+            }
+            record.operandCount = static_cast<uint32_t>(expr.getOperands().size());
+            for (LogicalOperator op : expr.getOperators()) {
+                tokens.push_back(tokenRecord(pool, Token(op)));
+            }
+        }
+        record.tokenCount = static_cast<uint32_t>(tokens.size()) - record.firstToken;
+        expressionRecords.push_back(record);
+    }
+
+    std::vector<uint64_t> stringEnds;
+    std::string stringBytes;
+    stringEnds.reserve(pool.strings().size());
+    for (std::string_view text : pool.strings()) {
+        stringBytes.append(text.data(), text.size());
+        stringEnds.push_back(stringBytes.size());
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.flags = (deduced ? kFlagDeduced : 0u) | (includeProvenance ? kFlagProvenance : 0u);
+
+    // Write beside the target and rename, so a failed save keeps the old file
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open file " << temporary << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        SectionWriter sections(out, sizeof(Header));
+        sections.write(header.stringEnds, stringEnds);
+        sections.write(header.stringBytes, stringBytes.data(), stringBytes.size());
+        sections.write(header.symbols, canonical);
+        sections.write(header.spellings, spellings);
+        sections.write(header.propositions, propositionRecords);
+        sections.write(header.provenance, provenanceRecords);
+        sections.write(header.premises, premises);
+        sections.write(header.expressions, expressionRecords);
+        sections.write(header.tokens, tokens);
+        sections.write(header.operands, operands);
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.flush();
+        if (!out) {
+            std::cerr << "Error: Could not write snapshot " << temporary << std::endl;
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        // Some platforms do not rename over an existing file
+        std::remove(path.c_str());
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::cerr << "Error: Could not replace snapshot " << path << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Snapshot::read(const std::string& path,
+                    std::unordered_map<std::string, Proposition>& propositions,
+                    std::vector<Expression>& expressions,
+                    SymbolTable& symbols,
+                    bool& deduced) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+
+    try {
+        SnapshotImage image(file.contents());
+        readSymbols(image, symbols);
+        readPropositions(image, propositions);
+        readExpressions(image, expressions);
+        deduced = (image.header().flags & kFlagDeduced) != 0;
+    } catch (const SnapshotError& e) {
+        std::cerr << "Error reading snapshot " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
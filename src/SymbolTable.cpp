@@ -0,0 +1,79 @@
+#include "SymbolTable.h"
+
+bool SymbolTable::isNegatedName(const std::string& name) {
+    return !name.empty() && (name[0] == '~' || name[0] == '!');
+}
+
+PropId SymbolTable::intern(const std::string& name) {
+    auto it = idBySpelling_.find(name);
+    if (it != idBySpelling_.end()) {
+        return it->second;
+    }
+
+    bool negated = isNegatedName(name);
+    std::string base = negated ? name.substr(1) : name;
+
+    PropId positive;
+    auto baseIt = idBySpelling_.find(base);
+    if (baseIt != idBySpelling_.end()) {
+        positive = baseIt->second;
+    } else {
+        positive = static_cast<PropId>(names_.size());
+        names_.push_back(base);
+        names_.push_back("~" + base);
+        idBySpelling_.emplace(base, positive);
+    }
+
+    PropId id = negated ? negateId(positive) : positive;
+    if (negated) {
+        // A knowledge base that only ever writes "!P" keeps that spelling
+        if (idBySpelling_.find(names_[id]) == idBySpelling_.end()) {
+            names_[id] = name;
+        }
+        idBySpelling_.emplace(name, id);
+    }
+    return id;
+}
+
+bool SymbolTable::find(const std::string& name, PropId& id) const {
+    auto it = idBySpelling_.find(name);
+    if (it != idBySpelling_.end()) {
+        id = it->second;
+        return true;
+    }
+    // A negation spelling not seen yet still names the known symbol's negative literal
+    if (isNegatedName(name)) {
+        auto baseIt = idBySpelling_.find(name.substr(1));
+        if (baseIt != idBySpelling_.end()) {
+            id = negateId(baseIt->second);
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string& SymbolTable::name(PropId id) const {
+    return names_[id];
+}
+
+const std::unordered_map<std::string, PropId>& SymbolTable::spellings() const {
+    return idBySpelling_;
+}
+
+size_t SymbolTable::idCount() const {
+    return names_.size();
+}
+
+size_t SymbolTable::symbolCount() const {
+    return names_.size() / 2;
+}
+
+void SymbolTable::reserve(size_t symbols, size_t spellings) {
+    idBySpelling_.reserve(spellings);
+    names_.reserve(symbols * 2);
+}
+
+void SymbolTable::clear() {
+    idBySpelling_.clear();
+    names_.clear();
+}
@@ -0,0 +1,167 @@
+#include "TraceGraph.h"
+
+#include <algorithm>
+#include <utility>
+
+TraceGraph::TraceGraph(const std::unordered_map<std::string, Proposition>& propositions,
+                       const SymbolTable* symbols) {
+    reset(propositions, symbols);
+}
+
+void TraceGraph::reset(const std::unordered_map<std::string, Proposition>& propositions,
+                       const SymbolTable* symbols) {
+    propositions_ = &propositions;
+    symbols_ = symbols;
+    nodes_.clear();
+    ids_.clear();
+    visited_.clear();
+    stamp_ = 0;
+}
+
+size_t TraceGraph::nodeCount() const {
+    return nodes_.size();
+}
+
+std::vector<std::string> TraceGraph::premiseNames(const InferenceProvenance& provenance,
+                                                  const SymbolTable* symbols) {
+    if (!provenance.premises.empty() || provenance.premiseIdCount == 0 || !symbols) {
+        return provenance.premises;
+    }
+    std::vector<std::string> names;
+    for (size_t i = 0; i < provenance.premiseIdCount; ++i) {
+        PropId id = provenance.premiseIds[i];
+        if (id < symbols->idCount()) {
+            names.push_back(symbols->name(id));
+        }
+    }
+    return names;
+}
+
+std::string_view TraceGraph::ruleOf(const Node& node) {
+    // No provenance - this is an axiom or direct assertion
+    return node.prop->hasProvenance() ? node.prop->getProvenance()->ruleFired : kAxiom;
+}
+
+uint32_t TraceGraph::nodeFor(const std::string& name) {
+    auto known = ids_.find(name);
+    if (known != ids_.end()) {
+        return known->second;
+    }
+    if (!propositions_) {
+        return kMissing;
+    }
+    auto it = propositions_->find(name);
+    if (it == propositions_->end()) {
+        return kMissing;
+    }
+
+    uint32_t id = static_cast<uint32_t>(nodes_.size());
+    ids_.emplace(it->first, id);
+    Node node{&it->first, &it->second, {}, {}, false};
+    if (it->second.hasProvenance()) {
+        node.premises = premiseNames(*it->second.getProvenance(), symbols_);
+    }
+    nodes_.push_back(std::move(node));
+    visited_.push_back(0);
+    return id;
+}
+
+const std::vector<uint32_t>& TraceGraph::children(uint32_t id) {
+    if (!nodes_[id].resolved) {
+        // nodeFor may grow nodes_, so index it afresh each time
+        std::vector<uint32_t> resolved;
+        resolved.reserve(nodes_[id].premises.size());
+        for (size_t i = 0; i < nodes_[id].premises.size(); ++i) {
+            resolved.push_back(nodeFor(nodes_[id].premises[i]));
+        }
+        nodes_[id].children = std::move(resolved);
+        nodes_[id].resolved = true;
+    }
+    return nodes_[id].children;
+}
+
+template <typename Visit>
+void TraceGraph::walk(const std::string& name, Visit visit) {
+    uint32_t root = nodeFor(name);
+    if (root == kMissing) {
+        return;
+    }
+    if (++stamp_ == 0) {
+        // Stamps wrapped: clear them so no stale mark matches
+        std::fill(visited_.begin(), visited_.end(), 0);
+        stamp_ = 1;
+    }
+
+    // Explicit stack (children pushed in reverse) visits in recursive preorder
+    std::vector<std::pair<uint32_t, int>> stack{{root, 0}};
+    while (!stack.empty()) {
+        auto [id, depth] = stack.back();
+        stack.pop_back();
+        if (visited_[id] == stamp_) {
+            continue;
+        }
+        visited_[id] = stamp_;
+        const std::vector<uint32_t>& premises = children(id);
+        visit(nodes_[id], depth);
+        for (auto child = premises.rbegin(); child != premises.rend(); ++child) {
+            if (*child != kMissing && visited_[*child] != stamp_) {
+                stack.emplace_back(*child, depth + 1);
+            }
+        }
+    }
+}
+
+std::vector<InferenceStep> TraceGraph::trace(const std::string& name) {
+    std::vector<InferenceStep> steps;
+    walk(name, [&](const Node& node, int depth) {
+        InferenceStep step;
+        step.proposition = *node.name;
+        step.truthValue = node.prop->getTruthValue();
+        step.depth = depth;
+        step.rule = ruleOf(node);
+        if (node.prop->hasProvenance()) {
+            step.premises = node.premises;
+        }
+        steps.push_back(std::move(step));
+    });
+    return steps;
+}
+
+void TraceGraph::writeTrace(std::ostream& out, const std::string& name) {
+    bool empty = true;
+    walk(name, [&](const Node& node, int depth) {
+        if (empty) {
+            out << "Inference trace for '" << name << "':\n";
+            out << "========================================\n";
+            empty = false;
+        }
+        std::string indent(depth * 2, ' ');
+        out << indent << *node.name << " = ";
+        switch (node.prop->getTruthValue()) {
+            case Tripartite::TRUE:    out << "TRUE"; break;
+            case Tripartite::FALSE:   out << "FALSE"; break;
+            case Tripartite::UNKNOWN: out << "UNKNOWN"; break;
+        }
+
+        std::string_view rule = ruleOf(node);
+        if (rule == kAxiom) {
+            out << " [Axiom/Direct Assertion]\n";
+            return;
+        }
+        out << " [" << rule << "]\n";
+        if (!node.premises.empty()) {
+            out << indent << "  Premises: ";
+            for (size_t i = 0; i < node.premises.size(); ++i) {
+                if (i > 0) out << ", ";
+                out << node.premises[i];
+            }
+            out << "\n";
+        }
+    });
+
+    if (empty) {
+        out << "No inference trace available for '" << name << "'\n";
+        return;
+    }
+    out << "========================================\n";
+}
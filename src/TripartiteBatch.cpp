@@ -0,0 +1,199 @@
+#include "TripartiteBatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t kAllWorlds = ~uint64_t(0);
+
+#if defined(__GNUC__)
+// 512 bits of worlds; the compiler splits the lane into whatever vector width
+// the target has (one AVX-512 register, two AVX2, four NEON or SSE2)
+typedef uint64_t Lanes __attribute__((vector_size(64)));
+constexpr size_t kLaneWords = sizeof(Lanes) / sizeof(uint64_t);
+#define LOGOSLAB_VECTOR_LANES 1
+#endif
+
+// Run a kernel over count words: whole lanes first, then word by word.
+// The kernel is generic so the same expression serves Lanes and uint64_t.
+template <typename Kernel>
+void forEachWord(uint64_t* known1, uint64_t* value1,
+                 const uint64_t* known2, const uint64_t* value2,
+                 size_t count, Kernel kernel) {
+    size_t i = 0;
+#ifdef LOGOSLAB_VECTOR_LANES
+    for (; i + kLaneWords <= count; i += kLaneWords) {
+        Lanes k1, v1, k2, v2;
+        std::memcpy(&k1, known1 + i, sizeof(Lanes));
+        std::memcpy(&v1, value1 + i, sizeof(Lanes));
+        std::memcpy(&k2, known2 + i, sizeof(Lanes));
+        std::memcpy(&v2, value2 + i, sizeof(Lanes));
+        kernel(k1, v1, k2, v2);
+        std::memcpy(known1 + i, &k1, sizeof(Lanes));
+        std::memcpy(value1 + i, &v1, sizeof(Lanes));
+    }
+#endif
+    for (; i < count; ++i) {
+        kernel(known1[i], value1[i], known2[i], value2[i]);
+    }
+}
+
+// With value ⊆ known: TRUE = value, FALSE = known & ~value.
+// Each kernel computes the TRUE and FALSE planes of the result.
+
+struct AndKernel {
+    template <typename W>
+    void operator()(W& k1, W& v1, const W& k2, const W& v2) const {
+        W isTrue = v1 & v2;
+        W isFalse = (k1 & ~v1) | (k2 & ~v2);
+        k1 = isTrue | isFalse;
+        v1 = isTrue;
+    }
+};
+
+struct OrKernel {
+    template <typename W>
+    void operator()(W& k1, W& v1, const W& k2, const W& v2) const {
+        W isTrue = v1 | v2;
+        W isFalse = (k1 & ~v1) & (k2 & ~v2);
+        k1 = isTrue | isFalse;
+        v1 = isTrue;
+    }
+};
+
+// implies(): TRUE if left is FALSE or right is TRUE, FALSE if TRUE -> FALSE
+struct ImpliesKernel {
+    template <typename W>
+    void operator()(W& k1, W& v1, const W& k2, const W& v2) const {
+        W isTrue = (k1 & ~v1) | v2;
+        W isFalse = v1 & (k2 & ~v2);
+        k1 = isTrue | isFalse;
+        v1 = isTrue;
+    }
+};
+
+// Biconditional is TRUE when both implications are TRUE and FALSE otherwise
+// (never UNKNOWN), matching Expression's scalar evaluation
+struct EquivalentKernel {
+    template <typename W>
+    void operator()(W& k1, W& v1, const W& k2, const W& v2) const {
+        W isTrue = ((k1 & ~v1) | v2) & ((k2 & ~v2) | v1);
+        k1 = isTrue | ~isTrue;
+        v1 = isTrue;
+    }
+};
+
+}  // namespace
+
+// ========== TripartiteBatch ==========
+
+TripartiteBatch::TripartiteBatch(size_t worlds, Tripartite fill) : worlds_(0) {
+    resize(worlds, fill);
+}
+
+void TripartiteBatch::resize(size_t worlds, Tripartite fillValue) {
+    worlds_ = worlds;
+    size_t words = (worlds + kWorldsPerWord - 1) / kWorldsPerWord;
+    known_.resize(words);
+    value_.resize(words);
+    fill(fillValue);
+}
+
+void TripartiteBatch::fill(Tripartite value) {
+    uint64_t known = (value == Tripartite::UNKNOWN) ? 0 : kAllWorlds;
+    uint64_t truth = (value == Tripartite::TRUE) ? kAllWorlds : 0;
+    std::fill(known_.begin(), known_.end(), known);
+    std::fill(value_.begin(), value_.end(), truth);
+}
+
+size_t TripartiteBatch::worldCount() const {
+    return worlds_;
+}
+
+size_t TripartiteBatch::wordCount() const {
+    return known_.size();
+}
+
+void TripartiteBatch::set(size_t world, Tripartite value) {
+    size_t word = world / kWorldsPerWord;
+    uint64_t bit = uint64_t(1) << (world % kWorldsPerWord);
+    if (value == Tripartite::UNKNOWN) {
+        known_[word] &= ~bit;
+    } else {
+        known_[word] |= bit;
+    }
+    if (value == Tripartite::TRUE) {
+        value_[word] |= bit;
+    } else {
+        value_[word] &= ~bit;
+    }
+}
+
+Tripartite TripartiteBatch::get(size_t world) const {
+    size_t word = world / kWorldsPerWord;
+    uint64_t bit = uint64_t(1) << (world % kWorldsPerWord);
+    if (!(known_[word] & bit)) {
+        return Tripartite::UNKNOWN;
+    }
+    return (value_[word] & bit) ? Tripartite::TRUE : Tripartite::FALSE;
+}
+
+const uint64_t* TripartiteBatch::known() const {
+    return known_.data();
+}
+
+const uint64_t* TripartiteBatch::value() const {
+    return value_.data();
+}
+
+uint64_t* TripartiteBatch::known() {
+    return known_.data();
+}
+
+uint64_t* TripartiteBatch::value() {
+    return value_.data();
+}
+
+// ========== Plane Kernels ==========
+
+const char* TripartiteBatch::kernelName() {
+#if defined(LOGOSLAB_VECTOR_LANES) && defined(__AVX512F__)
+    return "avx512";
+#elif defined(LOGOSLAB_VECTOR_LANES) && defined(__AVX2__)
+    return "avx2";
+#elif defined(LOGOSLAB_VECTOR_LANES) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    return "neon";
+#elif defined(LOGOSLAB_VECTOR_LANES) && defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+void TripartiteBatch::notPlanes(uint64_t* known, uint64_t* value, size_t count) {
+    // ¬TRUE = FALSE, ¬FALSE = TRUE: the new value plane is the old FALSE plane
+    forEachWord(known, value, known, value, count, [](auto& k, auto& v, const auto&, const auto&) {
+        v = k & ~v;
+    });
+}
+
+void TripartiteBatch::andPlanes(uint64_t* known1, uint64_t* value1,
+                                const uint64_t* known2, const uint64_t* value2, size_t count) {
+    forEachWord(known1, value1, known2, value2, count, AndKernel());
+}
+
+void TripartiteBatch::orPlanes(uint64_t* known1, uint64_t* value1,
+                               const uint64_t* known2, const uint64_t* value2, size_t count) {
+    forEachWord(known1, value1, known2, value2, count, OrKernel());
+}
+
+void TripartiteBatch::impliesPlanes(uint64_t* known1, uint64_t* value1,
+                                    const uint64_t* known2, const uint64_t* value2, size_t count) {
+    forEachWord(known1, value1, known2, value2, count, ImpliesKernel());
+}
+
+void TripartiteBatch::equivalentPlanes(uint64_t* known1, uint64_t* value1,
+                                       const uint64_t* known2, const uint64_t* value2, size_t count) {
+    forEachWord(known1, value1, known2, value2, count, EquivalentKernel());
+}
@@ -0,0 +1,126 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t WorkStealingPool::threadCount() const {
+    return queues_.size();
+}
+
+size_t WorkStealingPool::defaultThreadCount() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+// Own deque first (front), then steal from the back of the others
+bool WorkStealingPool::take(size_t thread, size_t& task) {
+    {
+        Queue& own = *queues_[thread];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        Queue& victim = *queues_[(thread + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every task is dealt before the batch starts, so empty deques mean the batch is drained
+void WorkStealingPool::drain(size_t thread) {
+    size_t task;
+    while (take(thread, task)) {
+        try {
+            (*task_)(task);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_ || task < errorTask_) {
+                error_ = std::current_exception();
+                errorTask_ = task;
+            }
+        }
+    }
+}
+
+void WorkStealingPool::workerLoop(size_t thread) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        drain(thread);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void WorkStealingPool::run(size_t taskCount, const std::function<void(size_t)>& task) {
+    std::lock_guard<std::mutex> runLock(runMutex_);
+    if (taskCount == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < taskCount; ++i) {
+        queues_[i % queues_.size()]->tasks.push_back(i);
+    }
+    error_ = nullptr;
+    task_ = &task;
+    if (!workers_.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&]() { return active_ == 0; });
+    }
+    task_ = nullptr;
+
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
@@ -3,12 +3,15 @@
 #include <string>
 #include <cstring>
 #include "Ratiocinator.h"
+#include "OutputFile.h"
+#include "Server.h"
 
 namespace {
-    constexpr const char* REPORT_FILENAME = "ratiocinator_report.txt";
+    constexpr const char* REPORT_BASENAME = "ratiocinator_report";
     
     void printUsage(const char* programName) {
         std::cerr << "Usage: " << programName << " [OPTIONS] <assumptions_file> <facts_file>\n"
+                  << "       " << programName << " --serve|--socket=PATH [<assumptions_file> [<facts_file>]]\n"
                   << "\nOptions:\n"
                   << "  --traces          Include inference traces in output\n"
                   << "  --true-only       Show only TRUE propositions\n"
@@ -21,12 +24,27 @@ namespace {
                   << "  --contains=STR    Show only propositions containing STR\n"
                   << "  --limit=N         Show at most N results\n"
                   << "  --sort=ORDER      Sort results: alpha, alpha-desc, truth, derivation\n"
+                  << "  --format=FORMAT   Report format: text, json, ndjson (default: text)\n"
                   << "  --verbose         Print results to console as well as file\n"
+                  << "  --stats           Print inference statistics as JSON after the results\n"
+                  << "  --serve           Keep the knowledge base loaded and answer requests on stdin\n"
+                  << "  --socket=PATH     Like --serve, but on a Unix domain socket at PATH\n"
+                  << "  --snapshots=DIR   Directory for the server's save and load snapshots (default: .)\n"
                   << "  --help            Show this help message\n"
                   << "\nExamples:\n"
                   << "  " << programName << " assumptions.txt facts.txt\n"
                   << "  " << programName << " --traces --true-only assumptions.txt facts.txt\n"
-                  << "  " << programName << " --prefix=user_ --sort=alpha assumptions.txt facts.txt\n";
+                  << "  " << programName << " --prefix=user_ --sort=alpha assumptions.txt facts.txt\n"
+                  << "  " << programName << " --socket=/tmp/logoslab.sock assumptions.txt facts.txt\n";
+    }
+    
+    std::string reportFilename(ResultFormat format) {
+        switch (format) {
+            case ResultFormat::JSON:   return std::string(REPORT_BASENAME) + ".json";
+            case ResultFormat::NDJSON: return std::string(REPORT_BASENAME) + ".ndjson";
+            case ResultFormat::TEXT:   break;
+        }
+        return std::string(REPORT_BASENAME) + ".txt";
     }
     
     bool startsWith(const char* str, const char* prefix) {
@@ -37,57 +55,32 @@ namespace {
 int main(int argc, char* argv[]) {
     ResultFilter filter;
     bool verbose = false;
+    bool stats = false;
+    bool serve = false;
+    std::string socketPath;  // Serve over this Unix socket instead of stdin/stdout
+    std::string snapshotDir = ".";  // Where save and load requests keep snapshots
     int fileArgStart = -1;  // Initialize to -1 to indicate no file arguments found yet
     
     // Parse options
     for (int i = 1; i < argc; ++i) {
-        if (std::strcmp(argv[i], "--traces") == 0) {
-            filter.includeTraces = true;
-        } else if (std::strcmp(argv[i], "--true-only") == 0) {
-            filter.showTrue = true;
-            filter.showFalse = false;
-            filter.showUnknown = false;
-        } else if (std::strcmp(argv[i], "--false-only") == 0) {
-            filter.showTrue = false;
-            filter.showFalse = true;
-            filter.showUnknown = false;
-        } else if (std::strcmp(argv[i], "--known-only") == 0) {
-            filter.showTrue = true;
-            filter.showFalse = true;
-            filter.showUnknown = false;
-        } else if (std::strcmp(argv[i], "--unknown-only") == 0) {
-            filter.showTrue = false;
-            filter.showFalse = false;
-            filter.showUnknown = true;
-        } else if (std::strcmp(argv[i], "--derived-only") == 0) {
-            filter.showDerived = true;
-            filter.showAxioms = false;
-        } else if (std::strcmp(argv[i], "--axioms-only") == 0) {
-            filter.showDerived = false;
-            filter.showAxioms = true;
-        } else if (startsWith(argv[i], "--prefix=")) {
-            filter.prefixPattern = argv[i] + 9;
-        } else if (startsWith(argv[i], "--contains=")) {
-            filter.containsPattern = argv[i] + 11;
-        } else if (startsWith(argv[i], "--limit=")) {
-            filter.limit = std::stoul(argv[i] + 8);
-        } else if (startsWith(argv[i], "--sort=")) {
-            std::string sortOrder = argv[i] + 7;
-            if (sortOrder == "alpha") {
-                filter.sortOrder = ResultSortOrder::ALPHABETICAL;
-            } else if (sortOrder == "alpha-desc") {
-                filter.sortOrder = ResultSortOrder::ALPHABETICAL_DESC;
-            } else if (sortOrder == "truth") {
-                filter.sortOrder = ResultSortOrder::BY_TRUTH_VALUE;
-            } else if (sortOrder == "derivation") {
-                filter.sortOrder = ResultSortOrder::BY_DERIVATION;
-            } else {
-                std::cerr << "Unknown sort order: " << sortOrder << "\n";
+        std::string filterError;
+        if (Server::parseFilterOption(argv[i], filter, filterError)) {
+            if (!filterError.empty()) {
+                std::cerr << filterError << "\n";
                 printUsage(argv[0]);
                 return 1;
             }
         } else if (std::strcmp(argv[i], "--verbose") == 0) {
             verbose = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (std::strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        } else if (startsWith(argv[i], "--socket=")) {
+            serve = true;
+            socketPath = argv[i] + 9;
+        } else if (startsWith(argv[i], "--snapshots=")) {
+            snapshotDir = argv[i] + 12;
         } else if (std::strcmp(argv[i], "--help") == 0) {
             printUsage(argv[0]);
             return 0;
@@ -101,47 +94,90 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    // Check for required file arguments
-    if (fileArgStart == -1 || argc - fileArgStart < 2) {
+    // Check for required file arguments (optional when serving)
+    int fileArgCount = fileArgStart == -1 ? 0 : argc - fileArgStart;
+    if (!serve && fileArgCount < 2) {
         std::cerr << "Error: Missing required file arguments.\n\n";
         printUsage(argv[0]);
         return 1;
     }
-
-    // Get the file paths from command-line arguments
-    std::string assumptionsFile = argv[fileArgStart];
-    std::string factsFile = argv[fileArgStart + 1];
+    
+    // Serving on stdin answers pipelined requests in one flush, which needs the
+    // streams' own buffers (see Server::serve). Unsyncing only takes effect
+    // reliably before the first I/O, so it happens before anything is logged.
+    if (serve && socketPath.empty()) {
+        std::ios::sync_with_stdio(false);
+    }
 
     // Create an instance of Ratiocinator
     Ratiocinator engine;
+    if (stats) {
+        InferenceEngine::Options options = engine.getInferenceOptions();
+        options.collectStats = true;
+        engine.setInferenceOptions(options);
+    }
+
+    // Progress goes to stderr when stdout carries responses
+    std::ostream& log = serve ? std::cerr : std::cout;
 
     // Load assumptions
-    std::cout << "Loading assumptions: " << assumptionsFile << std::endl;
-    engine.loadAssumptions(assumptionsFile);
+    if (fileArgCount >= 1) {
+        std::string assumptionsFile = argv[fileArgStart];
+        log << "Loading assumptions: " << assumptionsFile << std::endl;
+        engine.loadAssumptions(assumptionsFile);
+    }
 
     // Load facts
-    std::cout << "Loading facts: " << factsFile << std::endl;
-    engine.loadFacts(factsFile);
+    if (fileArgCount >= 2) {
+        std::string factsFile = argv[fileArgStart + 1];
+        log << "Loading facts: " << factsFile << std::endl;
+        engine.loadFacts(factsFile);
+    }
 
     // Deduce truth values
-    std::cout << "Deducing truth values..." << std::endl;
+    log << "Deducing truth values..." << std::endl;
     engine.deduce();
 
-    // Write report
-    std::ofstream reportFile(REPORT_FILENAME);
-    if (!reportFile) {
-        std::cerr << "Error: Could not open " << REPORT_FILENAME << " for writing." << std::endl;
+    if (serve) {
+        Server server(engine, snapshotDir);
+        if (socketPath.empty()) {
+            server.serve(std::cin, std::cout);
+            return 0;
+        }
+        std::string error;
+        log << "Serving on " << socketPath << std::endl;
+        if (!server.serveSocket(socketPath, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Write report, streaming it to the file as it is formatted
+    std::string reportPath = reportFilename(filter.format);
+    OutputFile reportFile;
+    if (!reportFile.open(reportPath)) {
+        std::cerr << "Error: Could not open " << reportPath << " for writing." << std::endl;
         return 1;
     }
 
-    std::string results = engine.formatResults(filter);
-    reportFile << results;
+    engine.writeResults(reportFile, filter);
+    if (!reportFile.close()) {
+        std::cerr << "Error: Could not write " << reportPath << "." << std::endl;
+        return 1;
+    }
 
-    std::cout << "Results written to " << REPORT_FILENAME << std::endl;
+    std::cout << "Results written to " << reportPath << std::endl;
     
     // Print to console if verbose or traces requested
     if (verbose || filter.includeTraces) {
-        std::cout << "\n" << results;
+        std::cout << "\n";
+        engine.writeResults(std::cout, filter);
+    }
+    
+    if (stats) {
+        engine.getStats().writeJson(std::cout);
+        std::cout << std::endl;
     }
 
     return 0;
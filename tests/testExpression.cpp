@@ -1,7 +1,10 @@
 #include "Expression.h"
+#include "ExpressionDag.h"
 #include "Proposition.h"
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 void testSimpleExpression() {
     // Test a simple expression: TRUE AND FALSE
@@ -312,6 +315,343 @@ void testParenthesesGrouping() {
     std::cout << "testParenthesesGrouping passed.\n";
 }
 
+void testCompiledProgram() {
+    std::cout << "Testing compiled program for (A AND B) OR (C AND D)\n";
+    Expression expr;
+    expr.openParen();
+    expr.addToken("A", Tripartite::TRUE);
+    expr.addToken(LogicalOperator::AND);
+    expr.addToken("B", Tripartite::TRUE);
+    expr.closeParen();
+    expr.addToken(LogicalOperator::OR);
+    expr.openParen();
+    expr.addToken("C", Tripartite::FALSE);
+    expr.addToken(LogicalOperator::AND);
+    expr.addToken("D", Tripartite::TRUE);
+    expr.closeParen();
+
+    // 4 operand loads + 3 operators; parentheses compile away
+    assert(expr.getInstructionCount() == 7);
+    assert(expr.evaluate() == Tripartite::TRUE);
+
+    // Adding tokens recompiles and is not hidden by the cached result
+    expr.addToken(LogicalOperator::EQUIVALENT);
+    expr.addToken("E", Tripartite::FALSE);
+    assert(expr.getInstructionCount() == 9);
+    assert(expr.evaluate() == Tripartite::FALSE);
+
+    std::cout << "testCompiledProgram passed.\n";
+}
+
+void testLiveBinding() {
+    std::cout << "Testing evaluation against live proposition storage\n";
+    Expression expr;
+    expr.addToken("P", Tripartite::TRUE);
+    expr.addToken(LogicalOperator::AND);
+    expr.addToken(LogicalOperator::NOT);
+    expr.addToken("Q", Tripartite::TRUE);
+    expr.addToken(LogicalOperator::OR);
+    expr.addToken(Proposition(Tripartite::FALSE));    // Anonymous operand
+    assert(expr.evaluate() == Tripartite::FALSE);       // Captured values
+
+    SymbolTable symbols;
+    expr.bind(symbols);
+    PropId p = symbols.intern("P");
+    PropId q = symbols.intern("Q");
+    assert(expr.getBoundLiterals().size() == 2);
+
+    Proposition pProp("P", Tripartite::TRUE);
+    Proposition qProp("Q", Tripartite::FALSE);
+    std::vector<Proposition*> byId(symbols.idCount(), nullptr);
+    byId[p] = &pProp;
+    byId[q] = &qProp;
+
+    // Every call reads the current values
+    assert(expr.evaluate(byId) == Tripartite::TRUE);
+    qProp.setTruthValue(Tripartite::TRUE);
+    assert(expr.evaluate(byId) == Tripartite::FALSE);
+    pProp.setTruthValue(Tripartite::UNKNOWN);
+    qProp.setTruthValue(Tripartite::FALSE);
+    assert(expr.evaluate(byId) == Tripartite::UNKNOWN);
+
+    // A literal with no proposition falls back to the captured value
+    byId[q] = nullptr;
+    pProp.setTruthValue(Tripartite::TRUE);
+    assert(expr.evaluate(byId) == Tripartite::FALSE);
+
+    std::cout << "testLiveBinding passed.\n";
+}
+
+void testMalformedExpression() {
+    std::cout << "Testing malformed expressions report errors on every evaluation\n";
+    Expression expr;
+    expr.addToken(LogicalOperator::AND);
+    expr.addToken("P", Tripartite::TRUE);
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool threw = false;
+        try {
+            expr.evaluate();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    Expression empty;
+    empty.openParen();
+    empty.closeParen();
+    assert(empty.evaluate() == Tripartite::UNKNOWN);
+
+    std::cout << "testMalformedExpression passed.\n";
+}
+
+void testTripartiteBatchStorage() {
+    std::cout << "Testing TripartiteBatch bit-plane storage\n";
+    TripartiteBatch batch(130, Tripartite::FALSE);
+    assert(batch.worldCount() == 130);
+    assert(batch.wordCount() == 3);
+    assert(batch.get(0) == Tripartite::FALSE);
+    assert(batch.get(129) == Tripartite::FALSE);
+
+    batch.set(1, Tripartite::TRUE);
+    batch.set(64, Tripartite::UNKNOWN);
+    batch.set(129, Tripartite::TRUE);
+    assert(batch.get(1) == Tripartite::TRUE);
+    assert(batch.get(64) == Tripartite::UNKNOWN);
+    assert(batch.get(129) == Tripartite::TRUE);
+    batch.set(1, Tripartite::FALSE);
+    assert(batch.get(1) == Tripartite::FALSE);
+
+    batch.fill(Tripartite::UNKNOWN);
+    assert(batch.get(1) == Tripartite::UNKNOWN);
+    assert(batch.get(129) == Tripartite::UNKNOWN);
+
+    std::cout << "testTripartiteBatchStorage passed.\n";
+}
+
+// Scalar value of world w when every (P, Q, R) combination repeats across the batch
+static Tripartite worldValue(size_t world, size_t digit) {
+    static const Tripartite kValues[] = {Tripartite::FALSE, Tripartite::TRUE, Tripartite::UNKNOWN};
+    size_t combination = world % 27;
+    for (size_t i = 0; i < digit; ++i) {
+        combination /= 3;
+    }
+    return kValues[combination % 3];
+}
+
+void testBatchMatchesScalar() {
+    std::cout << "Testing batch evaluation against scalar evaluation\n";
+    // 27 combinations repeated past one 512-world block, ending in a partial word
+    const size_t worlds = 27 * 25;
+
+    // One expression per connective, then one mixing all of them
+    std::vector<std::vector<Token>> formulas = {
+        {Token(LogicalOperator::NOT), Token("P", Tripartite::UNKNOWN)},
+        {Token("P", Tripartite::UNKNOWN), Token(LogicalOperator::AND), Token("Q", Tripartite::UNKNOWN)},
+        {Token("P", Tripartite::UNKNOWN), Token(LogicalOperator::OR), Token("Q", Tripartite::UNKNOWN)},
+        {Token("P", Tripartite::UNKNOWN), Token(LogicalOperator::IMPLIES), Token("Q", Tripartite::UNKNOWN)},
+        {Token("P", Tripartite::UNKNOWN), Token(LogicalOperator::EQUIVALENT), Token("Q", Tripartite::UNKNOWN)},
+        {Token(LogicalOperator::LPAREN), Token("P", Tripartite::UNKNOWN), Token(LogicalOperator::AND),
+         Token(LogicalOperator::NOT), Token("Q", Tripartite::UNKNOWN), Token(LogicalOperator::RPAREN),
+         Token(LogicalOperator::OR), Token("R", Tripartite::UNKNOWN), Token(LogicalOperator::IMPLIES),
+         Token("P", Tripartite::UNKNOWN), Token(LogicalOperator::EQUIVALENT), Token("", Tripartite::TRUE)},
+    };
+
+    for (const std::vector<Token>& formula : formulas) {
+        Expression expr;
+        for (const Token& token : formula) {
+            if (token.isOperand) {
+                expr.addToken(token.name, token.value);
+            } else {
+                expr.addToken(token.op);
+            }
+        }
+        SymbolTable symbols;
+        PropId ids[3] = {symbols.intern("P"), symbols.intern("Q"), symbols.intern("R")};
+        expr.bind(symbols);
+
+        TripartiteBatch columns[3];
+        std::vector<const TripartiteBatch*> byIdColumns(symbols.idCount(), nullptr);
+        Proposition props[3] = {Proposition("P", Tripartite::UNKNOWN), Proposition("Q", Tripartite::UNKNOWN),
+                                Proposition("R", Tripartite::UNKNOWN)};
+        std::vector<Proposition*> byId(symbols.idCount(), nullptr);
+        for (size_t digit = 0; digit < 3; ++digit) {
+            columns[digit].resize(worlds);
+            for (size_t world = 0; world < worlds; ++world) {
+                columns[digit].set(world, worldValue(world, digit));
+            }
+            byIdColumns[ids[digit]] = &columns[digit];
+            byId[ids[digit]] = &props[digit];
+        }
+
+        TripartiteBatch result(worlds);
+        expr.evaluateBatch(byIdColumns, result);
+        for (size_t world = 0; world < worlds; ++world) {
+            for (size_t digit = 0; digit < 3; ++digit) {
+                props[digit].setTruthValue(worldValue(world, digit));
+            }
+            assert(result.get(world) == expr.evaluate(byId));
+        }
+    }
+
+    // Unbound operands and missing columns broadcast their captured values
+    Expression captured;
+    captured.addToken("P", Tripartite::TRUE);
+    captured.addToken(LogicalOperator::AND);
+    captured.addToken("Q", Tripartite::UNKNOWN);
+    TripartiteBatch result(100);
+    captured.evaluateBatch({}, result);
+    assert(result.get(0) == Tripartite::UNKNOWN);
+    assert(result.get(99) == Tripartite::UNKNOWN);
+
+    // Columns must match the result's world count
+    SymbolTable symbols;
+    captured.bind(symbols);
+    TripartiteBatch shortColumn(10, Tripartite::TRUE);
+    std::vector<const TripartiteBatch*> mismatched(symbols.idCount(), &shortColumn);
+    bool threw = false;
+    try {
+        captured.evaluateBatch(mismatched, result);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "testBatchMatchesScalar passed.\n";
+}
+
+void testFoldMatchesStack() {
+    std::cout << "Testing folded chains against the general program\n";
+    const Tripartite values[] = {Tripartite::TRUE, Tripartite::FALSE, Tripartite::UNKNOWN};
+    const LogicalOperator ops[] = {LogicalOperator::AND, LogicalOperator::OR,
+                                   LogicalOperator::IMPLIES, LogicalOperator::EQUIVALENT};
+    const Connective connectives[] = {Connective::AND, Connective::OR,
+                                      Connective::IMPLIES, Connective::EQUIVALENT};
+    for (size_t c = 0; c < 4; ++c) {
+        for (int world = 0; world < 81; ++world) {
+            Tripartite operand[4];
+            for (int i = 0, w = world; i < 4; ++i, w /= 3) {
+                operand[i] = values[w % 3];
+            }
+            // a op b op c op d folds; !!a op ... is the same value through the stack
+            Expression folded;
+            Expression general;
+            general.addToken(LogicalOperator::NOT);
+            general.addToken(LogicalOperator::NOT);
+            for (int i = 0; i < 4; ++i) {
+                if (i > 0) {
+                    folded.addToken(ops[c]);
+                    general.addToken(ops[c]);
+                }
+                folded.addToken("X" + std::to_string(i), operand[i]);
+                general.addToken("X" + std::to_string(i), operand[i]);
+            }
+            Tripartite expected = operand[0];
+            for (int i = 1; i < 4; ++i) {
+                expected = connectiveByCases(connectives[c], expected, operand[i]);
+            }
+            assert(folded.getInstructionCount() == 7);
+            assert(folded.evaluate() == expected);
+            assert(general.evaluate() == expected);
+        }
+    }
+
+    std::cout << "testFoldMatchesStack passed.\n";
+}
+
+void testExpressionDag() {
+    std::cout << "Testing shared subexpressions in an expression DAG\n";
+    // t = P && N, s = !(P && N), u = N && P || R
+    Expression t, s, u;
+    t.addToken("P", Tripartite::TRUE);
+    t.addToken(LogicalOperator::AND);
+    t.addToken("N", Tripartite::TRUE);
+    s.addToken(LogicalOperator::NOT);
+    s.openParen();
+    s.addToken("P", Tripartite::TRUE);
+    s.addToken(LogicalOperator::AND);
+    s.addToken("N", Tripartite::TRUE);
+    s.closeParen();
+    u.addToken("N", Tripartite::TRUE);
+    u.addToken(LogicalOperator::AND);
+    u.addToken("P", Tripartite::TRUE);
+    u.addToken(LogicalOperator::OR);
+    u.addToken("R", Tripartite::FALSE);
+
+    SymbolTable symbols;
+    t.bind(symbols);
+    s.bind(symbols);
+    u.bind(symbols);
+    PropId p = symbols.intern("P");
+    PropId r = symbols.intern("R");
+    Proposition pProp("P", Tripartite::TRUE);
+    Proposition nProp("N", Tripartite::TRUE);
+    Proposition rProp("R", Tripartite::FALSE);
+    std::vector<Proposition*> byId(symbols.idCount(), nullptr);
+    byId[p] = &pProp;
+    byId[symbols.intern("N")] = &nProp;
+    byId[r] = &rProp;
+    auto read = [&](PropId literal) { return byId[literal]; };
+
+    // P, N, P && N, its negation, R and the disjunction: N && P is the node for P && N
+    ExpressionDag dag;
+    uint32_t tRoot = dag.add(t);
+    uint32_t sRoot = dag.add(s);
+    uint32_t uRoot = dag.add(u);
+    assert(dag.nodeCount() == 6);
+    uint32_t again = dag.add(t);
+    assert(again == tRoot);
+
+    assert(dag.evaluate(tRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluate(sRoot, read) == Tripartite::FALSE);
+    assert(dag.evaluate(uRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluations() == 6);
+
+    // Clean nodes are not recomputed
+    assert(dag.evaluate(uRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluations() == 6);
+
+    // Changing R dirties only R and the disjunction
+    rProp.setTruthValue(Tripartite::TRUE);
+    dag.invalidate(r);
+    assert(dag.evaluate(tRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluations() == 6);
+    assert(dag.evaluate(uRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluations() == 8);
+
+    // Changing P reaches every expression, each shared node once
+    pProp.setTruthValue(Tripartite::FALSE);
+    dag.invalidate(p);
+    assert(dag.evaluate(sRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluations() == 11);
+    assert(dag.evaluate(tRoot, read) == Tripartite::FALSE);
+    assert(dag.evaluate(uRoot, read) == Tripartite::TRUE);
+    assert(dag.evaluations() == 12);
+
+    // A literal with no proposition falls back to the captured value
+    byId[p] = nullptr;
+    dag.invalidate(p);
+    assert(dag.evaluate(tRoot, read) == Tripartite::TRUE);
+
+    // Anonymous operands are constants, and their disjunction folds into one of them
+    Expression constant;
+    constant.addToken(Proposition(Tripartite::FALSE));
+    constant.addToken(LogicalOperator::OR);
+    constant.addToken(Proposition(Tripartite::TRUE));
+    constant.bind(symbols);
+    size_t before = dag.nodeCount();
+    uint32_t constantRoot = dag.add(constant);
+    assert(dag.nodeCount() == before + 2);
+    assert(dag.evaluate(constantRoot, read) == Tripartite::TRUE);
+
+    // Nothing to share from an empty program
+    Expression empty;
+    uint32_t emptyRoot = dag.add(empty);
+    assert(emptyRoot == ExpressionDag::kNoNode);
+
+    std::cout << "testExpressionDag passed.\n";
+}
+
 int main() {
     std::cout << "Running tests for Expression class...\n";
     testSimpleExpression();
@@ -321,6 +661,13 @@ int main() {
     testExpressionReset();
     testUnaryNotOperator();
     testParenthesesGrouping();
+    testCompiledProgram();
+    testLiveBinding();
+    testFoldMatchesStack();
+    testExpressionDag();
+    testMalformedExpression();
+    testTripartiteBatchStorage();
+    testBatchMatchesScalar();
 
     std::cout << "All tests passed successfully.\n";
     return 0;
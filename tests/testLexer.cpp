@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cassert>
 #include <string>
+#include <vector>
 
 // Test: Basic identifier tokenization
 void testIdentifiers() {
@@ -299,6 +300,132 @@ void testComplexExpression() {
     std::cout << "Test passed: Complex expression tokenized correctly." << std::endl;
 }
 
+// Test: tokenizeView returns views into the input and reuses the output vector
+void testTokenizeView() {
+    std::cout << "Running testTokenizeView..." << std::endl;
+    
+    Lexer lexer;
+    std::string input = "t = p AND ~big-bang\n  -> q";
+    std::vector<LexerTokenView> tokens;
+    lexer.tokenizeView(input, tokens);
+    
+    assert(tokens.size() == 7);
+    assert(tokens[0].type == TokenType::IDENTIFIER && tokens[0].value == "t");
+    assert(tokens[1].type == TokenType::ASSIGN);
+    assert(tokens[3].type == TokenType::AND && tokens[3].value == "AND");
+    assert(tokens[4].type == TokenType::IDENTIFIER && tokens[4].value == "~big-bang");
+    assert(tokens[5].type == TokenType::IMPLIES);
+    
+    // Identifier text is not copied: it points into the input
+    assert(tokens[4].value.data() == input.data() + 10);
+    assert(tokens[6].location.line == 2);
+    assert(tokens[6].location.column == 6);
+    assert(tokens[6].location.offset == 25);
+    
+    // Matches the owning tokens
+    auto owned = lexer.tokenizeContent(input);
+    assert(owned.size() == tokens.size());
+    for (size_t i = 0; i < owned.size(); ++i) {
+        LexerToken copy = tokens[i].toToken();
+        assert(copy.type == owned[i].type);
+        assert(copy.value == owned[i].value);
+        assert(copy.location.offset == owned[i].location.offset);
+    }
+    
+    // A second call replaces the tokens in place
+    const LexerTokenView* storage = tokens.data();
+    lexer.tokenizeView("a || b", tokens);
+    assert(tokens.size() == 3);
+    assert(tokens.data() == storage);
+    assert(tokens[1].type == TokenType::OR);
+    
+    lexer.tokenizeView("", tokens);
+    assert(tokens.empty());
+    
+    std::cout << "Test passed: tokenizeView produces views into the input." << std::endl;
+}
+
+// Test: runs longer than a block lex the same at every length and alignment
+void testLongRuns() {
+    std::cout << "Running testLongRuns..." << std::endl;
+    
+    Lexer lexer;
+    for (size_t length = 1; length <= 40; ++length) {
+        for (size_t indent = 0; indent <= 17; ++indent) {
+            std::string name = "x" + std::string(length - 1, 'a' + length % 26);
+            name[length / 2] = length % 3 == 0 ? '-' : '_';
+            if (name.back() == '-') name.back() = '9';
+            std::string input = std::string(indent, ' ') + name + std::string(length, '\t') + "&&\n" +
+                                std::string(indent, ' ') + name;
+            auto tokens = lexer.tokenizeContent(input);
+            assert(tokens.size() == 3);
+            assert(tokens[0].value == name && tokens[0].location.column == indent + 1);
+            assert(tokens[1].type == TokenType::AND);
+            assert(tokens[1].location.column == indent + 2 * length + 1);
+            assert(tokens[2].value == name);
+            assert(tokens[2].location.line == 2 && tokens[2].location.column == indent + 1);
+        }
+    }
+    
+    // A run ends at the first byte outside it, even mid-block
+    std::string letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    Lexer::Options noHyphens;
+    noHyphens.allowHyphensInIds = false;
+    Lexer strict(noHyphens);
+    auto tokens = strict.tokenizeContent(letters + "->" + letters);
+    assert(tokens.size() == 3);
+    assert(tokens[0].value == letters && tokens[1].type == TokenType::IMPLIES);
+    assert(tokens[2].location.column == letters.size() + 3);
+    
+    // With hyphens allowed the '-' joins the identifier, and '>' is an error
+    bool errorThrown = false;
+    try {
+        lexer.tokenize(letters + "->" + letters);
+    } catch (const LexerError& e) {
+        errorThrown = true;
+        assert(e.location.column == letters.size() + 2);
+    }
+    assert(errorThrown);
+    
+    // Bytes outside ASCII end an identifier and are not recognised
+    errorThrown = false;
+    try {
+        lexer.tokenize("\n  " + letters + "\xC3\xA9");
+    } catch (const LexerError& e) {
+        errorThrown = true;
+        assert(e.location.line == 2 && e.location.column == letters.size() + 3);
+    }
+    assert(errorThrown);
+    
+    std::cout << "Test passed: long runs lex correctly." << std::endl;
+}
+
+// Test: tokenize into a reused vector matches tokenize and keeps its storage
+void testTokenizeReuse() {
+    std::cout << "Running testTokenizeReuse..." << std::endl;
+    
+    Lexer lexer;
+    std::vector<LexerToken> tokens;
+    lexer.tokenize("first-long-identifier && second-long-identifier || (third) -> x", tokens);
+    assert(tokens.size() == 10);
+    assert(tokens.back().type == TokenType::END_OF_INPUT);
+    const LexerToken* storage = tokens.data();
+    const char* text = tokens[0].value.data();
+    
+    lexer.tokenize(std::string_view("a || (b)"), tokens);
+    auto fresh = lexer.tokenize("a || (b)");
+    assert(tokens.size() == fresh.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        assert(tokens[i].type == fresh[i].type);
+        assert(tokens[i].value == fresh[i].value);
+        assert(tokens[i].location.offset == fresh[i].location.offset);
+    }
+    assert(tokens.data() == storage);
+    assert(tokens[0].value.data() == text);
+    
+    std::cout << "Test passed: tokenize reuses the output vector." << std::endl;
+}
+
 int main() {
     testIdentifiers();
     testHyphenatedIdentifiers();
@@ -315,6 +442,9 @@ int main() {
     testTokenMethods();
     testUnknownCharacterError();
     testComplexExpression();
+    testTokenizeView();
+    testLongRuns();
+    testTokenizeReuse();
     
     std::cout << "\nAll Lexer tests passed successfully!" << std::endl;
     return 0;
@@ -1,6 +1,7 @@
 #include "Proposition.h"
 #include <iostream>
 #include <cassert>
+#include <utility>
 
 void testPropositionAttributes() {
     Proposition prop;
@@ -80,6 +81,15 @@ void testLogicalOperations() {
     assert(propUnknown.implies(propTrue) == Tripartite::TRUE);
     assert(propTrue.implies(propUnknown) == Tripartite::UNKNOWN);
 
+    // EQUIVALENT operation (unknown is not equivalent to anything)
+    assert(equivalent(Tripartite::FALSE, Tripartite::FALSE) == Tripartite::TRUE);
+    assert(equivalent(Tripartite::TRUE, Tripartite::FALSE) == Tripartite::FALSE);
+    assert(equivalent(Tripartite::UNKNOWN, Tripartite::TRUE) == Tripartite::FALSE);
+
+    // Values index the truth tables directly
+    assert(static_cast<size_t>(Tripartite::UNKNOWN) == kTripartiteValues - 1);
+    assert(kTruthTables[static_cast<size_t>(Connective::OR)][2][0] == Tripartite::TRUE);
+
     // Equality operation
     assert((propTrue == propTrue) == true);
     assert((propTrue == propFalse) == false);
@@ -174,6 +184,49 @@ void testConflictDetection() {
     std::cout << "testConflictDetection passed.\n";
 }
 
+void testConflictRecording() {
+    std::cout << "Running testConflictRecording..." << std::endl;
+
+    // Alternate TRUE and FALSE ten times under each policy
+    auto flip = [](Proposition& prop, ConflictRecording recording) {
+        for (int i = 0; i < 10; ++i) {
+            Tripartite value = i % 2 ? Tripartite::FALSE : Tripartite::TRUE;
+            prop.setTruthValue(value, InferenceProvenance("Rule" + std::to_string(i), {"P"}), recording, 3);
+        }
+    };
+
+    Proposition off;
+    flip(off, ConflictRecording::OFF);
+    assert(!off.hasConflicts());
+    assert(off.getConflictCount() == 0);
+    assert(off.getProvenance()->ruleFired == "Rule9");
+
+    Proposition counted;
+    flip(counted, ConflictRecording::COUNT);
+    assert(counted.hasConflicts());
+    assert(counted.getConflictCount() == 9);
+    assert(counted.getConflicts().empty());
+
+    // The ring keeps the newest conflicts, oldest first
+    Proposition recent;
+    flip(recent, ConflictRecording::RECENT);
+    assert(recent.getConflictCount() == 9);
+    assert(recent.getConflicts().size() == 3);
+    assert(recent.getConflicts()[0].newProvenance.ruleFired == "Rule7");
+    assert(recent.getConflicts()[0].oldProvenance.ruleFired == "Rule6");
+    assert(recent.getConflicts()[2].newProvenance.ruleFired == "Rule9");
+    assert(recent.getConflicts()[2].oldValue == Tripartite::TRUE);
+
+    Proposition all;
+    flip(all, ConflictRecording::ALL);
+    assert(all.getConflicts().size() == 9);
+    all.clearConflicts();
+    assert(!all.hasConflicts());
+    assert(all.getConflictCount() == 0);
+
+    std::cout << "testConflictRecording passed.\n";
+}
+
 void testProvenanceInAssignment() {
     std::cout << "Running testProvenanceInAssignment..." << std::endl;
 
@@ -198,6 +251,56 @@ void testProvenanceInAssignment() {
     std::cout << "testProvenanceInAssignment passed.\n";
 }
 
+void testCopyAndMoveSemantics() {
+    std::cout << "Running testCopyAndMoveSemantics..." << std::endl;
+
+    // A plain fact has empty terms and no history
+    Proposition fact("P", Tripartite::TRUE);
+    assert(fact.getAntecedent().empty());
+    assert(fact.getPredicate().empty());
+    assert(!fact.hasProvenance());
+    assert(!fact.getProvenance().has_value());
+
+    Proposition rule;
+    rule.setPrefix("R");
+    rule.setRelation(LogicalOperator::IMPLIES);
+    rule.setAntecedent("P");
+    rule.setConsequent("Q");
+    rule.setTruthValue(Tripartite::TRUE, InferenceProvenance("DirectAssertion", {"fact"}));
+    rule.setTruthValue(Tripartite::FALSE, InferenceProvenance("ModusTollens", {"~Q"}));
+
+    // Copies are deep: changing the copy leaves the original intact
+    Proposition copy(rule);
+    copy.setAntecedent("X");
+    copy.clearConflicts();
+    copy.setTruthValue(Tripartite::UNKNOWN);
+    assert(rule.getAntecedent() == "P");
+    assert(rule.getConflicts().size() == 1);
+    assert(rule.getProvenance()->ruleFired == "ModusTollens");
+    assert(!copy.hasProvenance());
+
+    // Assigning a fact over a rule drops the rule's terms and history
+    copy = fact;
+    assert(copy.getAntecedent().empty());
+    assert(copy.getConsequent().empty());
+    assert(!copy.hasConflicts());
+
+    // Moves carry everything across
+    Proposition moved(std::move(rule));
+    assert(moved.getPrefix() == "R");
+    assert(moved.getConsequent() == "Q");
+    assert(moved.getConflicts().size() == 1);
+    assert(moved.getProvenance()->premises.size() == 1);
+
+    Proposition target;
+    target = std::move(moved);
+    assert(target.getAntecedent() == "P");
+    assert(target.getTruthValue() == Tripartite::FALSE);
+    assert(target.hasConflicts());
+
+    std::cout << "testCopyAndMoveSemantics passed.\n";
+}
+
 int main() {
     testPropositionAttributes();
     testPropositionAssertions();
@@ -205,7 +308,9 @@ int main() {
     testDisplay();
     testInferenceProvenance();
     testConflictDetection();
+    testConflictRecording();
     testProvenanceInAssignment();
+    testCopyAndMoveSemantics();
 
     std::cout << "All tests passed successfully.\n";
     return 0;
@@ -1,8 +1,35 @@
 #include "Ratiocinator.h"
 #include "Parser.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
+#include "OutputFile.h"
+#include "ResultIndex.h"
+#include "RuleBase.h"
+#include "Server.h"
+#include "TraceGraph.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 // Use paths relative to the project root (where tests are run from)
 #ifndef TEST_DATA_DIR
@@ -106,6 +133,168 @@ void testParseFactsFile() {
     std::cout << "Test passed: facts file parsed correctly." << std::endl;
 }
 
+// Test: files are read through a mapping; lines split like std::getline
+void testMappedFile() {
+    std::cout << "Running testMappedFile..." << std::endl;
+    
+    const std::string path = "mapped_file_test.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "first\r\n\nlast";
+    }
+    MappedFile file;
+    const bool opened = file.open(path);
+    assert(opened);
+    assert(file.isOpen());
+    assert(file.size() == 12);
+    assert(file.contents() == "first\r\n\nlast");
+    
+    std::vector<std::string> lines;
+    forEachLine(file.contents(), [&](std::string_view line) { lines.emplace_back(line); });
+    assert((lines == std::vector<std::string>{"first\r", "", "last"}));
+    
+    lines.clear();
+    forEachLine("a\nb\n", [&](std::string_view line) { lines.emplace_back(line); });
+    assert((lines == std::vector<std::string>{"a", "b"}));
+    
+    // Moving transfers the mapping
+    MappedFile moved(std::move(file));
+    assert(!file.isOpen());
+    assert(moved.contents().substr(0, 5) == "first");
+    moved.close();
+    assert(!moved.isOpen() && moved.contents().empty());
+    
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    }
+    const bool openedEmpty = file.open(path);
+    assert(openedEmpty);
+    assert(file.contents().empty());
+    file.close();
+    std::remove(path.c_str());
+    
+    const bool openedMissing = file.open("no_such_file_for_logoslab.txt");
+    assert(!openedMissing);
+    assert(!file.isOpen());
+    
+    std::cout << "Test passed: MappedFile maps files and splits lines." << std::endl;
+}
+
+// Test: parsing from memory matches the file format, including CRLF and odd spacing
+void testParseFromText() {
+    std::cout << "Running testParseFromText..." << std::endl;
+    
+    Parser parser;
+    std::unordered_map<std::string, Proposition> props;
+    parser.parseAssumptions("p, implies(light, red-shifted, universe, expanding)\r\n"
+                            "  q ,  some ( a b , c )  \n"
+                            "r,not(  y  ,)\n"
+                            "not a rule\n"
+                            "s, implies(4-forces, x, big-bang, y)", props);
+    assert(props.size() == 4);
+    assert(props["universe"].getAntecedent() == "light");
+    assert(props["universe"].getPredicate() == "expanding");
+    assert(props["a b"].getPrefix() == "q");
+    assert(props["a b"].getPredicate() == "c");
+    assert(props["y"].getRelation() == LogicalOperator::NOT);
+    assert(props["big-bang"].getAntecedent() == "4-forces");
+    
+    std::vector<Expression> exprs;
+    parser.parseFacts("light\r\n!y\nt = light && a\n\n(c || z) && !q", props, exprs);
+    assert(props["light"].getTruthValue() == Tripartite::TRUE);
+    assert(props["y"].getTruthValue() == Tripartite::FALSE);
+    assert(props["c"].getTruthValue() == Tripartite::TRUE);
+    assert(props["q"].getTruthValue() == Tripartite::FALSE);
+    assert(exprs.size() == 2);
+    assert(exprs[0].getPrefix() == "t");
+    
+    std::cout << "Test passed: parsing from text matches the file format." << std::endl;
+}
+
+// Parse with the given options, capturing diagnostics; returns "key:prefix:value" in map order
+static std::string parseWithOptions(const Parser::Options& opts, const std::string& assumptions,
+                                    const std::string& facts, std::vector<Expression>& exprs,
+                                    std::string& diagnostics) {
+    Parser parser(opts);
+    std::unordered_map<std::string, Proposition> props;
+    std::ostringstream errors;
+    std::streambuf* saved = std::cerr.rdbuf(errors.rdbuf());
+    parser.parseAssumptions(assumptions, props);
+    parser.parseFacts(facts, props, exprs);
+    std::cerr.rdbuf(saved);
+    diagnostics = errors.str();
+    
+    std::string dump;
+    for (const auto& entry : props) {
+        dump += entry.first + ":" + entry.second.getPrefix() + ":" + entry.second.getAntecedent() + ":" +
+                std::to_string(static_cast<int>(entry.second.getTruthValue())) + "\n";
+    }
+    return dump;
+}
+
+// Test: parallel chunked loading gives the serial result, order and diagnostics
+void testParallelParseMatchesSerial() {
+    std::cout << "Running testParallelParseMatchesSerial..." << std::endl;
+    
+    std::string assumptions;
+    std::string facts;
+    for (int i = 0; i < 200; ++i) {
+        std::string n = std::to_string(i);
+        assumptions += "p" + n + ", implies(a" + n + ", x, b" + n + ", y)\n";
+        if (i % 7 == 0) assumptions += "broken line " + n + "\n";
+        if (i % 11 == 0) assumptions += "d" + n + ", frobnicates(a" + n + ")\n";
+        // Redefinition: the later line must win in both modes
+        if (i % 5 == 0) assumptions += "q" + n + ", implies(c" + n + ", x, b" + n + ", y)\n";
+        
+        facts += (i % 2 ? "a" : "!a") + n + "\n";
+        if (i % 13 == 0) facts += "bad $ line\n\n";
+        if (i % 3 == 0) facts += "e" + n + " = a" + n + " || b" + n + "\n";
+        // Reassignment reads earlier values, so lines must apply in order
+        if (i % 4 == 0) facts += "a" + n + " = !a" + n + "\n";
+    }
+    
+    std::vector<Expression> serialExprs;
+    std::string serialErrors;
+    std::string serial = parseWithOptions(Parser::Options(), assumptions, facts, serialExprs, serialErrors);
+    
+    Parser::Options parallelOpts;
+    parallelOpts.threads = 4;
+    parallelOpts.chunkBytes = 64;
+    std::vector<Expression> parallelExprs;
+    std::string parallelErrors;
+    std::string parallel = parseWithOptions(parallelOpts, assumptions, facts, parallelExprs, parallelErrors);
+    
+    assert(parallel == serial);
+    assert(parallelErrors == serialErrors);
+    assert(!serialErrors.empty());
+    assert(parallelExprs.size() == serialExprs.size());
+    for (size_t i = 0; i < serialExprs.size(); ++i) {
+        assert(parallelExprs[i].getPrefix() == serialExprs[i].getPrefix());
+    }
+    
+    // Through the Ratiocinator, from files
+    const std::string assumptionsPath = "parallel_parse_assumptions.txt";
+    const std::string factsPath = "parallel_parse_facts.txt";
+    std::ofstream(assumptionsPath) << assumptions;
+    std::ofstream(factsPath) << facts;
+    Ratiocinator serialRat;
+    Ratiocinator parallelRat;
+    parallelRat.setParserOptions(parallelOpts);
+    assert(parallelRat.getParserOptions().threads == 4);
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);
+    for (Ratiocinator* rat : {&serialRat, &parallelRat}) {
+        rat->loadAssumptions(assumptionsPath);
+        rat->loadFacts(factsPath);
+        rat->deduce();
+    }
+    std::cerr.rdbuf(saved);
+    assert(parallelRat.formatResults() == serialRat.formatResults());
+    std::remove(assumptionsPath.c_str());
+    std::remove(factsPath.c_str());
+    
+    std::cout << "Test passed: parallel parsing matches the serial parser." << std::endl;
+}
+
 // ============================================================
 // INFERENCE TESTS - The brain of the Ratiocinator
 // ============================================================
@@ -597,6 +786,44 @@ void testExpressionsInDeduction() {
     std::cout << "Test passed: Expressions are used during deduction." << std::endl;
 }
 
+// Test: Expressions read values derived earlier in the same deduction
+void testExpressionsSeeDerivedValues() {
+    std::cout << "Running testExpressionsSeeDerivedValues..." << std::endl;
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        Ratiocinator rationator;
+        InferenceEngine::Options options;
+        options.strategy = strategy;
+        rationator.setInferenceOptions(options);
+        
+        Proposition result;
+        result.setPrefix("result");
+        result.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+        rationator.setProposition("result", result);
+        
+        // A -> B with A = TRUE; B is only known after Modus Ponens
+        Proposition imp;
+        imp.setPrefix("imp_AB");
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent("A");
+        imp.setConsequent("B");
+        rationator.setProposition("B", imp);
+        rationator.setPropositionTruthValue("A", Tripartite::TRUE);
+        
+        // Built while B is still UNKNOWN
+        Expression expr = rationator.addExpressionFromString("A && B", "result");
+        assert(expr.evaluate() == Tripartite::UNKNOWN);
+        
+        rationator.deduce();
+        
+        assert(rationator.getPropositionTruthValue("B") == Tripartite::TRUE);
+        assert(rationator.getPropositionTruthValue("result") == Tripartite::TRUE);
+    }
+    
+    std::cout << "Test passed: Expressions see derived values." << std::endl;
+}
+
 // ============================================================
 // INCREMENTAL API TESTS
 // ============================================================
@@ -1179,6 +1406,2442 @@ void testFluentFilterAPI() {
     std::cout << "Test passed: Fluent filter API works correctly." << std::endl;
 }
 
+// ============================================================
+// DEDUCTION STRATEGY TESTS
+// ============================================================
+
+// Build a knowledge base exercising every rule: an MP chain, an MT chain,
+// a disjunctive syllogism and a resolution pair
+void buildMixedKnowledgeBase(Ratiocinator& rationator) {
+    auto addImplication = [&](const std::string& ante, const std::string& cons) {
+        Proposition imp;
+        imp.setPrefix("imp_" + ante + "_" + cons);
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent(ante);
+        imp.setConsequent(cons);
+        rationator.setProposition(cons, imp);
+    };
+    auto addDisjunction = [&](const std::string& name, const std::string& left,
+                              const std::string& right) {
+        Proposition disj;
+        disj.setPrefix(name);
+        disj.setRelation(LogicalOperator::OR);
+        disj.setAntecedent(left);
+        disj.setConsequent(right);
+        rationator.setProposition(name, disj);
+    };
+    
+    // A0 -> A1 -> ... -> A20, A0 = TRUE
+    for (int i = 1; i <= 20; ++i) {
+        addImplication("A" + std::to_string(i - 1), "A" + std::to_string(i));
+    }
+    rationator.setPropositionTruthValue("A0", Tripartite::TRUE);
+    
+    // B0 -> B1 -> ... -> B10, B10 = FALSE
+    for (int i = 1; i <= 10; ++i) {
+        addImplication("B" + std::to_string(i - 1), "B" + std::to_string(i));
+    }
+    rationator.setPropositionTruthValue("B10", Tripartite::FALSE);
+    
+    // B0 || C, with B0 derived FALSE ⊢ C; C -> D
+    addDisjunction("disj_B0C", "B0", "C");
+    addImplication("C", "D");
+    
+    // P || Q, ~P || R, Q = FALSE ⊢ R
+    addDisjunction("disj_PQ", "P", "Q");
+    addDisjunction("disj_nPR", "~P", "R");
+    rationator.setPropositionTruthValue("Q", Tripartite::FALSE);
+}
+
+// Everything observable about a deduction, in the map's iteration order
+std::vector<std::string> describeKnowledgeBase(const Ratiocinator& rationator) {
+    std::vector<std::string> lines;
+    for (const auto& entry : rationator.getPropositions()) {
+        const Proposition& prop = entry.second;
+        std::string line = entry.first + "=" + std::to_string(static_cast<int>(prop.getTruthValue()));
+        if (prop.hasProvenance()) {
+            line += " ";
+            line += prop.getProvenance()->ruleFired;
+            for (const std::string& premise : prop.getProvenance()->premises) {
+                line += " " + premise;
+            }
+        }
+        line += " conflicts=" + std::to_string(prop.getConflicts().size());
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// X0 -> X1 -> ... -> X(links), links added in a scrambled order so the rules'
+// knowledge base order does not follow the chain
+void buildScrambledChain(Ratiocinator& rationator, int links) {
+    for (int k = 0; k < links; ++k) {
+        int i = 1 + (k * 3) % links;  // links is not a multiple of 3
+        Proposition imp;
+        imp.setPrefix("imp_X" + std::to_string(i));
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent("X" + std::to_string(i - 1));
+        imp.setConsequent("X" + std::to_string(i));
+        rationator.setProposition("X" + std::to_string(i), imp);
+    }
+    rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+}
+
+// Test: WORKLIST reaches the same fixed point as FULL_SWEEP, with the same provenance
+void testWorklistMatchesFullSweep() {
+    std::cout << "Running testWorklistMatchesFullSweep..." << std::endl;
+    
+    Ratiocinator sweep;
+    InferenceEngine::Options sweepOptions;
+    sweepOptions.strategy = DeductionStrategy::FULL_SWEEP;
+    sweep.setInferenceOptions(sweepOptions);
+    buildMixedKnowledgeBase(sweep);
+    buildScrambledChain(sweep, 8);
+    sweep.deduce();
+    
+    Ratiocinator worklist;
+    assert(worklist.getInferenceOptions().strategy == DeductionStrategy::WORKLIST);
+    buildMixedKnowledgeBase(worklist);
+    buildScrambledChain(worklist, 8);
+    worklist.deduce();
+    
+    assert(sweep.getPropositionCount() == worklist.getPropositionCount());
+    assert(describeKnowledgeBase(worklist) == describeKnowledgeBase(sweep));
+    
+    assert(worklist.getPropositionTruthValue("A20") == Tripartite::TRUE);
+    assert(worklist.getPropositionTruthValue("B0") == Tripartite::FALSE);
+    assert(worklist.getPropositionTruthValue("D") == Tripartite::TRUE);
+    assert(worklist.getPropositionTruthValue("R") == Tripartite::TRUE);
+    assert(worklist.getPropositionTruthValue("X8") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: WORKLIST matches FULL_SWEEP." << std::endl;
+}
+
+// Test: WORKLIST fires the rule a FULL_SWEEP pass fires for each link of a chain,
+// Hypothetical Syllogism included, whatever order the links are stored in
+void testWorklistChainProvenance() {
+    std::cout << "Running testWorklistChainProvenance..." << std::endl;
+    
+    for (int links : {4, 5, 7, 11}) {
+        Ratiocinator sweep;
+        InferenceEngine::Options sweepOptions;
+        sweepOptions.strategy = DeductionStrategy::FULL_SWEEP;
+        sweep.setInferenceOptions(sweepOptions);
+        buildScrambledChain(sweep, links);
+        sweep.deduce();
+        
+        Ratiocinator worklist;
+        buildScrambledChain(worklist, links);
+        worklist.deduce();
+        
+        for (int i = 1; i <= links; ++i) {
+            std::string name = "X" + std::to_string(i);
+            const Proposition* expected = sweep.getProposition(name);
+            const Proposition* actual = worklist.getProposition(name);
+            assert(actual->getTruthValue() == Tripartite::TRUE);
+            assert(actual->hasProvenance() && expected->hasProvenance());
+            assert(actual->getProvenance()->ruleFired == expected->getProvenance()->ruleFired);
+            assert(actual->getProvenance()->premises == expected->getProvenance()->premises);
+        }
+        assert(worklist.formatTrace("X" + std::to_string(links)) ==
+               sweep.formatTrace("X" + std::to_string(links)));
+    }
+    
+    std::cout << "Test passed: WORKLIST chain provenance matches FULL_SWEEP." << std::endl;
+}
+
+// Test: TOPOLOGICAL reaches FULL_SWEEP's fixed point in one pass over acyclic bases
+void testTopologicalSinglePass() {
+    std::cout << "Running testTopologicalSinglePass..." << std::endl;
+    
+    auto deduceWith = [](DeductionStrategy strategy, Ratiocinator& rationator,
+                         const std::function<void(Ratiocinator&)>& build) {
+        InferenceEngine::Options options;
+        options.strategy = strategy;
+        rationator.setInferenceOptions(options);
+        build(rationator);
+        rationator.deduce();
+        return rationator.getConvergence();
+    };
+    // Links added last to first, so an unordered sweep meets them backwards
+    auto reversedChain = [](Ratiocinator& rationator) {
+        for (int i = 40; i >= 1; --i) {
+            Proposition imp;
+            imp.setPrefix("imp_L" + std::to_string(i));
+            imp.setRelation(LogicalOperator::IMPLIES);
+            imp.setAntecedent("L" + std::to_string(i - 1));
+            imp.setConsequent("L" + std::to_string(i));
+            rationator.setProposition("L" + std::to_string(i), imp);
+        }
+        rationator.setPropositionTruthValue("L0", Tripartite::TRUE);
+    };
+    
+    for (const auto& build : std::vector<std::function<void(Ratiocinator&)>>{
+             buildMixedKnowledgeBase, reversedChain}) {
+        Ratiocinator sweep;
+        InferenceEngine::Convergence swept = deduceWith(DeductionStrategy::FULL_SWEEP, sweep, build);
+        Ratiocinator ordered;
+        InferenceEngine::Convergence topological = deduceWith(DeductionStrategy::TOPOLOGICAL, ordered, build);
+        
+        assert(topological.converged);
+        assert(topological.passes == 1);
+        assert(swept.passes == swept.iterations);
+        assert(sweep.getPropositionCount() == ordered.getPropositionCount());
+        for (const auto& entry : sweep.getPropositions()) {
+            const Proposition* other = ordered.getProposition(entry.first);
+            assert(other != nullptr);
+            assert(other->getTruthValue() == entry.second.getTruthValue());
+        }
+    }
+    
+    // Each link of the chain is applied once, in order
+    Ratiocinator chain;
+    InferenceEngine::Convergence convergence = deduceWith(DeductionStrategy::TOPOLOGICAL, chain, reversedChain);
+    assert(chain.getPropositionTruthValue("L40") == Tripartite::TRUE);
+    assert(convergence.iterations <= 2 * 40);
+    const Proposition* last = chain.getProposition("L40");
+    assert(last->getProvenance()->ruleFired == "ModusPonens");
+    
+    // A cycle still iterates to its fixed point: X -> Y -> Z -> X with Y = TRUE
+    Ratiocinator cycle;
+    convergence = deduceWith(DeductionStrategy::TOPOLOGICAL, cycle, [](Ratiocinator& rationator) {
+        const char* names[] = {"X", "Y", "Z"};
+        for (int i = 0; i < 3; ++i) {
+            Proposition imp;
+            imp.setPrefix(std::string("imp_") + names[i]);
+            imp.setRelation(LogicalOperator::IMPLIES);
+            imp.setAntecedent(names[i]);
+            imp.setConsequent(names[(i + 1) % 3]);
+            rationator.setProposition(names[(i + 1) % 3], imp);
+        }
+        rationator.setPropositionTruthValue("Y", Tripartite::TRUE);
+    });
+    assert(convergence.passes == 1);
+    assert(cycle.getPropositionTruthValue("X") == Tripartite::TRUE);
+    assert(cycle.getPropositionTruthValue("Z") == Tripartite::TRUE);
+    
+    // No passes to report for the worklist
+    Ratiocinator worklist;
+    convergence = deduceWith(DeductionStrategy::WORKLIST, worklist, reversedChain);
+    assert(convergence.passes == 0);
+    
+    std::cout << "Test passed: TOPOLOGICAL needs one pass over acyclic bases." << std::endl;
+}
+
+// ============================================================
+// LITERAL INDEX AND SYMBOL TABLE TESTS
+// ============================================================
+
+// Test: LiteralIndex lookups respect position and polarity
+void testLiteralIndexLookups() {
+    std::cout << "Running testLiteralIndexLookups..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildMixedKnowledgeBase(rationator);
+    const LiteralIndex& index = rationator.getLiteralIndex();
+    
+    // 31 implications, 3 disjunctions
+    assert(index.ruleCount() == 34);
+    
+    const auto& fromA3 = index.implicationsWithAntecedent("A3");
+    assert(fromA3.size() == 1);
+    assert(index.ruleKey(fromA3[0]) == "A4");
+    
+    const auto& intoA3 = index.implicationsWithConsequent("A3");
+    assert(intoA3.size() == 1);
+    assert(index.ruleKey(intoA3[0]) == "A3");
+    
+    assert(index.implicationsWithAntecedent("A20").empty());
+    assert(index.implicationsWithAntecedent("~A3").empty());
+    
+    // B0 is both an antecedent and a disjunct
+    assert(index.implicationsWithAntecedent("B0").size() == 1);
+    assert(index.disjunctionsContaining("B0").size() == 1);
+    
+    // P and ~P are distinct literals; each is the other's complement
+    assert(index.disjunctionsContaining("P").size() == 1);
+    assert(index.disjunctionsContaining("~P").size() == 1);
+    assert(index.disjunctionsContaining("!P").size() == 1);
+    const auto& complement = index.disjunctionsContainingComplement("P");
+    assert(complement.size() == 1);
+    assert(index.ruleKey(complement[0]) == "disj_nPR");
+    
+    assert(index.disjunctionsContaining("unknownLiteral").empty());
+    
+    std::cout << "Test passed: LiteralIndex lookups are correct." << std::endl;
+}
+
+// Test: addProposition/removeProposition keep the index in step
+void testLiteralIndexMaintenance() {
+    std::cout << "Running testLiteralIndexMaintenance..." << std::endl;
+    
+    Ratiocinator rationator;
+    
+    Proposition imp;
+    imp.setPrefix("imp_X_Y");
+    imp.setRelation(LogicalOperator::IMPLIES);
+    imp.setAntecedent("X");
+    imp.setConsequent("Y");
+    const bool added = rationator.addProposition("Y", imp);
+    assert(added);
+    assert(rationator.getLiteralIndex().ruleCount() == 1);
+    
+    // Replacing a rule with a plain proposition unindexes it
+    Proposition plain;
+    plain.setPrefix("Y");
+    rationator.setProposition("Y", plain);
+    assert(rationator.getLiteralIndex().ruleCount() == 0);
+    assert(rationator.getLiteralIndex().implicationsWithAntecedent("X").empty());
+    
+    rationator.setProposition("Y", imp);
+    assert(rationator.getLiteralIndex().implicationsWithAntecedent("X").size() == 1);
+    
+    const bool removed = rationator.removeProposition("Y");
+    assert(removed);
+    assert(rationator.getLiteralIndex().ruleCount() == 0);
+    assert(rationator.getLiteralIndex().implicationsWithAntecedent("X").empty());
+    
+    // Editing a rule through the mutable accessor is picked up before deduce
+    rationator.setProposition("Y", imp);
+    rationator.getProposition("Y")->setAntecedent("Z");
+    assert(rationator.getLiteralIndex().implicationsWithAntecedent("X").empty());
+    assert(rationator.getLiteralIndex().implicationsWithAntecedent("Z").size() == 1);
+    
+    rationator.clearPropositions();
+    assert(rationator.getLiteralIndex().ruleCount() == 0);
+    
+    std::cout << "Test passed: literal index follows the knowledge base." << std::endl;
+}
+
+// Test: deduce uses the maintained index after rules are added and removed
+void testDeduceAfterIndexUpdates() {
+    std::cout << "Running testDeduceAfterIndexUpdates..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildMixedKnowledgeBase(rationator);
+    
+    // Break the A chain at A10 and the resolution pair
+    const bool removedLink = rationator.removeProposition("A10");
+    const bool removedPair = rationator.removeProposition("disj_nPR");
+    assert(removedLink && removedPair);
+    rationator.deduce();
+    
+    assert(rationator.getPropositionTruthValue("A9") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("A11") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("A20") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("R") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("D") == Tripartite::TRUE);
+    
+    // Repair the chain with a new key; the index reuses the freed slot
+    Proposition bridge;
+    bridge.setPrefix("bridge");
+    bridge.setRelation(LogicalOperator::IMPLIES);
+    bridge.setAntecedent("A9");
+    bridge.setConsequent("A11");
+    const bool bridged = rationator.addProposition("bridge", bridge);
+    assert(bridged);
+    rationator.deduce();
+    
+    assert(rationator.getPropositionTruthValue("A11") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("A20") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: deduce follows index updates." << std::endl;
+}
+
+// Test: SymbolTable hands out dense literal ids with a negation bit
+void testSymbolTableInterning() {
+    std::cout << "Running testSymbolTableInterning..." << std::endl;
+    
+    SymbolTable symbols;
+    PropId p = symbols.intern("P");
+    PropId q = symbols.intern("Q");
+    assert(p != q);
+    assert(!isNegatedId(p));
+    assert(symbols.intern("P") == p);
+    
+    // Both negation spellings name the same literal, adjacent to the positive one
+    PropId notP = symbols.intern("~P");
+    assert(notP == negateId(p));
+    assert(isNegatedId(notP));
+    assert(positiveId(notP) == p);
+    assert(symbols.intern("!P") == notP);
+    assert(symbols.name(notP) == "~P");
+    
+    // A symbol first seen negated is interned with both literals
+    PropId notR = symbols.intern("!R");
+    assert(isNegatedId(notR));
+    assert(symbols.name(notR) == "!R");
+    assert(symbols.name(negateId(notR)) == "R");
+    
+    assert(symbols.symbolCount() == 3);
+    assert(symbols.idCount() == 6);
+    
+    PropId found;
+    assert(symbols.find("Q", found) && found == q);
+    assert(symbols.find("~Q", found) && found == negateId(q));
+    assert(!symbols.find("S", found));
+    
+    symbols.clear();
+    assert(symbols.idCount() == 0);
+    assert(!symbols.find("P", found));
+    
+    std::cout << "Test passed: SymbolTable interning is correct." << std::endl;
+}
+
+// Test: deduction treats "~P" and "!P" as the same literal of P
+void testNegationSpellings() {
+    std::cout << "Running testNegationSpellings..." << std::endl;
+    
+    Ratiocinator rationator;
+    auto addDisjunction = [&](const std::string& name, const std::string& left,
+                              const std::string& right) {
+        Proposition disj;
+        disj.setPrefix(name);
+        disj.setRelation(LogicalOperator::OR);
+        disj.setAntecedent(left);
+        disj.setConsequent(right);
+        rationator.setProposition(name, disj);
+    };
+    
+    // P || Q, !P || R, Q = FALSE ⊢ R
+    addDisjunction("disj_PQ", "P", "Q");
+    addDisjunction("disj_nPR", "!P", "R");
+    rationator.setPropositionTruthValue("Q", Tripartite::FALSE);
+    rationator.deduce();
+    
+    assert(rationator.getPropositionTruthValue("R") == Tripartite::TRUE);
+    assert(rationator.getProposition("R")->getProvenance()->ruleFired == "Resolution");
+    
+    // ~S || T, T = FALSE ⊢ ~S, stored under the spelling the rule used
+    addDisjunction("disj_nST", "~S", "T");
+    rationator.setPropositionTruthValue("T", Tripartite::FALSE);
+    rationator.deduce();
+    
+    assert(rationator.hasProposition("~S"));
+    assert(rationator.getPropositionTruthValue("~S") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: negation spellings share a literal." << std::endl;
+}
+
+// ============================================================
+// PARALLEL DEDUCTION TESTS
+// ============================================================
+
+// Independent tenants: chains, disjunctions, conflicts, expressions and
+// propositions that only exist once derived
+void buildTenantKnowledgeBase(Ratiocinator& rationator, int tenants) {
+    auto addRule = [&](const std::string& key, LogicalOperator relation,
+                       const std::string& left, const std::string& right) {
+        Proposition rule;
+        rule.setPrefix(key);
+        rule.setRelation(relation);
+        rule.setAntecedent(left);
+        rule.setConsequent(right);
+        rationator.setProposition(key, rule);
+    };
+    
+    for (int t = 0; t < tenants; ++t) {
+        std::string id = std::to_string(t);
+        for (int i = 1; i <= 5; ++i) {
+            std::string prev = "A" + id + "_" + std::to_string(i - 1);
+            std::string curr = "A" + id + "_" + std::to_string(i);
+            addRule(curr, LogicalOperator::IMPLIES, prev, curr);
+        }
+        rationator.setPropositionTruthValue("A" + id + "_0", Tripartite::TRUE);
+        
+        // B || C with B FALSE ⊢ C, where C does not exist yet
+        addRule("disj_BC" + id, LogicalOperator::OR, "B" + id, "C" + id);
+        rationator.setPropositionTruthValue("B" + id, Tripartite::FALSE);
+        
+        // X -> Y with X TRUE and Y FALSE records conflicts
+        addRule("imp_XY" + id, LogicalOperator::IMPLIES, "X" + id, "Y" + id);
+        rationator.setPropositionTruthValue("X" + id, Tripartite::TRUE);
+        rationator.setPropositionTruthValue("Y" + id, Tripartite::FALSE);
+        
+        Proposition result;
+        result.setPrefix("result" + id);
+        result.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+        rationator.setProposition("result" + id, result);
+        rationator.addExpressionFromString("A" + id + "_5 && C" + id, "result" + id);
+    }
+}
+
+// Test: Results do not depend on the number of threads
+void testParallelDeductionDeterministic() {
+    std::cout << "Running testParallelDeductionDeterministic..." << std::endl;
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        std::vector<std::string> reference;
+        for (size_t threads : {1, 2, 3, 8, 0}) {
+            Ratiocinator rationator;
+            InferenceEngine::Options options;
+            options.strategy = strategy;
+            options.threads = threads;
+            rationator.setInferenceOptions(options);
+            buildTenantKnowledgeBase(rationator, 12);
+            buildMixedKnowledgeBase(rationator);
+            rationator.deduce();
+            
+            assert(rationator.getPropositionTruthValue("A11_5") == Tripartite::TRUE);
+            assert(rationator.getPropositionTruthValue("C7") == Tripartite::TRUE);
+            assert(rationator.getPropositionTruthValue("result3") == Tripartite::TRUE);
+            assert(rationator.getProposition("Y5")->hasConflicts());
+            assert(rationator.getPropositionTruthValue("R") == Tripartite::TRUE);
+            
+            std::vector<std::string> description = describeKnowledgeBase(rationator);
+            if (reference.empty()) {
+                reference = description;
+            }
+            assert(description == reference);
+        }
+    }
+    
+    std::cout << "Test passed: parallel deduction is deterministic." << std::endl;
+}
+
+// Test: Repeated parallel deductions reuse the engine's threads
+void testParallelDeductionRepeated() {
+    std::cout << "Running testParallelDeductionRepeated..." << std::endl;
+    
+    Ratiocinator rationator;
+    InferenceEngine::Options options;
+    options.threads = 4;
+    rationator.setInferenceOptions(options);
+    buildTenantKnowledgeBase(rationator, 6);
+    rationator.deduce();
+    
+    // New facts in one tenant only affect that tenant
+    rationator.setPropositionTruthValue("B2", Tripartite::TRUE);
+    rationator.setPropositionTruthValue("A4_0", Tripartite::FALSE);
+    rationator.deduce();
+    assert(rationator.getPropositionTruthValue("A1_5") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("C3") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: repeated parallel deductions." << std::endl;
+}
+
+// ============================================================
+// INCREMENTAL DEDUCTION TESTS
+// ============================================================
+
+// X0 -> X1 -> X2 -> X3, each rule keyed by its own name
+void buildChainKnowledgeBase(Ratiocinator& rationator) {
+    for (int i = 1; i <= 3; ++i) {
+        std::string prev = "X" + std::to_string(i - 1);
+        std::string curr = "X" + std::to_string(i);
+        Proposition imp;
+        imp.setPrefix("imp_" + prev + "_" + curr);
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent(prev);
+        imp.setConsequent(curr);
+        rationator.setProposition(imp.getPrefix(), imp);
+    }
+}
+
+// Test: deduceIncremental propagates new facts like a full deduction
+void testDeduceIncrementalPropagates() {
+    std::cout << "Running testDeduceIncrementalPropagates..." << std::endl;
+    
+    Ratiocinator incremental;
+    buildChainKnowledgeBase(incremental);
+    buildMixedKnowledgeBase(incremental);
+    incremental.deduceIncremental();  // First call is a full deduction
+    assert(incremental.getPropositionTruthValue("A20") == Tripartite::TRUE);
+    assert(incremental.getPropositionTruthValue("X3") == Tripartite::UNKNOWN);
+    
+    incremental.setPropositionTruthValue("X0", Tripartite::TRUE);
+    incremental.deduceIncremental();
+    assert(incremental.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    assert(incremental.getProposition("X3")->getProvenance()->ruleFired == "ModusPonens");
+    
+    // A rule added later fires on existing facts: X3 -> X4
+    Proposition imp;
+    imp.setPrefix("imp_X3_X4");
+    imp.setRelation(LogicalOperator::IMPLIES);
+    imp.setAntecedent("X3");
+    imp.setConsequent("X4");
+    const bool added = incremental.addProposition(imp.getPrefix(), imp);
+    assert(added);
+    incremental.deduceIncremental();
+    assert(incremental.getPropositionTruthValue("X4") == Tripartite::TRUE);
+    
+    // Same values as deducing the final knowledge base from scratch
+    Ratiocinator full;
+    buildChainKnowledgeBase(full);
+    buildMixedKnowledgeBase(full);
+    full.setPropositionTruthValue("X0", Tripartite::TRUE);
+    full.addProposition(imp.getPrefix(), imp);
+    full.deduce();
+    for (const auto& entry : full.getPropositions()) {
+        assert(incremental.getPropositionTruthValue(entry.first) == entry.second.getTruthValue());
+    }
+    assert(incremental.getPropositionCount() == full.getPropositionCount());
+    
+    std::cout << "Test passed: deduceIncremental propagates new facts." << std::endl;
+}
+
+// Test: Flipped and removed facts retract what was derived from them
+void testDeduceIncrementalRetracts() {
+    std::cout << "Running testDeduceIncrementalRetracts..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+    rationator.deduce();
+    assert(rationator.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    
+    // Flipping X0 withdraws the support for the whole chain
+    rationator.updatePropositionTruthValue("X0", Tripartite::FALSE, InferenceProvenance());
+    rationator.deduceIncremental();
+    for (const char* name : {"X1", "X2", "X3"}) {
+        assert(rationator.getPropositionTruthValue(name) == Tripartite::UNKNOWN);
+        assert(!rationator.hasInferenceProvenance(name));
+    }
+    
+    // Values with other support are re-derived: Y -> X2, Y = TRUE
+    Proposition imp;
+    imp.setPrefix("imp_Y_X2");
+    imp.setRelation(LogicalOperator::IMPLIES);
+    imp.setAntecedent("Y");
+    imp.setConsequent("X2");
+    rationator.setProposition(imp.getPrefix(), imp);
+    rationator.setPropositionTruthValue("Y", Tripartite::TRUE);
+    rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+    rationator.deduceIncremental();
+    assert(rationator.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    
+    rationator.removeProposition("X0");
+    rationator.deduceIncremental();
+    assert(rationator.getPropositionTruthValue("X1") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("X2") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    
+    // Removing a rule retracts what was derived through it
+    rationator.removeProposition("imp_Y_X2");
+    rationator.deduceIncremental();
+    assert(rationator.getPropositionTruthValue("X2") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("X3") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("Y") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: deduceIncremental retracts unsupported values." << std::endl;
+}
+
+// Test: Incremental expressions and disjunctions
+void testDeduceIncrementalExpressions() {
+    std::cout << "Running testDeduceIncrementalExpressions..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildMixedKnowledgeBase(rationator);
+    Proposition result;
+    result.setPrefix("result");
+    result.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+    rationator.setProposition("result", result);
+    rationator.addExpressionFromString("R && S", "result");
+    rationator.deduce();
+    assert(rationator.getPropositionTruthValue("R") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("result") == Tripartite::UNKNOWN);
+    
+    rationator.setPropositionTruthValue("S", Tripartite::TRUE);
+    rationator.deduceIncremental();
+    assert(rationator.getPropositionTruthValue("result") == Tripartite::TRUE);
+    
+    // Q no longer FALSE: R loses its Resolution support
+    rationator.setPropositionTruthValue("Q", Tripartite::UNKNOWN);
+    rationator.deduceIncremental();
+    assert(rationator.getPropositionTruthValue("R") == Tripartite::UNKNOWN);
+    
+    std::cout << "Test passed: deduceIncremental with expressions and disjunctions." << std::endl;
+}
+
+// Engine options with the given provenance level
+InferenceEngine::Options provenanceOptions(ProvenanceLevel level) {
+    InferenceEngine::Options options;
+    options.provenance = level;
+    return options;
+}
+
+// Test: every provenance level reaches the same values; compact traces match full ones
+void testProvenanceLevels() {
+    std::cout << "Running testProvenanceLevels..." << std::endl;
+    
+    Ratiocinator full;
+    buildMixedKnowledgeBase(full);
+    full.deduce();
+    
+    Ratiocinator compact;
+    compact.setInferenceOptions(provenanceOptions(ProvenanceLevel::COMPACT));
+    buildMixedKnowledgeBase(compact);
+    compact.deduce();
+    
+    Ratiocinator none;
+    none.setInferenceOptions(provenanceOptions(ProvenanceLevel::NONE));
+    buildMixedKnowledgeBase(none);
+    none.deduce();
+    
+    assert(compact.getPropositionCount() == full.getPropositionCount());
+    assert(none.getPropositionCount() == full.getPropositionCount());
+    for (const auto& entry : full.getPropositions()) {
+        const Proposition* c = compact.getProposition(entry.first);
+        const Proposition* n = none.getProposition(entry.first);
+        assert(c != nullptr && n != nullptr);
+        assert(c->getTruthValue() == entry.second.getTruthValue());
+        assert(n->getTruthValue() == entry.second.getTruthValue());
+        assert(!n->hasProvenance());
+        
+        assert(c->hasProvenance() == entry.second.hasProvenance());
+        if (c->hasProvenance()) {
+            const InferenceProvenance& fullProv = *entry.second.getProvenance();
+            const InferenceProvenance& compactProv = *c->getProvenance();
+            assert(compactProv.rule == fullProv.rule);
+            assert(compactProv.ruleFired == fullProv.ruleFired);
+            assert(compactProv.premises.empty());
+            assert(compactProv.premiseIdCount == fullProv.premises.size());
+        }
+    }
+    assert(full.getProposition("A20")->hasProvenance());
+    
+    // Where rules are keyed by their prefix, compact traces name the same premises
+    Ratiocinator chainFull;
+    Ratiocinator chainCompact;
+    chainCompact.setInferenceOptions(provenanceOptions(ProvenanceLevel::COMPACT));
+    for (Ratiocinator* rationator : {&chainFull, &chainCompact}) {
+        buildChainKnowledgeBase(*rationator);
+        rationator->setPropositionTruthValue("X0", Tripartite::TRUE);
+        rationator->deduce();
+    }
+    std::vector<InferenceStep> fullTrace = chainFull.traceInference("X3");
+    std::vector<InferenceStep> compactTrace = chainCompact.traceInference("X3");
+    assert(fullTrace.size() == compactTrace.size());
+    for (size_t i = 0; i < fullTrace.size(); ++i) {
+        assert(compactTrace[i].proposition == fullTrace[i].proposition);
+        assert(compactTrace[i].rule == fullTrace[i].rule);
+        assert(compactTrace[i].premises == fullTrace[i].premises);
+    }
+    
+    std::cout << "Test passed: provenance levels agree on values and traces." << std::endl;
+}
+
+// Test: incremental retraction works with compact provenance and falls back without any
+void testDeduceIncrementalProvenanceLevels() {
+    std::cout << "Running testDeduceIncrementalProvenanceLevels..." << std::endl;
+    
+    for (ProvenanceLevel level : {ProvenanceLevel::COMPACT, ProvenanceLevel::NONE}) {
+        Ratiocinator rationator;
+        rationator.setInferenceOptions(provenanceOptions(level));
+        buildChainKnowledgeBase(rationator);
+        rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+        rationator.deduce();
+        assert(rationator.getPropositionTruthValue("X3") == Tripartite::TRUE);
+        
+        rationator.removeProposition("imp_X1_X2");
+        rationator.deduceIncremental();
+        assert(rationator.getPropositionTruthValue("X1") == Tripartite::TRUE);
+        if (level == ProvenanceLevel::COMPACT) {
+            assert(rationator.getPropositionTruthValue("X2") == Tripartite::UNKNOWN);
+            assert(rationator.getPropositionTruthValue("X3") == Tripartite::UNKNOWN);
+        }
+        
+        rationator.updatePropositionTruthValue("X0", Tripartite::FALSE, InferenceProvenance());
+        rationator.deduceIncremental();
+        if (level == ProvenanceLevel::COMPACT) {
+            assert(rationator.getPropositionTruthValue("X1") == Tripartite::UNKNOWN);
+        }
+    }
+    
+    std::cout << "Test passed: deduceIncremental honours the provenance level." << std::endl;
+}
+
+// Assert two knowledge bases hold the same propositions, provenance and expressions
+static void assertSameKnowledgeBase(const Ratiocinator& a, const Ratiocinator& b) {
+    assert(a.getPropositionCount() == b.getPropositionCount());
+    for (const auto& entry : a.getPropositions()) {
+        const Proposition* other = b.getProposition(entry.first);
+        assert(other != nullptr);
+        assert(*other == entry.second);
+        assert(other->getPrefix() == entry.second.getPrefix());
+        assert(other->getRelation() == entry.second.getRelation());
+        assert(other->getPropositionScope() == entry.second.getPropositionScope());
+        assert(other->getAntecedent() == entry.second.getAntecedent());
+        assert(other->getSubject() == entry.second.getSubject());
+        assert(other->getConsequent() == entry.second.getConsequent());
+        assert(other->getPredicate() == entry.second.getPredicate());
+        assert(other->hasProvenance() == entry.second.hasProvenance());
+        if (other->hasProvenance()) {
+            const InferenceProvenance& expected = *entry.second.getProvenance();
+            const InferenceProvenance& actual = *other->getProvenance();
+            assert(actual.rule == expected.rule);
+            assert(actual.ruleFired == expected.ruleFired);
+            assert(actual.premises == expected.premises);
+            assert(actual.premiseIdCount == expected.premiseIdCount);
+            for (size_t i = 0; i < expected.premiseIdCount; ++i) {
+                assert(actual.premiseIds[i] == expected.premiseIds[i]);
+            }
+        }
+    }
+    assert(a.getExpressionCount() == b.getExpressionCount());
+    for (size_t i = 0; i < a.getExpressionCount(); ++i) {
+        assert(a.getExpressions()[i].getPrefix() == b.getExpressions()[i].getPrefix());
+    }
+}
+
+// Test: a snapshot restores the deduced knowledge base, symbols and traces
+void testSnapshotRoundTrip() {
+    std::cout << "Running testSnapshotRoundTrip..." << std::endl;
+    const std::string path = "snapshot_round_trip.snap";
+    
+    for (ProvenanceLevel level : {ProvenanceLevel::FULL, ProvenanceLevel::COMPACT}) {
+        Ratiocinator original;
+        original.setInferenceOptions(provenanceOptions(level));
+        original.loadAssumptions(assumptionsFile);
+        original.loadFacts(factsFile);
+        buildChainKnowledgeBase(original);
+        original.setPropositionTruthValue("X0", Tripartite::TRUE);
+        original.setPropositionTruthValue("!Y", Tripartite::FALSE);
+        original.setPropositionTruthValue("manual", Tripartite::UNKNOWN);
+        original.updatePropositionTruthValue("manual", Tripartite::TRUE,
+                                             InferenceProvenance("Observation", {"X0"}, 0.5f));
+        original.deduce();
+        const bool saved = original.saveSnapshot(path);
+        assert(saved);
+        
+        Ratiocinator restored;
+        restored.setInferenceOptions(provenanceOptions(level));
+        const bool loaded = restored.loadSnapshot(path);
+        assert(loaded);
+        assertSameKnowledgeBase(original, restored);
+        const Proposition* manual = static_cast<const Ratiocinator&>(restored).getProposition("manual");
+        assert(manual->getProvenance()->ruleFired == "Observation");
+        assert(manual->getProvenance()->confidence == 0.5f);
+        
+        // Literal ids are preserved, so compact provenance resolves to the same names
+        const SymbolTable& before = original.getLiteralIndex().symbols();
+        const SymbolTable& after = restored.getLiteralIndex().symbols();
+        assert(after.idCount() == before.idCount());
+        for (PropId id = 0; id < before.idCount(); ++id) {
+            assert(after.name(id) == before.name(id));
+        }
+        assert(restored.formatTrace("X3") == original.formatTrace("X3"));
+        assert(restored.formatResults(ResultFilter()) == original.formatResults(ResultFilter()));
+        
+        // The restored base continues incrementally, like the original
+        for (Ratiocinator* rationator : {&original, &restored}) {
+            rationator->removeProposition("imp_X1_X2");
+            rationator->deduceIncremental();
+        }
+        assert(restored.getPropositionTruthValue("X3") == original.getPropositionTruthValue("X3"));
+        assert(restored.getPropositionTruthValue("X2") == original.getPropositionTruthValue("X2"));
+    }
+    
+    // Without provenance only the values are restored
+    Ratiocinator original;
+    buildChainKnowledgeBase(original);
+    original.setPropositionTruthValue("X0", Tripartite::TRUE);
+    original.deduce();
+    const bool saved = original.saveSnapshot(path, false);
+    assert(saved);
+    Ratiocinator restored;
+    const bool loaded = restored.loadSnapshot(path);
+    assert(loaded);
+    assert(restored.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    assert(!restored.hasInferenceProvenance("X3"));
+    restored.setPropositionTruthValue("X4", Tripartite::UNKNOWN);
+    restored.deduceIncremental();
+    assert(restored.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    
+    std::remove(path.c_str());
+    std::cout << "Test passed: snapshots round-trip the knowledge base." << std::endl;
+}
+
+// Test: missing, foreign and truncated snapshots are rejected without changing the base
+void testSnapshotRejectsInvalidFiles() {
+    std::cout << "Running testSnapshotRejectsInvalidFiles..." << std::endl;
+    const std::string path = "snapshot_invalid.snap";
+    
+    Ratiocinator source;
+    buildChainKnowledgeBase(source);
+    source.deduce();
+    const bool written = source.saveSnapshot(path);
+    assert(written);
+    std::string bytes;
+    {
+        MappedFile file(path);
+        bytes.assign(file.contents());
+    }
+    
+    Ratiocinator rationator;
+    rationator.setPropositionTruthValue("kept", Tripartite::TRUE);
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);
+    bool loaded = rationator.loadSnapshot("no_such_snapshot.snap");
+    assert(!loaded);
+    loaded = rationator.loadSnapshot(assumptionsFile);
+    assert(!loaded);
+    for (size_t length : {size_t(0), size_t(16), bytes.size() / 2, bytes.size() - 1}) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes.substr(0, length);
+        loaded = rationator.loadSnapshot(path);
+        assert(!loaded);
+    }
+    std::string wrongVersion = bytes;
+    wrongVersion[8] = static_cast<char>(Snapshot::kVersion + 1);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << wrongVersion;
+    loaded = rationator.loadSnapshot(path);
+    assert(!loaded);
+    std::cerr.rdbuf(saved);
+    
+    assert(rationator.getPropositionCount() == 1);
+    assert(rationator.getPropositionTruthValue("kept") == Tripartite::TRUE);
+    
+    std::remove(path.c_str());
+    std::cout << "Test passed: invalid snapshots are rejected." << std::endl;
+}
+
+// Value a change list reports for a proposition (before, after), or false if absent
+static bool findChange(const std::vector<PropositionChange>& changes, const std::string& name,
+                       Tripartite before, Tripartite after) {
+    for (const PropositionChange& change : changes) {
+        if (change.name == name) {
+            return change.before == before && change.after == after;
+        }
+    }
+    return false;
+}
+
+// Test: streamed facts are applied in batches and every changed value is reported
+void testStreamingIngest() {
+    std::cout << "Running testStreamingIngest..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    rationator.deduce();
+    IngestOptions options;
+    options.batchSize = 2;
+    rationator.setIngestOptions(options);
+    assert(rationator.getIngestOptions().batchSize == 2);
+    std::vector<std::vector<PropositionChange>> batches;
+    rationator.setChangeCallback([&](const std::vector<PropositionChange>& changes) {
+        batches.push_back(changes);
+    });
+    
+    rationator.ingest("X0");
+    assert(rationator.getPendingLineCount() == 1);
+    assert(rationator.getPropositionTruthValue("X0") == Tripartite::UNKNOWN);
+    rationator.ingest("!Y");
+    assert(rationator.getPendingLineCount() == 0);
+    assert(batches.size() == 1);
+    assert(batches[0].size() == 5);
+    assert(findChange(batches[0], "X0", Tripartite::UNKNOWN, Tripartite::TRUE));
+    assert(findChange(batches[0], "X3", Tripartite::UNKNOWN, Tripartite::TRUE));
+    assert(findChange(batches[0], "Y", Tripartite::UNKNOWN, Tripartite::FALSE));
+    
+    // Retractions are reported; a value set and reset within a batch is not
+    rationator.ingest("!X0");
+    rationator.ingest("Y = X0 || Y");
+    assert(batches.size() == 2);
+    assert(findChange(batches[1], "X0", Tripartite::TRUE, Tripartite::FALSE));
+    assert(findChange(batches[1], "X1", Tripartite::TRUE, Tripartite::UNKNOWN));
+    assert(findChange(batches[1], "X3", Tripartite::TRUE, Tripartite::UNKNOWN));
+    assert(batches[1].size() == 4);
+    
+    // A batch that changes nothing does not call back
+    rationator.ingest("!X0");
+    std::vector<PropositionChange> flushed = rationator.flush();
+    assert(flushed.empty());
+    assert(batches.size() == 2);
+    flushed = rationator.flush();
+    assert(flushed.empty());
+    
+    // Whole streams: read every line, then flush
+    std::istringstream stream("X0\n\nX5 = X3 && X0\n");
+    const size_t ingested = rationator.ingest(stream);
+    assert(ingested == 3);
+    assert(rationator.getPendingLineCount() == 0);
+    assert(rationator.getPropositionTruthValue("X3") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("X5") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: streamed facts are applied in batches." << std::endl;
+}
+
+// Test: streaming a facts file reaches the values of loading it, and latency bounds flush
+void testStreamingIngestMatchesLoad() {
+    std::cout << "Running testStreamingIngestMatchesLoad..." << std::endl;
+    
+    Ratiocinator loaded;
+    loaded.loadAssumptions(assumptionsFile);
+    loaded.loadFacts(factsFile);
+    loaded.deduce();
+    
+    for (size_t batchSize : {1, 3, 0}) {
+        Ratiocinator streamed;
+        streamed.loadAssumptions(assumptionsFile);
+        IngestOptions options;
+        options.batchSize = batchSize;
+        streamed.setIngestOptions(options);
+        std::ifstream facts(factsFile);
+        streamed.ingest(facts);
+        for (const auto& entry : loaded.getPropositions()) {
+            assert(streamed.getPropositionTruthValue(entry.first) == entry.second.getTruthValue());
+        }
+        assert(streamed.getExpressionCount() == loaded.getExpressionCount());
+    }
+    
+    Ratiocinator timed;
+    IngestOptions options;
+    options.batchSize = 0;
+    options.maxLatency = std::chrono::milliseconds(1);
+    timed.setIngestOptions(options);
+    timed.ingest("a");
+    assert(timed.getPendingLineCount() == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    timed.ingest("b");
+    assert(timed.getPendingLineCount() == 0);
+    assert(timed.getPropositionTruthValue("a") == Tripartite::TRUE);
+    assert(timed.getPropositionTruthValue("b") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: streaming matches loading the file." << std::endl;
+}
+
+// Test: published views are immutable versions of the knowledge base
+void testSnapshotPublishing() {
+    std::cout << "Running testSnapshotPublishing..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    std::shared_ptr<const KnowledgeView> empty = rationator.snapshot();
+    assert(empty->getVersion() == 0);
+    assert(empty->getPropositionCount() == 0);
+    
+    // Nothing is published until publishing is enabled
+    rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+    rationator.deduce();
+    assert(rationator.snapshot() == empty);
+    assert(!rationator.isSnapshotPublishing());
+    rationator.setSnapshotPublishing(true);
+    assert(rationator.isSnapshotPublishing());
+    std::shared_ptr<const KnowledgeView> first = rationator.snapshot();
+    assert(first->getVersion() == 1);
+    assert(first->getPropositionCount() == rationator.getPropositionCount());
+    assert(first->getPropositionTruthValue("X3") == Tripartite::TRUE);
+    assert(first->getPropositionTruthValue("missing") == Tripartite::UNKNOWN);
+    assert(first->getProposition("missing") == nullptr);
+    assert(first->hasProposition("X3"));
+    
+    // Edits are invisible until the next deduction publishes them
+    rationator.setPropositionTruthValue("X0", Tripartite::FALSE);
+    assert(rationator.snapshot() == first);
+    rationator.deduceIncremental();
+    std::shared_ptr<const KnowledgeView> second = rationator.snapshot();
+    assert(second->getVersion() == 2);
+    assert(second->getPropositionTruthValue("X3") == Tripartite::UNKNOWN);
+    assert(first->getPropositionTruthValue("X3") == Tripartite::TRUE);
+    
+    // Views answer filters and traces like the engine did when they were published
+    rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+    rationator.deduceIncremental();
+    std::shared_ptr<const KnowledgeView> third = rationator.snapshot();
+    ResultFilter filter = ResultFilter::trueOnly();
+    assert(third->getFilteredPropositionNames(filter) ==
+           rationator.getFilteredPropositionNames(filter));
+    std::vector<InferenceStep> expected = rationator.traceInference("X3");
+    std::vector<InferenceStep> traced = third->traceInference("X3");
+    assert(traced.size() == expected.size());
+    assert(traced.size() > 1);
+    for (size_t i = 0; i < traced.size(); ++i) {
+        assert(traced[i].proposition == expected[i].proposition);
+        assert(traced[i].premises == expected[i].premises);
+    }
+    
+    rationator.clearKnowledgeBase();
+    rationator.publishSnapshot();
+    assert(rationator.snapshot()->getPropositionCount() == 0);
+    assert(third->traceInference("X3").size() == expected.size());
+    rationator.setSnapshotPublishing(false);
+    rationator.deduce();
+    assert(rationator.snapshot()->getVersion() == 4);
+    
+    std::cout << "Test passed: views are immutable published versions." << std::endl;
+}
+
+// Test: readers on other threads always see a complete deduction
+void testConcurrentSnapshotReads() {
+    std::cout << "Running testConcurrentSnapshotReads..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    rationator.setPropositionTruthValue("X0", Tripartite::FALSE);
+    rationator.setSnapshotPublishing(true);
+    
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t lastVersion = 0;
+            while (!done.load()) {
+                std::shared_ptr<const KnowledgeView> view = rationator.snapshot();
+                bool x0 = view->getPropositionTruthValue("X0") == Tripartite::TRUE;
+                bool x3 = view->getPropositionTruthValue("X3") == Tripartite::TRUE;
+                if (view->getVersion() < lastVersion || x0 != x3 ||
+                    (x3 && view->traceInference("X3").size() < 2)) {
+                    consistent = false;
+                }
+                lastVersion = view->getVersion();
+            }
+        });
+    }
+    
+    for (int i = 0; i < 200; ++i) {
+        rationator.setPropositionTruthValue("X0", i % 2 == 0 ? Tripartite::TRUE : Tripartite::FALSE);
+        rationator.deduceIncremental();
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    const bool readersConsistent = consistent.load();
+    assert(readersConsistent);
+    assert(rationator.snapshot()->getVersion() == 201);
+    
+    std::cout << "Test passed: concurrent readers see consistent versions." << std::endl;
+}
+
+// Test: querying any one proposition gives the value a full deduction gives it
+void testQueryMatchesDeduce() {
+    std::cout << "Running testQueryMatchesDeduce..." << std::endl;
+    
+    Ratiocinator mixed;
+    buildMixedKnowledgeBase(mixed);
+    mixed.deduce();
+    for (const auto& entry : mixed.getPropositions()) {
+        Ratiocinator queried;
+        buildMixedKnowledgeBase(queried);
+        QueryResult result = queried.query(entry.first);
+        assert(result.name == entry.first);
+        assert(result.value == entry.second.getTruthValue());
+    }
+    
+    Ratiocinator loaded;
+    loaded.loadAssumptions(assumptionsFile);
+    loaded.loadFacts(factsFile);
+    loaded.deduce();
+    for (const auto& entry : loaded.getPropositions()) {
+        Ratiocinator queried;
+        queried.loadAssumptions(assumptionsFile);
+        queried.loadFacts(factsFile);
+        QueryResult result = queried.query(entry.first);
+        assert(result.value == entry.second.getTruthValue());
+    }
+    
+    std::cout << "Test passed: queries agree with full deduction." << std::endl;
+}
+
+// Test: a query only derives what its goal needs, and explains its answer
+void testQueryIsGoalDirected() {
+    std::cout << "Running testQueryIsGoalDirected..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildMixedKnowledgeBase(rationator);
+    
+    // R needs Resolution (P || Q, ~P || R, Q = FALSE); the A and B chains are untouched
+    QueryResult r = rationator.query("R");
+    assert(r.value == Tripartite::TRUE);
+    assert(r.provenance && r.provenance->ruleFired == "Resolution");
+    assert(r.rulesConsidered == 2);
+    assert(rationator.getPropositionTruthValue("A20") == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue("B0") == Tripartite::UNKNOWN);
+    
+    // D comes through Modus Tollens down B, Disjunctive Syllogism, then Modus Ponens
+    QueryResult d = rationator.query("D");
+    assert(d.value == Tripartite::TRUE);
+    assert(d.provenance && d.provenance->ruleFired == "ModusPonens");
+    assert(d.derivedCount >= 3);
+    std::vector<InferenceStep> trace = rationator.traceInference("D");
+    bool throughB0 = false;
+    for (const InferenceStep& step : trace) {
+        throughB0 = throughB0 || step.proposition == "B0";
+    }
+    assert(throughB0);
+    assert(rationator.getPropositionTruthValue("A20") == Tripartite::UNKNOWN);
+    
+    // Answers are tabled: asking again derives nothing
+    QueryResult again = rationator.query("D");
+    assert(again.value == Tripartite::TRUE);
+    assert(again.derivedCount == 0);
+    QueryResult missing = rationator.query("no_such_proposition");
+    assert(missing.value == Tripartite::UNKNOWN);
+    
+    // After a deduction, a retracted premise is propagated before answering
+    rationator.deduce();
+    rationator.setPropositionTruthValue("A0", Tripartite::FALSE);
+    QueryResult retracted = rationator.query("A20");
+    assert(retracted.value == Tripartite::UNKNOWN);
+    rationator.setPropositionTruthValue("A0", Tripartite::TRUE);
+    QueryResult restored = rationator.query("A20");
+    assert(restored.value == Tripartite::TRUE);
+    
+    std::cout << "Test passed: queries are goal-directed." << std::endl;
+}
+
+// Test: traces share one derivation DAG and follow changes to the knowledge base
+void testTraceGraphSharedAcrossTraces() {
+    std::cout << "Running testTraceGraphSharedAcrossTraces..." << std::endl;
+    
+    // X0 implies X1 implies ... X5
+    Ratiocinator rationator;
+    for (int i = 0; i < 5; ++i) {
+        Proposition imp;
+        imp.setPrefix("imp_X" + std::to_string(i));
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent("X" + std::to_string(i));
+        imp.setConsequent("X" + std::to_string(i + 1));
+        rationator.setProposition("X" + std::to_string(i + 1), imp);
+    }
+    rationator.setPropositionTruthValue("X0", Tripartite::TRUE);
+    rationator.deduce();
+    
+    // Streamed and formatted traces agree, and repeated traces are unchanged
+    std::ostringstream streamed;
+    rationator.writeTrace(streamed, "X5");
+    std::string first = rationator.formatTrace("X5");
+    assert(streamed.str() == first);
+    assert(rationator.formatTrace("X5") == first);
+    std::ostringstream all;
+    rationator.writeAllTraces(all);
+    assert(all.str() == rationator.formatAllTraces());
+    assert(rationator.traceInference("X5").size() > rationator.traceInference("X3").size());
+    
+    // A change invalidates the shared graph
+    rationator.setPropositionTruthValue("X0", Tripartite::FALSE);
+    rationator.deduceIncremental();
+    std::vector<InferenceStep> retracted = rationator.traceInference("X5");
+    assert(retracted.size() == 1);
+    assert(retracted[0].truthValue == Tripartite::UNKNOWN);
+    assert(retracted[0].rule == "Axiom");
+    
+    std::cout << "Test passed: traces share a DAG and follow changes." << std::endl;
+}
+
+// Test: a trace visits each premise once, survives cycles and does not recurse
+void testTraceGraphShapes() {
+    std::cout << "Running testTraceGraphShapes..." << std::endl;
+    
+    // Diamond: D from B and C, both from A
+    std::unordered_map<std::string, Proposition> props;
+    props["A"].setTruthValue(Tripartite::TRUE);
+    props["B"].setTruthValue(Tripartite::TRUE, InferenceProvenance("ModusPonens", {"A"}));
+    props["C"].setTruthValue(Tripartite::TRUE, InferenceProvenance("ModusPonens", {"A"}));
+    props["D"].setTruthValue(Tripartite::TRUE, InferenceProvenance("Conjunction", {"B", "C", "missing"}));
+    
+    TraceGraph graph(props, nullptr);
+    std::vector<InferenceStep> steps = graph.trace("D");
+    assert(steps.size() == 4);
+    assert(steps[0].proposition == "D" && steps[0].depth == 0);
+    assert(steps[1].proposition == "B" && steps[1].depth == 1);
+    assert(steps[2].proposition == "A" && steps[2].depth == 2);
+    assert(steps[3].proposition == "C" && steps[3].depth == 1);
+    assert(steps[0].premises.size() == 3);
+    assert(graph.nodeCount() == 4);
+    
+    // Later traces reuse the nodes already built
+    assert(graph.trace("B").size() == 2);
+    assert(graph.nodeCount() == 4);
+    assert(graph.trace("missing").empty());
+    
+    // Premises that cite each other terminate
+    props["P"].setTruthValue(Tripartite::TRUE, InferenceProvenance("Custom", {"Q"}));
+    props["Q"].setTruthValue(Tripartite::TRUE, InferenceProvenance("Custom", {"P"}));
+    graph.reset(props, nullptr);
+    assert(graph.trace("P").size() == 2);
+    
+    // A chain far deeper than the call stack would allow
+    const int depth = 200000;
+    std::unordered_map<std::string, Proposition> chain;
+    chain["L0"].setTruthValue(Tripartite::TRUE);
+    for (int i = 1; i <= depth; ++i) {
+        chain["L" + std::to_string(i)].setTruthValue(
+            Tripartite::TRUE, InferenceProvenance("ModusPonens", {"L" + std::to_string(i - 1)}));
+    }
+    TraceGraph deep(chain, nullptr);
+    std::vector<InferenceStep> longTrace = deep.trace("L" + std::to_string(depth));
+    assert(longTrace.size() == static_cast<size_t>(depth) + 1);
+    assert(longTrace.back().proposition == "L0" && longTrace.back().depth == depth);
+    
+    std::cout << "Test passed: traces handle diamonds, cycles and deep chains." << std::endl;
+}
+
+// Test: a limited selection is the head of the fully sorted one, for every order
+void testResultLimitMatchesFullSort() {
+    std::cout << "Running testResultLimitMatchesFullSort..." << std::endl;
+    
+    Ratiocinator rationator;
+    for (int i = 0; i < 9; ++i) {
+        Proposition imp;
+        imp.setPrefix("imp_" + std::to_string(i));
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent("A" + std::to_string(i));
+        imp.setConsequent("C" + std::to_string(i));
+        rationator.setProposition("C" + std::to_string(i), imp);
+        Tripartite value = (i % 3 == 0) ? Tripartite::TRUE :
+                           (i % 3 == 1) ? Tripartite::FALSE : Tripartite::UNKNOWN;
+        rationator.setPropositionTruthValue("A" + std::to_string(i), value);
+    }
+    rationator.deduce();
+    
+    for (ResultSortOrder order : {ResultSortOrder::ALPHABETICAL, ResultSortOrder::ALPHABETICAL_DESC,
+                                  ResultSortOrder::BY_TRUTH_VALUE, ResultSortOrder::BY_DERIVATION}) {
+        ResultFilter all;
+        all.withSort(order);
+        std::vector<std::string> full = rationator.getFilteredPropositionNames(all);
+        assert(full.size() == 18);
+        for (size_t limit : {1, 5, 17, 18, 40}) {
+            ResultFilter limited = all;
+            limited.withLimit(limit);
+            std::vector<std::string> head = rationator.getFilteredPropositionNames(limited);
+            assert(head.size() == std::min(limit, full.size()));
+            assert(std::equal(head.begin(), head.end(), full.begin()));
+        }
+    }
+    
+    // Truth value groups keep the enum order, names sorted within each group
+    std::vector<std::string> byTruth = rationator.getFilteredPropositionNames(
+        ResultFilter().withSort(ResultSortOrder::BY_TRUTH_VALUE));
+    assert(rationator.getPropositionTruthValue(byTruth.front()) == Tripartite::UNKNOWN);
+    assert(rationator.getPropositionTruthValue(byTruth.back()) == Tripartite::FALSE);
+    
+    // Unsorted results stop at the limit
+    assert(rationator.getFilteredPropositionNames(
+        ResultFilter().withSort(ResultSortOrder::NONE).withLimit(4)).size() == 4);
+    
+    std::cout << "Test passed: limited results match the full sort." << std::endl;
+}
+
+// Test: writeResults streams text, JSON and NDJSON reports
+void testWriteResultsFormats() {
+    std::cout << "Running testWriteResultsFormats..." << std::endl;
+    
+    Ratiocinator rationator;
+    Proposition impPQ;
+    impPQ.setPrefix("imp_PQ");
+    impPQ.setRelation(LogicalOperator::IMPLIES);
+    impPQ.setAntecedent("P");
+    impPQ.setConsequent("Q");
+    rationator.setProposition("Q", impPQ);
+    rationator.setPropositionTruthValue("P", Tripartite::TRUE);
+    rationator.setPropositionTruthValue("say \"hi\"\\\n", Tripartite::FALSE);
+    rationator.deduce();
+    
+    // Text is formatResults()
+    ResultFilter text;
+    text.withTraces();
+    std::ostringstream streamed;
+    rationator.writeResults(streamed, text);
+    assert(streamed.str() == rationator.formatResults(text));
+    
+    // JSON: one document with the results array
+    ResultFilter json;
+    json.withFormat(ResultFormat::JSON).withTraces();
+    std::string doc = rationator.formatResults(json);
+    assert(doc.rfind("{\"total\":3,\"shown\":3,\"results\":[", 0) == 0);
+    assert(doc.find("{\"name\":\"P\",\"value\":\"TRUE\",\"derived\":false}") != std::string::npos);
+    assert(doc.find("{\"name\":\"Q\",\"value\":\"TRUE\",\"derived\":true,"
+                    "\"rule\":\"ModusPonens\",\"premises\":[") != std::string::npos);
+    assert(doc.find("\"trace\":[{\"proposition\":\"Q\",\"value\":\"TRUE\",\"rule\":\"ModusPonens\"") 
+           != std::string::npos);
+    assert(doc.find("\"name\":\"say \\\"hi\\\"\\\\\\n\"") != std::string::npos);
+    assert(doc.substr(doc.size() - 4) == "\n]}\n");
+    
+    // NDJSON: one object per line, without provenance when it is hidden
+    ResultFilter ndjson;
+    ndjson.withFormat(ResultFormat::NDJSON).withLimit(2);
+    ndjson.showProvenance = false;
+    std::string lines = rationator.formatResults(ndjson);
+    std::istringstream in(lines);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(in, line)) {
+        assert(line.front() == '{' && line.back() == '}');
+        assert(line.find("\"rule\"") == std::string::npos);
+        ++count;
+    }
+    assert(count == 2);
+    
+    std::cout << "Test passed: results stream as text, JSON and NDJSON." << std::endl;
+}
+
+// Test: OutputFile writes a report to disk through its buffer
+void testOutputFile() {
+    std::cout << "Running testOutputFile..." << std::endl;
+    
+    const std::string path = "test_output_file.txt";
+    std::string big(200000, 'x');
+    {
+        OutputFile out;
+        assert(!out.good());
+        const bool opened = out.open(path, 16);
+        assert(opened);
+        out << "small " << 42 << '\n';
+        out.write(big.data(), static_cast<std::streamsize>(big.size()));
+        out << "\nend\n";
+        bool closed = out.close();
+        assert(closed);
+        // Closing again is a no-op that still reports success
+        closed = out.close();
+        assert(closed);
+    }
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    assert(contents == "small 42\n" + big + "\nend\n");
+    in.close();
+    std::remove(path.c_str());
+    
+    OutputFile missing;
+    const bool openedMissing = missing.open("no_such_directory/report.txt");
+    assert(!openedMissing);
+    
+    std::cout << "Test passed: OutputFile writes buffered output." << std::endl;
+}
+
+// Test: ResultIndex buckets, prefix ranges and removals
+void testResultIndexBuckets() {
+    std::cout << "Running testResultIndexBuckets..." << std::endl;
+    
+    std::unordered_map<std::string, Proposition> props;
+    props["tenant_a"].setTruthValue(Tripartite::TRUE);
+    props["tenant_b"].setTruthValue(Tripartite::TRUE, InferenceProvenance("ModusPonens", {"x"}));
+    props["tenant_c"].setTruthValue(Tripartite::FALSE);
+    props["other"].setTruthValue(Tripartite::TRUE);
+    props["tenant"];
+    
+    ResultIndex index;
+    index.rebuild(props);
+    assert(index.size() == 5);
+    assert(index.bucketSize(Tripartite::TRUE, false) == 2);
+    assert(index.bucketSize(Tripartite::TRUE, true) == 1);
+    assert(index.bucketSize(Tripartite::UNKNOWN, false) == 1);
+    assert(index.countByName("tenant") == 4);
+    assert(index.countByName("tenant_") == 3);
+    assert(index.countByName("zzz") == 0);
+    
+    std::vector<std::string> names;
+    index.forEachByName("tenant_", true, [&](const ResultIndex::Entry& entry) {
+        names.push_back(entry.first);
+        return true;
+    });
+    assert((names == std::vector<std::string>{"tenant_c", "tenant_b", "tenant_a"}));
+    
+    // Values move between buckets; removed names leave the name order
+    props["tenant_a"].setTruthValue(Tripartite::FALSE);
+    index.update(*props.find("tenant_a"));
+    assert(index.bucketSize(Tripartite::TRUE, false) == 1);
+    assert(index.bucketSize(Tripartite::FALSE, false) == 2);
+    index.remove("tenant_b");
+    props.erase("tenant_b");
+    assert(index.size() == 4 && index.countByName("tenant_") == 2);
+    assert(index.bucketSize(Tripartite::TRUE, true) == 0);
+    
+    // Added names are found once merged into the name order
+    props["tenant_aa"].setTruthValue(Tripartite::TRUE);
+    index.update(*props.find("tenant_aa"));
+    names.clear();
+    index.forEachByName("tenant_", false, [&](const ResultIndex::Entry& entry) {
+        names.push_back(entry.first);
+        return names.size() < 2;
+    });
+    assert((names == std::vector<std::string>{"tenant_a", "tenant_aa"}));
+    
+    std::cout << "Test passed: ResultIndex keeps buckets and name order." << std::endl;
+}
+
+// Test: indexed filtering matches a full scan as the knowledge base changes
+void testFilteredResultsFollowChanges() {
+    std::cout << "Running testFilteredResultsFollowChanges..." << std::endl;
+    
+    Ratiocinator rationator;
+    for (int i = 0; i < 40; ++i) {
+        std::string n = std::to_string(i);
+        Proposition imp;
+        imp.setPrefix("imp_" + n);
+        imp.setRelation(LogicalOperator::IMPLIES);
+        imp.setAntecedent((i % 2 ? "tenant_a" : "tenant_b") + n);
+        imp.setConsequent("derived_" + n);
+        rationator.setProposition("derived_" + n, imp);
+        rationator.setPropositionTruthValue((i % 2 ? "tenant_a" : "tenant_b") + n,
+                                            i % 3 ? Tripartite::TRUE : Tripartite::FALSE);
+    }
+    
+    std::vector<ResultFilter> filters = {
+        ResultFilter(),
+        ResultFilter::trueOnly().withPrefix("tenant_"),
+        ResultFilter::knownOnly().withPrefix("derived_").withLimit(5),
+        ResultFilter().derivedOnly().withSort(ResultSortOrder::BY_TRUTH_VALUE),
+        ResultFilter::unknownOnly().withSort(ResultSortOrder::ALPHABETICAL_DESC).withLimit(7),
+        ResultFilter().axiomsOnly().withPrefix("tenant_a").withContains("1"),
+    };
+    auto check = [&]() {
+        rationator.publishSnapshot();
+        std::shared_ptr<const KnowledgeView> scanned = rationator.snapshot();
+        for (const ResultFilter& filter : filters) {
+            assert(rationator.getFilteredPropositionNames(filter) ==
+                   scanned->getFilteredPropositionNames(filter));
+        }
+    };
+    
+    check();
+    rationator.deduce();
+    check();
+    rationator.setPropositionTruthValue("tenant_b0", Tripartite::TRUE);
+    rationator.setPropositionTruthValue("tenant_new", Tripartite::TRUE);
+    check();
+    rationator.deduceIncremental();
+    check();
+    rationator.removeProposition("derived_3");
+    rationator.removeProposition("tenant_a5");
+    check();
+    rationator.setPropositionTruthValue("tenant_a7", Tripartite::FALSE);
+    rationator.deduceIncremental();
+    check();
+    rationator.updatePropositionTruthValue("tenant_a9", Tripartite::TRUE,
+                                           InferenceProvenance("Custom", {"tenant_b0"}));
+    check();
+    rationator.setPropositionTruthValue("tenant_b12", Tripartite::UNKNOWN);
+    rationator.query("derived_12");
+    check();
+    rationator.clearPropositions();
+    check();
+    
+    std::cout << "Test passed: filtered results follow changes." << std::endl;
+}
+
+// Build the knowledge base scenarios are evaluated against: chains
+// a_i -> b_i -> c_i, disjunctions c_i | d_i, and a few decided facts
+void buildScenarioBase(Ratiocinator& rationator) {
+    for (int i = 0; i < 6; ++i) {
+        std::string n = std::to_string(i);
+        Proposition ab;
+        ab.setPrefix("ab_" + n);
+        ab.setRelation(LogicalOperator::IMPLIES);
+        ab.setAntecedent("a_" + n);
+        ab.setConsequent("b_" + n);
+        rationator.setProposition("ab_" + n, ab);
+        Proposition bc;
+        bc.setPrefix("bc_" + n);
+        bc.setRelation(LogicalOperator::IMPLIES);
+        bc.setAntecedent("b_" + n);
+        bc.setConsequent("c_" + n);
+        rationator.setProposition("bc_" + n, bc);
+        Proposition cd;
+        cd.setPrefix("cd_" + n);
+        cd.setRelation(LogicalOperator::OR);
+        cd.setAntecedent("c_" + n);
+        cd.setConsequent("d_" + n);
+        rationator.setProposition("cd_" + n, cd);
+    }
+    rationator.setPropositionTruthValue("a_0", Tripartite::TRUE);
+    rationator.setPropositionTruthValue("c_1", Tripartite::FALSE);
+}
+
+// Test: a scenario changes exactly what a fresh deduction with its facts would
+void testScenariosMatchFreshDeduction() {
+    std::cout << "Running testScenariosMatchFreshDeduction..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildScenarioBase(rationator);
+    std::shared_ptr<const RuleBase> rules = rationator.compileRuleBase(4);
+    
+    Ratiocinator deduced;
+    buildScenarioBase(deduced);
+    deduced.deduce();
+    for (const auto& entry : deduced.getPropositions()) {
+        assert(rules->getPropositionTruthValue(entry.first) == entry.second.getTruthValue());
+    }
+    
+    std::vector<std::string> scenarios = {
+        "",
+        "a_2",                 // Propagates down one chain
+        "a_3\n!d_4\nfresh",    // Several chains, and a name no rule mentions
+        "a_0",                 // Already true: nothing changes
+        "!a_0",                // Contradicts a decided fact: full deduction
+        "!c_1\nd_5 = a_2 || a_0",  // Defines an expression
+    };
+    std::vector<ScenarioResult> results = rules->evaluateAll(scenarios);
+    assert(results.size() == scenarios.size());
+    
+    const std::string factsPath = "scenario_facts.txt";
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        std::ofstream(factsPath, std::ios::trunc) << scenarios[i] << "\n";
+        Ratiocinator fresh;
+        buildScenarioBase(fresh);
+        fresh.loadFacts(factsPath);
+        fresh.deduce();
+        
+        // Base values with the scenario's changes applied
+        std::unordered_map<std::string, Tripartite> expected;
+        for (const auto& entry : rules->getPropositions()) {
+            expected[entry.first] = entry.second.getTruthValue();
+        }
+        for (size_t c = 0; c < results[i].changes.size(); ++c) {
+            const PropositionChange& change = results[i].changes[c];
+            assert(change.before != change.after);
+            assert(change.before == rules->getPropositionTruthValue(change.name));
+            assert(c == 0 || results[i].changes[c - 1].name < change.name);
+            expected[change.name] = change.after;
+        }
+        for (const auto& entry : fresh.getPropositions()) {
+            assert(expected[entry.first] == entry.second.getTruthValue());
+        }
+        ScenarioResult serial = rules->evaluate(scenarios[i]);
+        assert(serial.changes.size() == results[i].changes.size());
+        for (size_t c = 0; c < serial.changes.size(); ++c) {
+            assert(serial.changes[c].name == results[i].changes[c].name);
+            assert(serial.changes[c].after == results[i].changes[c].after);
+        }
+    }
+    std::remove(factsPath.c_str());
+    
+    assert(results[0].changes.empty() && !results[0].fullDeduction);
+    assert(results[1].changes.size() == 3 && !results[1].fullDeduction);
+    assert(results[3].changes.empty());
+    assert(results[4].retracted == 2 && !results[4].fullDeduction);
+    assert(results[5].fullDeduction);
+    
+    // Without provenance, overturning a fact deduces from the undeduced base
+    RuleBase::Options untraced;
+    untraced.inference.provenance = ProvenanceLevel::NONE;
+    untraced.threads = 1;
+    RuleBase plain(rationator.getPropositions(), {}, untraced);
+    ScenarioResult overturned = plain.evaluate("!a_0");
+    assert(overturned.fullDeduction);
+    assert(overturned.changes.size() == results[4].changes.size());
+    for (size_t c = 0; c < overturned.changes.size(); ++c) {
+        assert(overturned.changes[c].name == results[4].changes[c].name);
+        assert(overturned.changes[c].after == results[4].changes[c].after);
+    }
+    
+    // Neither the compiled base nor the Ratiocinator it came from changed
+    assert(rules->getPropositionTruthValue("a_2") == Tripartite::UNKNOWN);
+    assert(rules->getPropositionTruthValue("c_0") == Tripartite::TRUE);
+    assert(rationator.getPropositionTruthValue("b_0") == Tripartite::UNKNOWN);
+    
+    std::cout << "Test passed: scenarios match fresh deductions." << std::endl;
+}
+
+// Contradictory rules that never settle: X -> Y, with X := !Y (universal
+// affirmative) and Y := !X (universal negative) flipping them back
+void buildOscillatingKnowledgeBase(Ratiocinator& rationator) {
+    Proposition x;
+    x.setPrefix("X");
+    x.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+    rationator.setProposition("X", x);
+    Proposition y;
+    y.setPrefix("Y");
+    y.setPropositionScope(Quantifier::UNIVERSAL_NEGATIVE);
+    rationator.setProposition("Y", y);
+    Proposition imp;
+    imp.setPrefix("imp_XY");
+    imp.setRelation(LogicalOperator::IMPLIES);
+    imp.setAntecedent("X");
+    imp.setConsequent("Y");
+    rationator.setProposition("imp_XY", imp);
+    rationator.addExpressionFromString("!Y", "X");
+    rationator.addExpressionFromString("!X", "Y");
+    rationator.setPropositionTruthValue("X", Tripartite::TRUE);
+}
+
+// Test: an oscillating fixed point is stopped and reported, with bounded history
+void testOscillationStopsDeduction() {
+    std::cout << "Running testOscillationStopsDeduction..." << std::endl;
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        for (ConflictRecording recording : {ConflictRecording::OFF, ConflictRecording::COUNT,
+                                            ConflictRecording::RECENT, ConflictRecording::ALL}) {
+            Ratiocinator rationator;
+            InferenceEngine::Options options;
+            options.strategy = strategy;
+            options.conflicts = recording;
+            options.conflictHistory = 4;
+            options.oscillationLimit = 20;
+            rationator.setInferenceOptions(options);
+            buildOscillatingKnowledgeBase(rationator);
+            
+            std::streambuf* saved = std::cerr.rdbuf(nullptr);
+            rationator.deduce();
+            std::cerr.rdbuf(saved);
+            
+            const InferenceEngine::Convergence& convergence = rationator.getConvergence();
+            assert(!convergence.converged);
+            assert(convergence.oscillating.size() == 1);
+            assert(convergence.oscillating[0] == "X" || convergence.oscillating[0] == "Y");
+            assert(convergence.conflicts > 20);
+            assert(convergence.iterations > 0);
+            
+            // Derived values overturning it are conflicts; expression results carry no provenance
+            const Proposition* flipping = rationator.getProposition(convergence.oscillating[0]);
+            switch (recording) {
+                case ConflictRecording::OFF:
+                    assert(!flipping->hasConflicts() && flipping->getConflicts().empty());
+                    break;
+                case ConflictRecording::COUNT:
+                    assert(flipping->getConflictCount() > 4 && flipping->getConflicts().empty());
+                    break;
+                case ConflictRecording::RECENT:
+                    assert(flipping->getConflictCount() > 4 && flipping->getConflicts().size() == 4);
+                    break;
+                case ConflictRecording::ALL:
+                    assert(flipping->getConflicts().size() == flipping->getConflictCount());
+                    break;
+            }
+        }
+    }
+    
+    // The same rules with a fixed Y settle, and say how long it took
+    Ratiocinator settled;
+    buildOscillatingKnowledgeBase(settled);
+    settled.removeProposition("Y");
+    settled.deduce();
+    assert(settled.getConvergence().converged);
+    assert(settled.getConvergence().oscillating.empty());
+    assert(settled.getConvergence().iterations > 0);
+    
+    std::cout << "Test passed: oscillation stops deduction." << std::endl;
+}
+
+// Test: re-asserting a particular affirmative subject is not a change
+void testParticularAffirmativeConverges() {
+    std::cout << "Running testParticularAffirmativeConverges..." << std::endl;
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        Ratiocinator rationator;
+        InferenceEngine::Options options;
+        options.strategy = strategy;
+        rationator.setInferenceOptions(options);
+        
+        Proposition some;
+        some.setPrefix("some_A");
+        some.setPropositionScope(Quantifier::PARTICULAR_AFFIRMATIVE);
+        rationator.setProposition("some_A", some);
+        rationator.setPropositionTruthValue("A", Tripartite::TRUE);
+        rationator.addExpressionFromString("A", "some_A");
+        rationator.deduce();
+        
+        assert(rationator.getPropositionTruthValue("some_A") == Tripartite::TRUE);
+        assert(rationator.getConvergence().converged);
+        if (strategy == DeductionStrategy::FULL_SWEEP) {
+            // One pass assigns it, the next sees nothing change
+            assert(rationator.getConvergence().iterations == 2);
+        }
+    }
+    
+    std::cout << "Test passed: particular affirmative subjects converge." << std::endl;
+}
+
+// Test: deductions stop at their limits, keep what they derived, and run asynchronously
+void testDeductionLimits() {
+    std::cout << "Running testDeductionLimits..." << std::endl;
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        InferenceEngine::Options options;
+        options.strategy = strategy;
+        
+        // A step budget stops the run early; the next incremental deduction finishes it
+        Ratiocinator stepped;
+        stepped.setInferenceOptions(options);
+        buildMixedKnowledgeBase(stepped);
+        DeductionLimits steps;
+        steps.maxSteps = 2;
+        InferenceEngine::Convergence convergence = stepped.deduce(steps);
+        assert(!convergence.converged);
+        assert(convergence.interrupted == Interruption::STEPS);
+        assert(convergence.iterations == 2);
+        stepped.deduceIncremental();
+        assert(stepped.getConvergence().converged);
+        assert(stepped.getConvergence().interrupted == Interruption::NONE);
+        assert(stepped.getPropositionTruthValue("A20") == Tripartite::TRUE);
+        assert(stepped.getPropositionTruthValue("R") == Tripartite::TRUE);
+        
+        // Limits apply to one call only
+        Ratiocinator generous;
+        generous.setInferenceOptions(options);
+        buildMixedKnowledgeBase(generous);
+        steps.maxSteps = 100000;
+        convergence = generous.deduce(steps);
+        assert(convergence.converged);
+        convergence = generous.deduce(DeductionLimits::within(std::chrono::hours(1)));
+        assert(convergence.converged);
+        
+        // Without a limit, contradictory rules never settle: only the deadline or the token ends them
+        options.oscillationLimit = 0;
+        Ratiocinator endless;
+        endless.setInferenceOptions(options);
+        buildOscillatingKnowledgeBase(endless);
+        convergence = endless.deduce(DeductionLimits::within(std::chrono::milliseconds(5)));
+        assert(convergence.interrupted == Interruption::DEADLINE);
+        assert(convergence.oscillating.empty() && convergence.iterations > 0);
+        
+        DeductionLimits cancellable;
+        std::future<InferenceEngine::Convergence> running = endless.deduceAsync(cancellable);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        cancellable.cancellation.cancel();
+        convergence = running.get();
+        assert(convergence.interrupted == Interruption::CANCELLED);
+        assert(!convergence.converged);
+        
+        // A token cancelled up front stops the first step
+        convergence = endless.deduce(cancellable);
+        assert(convergence.interrupted == Interruption::CANCELLED && convergence.iterations == 0);
+    }
+    
+    // Parallel components share the budget and stop together
+    Ratiocinator parallel;
+    InferenceEngine::Options options;
+    options.threads = 4;
+    parallel.setInferenceOptions(options);
+    buildTenantKnowledgeBase(parallel, 8);
+    DeductionLimits steps;
+    steps.maxSteps = 10;
+    InferenceEngine::Convergence convergence = parallel.deduce(steps);
+    assert(convergence.interrupted == Interruption::STEPS);
+    assert(convergence.iterations == 10);
+    
+    // An executor decides where the deduction runs
+    Ratiocinator queued;
+    buildMixedKnowledgeBase(queued);
+    std::vector<std::function<void()>> tasks;
+    std::future<InferenceEngine::Convergence> pending =
+        queued.deduceAsync(DeductionLimits(), [&](std::function<void()> task) { tasks.push_back(std::move(task)); });
+    assert(tasks.size() == 1);
+    assert(pending.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+    tasks.front()();
+    convergence = pending.get();
+    assert(convergence.converged);
+    assert(queued.getPropositionTruthValue("A20") == Tripartite::TRUE);
+    
+    std::cout << "Test passed: deductions stop at their limits." << std::endl;
+}
+
+// Test: statistics count phases and rules, and stay zero unless requested
+void testInferenceStats() {
+    std::cout << "Running testInferenceStats..." << std::endl;
+    
+    auto counters = [](const InferenceStats& stats) {
+        std::vector<uint64_t> values{stats.calls, stats.iterations, stats.conflicts,
+                                     stats.propositionsCreated};
+        for (const auto& phase : stats.phases) values.push_back(phase.steps);
+        for (const auto& rule : stats.rules) {
+            values.push_back(rule.candidates);
+            values.push_back(rule.fired);
+        }
+        return values;
+    };
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        Ratiocinator rationator;
+        buildTenantKnowledgeBase(rationator, 4);
+        InferenceEngine::Options options;
+        options.strategy = strategy;
+        rationator.setInferenceOptions(options);
+        rationator.deduce();
+        
+        // Not requested: nothing is counted
+        const InferenceStats& idle = rationator.getStats();
+        assert(idle.calls == 0 && idle.iterations == 0);
+        assert(idle.rule(InferenceRule::MODUS_PONENS).candidates == 0);
+        
+        Ratiocinator counted;
+        buildTenantKnowledgeBase(counted, 4);
+        options.collectStats = true;
+        counted.setInferenceOptions(options);
+        counted.deduce();
+        
+        const InferenceStats& stats = counted.getStats();
+        if (!InferenceStats::kCompiled) {
+            assert(stats.calls == 0);
+            continue;
+        }
+        assert(stats.calls == 1);
+        assert(stats.iterations == counted.getConvergence().iterations);
+        assert(stats.conflicts == counted.getConvergence().conflicts);
+        
+        // Each tenant's A chain derives its five links by modus ponens or,
+        // when a pass composes links first, hypothetical syllogism
+        const InferenceStats::RuleCounts& mp = stats.rule(InferenceRule::MODUS_PONENS);
+        const InferenceStats::RuleCounts& hs = stats.rule(InferenceRule::HYPOTHETICAL_SYLLOGISM);
+        assert(mp.fired > 0 && mp.fired + hs.fired >= 20);
+        assert(mp.candidates >= mp.fired && hs.candidates >= hs.fired);
+        // B || C with B FALSE creates C
+        assert(stats.rule(InferenceRule::DISJUNCTIVE_SYLLOGISM).fired == 4);
+        assert(stats.propositionsCreated >= 4);
+        assert(stats.phase(InferenceStats::Phase::IMPLICATIONS).steps > 0);
+        assert(stats.phase(InferenceStats::Phase::DISJUNCTIONS).steps > 0);
+        
+        std::ostringstream json;
+        stats.writeJson(json);
+        assert(json.str().front() == '{' && json.str().back() == '}');
+        assert(json.str().find("\"calls\":1") != std::string::npos);
+        assert(json.str().find("\"ModusPonens\":{\"candidates\":") != std::string::npos);
+        assert(json.str().find("\"implications\":{\"steps\":") != std::string::npos);
+        
+        // Counters (not timings) do not depend on the thread count
+        if (strategy == DeductionStrategy::WORKLIST) {
+            Ratiocinator parallel;
+            buildTenantKnowledgeBase(parallel, 4);
+            options.threads = 4;
+            parallel.setInferenceOptions(options);
+            parallel.deduce();
+            std::vector<uint64_t> serial = counters(stats);
+            std::vector<uint64_t> split = counters(parallel.getStats());
+            // Iterations are summed over partitions, so only compare the rest
+            serial.erase(serial.begin() + 1);
+            split.erase(split.begin() + 1);
+            assert(serial == split);
+        }
+        
+        counted.resetStats();
+        assert(counters(counted.getStats()) == counters(InferenceStats()));
+    }
+    
+    std::cout << "Test passed: inference statistics count phases and rules." << std::endl;
+}
+
+// Test: Sharing subexpressions across expressions changes no result
+void testSharedExpressionsMatchReference() {
+    std::cout << "Running testSharedExpressionsMatchReference..." << std::endl;
+    
+    // Each tenant's expressions repeat A_5 && C, in both operand orders
+    auto build = [](Ratiocinator& rationator) {
+        buildTenantKnowledgeBase(rationator, 6);
+        buildMixedKnowledgeBase(rationator);
+        for (int t = 0; t < 6; ++t) {
+            std::string id = std::to_string(t);
+            for (const char* name : {"either", "neither", "both"}) {
+                Proposition subject;
+                subject.setPrefix(name + id);
+                subject.setPropositionScope(Quantifier::UNIVERSAL_AFFIRMATIVE);
+                rationator.setProposition(name + id, subject);
+            }
+            rationator.addExpressionFromString("C" + id + " && A" + id + "_5 || X" + id, "either" + id);
+            rationator.addExpressionFromString("!(A" + id + "_5 && C" + id + ")", "neither" + id);
+            rationator.addExpressionFromString("(A" + id + "_5 && C" + id + ") && result" + id, "both" + id);
+        }
+    };
+    
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        for (size_t threads : {1, 4}) {
+            std::vector<std::string> reference;
+            for (bool share : {false, true}) {
+                Ratiocinator rationator;
+                InferenceEngine::Options options;
+                options.strategy = strategy;
+                options.threads = threads;
+                options.shareExpressions = share;
+                rationator.setInferenceOptions(options);
+                build(rationator);
+                rationator.deduce();
+                
+                assert(rationator.getPropositionTruthValue("either2") == Tripartite::TRUE);
+                assert(rationator.getPropositionTruthValue("both4") == Tripartite::TRUE);
+                
+                std::vector<std::string> description = describeKnowledgeBase(rationator);
+                if (!share) {
+                    reference = description;
+                }
+                assert(description == reference);
+            }
+        }
+    }
+    
+    std::cout << "Test passed: shared expressions match the reference." << std::endl;
+}
+
+// ============================================================
+// N-ARY CLAUSE TESTS
+// ============================================================
+
+// Add the rules of assumption lines to a knowledge base
+void addAssumptionLines(Ratiocinator& rationator, const std::string& text) {
+    Parser parser;
+    std::unordered_map<std::string, Proposition> props;
+    parser.parseAssumptions(text, props);
+    for (const auto& entry : props) {
+        rationator.setProposition(entry.first, entry.second);
+    }
+}
+
+// Test: or/and lines store clauses keyed by their prefix
+void testParseClauseRelations() {
+    std::cout << "Running testParseClauseRelations..." << std::endl;
+    
+    Parser parser;
+    std::unordered_map<std::string, Proposition> props;
+    parser.parseAssumptions("c1, or(a, ~b, !c , d-e)\n"
+                            "c2 , and( x,~y )\n"
+                            "c3, or(a,,b)\n"
+                            "c4, or()\n"
+                            "c5, or(single)", props);
+    assert(props.size() == 3);
+    assert(props["c1"].getRelation() == LogicalOperator::OR);
+    assert(props["c1"].getPrefix() == "c1");
+    assert((props["c1"].getOperands() == std::vector<std::string>{"a", "~b", "!c", "d-e"}));
+    assert(props["c2"].getRelation() == LogicalOperator::AND);
+    assert((props["c2"].getOperands() == std::vector<std::string>{"x", "~y"}));
+    assert(props["c5"].getOperands().size() == 1);
+    assert(props["c1"].getAntecedent().empty());
+    
+    LiteralIndex index;
+    index.rebuild(props);
+    assert(index.ruleCount() == 3);
+    RuleSlot slot;
+    assert(index.findSlot("c1", slot) && index.isClause(slot));
+    assert(index.clauses().kind(slot) == ClauseKind::DISJUNCTION);
+    PropId notB, notC;
+    assert(index.symbols().find("~b", notB) && index.symbols().find("!c", notC));
+    assert((index.clausesContaining(notB) == std::vector<RuleSlot>{slot}));
+    assert((index.clausesContaining(notC) == std::vector<RuleSlot>{slot}));
+    assert(index.disjunctionsContaining(notB).empty());
+    
+    std::cout << "Test passed: or/and clauses parse." << std::endl;
+}
+
+// Test: clauses live back to back and survive removal and compaction
+void testClauseStore() {
+    std::cout << "Running testClauseStore..." << std::endl;
+    
+    ClauseStore store;
+    store.add(0, ClauseKind::DISJUNCTION, {4, 6, 4, 8});
+    store.add(2, ClauseKind::CONJUNCTION, {10, 12});
+    assert(store.clauseCount() == 2);
+    assert(store.literalCount() == 5);
+    assert((std::vector<PropId>(store.literals(0).begin(), store.literals(0).end()) ==
+            std::vector<PropId>{4, 6, 8}));
+    assert(store.kind(2) == ClauseKind::CONJUNCTION);
+    assert(!store.contains(1) && store.literals(1).empty());
+    
+    // Replacing and removing leave holes until they outweigh the live literals
+    store.add(0, ClauseKind::DISJUNCTION, {14});
+    assert(store.literalCount() == 3);
+    bool removed = store.remove(2);
+    assert(removed);
+    removed = store.remove(2);
+    assert(!removed);
+    assert(store.clauseCount() == 1);
+    assert(store.literalCount() == 1);
+    assert(store.literals(0).size() == 1 && store.literals(0)[0] == 14);
+    
+    store.add(5, ClauseKind::DISJUNCTION, {16, 18});
+    assert(store.literals(5)[1] == 18 && store.literals(0)[0] == 14);
+    store.clear();
+    assert(store.clauseCount() == 0 && !store.contains(0));
+    
+    std::cout << "Test passed: clause store." << std::endl;
+}
+
+// Wide clauses, a resolution chain and conjunctions over separate literals
+void buildClauseKnowledgeBase(Ratiocinator& rationator) {
+    std::string wide = "w, or(";
+    for (int i = 0; i < 10; ++i) {
+        wide += (i ? ", p" : "p") + std::to_string(i);
+    }
+    addAssumptionLines(rationator, wide + ")\n"
+                                   "r1, or(a, b, c)\n"
+                                   "r2, or(~c, d, e)\n"
+                                   "k1, and(m, ~n)\n"
+                                   "k2, and(q)\n"
+                                   "r3, or(~q, s)\n"
+                                   "open, or(u0, u1, u2, u3)");
+    for (int i = 0; i < 9; ++i) {
+        rationator.setPropositionTruthValue("p" + std::to_string(i), Tripartite::FALSE);
+    }
+    for (const char* name : {"a", "b", "d", "u0"}) {
+        rationator.setPropositionTruthValue(name, Tripartite::FALSE);
+    }
+}
+
+// Test: clauses derive by Disjunctive Syllogism, Resolution and Simplification alike
+// under every strategy and thread count
+void testClauseDeduction() {
+    std::cout << "Running testClauseDeduction..." << std::endl;
+    
+    auto premises = [](const Ratiocinator& rationator, const std::string& name) {
+        return rationator.getProposition(name)->getProvenance()->premises;
+    };
+    
+    std::vector<std::string> reference;
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        for (size_t threads : {1, 4}) {
+            Ratiocinator rationator;
+            InferenceEngine::Options options;
+            options.strategy = strategy;
+            options.threads = threads;
+            options.collectStats = true;
+            rationator.setInferenceOptions(options);
+            buildClauseKnowledgeBase(rationator);
+            rationator.deduce();
+            const Ratiocinator& kb = rationator;
+            
+            assert(kb.getPropositionTruthValue("p9") == Tripartite::TRUE);
+            assert(kb.getProposition("p9")->getProvenance()->ruleFired == "DisjunctiveSyllogism");
+            assert(premises(kb, "p9").size() == 10 && premises(kb, "p9").front() == "w");
+            
+            // c is forced by r1, which refutes ~c in r2
+            assert(kb.getPropositionTruthValue("c") == Tripartite::TRUE);
+            assert(kb.getPropositionTruthValue("e") == Tripartite::TRUE);
+            assert(kb.getProposition("e")->getProvenance()->ruleFired == "Resolution");
+            assert((premises(kb, "e") == std::vector<std::string>{"r2", "r1", "c", "d"}));
+            
+            assert(kb.getPropositionTruthValue("m") == Tripartite::TRUE);
+            assert(kb.getPropositionTruthValue("~n") == Tripartite::TRUE);
+            assert(kb.getPropositionTruthValue("n") == Tripartite::UNKNOWN);
+            assert(kb.getProposition("m")->getProvenance()->ruleFired == "Simplification");
+            assert(kb.getPropositionTruthValue("s") == Tripartite::TRUE);
+            assert((premises(kb, "s") == std::vector<std::string>{"r3", "k2", "q"}));
+            
+            // One refuted literal of four leaves the clause open
+            assert(kb.getPropositionTruthValue("u1") == Tripartite::UNKNOWN);
+            assert(kb.getPropositionTruthValue("u3") == Tripartite::UNKNOWN);
+            if (InferenceStats::kCompiled) {
+                assert(kb.getStats().rule(InferenceRule::SIMPLIFICATION).fired == 2);
+            }
+            
+            std::vector<std::string> description = describeKnowledgeBase(kb);
+            if (reference.empty()) {
+                reference = description;
+            }
+            assert(description == reference);
+        }
+    }
+    
+    std::cout << "Test passed: clauses deduce under every strategy." << std::endl;
+}
+
+// Test: two-literal clauses derive the same values as binary disjunctions
+void testClausesMatchBinaryDisjunctions() {
+    std::cout << "Running testClausesMatchBinaryDisjunctions..." << std::endl;
+    
+    const std::vector<std::pair<std::string, std::string>> disjunctions = {
+        {"a", "b"}, {"~a", "c"}, {"~c", "d"}, {"e", "f"}, {"~f", "g"}, {"g", "h"}};
+    for (DeductionStrategy strategy : {DeductionStrategy::WORKLIST, DeductionStrategy::FULL_SWEEP,
+                                        DeductionStrategy::TOPOLOGICAL}) {
+        InferenceEngine::Options options;
+        options.strategy = strategy;
+        Ratiocinator binary;
+        Ratiocinator clauses;
+        binary.setInferenceOptions(options);
+        clauses.setInferenceOptions(options);
+        for (size_t i = 0; i < disjunctions.size(); ++i) {
+            Proposition disjunction;
+            disjunction.setPrefix("d" + std::to_string(i));
+            disjunction.setRelation(LogicalOperator::OR);
+            disjunction.setAntecedent(disjunctions[i].first);
+            disjunction.setConsequent(disjunctions[i].second);
+            binary.setProposition(disjunction.getPrefix(), disjunction);
+            addAssumptionLines(clauses, "d" + std::to_string(i) + ", or(" + disjunctions[i].first + ", " +
+                                            disjunctions[i].second + ")");
+        }
+        for (Ratiocinator* rationator : {&binary, &clauses}) {
+            rationator->setPropositionTruthValue("b", Tripartite::FALSE);
+            rationator->setPropositionTruthValue("e", Tripartite::FALSE);
+            rationator->deduce();
+        }
+        
+        assert(clauses.getPropositionTruthValue("c") == Tripartite::TRUE);
+        assert(clauses.getPropositionTruthValue("g") == Tripartite::TRUE);
+        for (const auto& entry : binary.getPropositions()) {
+            if (entry.second.getRelation() != LogicalOperator::NONE) continue;
+            assert(clauses.getPropositionTruthValue(entry.first) == entry.second.getTruthValue());
+        }
+    }
+    
+    std::cout << "Test passed: two-literal clauses match binary disjunctions." << std::endl;
+}
+
+// Test: incremental runs and queries over clauses agree with full deduction
+void testClausesIncrementalAndQuery() {
+    std::cout << "Running testClausesIncrementalAndQuery..." << std::endl;
+    
+    Ratiocinator incremental;
+    addAssumptionLines(incremental, "c1, or(a, b)\nwide, or(u0, u1, u2, u3)");
+    incremental.setPropositionTruthValue("u0", Tripartite::FALSE);
+    incremental.deduceIncremental();
+    incremental.setPropositionTruthValue("a", Tripartite::FALSE);
+    incremental.deduceIncremental();
+    assert(incremental.getPropositionTruthValue("b") == Tripartite::TRUE);
+    
+    // b was forced by an earlier run; the new clause still sees ~b refuted
+    addAssumptionLines(incremental, "c2, or(~b, c, d)");
+    incremental.setPropositionTruthValue("d", Tripartite::FALSE);
+    incremental.setPropositionTruthValue("u1", Tripartite::FALSE);
+    incremental.setPropositionTruthValue("u2", Tripartite::FALSE);
+    incremental.deduceIncremental();
+    assert(incremental.getPropositionTruthValue("c") == Tripartite::TRUE);
+    assert(static_cast<const Ratiocinator&>(incremental).getProposition("c")->getProvenance()->ruleFired ==
+           "Resolution");
+    assert(incremental.getPropositionTruthValue("u3") == Tripartite::TRUE);
+    
+    auto build = [](Ratiocinator& rationator) {
+        addAssumptionLines(rationator, "c1, or(a, b)\nwide, or(u0, u1, u2, u3)\nc2, or(~b, c, d)");
+        for (const char* name : {"u0", "a", "d", "u1", "u2"}) {
+            rationator.setPropositionTruthValue(name, Tripartite::FALSE);
+        }
+    };
+    Ratiocinator full;
+    build(full);
+    full.deduce();
+    for (const auto& entry : full.getPropositions()) {
+        assert(incremental.getPropositionTruthValue(entry.first) == entry.second.getTruthValue());
+        Ratiocinator queried;
+        build(queried);
+        QueryResult result = queried.query(entry.first);
+        assert(result.value == entry.second.getTruthValue());
+    }
+    
+    // Removing the clause retracts what it derived
+    incremental.removeProposition("wide");
+    incremental.deduceIncremental();
+    assert(incremental.getPropositionTruthValue("u3") == Tripartite::UNKNOWN);
+    
+    std::cout << "Test passed: incremental runs and queries over clauses." << std::endl;
+}
+
+// Test: snapshots keep clause operands, and the restored base deduces on
+void testClauseSnapshotRoundTrip() {
+    std::cout << "Running testClauseSnapshotRoundTrip..." << std::endl;
+    const std::string path = "snapshot_clauses.snap";
+    
+    Ratiocinator original;
+    buildClauseKnowledgeBase(original);
+    original.deduce();
+    const bool saved = original.saveSnapshot(path);
+    assert(saved);
+    
+    Ratiocinator restored;
+    const bool loaded = restored.loadSnapshot(path);
+    assert(loaded);
+    assertSameKnowledgeBase(original, restored);
+    const Ratiocinator& kb = restored;
+    assert((kb.getProposition("r2")->getOperands() == std::vector<std::string>{"~c", "d", "e"}));
+    assert(kb.getProposition("k1")->getRelation() == LogicalOperator::AND);
+    assert(kb.getProposition("s")->getProvenance()->ruleFired == "Resolution");
+    
+    for (Ratiocinator* rationator : {&original, &restored}) {
+        rationator->setPropositionTruthValue("u1", Tripartite::FALSE);
+        rationator->setPropositionTruthValue("u2", Tripartite::FALSE);
+        rationator->deduceIncremental();
+        assert(rationator->getPropositionTruthValue("u3") == Tripartite::TRUE);
+    }
+    
+    std::remove(path.c_str());
+    std::cout << "Test passed: snapshots round-trip clauses." << std::endl;
+}
+
+// One server response: its status line ("ok N" or "error ...") and body lines
+struct ServerResponse {
+    std::string status;
+    std::vector<std::string> body;
+};
+
+// Split a server's output into responses, checking each "ok N" is followed by N lines
+static std::vector<ServerResponse> readResponses(const std::string& output) {
+    std::vector<ServerResponse> responses;
+    std::istringstream in(output);
+    std::string line;
+    while (std::getline(in, line)) {
+        ServerResponse response;
+        response.status = line;
+        if (line.rfind("ok ", 0) == 0) {
+            size_t lines = std::stoul(line.substr(3));
+            for (size_t i = 0; i < lines; ++i) {
+                const bool more = static_cast<bool>(std::getline(in, line));
+                assert(more);
+                response.body.push_back(line);
+            }
+        } else {
+            assert(line.rfind("error ", 0) == 0);
+        }
+        responses.push_back(std::move(response));
+    }
+    return responses;
+}
+
+static bool containsLine(const std::vector<std::string>& lines, const std::string& wanted) {
+    return std::find(lines.begin(), lines.end(), wanted) != lines.end();
+}
+
+// A derived value's line, whichever rule the deduction happened to fire first
+static bool containsDerivedLine(const std::vector<std::string>& lines, const std::string& value) {
+    return std::any_of(lines.begin(), lines.end(), [&](const std::string& line) {
+        return line.rfind(value + " [derived via ", 0) == 0;
+    });
+}
+
+// Test: a pipelined session answers every request in order from one resident knowledge base
+void testServerRequests() {
+    std::cout << "Running testServerRequests..." << std::endl;
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    rationator.deduce();
+    Server server(rationator);
+    assert(rationator.getIngestOptions().batchSize == 0);
+    
+    std::istringstream in(
+        "fact X0\n"
+        "query X3\n"
+        "# comments and blank lines get no response\n"
+        "\n"
+        "changes\n"
+        "results --true-only --prefix=X\n"
+        "trace X3\n"
+        "assume c1, or(X5, X4)\n"
+        "fact !X5\n"
+        "query X4\n"
+        "retract X0\n"
+        "query X3\n"
+        "retract X0\n"
+        "frobnicate\n"
+        "results --sort=sideways\n"
+        "quit\n"
+        "fact X9\n");
+    std::ostringstream out;
+    server.serve(in, out);
+    assert(!server.isShutdownRequested());
+    
+    std::vector<ServerResponse> responses = readResponses(out.str());
+    assert(responses.size() == 14);
+    assert(responses[0].status == "ok 0");
+    assert(responses[1].body.size() == 1 && containsDerivedLine(responses[1].body, "X3: True"));
+    
+    // The batch's changes, reported once
+    assert(responses[2].body.size() == 4);
+    assert(containsLine(responses[2].body, "X0: Unknown -> True"));
+    assert(containsLine(responses[2].body, "X3: Unknown -> True"));
+    
+    assert(containsDerivedLine(responses[3].body, "X2: True"));
+    assert(!containsLine(responses[3].body, "imp_X0_X1: Unknown"));
+    assert(!responses[4].body.empty());
+    assert(responses[4].body[0].find("X3") != std::string::npos);
+    
+    // Assumptions take part in the next deduction
+    assert(responses[5].status == "ok 0");
+    assert(responses[6].status == "ok 0");
+    assert(responses[7].body == std::vector<std::string>{"X4: True [derived via DisjunctiveSyllogism]"});
+    
+    // Retracting the fact withdraws what was derived from it, and only that
+    assert(responses[8].status == "ok 0");
+    assert(responses[9].body == std::vector<std::string>{"X3: Unknown"});
+    assert(responses[10].status == "error unknown proposition: X0");
+    assert(responses[11].status == "error unknown request: frobnicate");
+    assert(responses[12].status == "error Unknown sort order: sideways");
+    assert(responses[13].status == "ok 0");
+    assert(rationator.getPropositionTruthValue("X4") == Tripartite::TRUE);
+    
+    // Nothing after quit is read
+    assert(!rationator.hasProposition("X9"));
+    
+    std::cout << "Test passed: pipelined requests are answered in order." << std::endl;
+}
+
+// Test: snapshots through the server, and the filter options shared with main
+void testServerSnapshotsAndFilterOptions() {
+    std::cout << "Running testServerSnapshotsAndFilterOptions..." << std::endl;
+    const std::string path = "snapshot_server.snap";
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    Server server(rationator);
+    std::istringstream in("fact X0\nsave " + path + "\nfact !X0\nquery X3\nload " + path +
+                          "\nquery X3\nload missing.snap\nsave ../escaped.snap\nload /etc/hosts\nload ..\nshutdown\n");
+    std::ostringstream out;
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);  // Silence the missing snapshot warning
+    server.serve(in, out);
+    std::cerr.rdbuf(saved);
+    assert(server.isShutdownRequested());
+    
+    std::vector<ServerResponse> responses = readResponses(out.str());
+    assert(responses.size() == 11);
+    assert(responses[1].status == "ok 0");
+    assert(responses[3].body == std::vector<std::string>{"X3: Unknown"});
+    assert(responses[5].body.size() == 1 && containsDerivedLine(responses[5].body, "X3: True"));
+    assert(responses[6].status == "error not a snapshot: missing.snap");
+    // Requests name files in the snapshot directory, never paths
+    assert(responses[7].status == "error not a snapshot name: ../escaped.snap");
+    assert(responses[8].status == "error not a snapshot name: /etc/hosts");
+    assert(responses[9].status == "error not a snapshot name: ..");
+    std::remove(path.c_str());
+    
+    ResultFilter filter;
+    std::string error;
+    bool parsed = Server::parseFilterOption("--known-only", filter, error);
+    assert(parsed && error.empty());
+    assert(filter.showTrue && filter.showFalse && !filter.showUnknown);
+    parsed = Server::parseFilterOption("--limit=25", filter, error);
+    assert(parsed && error.empty());
+    assert(filter.limit == 25);
+    parsed = Server::parseFilterOption("--limit=many", filter, error);
+    assert(parsed && !error.empty());
+    assert(filter.limit == 25);
+    parsed = Server::parseFilterOption("--format=ndjson", filter, error);
+    assert(parsed && error.empty());
+    assert(filter.format == ResultFormat::NDJSON);
+    parsed = Server::parseFilterOption("--verbose", filter, error);
+    assert(!parsed);
+    
+    std::cout << "Test passed: the server saves and loads snapshots." << std::endl;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// Test: requests sent in one write over a Unix socket are answered in order
+void testServerSocket() {
+    std::cout << "Running testServerSocket..." << std::endl;
+    const std::string path = "server_test.sock";
+    
+    Ratiocinator rationator;
+    buildChainKnowledgeBase(rationator);
+    Server server(rationator);
+    std::string error;
+    std::future<bool> served = std::async(std::launch::async, [&] { return server.serveSocket(path, error); });
+    
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = -1;
+    for (int attempt = 0; attempt < 500 && fd < 0; ++attempt) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    assert(fd >= 0);
+    
+    const std::string requests = "fact X1\nquery X3\nquery X0\nshutdown\n";
+    ssize_t sent = ::write(fd, requests.data(), requests.size());
+    assert(sent == static_cast<ssize_t>(requests.size()));
+    std::string output;
+    char chunk[256];
+    ssize_t received;
+    while ((received = ::read(fd, chunk, sizeof(chunk))) > 0) {
+        output.append(chunk, static_cast<size_t>(received));
+    }
+    ::close(fd);
+    const bool servedCleanly = served.get();
+    assert(servedCleanly);
+    
+    std::vector<ServerResponse> responses = readResponses(output);
+    assert(responses.size() == 4);
+    assert(responses[1].body.size() == 1 && containsDerivedLine(responses[1].body, "X3: True"));
+    assert(responses[2].body == std::vector<std::string>{"X0: Unknown"});
+    assert(server.isShutdownRequested());
+    assert(!std::ifstream(path).good());
+    
+    std::cout << "Test passed: socket clients pipeline requests." << std::endl;
+}
+#endif
+
 // Main function to run all tests
 int main() {
     // Parsing tests
@@ -1187,6 +3850,9 @@ int main() {
     testParseNotRelation();
     testParseDiscoveredRelation();
     testParseFactsFile();
+    testMappedFile();
+    testParseFromText();
+    testParallelParseMatchesSerial();
     
     // Basic inference tests
     testModusPonens();
@@ -1211,6 +3877,7 @@ int main() {
     testExpressionsFromFacts();
     testAddExpressionFromString();
     testExpressionsInDeduction();
+    testExpressionsSeeDerivedValues();
     
     // Incremental API tests
     testAddProposition();
@@ -1236,6 +3903,89 @@ int main() {
     testGetFilteredPropositionNames();
     testFormatResultsWithFilter();
     testFluentFilterAPI();
+    
+    // Deduction strategy tests
+    testWorklistMatchesFullSweep();
+    testWorklistChainProvenance();
+    testTopologicalSinglePass();
+    
+    // Literal index and symbol table tests
+    testLiteralIndexLookups();
+    testLiteralIndexMaintenance();
+    testDeduceAfterIndexUpdates();
+    testSymbolTableInterning();
+    testNegationSpellings();
+    
+    // Parallel deduction tests
+    testParallelDeductionDeterministic();
+    testParallelDeductionRepeated();
+    
+    // Incremental deduction tests
+    testDeduceIncrementalPropagates();
+    testDeduceIncrementalRetracts();
+    testDeduceIncrementalExpressions();
+    
+    // Provenance level tests
+    testProvenanceLevels();
+    testDeduceIncrementalProvenanceLevels();
+    
+    // Snapshot tests
+    testSnapshotRoundTrip();
+    testSnapshotRejectsInvalidFiles();
+    
+    // Streaming ingestion tests
+    testStreamingIngest();
+    testStreamingIngestMatchesLoad();
+    
+    // Read snapshot tests
+    testSnapshotPublishing();
+    testConcurrentSnapshotReads();
+    
+    // Backward chaining tests
+    testQueryMatchesDeduce();
+    testQueryIsGoalDirected();
+    
+    // Trace graph tests
+    testTraceGraphSharedAcrossTraces();
+    testTraceGraphShapes();
+    
+    // Result writer tests
+    testResultLimitMatchesFullSort();
+    testWriteResultsFormats();
+    testOutputFile();
+    
+    // Result index tests
+    testResultIndexBuckets();
+    testFilteredResultsFollowChanges();
+
+    // Scenario tests
+    testScenariosMatchFreshDeduction();
+
+    // Convergence tests
+    testOscillationStopsDeduction();
+    testParticularAffirmativeConverges();
+    testDeductionLimits();
+    
+    // Statistics tests
+    testInferenceStats();
+
+    // Expression sharing tests
+    testSharedExpressionsMatchReference();
+
+    // N-ary clause tests
+    testParseClauseRelations();
+    testClauseStore();
+    testClauseDeduction();
+    testClausesMatchBinaryDisjunctions();
+    testClausesIncrementalAndQuery();
+    testClauseSnapshotRoundTrip();
+
+    // Server tests
+    testServerRequests();
+    testServerSnapshotsAndFilterOptions();
+#if defined(__unix__) || defined(__APPLE__)
+    testServerSocket();
+#endif
 
     std::cout << "\n All Ratiocinator tests passed successfully!" << std::endl;
     return 0;